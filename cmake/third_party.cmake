@@ -21,12 +21,13 @@ if (WITH_XLA)
 endif()
 
 if (WITH_TENSORRT)
-  if (NOT WITH_XLA)
-    include(absl)
-  endif()
   include(tensorrt)
 endif()
 
+if ((WITH_TENSORRT OR WITH_XRT_NATIVE) AND NOT WITH_XLA)
+  include(absl)
+endif()
+
 if (BUILD_CUDA)
   set(CUDA_SEPARABLE_COMPILATION ON)
   find_package(CUDA REQUIRED)
@@ -72,13 +73,16 @@ if (NOT WIN32)
   set(BLA_STATIC ON)
   set(BLA_VENDOR "Intel10_64lp_seq")
   find_package(BLAS)
-  if (NOT BLAS_FOUND)
+  if (BLAS_FOUND)
+    add_definitions(-DWITH_MKL)
+  else()
     set(BLA_VENDOR "All")
     find_package(BLAS)
   endif()
 else()
   set(MKL_LIB_PATH "C:/Program Files (x86)/IntelSWTools/compilers_and_libraries_2017/windows/mkl/lib/intel64_win")
   set(BLAS_LIBRARIES ${MKL_LIB_PATH}/mkl_core_dll.lib ${MKL_LIB_PATH}/mkl_sequential_dll.lib ${MKL_LIB_PATH}/mkl_intel_lp64_dll.lib)
+  add_definitions(-DWITH_MKL)
 endif()
 message(STATUS "Found Blas Lib: " ${BLAS_LIBRARIES})
 
@@ -210,12 +214,13 @@ if(WITH_XLA)
 endif()
 
 if(WITH_TENSORRT)
-  if (NOT WITH_XLA)
-    list(APPEND oneflow_third_party_libs ${ABSL_LIBRARIES})
-  endif()
   list(APPEND oneflow_third_party_libs ${TENSORRT_LIBRARIES})
 endif()
 
+if ((WITH_TENSORRT OR WITH_XRT_NATIVE) AND NOT WITH_XLA)
+  list(APPEND oneflow_third_party_libs ${ABSL_LIBRARIES})
+endif()
+
 message(STATUS "oneflow_third_party_libs: " ${oneflow_third_party_libs})
 
 add_definitions(-DHALF_ENABLE_CPP11_USER_LITERALS=0)
@@ -14,6 +14,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include "oneflow/core/comm_network/comm_network.h"
+#include "oneflow/core/thread/thread_placement.h"
 
 namespace oneflow {
 
@@ -93,6 +94,7 @@ CommNet::CommNet(const Plan& plan) {
   peer_machine_id_.insert(peer_machine_ids.begin(), peer_machine_ids.end());
 
   ready_cb_poller_ = std::thread([this]() {
+    Global<ThreadPlacement>::Get()->PinIoThread();
     std::function<void()> cb;
     while (ready_cbs_.Receive(&cb) == kChannelStatusSuccess) { cb(); }
   });
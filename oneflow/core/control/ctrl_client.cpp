@@ -24,8 +24,18 @@ namespace {
 const int32_t max_retry_num = 60;
 const int64_t sleep_seconds = 10;
 
+// every machine of the control tree has at most this many children
+const int64_t kCtrlTreeDegree = 4;
+
 #define GRPC_CHECK(x) CHECK_EQ(x.error_code(), grpc::StatusCode::OK)
 
+int64_t CtrlTreeParentId(int64_t machine_id) { return (machine_id - 1) / kCtrlTreeDegree; }
+
+int64_t CtrlTreeChildNum(int64_t machine_id, int64_t machine_num) {
+  const int64_t first_child_id = machine_id * kCtrlTreeDegree + 1;
+  return std::max<int64_t>(std::min<int64_t>(machine_num - first_child_id, kCtrlTreeDegree), 0);
+}
+
 template<CtrlMethod ctrl_method>
 class ClientCall final {
  public:
@@ -66,6 +76,32 @@ void CtrlClient::Barrier(const std::string& barrier_name, int32_t barrier_num) {
   call(GetMasterStub());
 }
 
+void CtrlClient::TreeBarrier(const std::string& barrier_name, int64_t machine_num) {
+  // the master handles a small cluster as fast as a tree does
+  if (machine_num <= kCtrlTreeDegree + 1) {
+    Barrier(barrier_name, machine_num);
+    return;
+  }
+  const int64_t this_machine_id = Global<MachineCtx>::Get()->this_machine_id();
+  CHECK_LT(this_machine_id, machine_num);
+  auto BarrierOn = [&](int64_t machine_id, const std::string& phase) {
+    ClientCall<CtrlMethod::kBarrier> call;
+    call.mut_request()->set_name(barrier_name + "/" + phase);
+    call.mut_request()->set_num(CtrlTreeChildNum(machine_id, machine_num) + 1);
+    call(stubs_.at(machine_id).get());
+  };
+  const bool has_children = CtrlTreeChildNum(this_machine_id, machine_num) > 0;
+  // every machine waits for its subtree before it arrives at its parent, so the root is
+  // the last to arrive, and it then releases the tree level by level
+  if (has_children) { BarrierOn(this_machine_id, "gather"); }
+  if (this_machine_id != 0) {
+    const int64_t parent_id = CtrlTreeParentId(this_machine_id);
+    BarrierOn(parent_id, "gather");
+    BarrierOn(parent_id, "release");
+  }
+  if (has_children) { BarrierOn(this_machine_id, "release"); }
+}
+
 TryLockResult CtrlClient::TryLock(const std::string& name) {
   {
     std::unique_lock<std::mutex> lck(done_names_mtx_);
@@ -129,6 +165,48 @@ void CtrlClient::PullKV(const std::string& k, PbMessage* msg) {
   PullKV(k, [&](const std::string& i) { msg->ParseFromString(i); });
 }
 
+void CtrlClient::PushBroadcastKV(const std::string& k, std::function<void(std::string*)> VSetter) {
+  CHECK(Global<MachineCtx>::Get()->IsThisMachineMaster());
+  ClientCall<CtrlMethod::kPushKV> call;
+  call.mut_request()->set_key(k);
+  VSetter(call.mut_request()->mutable_val());
+  call(GetMasterStub());
+}
+
+void CtrlClient::PushBroadcastKV(const std::string& k, const std::string& v) {
+  PushBroadcastKV(k, [&](std::string* o) { *o = v; });
+}
+
+void CtrlClient::PushBroadcastKV(const std::string& k, const PbMessage& msg) {
+  PushBroadcastKV(k, [&](std::string* o) { msg.SerializeToString(o); });
+}
+
+void CtrlClient::PullBroadcastKV(const std::string& k, int64_t machine_num,
+                                 std::function<void(const std::string&)> VGetter) {
+  const int64_t this_machine_id = Global<MachineCtx>::Get()->this_machine_id();
+  CHECK_GT(this_machine_id, 0);
+  CHECK_LT(this_machine_id, machine_num);
+  ClientCall<CtrlMethod::kPullKV> pull_call;
+  pull_call.mut_request()->set_key(k);
+  pull_call(stubs_.at(CtrlTreeParentId(this_machine_id)).get());
+  // the value is kept by the CtrlServer of this machine for its children to pull
+  if (CtrlTreeChildNum(this_machine_id, machine_num) > 0) {
+    ClientCall<CtrlMethod::kPushKV> push_call;
+    push_call.mut_request()->set_key(k);
+    push_call.mut_request()->set_val(pull_call.response().val());
+    push_call(GetThisStub());
+  }
+  VGetter(pull_call.response().val());
+}
+
+void CtrlClient::PullBroadcastKV(const std::string& k, int64_t machine_num, std::string* v) {
+  PullBroadcastKV(k, machine_num, [&](const std::string& i) { *v = i; });
+}
+
+void CtrlClient::PullBroadcastKV(const std::string& k, int64_t machine_num, PbMessage* msg) {
+  PullBroadcastKV(k, machine_num, [&](const std::string& i) { msg->ParseFromString(i); });
+}
+
 void CtrlClient::PushActEvent(const ActEvent& act_event) {
   ClientCall<CtrlMethod::kPushActEvent> call;
   *(call.mut_request()->mutable_act_event()) = act_event;
@@ -30,6 +30,9 @@ class CtrlClient final {
 
   void Barrier(const std::string& barrier_name);
   void Barrier(const std::string& barrier_name, int32_t barrier_num);
+  // barrier of the machines [0, machine_num), gathered and released through a tree of
+  // CtrlServers so that no server handles more than a few calls of it
+  void TreeBarrier(const std::string& barrier_name, int64_t machine_num);
 
   TryLockResult TryLock(const std::string& name);
   void NotifyDone(const std::string& name);
@@ -54,6 +57,16 @@ class CtrlClient final {
     *v = oneflow_cast<T>(v_str);
   }
 
+  // kv pushed by the master and pulled by every other machine of [0, machine_num), each of
+  // which pulls it from the CtrlServer of its parent in a tree rooted at the master
+  void PushBroadcastKV(const std::string& k, std::function<void(std::string*)> VSetter);
+  void PushBroadcastKV(const std::string& k, const std::string& v);
+  void PushBroadcastKV(const std::string& k, const PbMessage& msg);
+  void PullBroadcastKV(const std::string& k, int64_t machine_num,
+                       std::function<void(const std::string&)> VGetter);
+  void PullBroadcastKV(const std::string& k, int64_t machine_num, std::string* v);
+  void PullBroadcastKV(const std::string& k, int64_t machine_num, PbMessage* msg);
+
   void PushActEvent(const ActEvent&);
   void Clear();
 
@@ -81,9 +94,9 @@ class CtrlClient final {
 #define FILE_LINE_STR __FILE__ ":" OF_PP_STRINGIZE(__LINE__)
 
 #define OF_BARRIER_ALL() Global<CtrlClient>::Get()->Barrier(FILE_LINE_STR)
-#define OF_BARRIER()                                \
-  Global<CtrlClient>::Get()->Barrier(FILE_LINE_STR, \
-                                     Global<ResourceDesc, ForSession>::Get()->TotalMachineNum())
+#define OF_BARRIER()                                    \
+  Global<CtrlClient>::Get()->TreeBarrier(FILE_LINE_STR, \
+                                         Global<ResourceDesc, ForSession>::Get()->TotalMachineNum())
 
 static void OfCallOnce(const std::string& name, std::function<void()> f) {
   TryLockResult lock_ret = Global<CtrlClient>::Get()->TryLock(name);
@@ -0,0 +1,113 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include <sys/wait.h>
+#include <unistd.h>
+#include "oneflow/core/control/ctrl_client.h"
+#include "oneflow/core/control/ctrl_server.h"
+#include "oneflow/core/job/env_desc.h"
+#include "oneflow/core/job/machine_context.h"
+
+namespace oneflow {
+
+namespace {
+
+// machines of different loopback addresses, each of which listens on a port of its own
+EnvProto GetLoopbackEnvProto(int64_t machine_num, int32_t base_port, int64_t this_machine_id) {
+  EnvProto env_proto;
+  for (int64_t i = 0; i < machine_num; ++i) {
+    Machine* machine = env_proto.add_machine();
+    machine->set_id(i);
+    machine->set_addr("127.0.0." + std::to_string(i + 1));
+    machine->set_ctrl_port_agent(base_port + i);
+  }
+  env_proto.set_ctrl_port(base_port + this_machine_id);
+  return env_proto;
+}
+
+double GetCurSeconds() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// runs in a process of its own, returns the exit code of the process
+int RunLoopbackMachine(int64_t machine_num, int32_t base_port, int64_t this_machine_id) {
+  const int64_t round_num = 16;
+  Global<EnvDesc>::New(GetLoopbackEnvProto(machine_num, base_port, this_machine_id));
+  Global<CtrlServer>::New();
+  Global<CtrlClient>::New();
+  Global<MachineCtx>::New(this_machine_id);
+  CtrlClient* client = Global<CtrlClient>::Get();
+  int ret = 0;
+  client->Barrier("start");
+  double flat_seconds = GetCurSeconds();
+  for (int64_t i = 0; i < round_num; ++i) { client->Barrier("flat", machine_num); }
+  flat_seconds = GetCurSeconds() - flat_seconds;
+  double tree_seconds = GetCurSeconds();
+  for (int64_t i = 0; i < round_num; ++i) {
+    const std::string count_key = "tree_arrived_" + std::to_string(i);
+    client->IncreaseCount(count_key);
+    client->TreeBarrier("tree", machine_num);
+    // nobody leaves the barrier before everybody arrived
+    if (client->IncreaseCount(count_key, 0) != machine_num) { ret = 1; }
+  }
+  tree_seconds = GetCurSeconds() - tree_seconds;
+  for (int64_t i = 0; i < round_num; ++i) {
+    const std::string key = "broadcast_" + std::to_string(i);
+    const std::string val = std::string(1024, 'a' + i);
+    if (this_machine_id == 0) {
+      client->PushBroadcastKV(key, val);
+    } else {
+      std::string pulled;
+      client->PullBroadcastKV(key, machine_num, &pulled);
+      if (pulled != val) { ret = 1; }
+    }
+  }
+  if (this_machine_id == 0) {
+    std::cout << machine_num << " machines, flat barrier: " << flat_seconds / round_num * 1e3
+              << "ms, tree barrier: " << tree_seconds / round_num * 1e3 << "ms" << std::endl;
+  }
+  client->Barrier("end");
+  // the servers of the others may still be sending the responses of the last barrier
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+  return ret;
+}
+
+void TestLoopbackCluster(int64_t machine_num) {
+  const int32_t base_port = 30000 + (getpid() % 1000) * 32;
+  std::vector<pid_t> pids;
+  for (int64_t i = 0; i < machine_num; ++i) {
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    // the globals are neither deleted nor joined in the forked process
+    if (pid == 0) { _exit(RunLoopbackMachine(machine_num, base_port, i)); }
+    pids.push_back(pid);
+  }
+  for (pid_t pid : pids) {
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+  }
+}
+
+}  // namespace
+
+TEST(CtrlClient, loopback_tree_barrier_and_broadcast_kv) {
+  TestLoopbackCluster(3);
+  TestLoopbackCluster(11);
+}
+
+}  // namespace oneflow
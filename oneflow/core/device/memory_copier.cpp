@@ -15,7 +15,8 @@ limitations under the License.
 */
 #include "oneflow/core/device/memory_copier.h"
 #include "oneflow/core/common/auto_registration_factory.h"
-#include "oneflow/core/common/nd_index_offset_helper.h"
+#include "oneflow/core/common/balanced_splitter.h"
+#include "oneflow/core/thread/thread_manager.h"
 
 namespace oneflow {
 
@@ -77,25 +78,70 @@ MemoryCopyNdDesc GetDescInBytes(const MemoryCopyNdDesc& desc) {
 
 }  // namespace
 
+// every task dispatched to Global<ThreadPool> copies kCopyNDGrainSize bytes at least
+constexpr int64_t kCopyNDGrainSize = 1 << 20;
+
 template<int32_t NDIMS>
 void CopyNDCpuImpl(DeviceCtx* ctx, void* dst, const void* src, const MemoryCopyNdDesc& desc) {
-  NdIndexOffsetHelper<int64_t, NDIMS> src_helper(desc.src_shape.dim_vec().data());
-  NdIndexOffsetHelper<int64_t, NDIMS> dst_helper(desc.dst_shape.dim_vec().data());
-  NdIndexOffsetHelper<int64_t, NDIMS> copy_helper(desc.extent.dim_vec().data());
-  FOR_RANGE(int64_t, i, 0, desc.extent.elem_cnt()) {
-    int64_t copy_idx[NDIMS];
-    int64_t src_idx[NDIMS];
-    int64_t dst_idx[NDIMS];
-    copy_helper.OffsetToNdIndex(i, copy_idx);
-    FOR_RANGE(int64_t, j, 0, NDIMS) {
-      src_idx[j] = desc.src_pos.At(j) + copy_idx[j];
-      dst_idx[j] = desc.dst_pos.At(j) + copy_idx[j];
+  // the trailing axes that are fully covered by the extent on both sides are merged with the
+  // axis before them into one contiguous run, which is copied by a single memcpy
+  int64_t run_axis = NDIMS - 1;
+  int64_t run_size = desc.extent.At(run_axis);
+  while (run_axis > 0 && desc.extent.At(run_axis) == desc.src_shape.At(run_axis)
+         && desc.extent.At(run_axis) == desc.dst_shape.At(run_axis)) {
+    run_axis -= 1;
+    run_size *= desc.extent.At(run_axis);
+  }
+  int64_t src_strides[NDIMS];
+  int64_t dst_strides[NDIMS];
+  int64_t src_base = 0;
+  int64_t dst_base = 0;
+  FOR_RANGE(int64_t, i, 0, NDIMS) {
+    src_strides[i] = desc.src_shape.Count(i + 1);
+    dst_strides[i] = desc.dst_shape.Count(i + 1);
+    src_base += desc.src_pos.At(i) * src_strides[i];
+    dst_base += desc.dst_pos.At(i) * dst_strides[i];
+  }
+  const int64_t run_cnt = desc.extent.Count(0, run_axis);
+  auto CopyRuns = [&](int64_t begin, int64_t end) {
+    if (begin >= end) { return; }
+    int64_t run_idx[NDIMS];
+    int64_t src_offset = src_base;
+    int64_t dst_offset = dst_base;
+    int64_t rest = begin;
+    for (int64_t i = run_axis - 1; i >= 0; --i) {
+      run_idx[i] = rest % desc.extent.At(i);
+      rest /= desc.extent.At(i);
+      src_offset += run_idx[i] * src_strides[i];
+      dst_offset += run_idx[i] * dst_strides[i];
     }
-    const int64_t src_offset = src_helper.NdIndexToOffset(src_idx);
-    const int64_t dst_offset = dst_helper.NdIndexToOffset(dst_idx);
-    unsigned char* dst_ptr = reinterpret_cast<unsigned char*>(dst) + dst_offset;
-    const unsigned char* src_ptr = reinterpret_cast<const unsigned char*>(src) + src_offset;
-    *dst_ptr = *src_ptr;
+    const unsigned char* src_ptr = reinterpret_cast<const unsigned char*>(src);
+    unsigned char* dst_ptr = reinterpret_cast<unsigned char*>(dst);
+    for (int64_t r = begin; r < end; ++r) {
+      memcpy(dst_ptr + dst_offset, src_ptr + src_offset, run_size);
+      // advances the outer index like an odometer, so no division is done per run
+      for (int64_t i = run_axis - 1; i >= 0; --i) {
+        src_offset += src_strides[i];
+        dst_offset += dst_strides[i];
+        if (++run_idx[i] < desc.extent.At(i)) { break; }
+        src_offset -= run_idx[i] * src_strides[i];
+        dst_offset -= run_idx[i] * dst_strides[i];
+        run_idx[i] = 0;
+      }
+    }
+  };
+  const ThreadPool* thread_pool = Global<ThreadPool>::Get();
+  const int64_t parallel_num =
+      thread_pool == nullptr
+          ? 1
+          : std::max<int64_t>(std::min<int64_t>({static_cast<int64_t>(thread_pool->thread_num()),
+                                                 run_cnt * run_size / kCopyNDGrainSize, run_cnt}),
+                              1);
+  if (parallel_num == 1) {
+    CopyRuns(0, run_cnt);
+  } else {
+    const BalancedSplitter bs(run_cnt, parallel_num);
+    MultiThreadLoop(parallel_num, [&](size_t i) { CopyRuns(bs.At(i).begin(), bs.At(i).end()); });
   }
 }
 
@@ -32,40 +32,84 @@ namespace eager {
 
 namespace {
 
-void StorageAdd(const EagerSymbol& symbol) {
-  int64_t symbol_id = symbol.symbol_id();
-  if (symbol.has_string_symbol()) {
-    Global<vm::SymbolStorage<std::string>>::Get()->Add(symbol_id, symbol.string_symbol());
-  } else if (symbol.has_scope_symbol()) {
-    Global<vm::SymbolStorage<Scope>>::Get()->Add(symbol_id, symbol.scope_symbol());
-  } else if (symbol.has_job_conf_symbol()) {
-    Global<vm::SymbolStorage<JobDesc>>::Get()->Add(symbol_id, symbol.job_conf_symbol());
-  } else if (symbol.has_parallel_conf_symbol()) {
-    Global<vm::SymbolStorage<ParallelDesc>>::Get()->Add(symbol_id, symbol.parallel_conf_symbol());
-  } else if (symbol.has_op_conf_symbol()) {
-    Global<vm::SymbolStorage<OperatorConf>>::Get()->Add(symbol_id, symbol.op_conf_symbol());
-  } else if (symbol.has_op_node_signature_symbol()) {
-    Global<vm::SymbolStorage<OpNodeSignatureDesc>>::Get()->Add(symbol_id,
-                                                               symbol.op_node_signature_symbol());
-  } else {
-    UNIMPLEMENTED();
-  }
+template<typename T>
+using SymbolBatch =
+    std::vector<std::pair<int64_t, const typename vm::SymbolStorage<T>::ConstructArgType*>>;
+
+template<typename T>
+void StorageBatchAdd(const SymbolBatch<T>& batch) {
+  if (batch.empty()) { return; }
+  Global<vm::SymbolStorage<T>>::Get()->BatchAdd(batch);
+}
+
+template<typename T>
+void AppendMemoryUsage(const std::string& name, std::ostringstream* ss) {
+  const auto* storage = Global<vm::SymbolStorage<T>>::Get();
+  if (storage == nullptr) { return; }
+  *ss << name << ": " << storage->size() << " symbols, " << storage->ByteSize() << " bytes\n";
 }
 
 Maybe<void> RunLogicalInstruction(const vm::InstructionListProto& instruction_list_proto,
                                   const EagerSymbolList& eager_symbol_list) {
-  for (const auto& eager_symbol : eager_symbol_list.eager_symbol()) { StorageAdd(eager_symbol); }
+  StorageAdd(eager_symbol_list);
   return vm::Run(instruction_list_proto);
 }
 
 Maybe<void> RunPhysicalInstruction(const vm::InstructionListProto& instruction_list_proto,
                                    const EagerSymbolList& eager_symbol_list) {
-  for (const auto& eager_symbol : eager_symbol_list.eager_symbol()) { StorageAdd(eager_symbol); }
+  StorageAdd(eager_symbol_list);
   return vm::Run(instruction_list_proto);
 }
 
+Maybe<int64_t> SubmitInstructionFromBinaryProto(const std::string& serialized_instruction_list,
+                                                const std::string& serialized_eager_symbol_list) {
+  vm::InstructionListProto instruction_list_proto;
+  CHECK_OR_RETURN(instruction_list_proto.ParseFromString(serialized_instruction_list))
+      << "InstructionListProto parse failed";
+  EagerSymbolList eager_symbol_list;
+  CHECK_OR_RETURN(eager_symbol_list.ParseFromString(serialized_eager_symbol_list))
+      << "EagerSymbolList parse failed";
+  // the symbols are stored before submitting since the instructions may be run at once
+  StorageAdd(eager_symbol_list);
+  return vm::Submit(instruction_list_proto);
+}
+
 }  // namespace
 
+void StorageAdd(const EagerSymbolList& eager_symbol_list) {
+  SymbolBatch<std::string> string_symbols;
+  SymbolBatch<Scope> scope_symbols;
+  SymbolBatch<JobDesc> job_conf_symbols;
+  SymbolBatch<ParallelDesc> parallel_conf_symbols;
+  SymbolBatch<OperatorConf> op_conf_symbols;
+  SymbolBatch<OpNodeSignatureDesc> op_node_signature_symbols;
+  for (const auto& symbol : eager_symbol_list.eager_symbol()) {
+    int64_t symbol_id = symbol.symbol_id();
+    if (symbol.has_string_symbol()) {
+      string_symbols.emplace_back(symbol_id, &symbol.string_symbol());
+    } else if (symbol.has_scope_symbol()) {
+      scope_symbols.emplace_back(symbol_id, &symbol.scope_symbol());
+    } else if (symbol.has_job_conf_symbol()) {
+      job_conf_symbols.emplace_back(symbol_id, &symbol.job_conf_symbol());
+    } else if (symbol.has_parallel_conf_symbol()) {
+      parallel_conf_symbols.emplace_back(symbol_id, &symbol.parallel_conf_symbol());
+    } else if (symbol.has_op_conf_symbol()) {
+      op_conf_symbols.emplace_back(symbol_id, &symbol.op_conf_symbol());
+    } else if (symbol.has_op_node_signature_symbol()) {
+      op_node_signature_symbols.emplace_back(symbol_id, &symbol.op_node_signature_symbol());
+    } else {
+      UNIMPLEMENTED();
+    }
+  }
+  StorageBatchAdd<std::string>(string_symbols);
+  StorageBatchAdd<JobDesc>(job_conf_symbols);
+  StorageBatchAdd<ParallelDesc>(parallel_conf_symbols);
+  // a scope gets its job desc and parallel descs from the storages on construction
+  StorageBatchAdd<Scope>(scope_symbols);
+  StorageBatchAdd<OperatorConf>(op_conf_symbols);
+  StorageBatchAdd<OpNodeSignatureDesc>(op_node_signature_symbols);
+}
+
 Maybe<void> RunPhysicalInstruction(const std::string& instruction_list_proto_str,
                                    const std::string& eager_symbol_list_str) {
   vm::InstructionListProto instruction_list_proto;
@@ -88,5 +132,58 @@ Maybe<void> RunLogicalInstruction(const std::string& instruction_list_proto_str,
   return RunLogicalInstruction(instruction_list_proto, eager_symbol_list);
 }
 
+Maybe<void> RunPhysicalInstructionFromBinaryProto(const std::string& serialized_instruction_list,
+                                                  const std::string& serialized_eager_symbol_list) {
+  vm::InstructionListProto instruction_list_proto;
+  CHECK_OR_RETURN(instruction_list_proto.ParseFromString(serialized_instruction_list))
+      << "InstructionListProto parse failed";
+  EagerSymbolList eager_symbol_list;
+  CHECK_OR_RETURN(eager_symbol_list.ParseFromString(serialized_eager_symbol_list))
+      << "EagerSymbolList parse failed";
+  return RunPhysicalInstruction(instruction_list_proto, eager_symbol_list);
+}
+
+Maybe<void> RunLogicalInstructionFromBinaryProto(const std::string& serialized_instruction_list,
+                                                 const std::string& serialized_eager_symbol_list) {
+  vm::InstructionListProto instruction_list_proto;
+  CHECK_OR_RETURN(instruction_list_proto.ParseFromString(serialized_instruction_list))
+      << "InstructionListProto parse failed";
+  EagerSymbolList eager_symbol_list;
+  CHECK_OR_RETURN(eager_symbol_list.ParseFromString(serialized_eager_symbol_list))
+      << "EagerSymbolList parse failed";
+  return RunLogicalInstruction(instruction_list_proto, eager_symbol_list);
+}
+
+Maybe<int64_t> SubmitPhysicalInstructionFromBinaryProto(
+    const std::string& serialized_instruction_list,
+    const std::string& serialized_eager_symbol_list) {
+  return SubmitInstructionFromBinaryProto(serialized_instruction_list,
+                                          serialized_eager_symbol_list);
+}
+
+Maybe<int64_t> SubmitLogicalInstructionFromBinaryProto(
+    const std::string& serialized_instruction_list,
+    const std::string& serialized_eager_symbol_list) {
+  return SubmitInstructionFromBinaryProto(serialized_instruction_list,
+                                          serialized_eager_symbol_list);
+}
+
+Maybe<void> WaitUntilInstructionsDone(int64_t submitted_seq) {
+  return vm::WaitUntilDone(submitted_seq);
+}
+
+Maybe<bool> InstructionsDone(int64_t submitted_seq) { return vm::IsDone(submitted_seq); }
+
+Maybe<std::string> SymbolStorageMemoryUsage() {
+  std::ostringstream ss;
+  AppendMemoryUsage<std::string>("string", &ss);
+  AppendMemoryUsage<Scope>("scope", &ss);
+  AppendMemoryUsage<JobDesc>("job_conf", &ss);
+  AppendMemoryUsage<ParallelDesc>("parallel_conf", &ss);
+  AppendMemoryUsage<OperatorConf>("op_conf", &ss);
+  AppendMemoryUsage<OpNodeSignatureDesc>("op_node_signature", &ss);
+  return ss.str();
+}
+
 }  // namespace eager
 }  // namespace oneflow
@@ -21,11 +21,40 @@ limitations under the License.
 namespace oneflow {
 namespace eager {
 
+class EagerSymbolList;
+
+// stores the symbols into the symbol storages of their kinds, the symbols depended on by the
+// others are stored first whatever the order in the list is
+void StorageAdd(const EagerSymbolList& eager_symbol_list);
+
 Maybe<void> RunPhysicalInstruction(const std::string& instruction_list_proto_str,
                                    const std::string& eager_symbol_list_str);
 Maybe<void> RunLogicalInstruction(const std::string& instruction_list_proto_str,
                                   const std::string& eager_symbol_list_str);
 
+// same as above, but the protos are serialized in binary format which is much cheaper to parse
+// than text format
+Maybe<void> RunPhysicalInstructionFromBinaryProto(const std::string& serialized_instruction_list,
+                                                  const std::string& serialized_eager_symbol_list);
+Maybe<void> RunLogicalInstructionFromBinaryProto(const std::string& serialized_instruction_list,
+                                                 const std::string& serialized_eager_symbol_list);
+
+// same as above, but return without waiting for the instructions to be done. the returned
+// sequence number is passed to WaitUntilInstructionsDone or InstructionsDone
+Maybe<int64_t> SubmitPhysicalInstructionFromBinaryProto(
+    const std::string& serialized_instruction_list,
+    const std::string& serialized_eager_symbol_list);
+Maybe<int64_t> SubmitLogicalInstructionFromBinaryProto(
+    const std::string& serialized_instruction_list,
+    const std::string& serialized_eager_symbol_list);
+// blocks until all the instructions submitted no later than submitted_seq are done
+Maybe<void> WaitUntilInstructionsDone(int64_t submitted_seq);
+// returns immediately
+Maybe<bool> InstructionsDone(int64_t submitted_seq);
+
+// number of symbols and bytes held by every kind of eager symbol storage
+Maybe<std::string> SymbolStorageMemoryUsage();
+
 }  // namespace eager
 }  // namespace oneflow
 
@@ -0,0 +1,75 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/eager/eager_util.h"
+#include "oneflow/core/eager/eager_symbol.pb.h"
+#include "oneflow/core/eager/eager_symbol_storage.h"
+#include "oneflow/core/vm/id_util.h"
+#include "oneflow/core/vm/symbol_storage.h"
+#include "oneflow/core/vm/test_util.h"
+#include "oneflow/core/job/job_desc.h"
+#include "oneflow/core/job/parallel_desc.h"
+#include "oneflow/core/job/scope.h"
+#include "oneflow/core/operator/op_conf.pb.h"
+
+namespace oneflow {
+namespace eager {
+namespace test {
+
+TEST(EagerUtil, storage_add_scope_with_its_symbols) {
+  vm::TestResourceDescScope resource_scope(0, 1);
+  const int64_t job_desc_symbol_id = vm::IdUtil::NewLogicalSymbolId();
+  const int64_t parallel_desc_symbol_id = vm::IdUtil::NewLogicalSymbolId();
+  const int64_t scope_symbol_id = vm::IdUtil::NewLogicalSymbolId();
+  EagerSymbolList eager_symbol_list;
+  // the scope comes first, as the symbols depended on are not required to precede it
+  {
+    EagerSymbol* symbol = eager_symbol_list.add_eager_symbol();
+    symbol->set_symbol_id(scope_symbol_id);
+    ScopeProto* scope_proto = symbol->mutable_scope_symbol();
+    scope_proto->set_symbol_id(scope_symbol_id);
+    scope_proto->set_job_desc_symbol_id(job_desc_symbol_id);
+    scope_proto->set_device_parallel_desc_symbol_id(parallel_desc_symbol_id);
+    scope_proto->set_host_parallel_desc_symbol_id(parallel_desc_symbol_id);
+    scope_proto->mutable_opt_mirrored_parallel_conf();
+  }
+  {
+    EagerSymbol* symbol = eager_symbol_list.add_eager_symbol();
+    symbol->set_symbol_id(job_desc_symbol_id);
+    symbol->mutable_job_conf_symbol()->set_job_name("test_job");
+  }
+  {
+    EagerSymbol* symbol = eager_symbol_list.add_eager_symbol();
+    symbol->set_symbol_id(parallel_desc_symbol_id);
+    ParallelConf* parallel_conf = symbol->mutable_parallel_conf_symbol();
+    parallel_conf->set_device_tag("cpu");
+    parallel_conf->add_device_name("0:0");
+  }
+  StorageAdd(eager_symbol_list);
+  const auto& scope_storage = *Global<vm::SymbolStorage<Scope>>::Get();
+  ASSERT_TRUE(scope_storage.Has(scope_symbol_id));
+  const Scope& scope = scope_storage.Get(scope_symbol_id);
+  ASSERT_EQ(CHECK_JUST(scope.job_desc())->job_name(), "test_job");
+  OperatorConf op_conf;
+  op_conf.set_device_type(DeviceType::kCPU);
+  ASSERT_EQ(CHECK_JUST(scope.GetParallelDesc(op_conf))->parallel_num(), 1);
+  Global<vm::SymbolStorage<Scope>>::Get()->Clear(scope_symbol_id);
+  Global<vm::SymbolStorage<ParallelDesc>>::Get()->Clear(parallel_desc_symbol_id);
+  Global<vm::SymbolStorage<JobDesc>>::Get()->Clear(job_desc_symbol_id);
+}
+
+}  // namespace test
+}  // namespace eager
+}  // namespace oneflow
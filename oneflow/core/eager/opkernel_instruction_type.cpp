@@ -387,6 +387,32 @@ Maybe<void> OpKernelCompute(SystemOpKernelObject* opkernel_obj, vm::Instruction*
   return Maybe<void>::Ok();
 }
 
+}  // namespace
+
+template<typename T>
+Maybe<T*> InitSharedOpKernel(vm::RwMutexedObject* rw_mutexed_object, const OperatorConf& op_conf,
+                             const std::shared_ptr<const JobDesc>& job_desc,
+                             DeviceType device_type) {
+  rw_mutexed_object->reset_object();
+  return rw_mutexed_object->Init<T>(op_conf, job_desc, device_type);
+}
+
+// the shared opkernel object is reused so that the kernels cached in it survive across calls
+template<>
+Maybe<OpKernelObject*> InitSharedOpKernel<OpKernelObject>(
+    vm::RwMutexedObject* rw_mutexed_object, const OperatorConf& op_conf,
+    const std::shared_ptr<const JobDesc>& job_desc, DeviceType device_type) {
+  if (rw_mutexed_object->has_object() && rw_mutexed_object->Has<OpKernelObject>()) {
+    auto* opkernel_obj = rw_mutexed_object->Mut<OpKernelObject>();
+    opkernel_obj->ResetOpConf(op_conf, job_desc, device_type);
+    return opkernel_obj;
+  }
+  rw_mutexed_object->reset_object();
+  return rw_mutexed_object->Init<OpKernelObject>(op_conf, job_desc, device_type);
+}
+
+namespace {
+
 template<typename T>
 Maybe<T*> GetSharedOpKernel(vm::Instruction* instruction, DeviceType device_type,
                             const StatelessCallOpKernelInstrOperand& args) {
@@ -401,8 +427,7 @@ Maybe<T*> GetSharedOpKernel(vm::Instruction* instruction, DeviceType device_type
   const auto& parallel_desc = instruction->parallel_desc();
   CHECK_OR_RETURN(static_cast<bool>(parallel_desc));
   CHECK_EQ_OR_RETURN(device_type, parallel_desc->device_type());
-  rw_mutexed_object->reset_object();
-  return rw_mutexed_object->Init<T>(op_conf, job_desc_ptr, device_type);
+  return InitSharedOpKernel<T>(rw_mutexed_object, op_conf, job_desc_ptr, device_type);
 }
 
 }  // namespace
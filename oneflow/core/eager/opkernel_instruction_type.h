@@ -21,8 +21,25 @@ limitations under the License.
 #include "oneflow/core/memory/memory_case.pb.h"
 
 namespace oneflow {
+
+class JobDesc;
+class OperatorConf;
+
 namespace eager {
 
+class OpKernelObject;
+
+// inits the opkernel object in rw_mutexed_object for a stateless call
+template<typename T>
+Maybe<T*> InitSharedOpKernel(vm::RwMutexedObject* rw_mutexed_object, const OperatorConf& op_conf,
+                             const std::shared_ptr<const JobDesc>& job_desc,
+                             DeviceType device_type);
+
+template<>
+Maybe<OpKernelObject*> InitSharedOpKernel<OpKernelObject>(
+    vm::RwMutexedObject* rw_mutexed_object, const OperatorConf& op_conf,
+    const std::shared_ptr<const JobDesc>& job_desc, DeviceType device_type);
+
 class CallOpKernelInstructionType : public vm::InstructionType {
  public:
   void Infer(vm::Instruction* instruction) const override;
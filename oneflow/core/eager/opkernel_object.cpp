@@ -13,22 +13,163 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 */
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include "oneflow/core/eager/opkernel_object.h"
 
 namespace oneflow {
 namespace eager {
 
+namespace {
+
+void AppendDeterministicSerialization(const PbMessage& msg, std::string* key) {
+  std::string serialized;
+  {
+    google::protobuf::io::StringOutputStream output_stream(&serialized);
+    google::protobuf::io::CodedOutputStream coded_stream(&output_stream);
+    // maps (e.g. the attrs of user ops) are serialized in an unspecified order by default
+    coded_stream.SetSerializationDeterministic(true);
+    CHECK(msg.SerializePartialToCodedStream(&coded_stream));
+  }
+  key->append(std::to_string(serialized.size())).append(":").append(serialized).append("\n");
+}
+
+std::string GenJobDescKey(const JobDesc& job_desc) {
+  std::string key = std::to_string(job_desc.job_id()) + "\n";
+  AppendDeterministicSerialization(job_desc.job_conf(), &key);
+  return key;
+}
+
+}  // namespace
+
+constexpr size_t OpKernelObject::kMaxCachedKernelNum;
+
+OpKernelObject::OpKernelObject(const OperatorConf& op_conf,
+                               const std::shared_ptr<const JobDesc>& job_desc,
+                               DeviceType device_type)
+    : op_conf_(op_conf),
+      job_desc_(job_desc),
+      job_desc_key_(GenJobDescKey(*job_desc)),
+      device_type_(device_type),
+      kernel_(nullptr),
+      opkernel_state_(nullptr) {
+  CHECK(op_conf.has_user_conf());
+}
+
+void OpKernelObject::ResetOpConf(const OperatorConf& op_conf,
+                                 const std::shared_ptr<const JobDesc>& job_desc,
+                                 DeviceType device_type) {
+  CHECK(op_conf.has_user_conf());
+  op_conf_ = op_conf;
+  // the old job desc is still alive here, so an equal address means the same job desc
+  if (job_desc != job_desc_) { job_desc_key_ = GenJobDescKey(*job_desc); }
+  job_desc_ = job_desc;
+  device_type_ = device_type;
+  kernel_.reset();
+  opkernel_state_.reset();
+}
+
 Maybe<void> OpKernelObject::ResetOpAndKernel(
     const OpNodeSignatureDesc& op_node_signature, const ParallelContext* parallel_ctx,
     const std::function<BlobDesc*(const std::string&)>& BlobDesc4BnInOp) {
+  const std::string& key = GenCachedKernelKey(op_node_signature, parallel_ctx, BlobDesc4BnInOp);
+  const CachedKernel* cached_kernel = FindCachedKernel(key);
+  if (cached_kernel != nullptr) {
+    for (const auto& pair : cached_kernel->obn7blob_desc) {
+      BlobDesc* blob_desc = BlobDesc4BnInOp(pair.first);
+      CHECK_NOTNULL_OR_RETURN(blob_desc) << "obn: " << pair.first;
+      *blob_desc = *pair.second;
+    }
+    kernel_ = cached_kernel->kernel;
+    return Maybe<void>::Ok();
+  }
   auto op = ConstructOp(op_conf_, device_type_, job_desc_.get());
   std::unique_ptr<OpContext> op_ctx;
   JUST(InferBlobDescs(*op, BlobDesc4BnInOp, &op_node_signature.sbp_signature(), parallel_ctx,
                       &op_ctx));
   NewPartialInitializedKernel(*op, BlobDesc4BnInOp, op_node_signature, parallel_ctx, op_ctx.get());
+  AddCachedKernel(key, *op, BlobDesc4BnInOp);
   return Maybe<void>::Ok();
 }
 
+std::string OpKernelObject::GenCachedKernelKey(
+    const OpNodeSignatureDesc& op_node_signature, const ParallelContext* parallel_ctx,
+    const std::function<BlobDesc*(const std::string&)>& BlobDesc4BnInOp) const {
+  const UserOpConf& user_conf = op_conf_.user_conf();
+  std::string key;
+  key += user_conf.op_type_name() + "\n";
+  key += std::to_string(device_type_) + "\n";
+  // keyed by the content of the job desc, so that the cached kernels survive ResetOpConf with
+  // another job desc symbol of the same config
+  key += job_desc_key_;
+  AppendDeterministicSerialization(*parallel_ctx, &key);
+  AppendDeterministicSerialization(op_node_signature.op_node_signature(), &key);
+  // the iteration order of protobuf maps is unspecified
+  std::map<std::string, const UserOpAttrVal*> attr_name2attr_val;
+  for (const auto& pair : user_conf.attr()) {
+    attr_name2attr_val.emplace(pair.first, &pair.second);
+  }
+  for (const auto& pair : attr_name2attr_val) {
+    key += pair.first + ":";
+    AppendDeterministicSerialization(*pair.second, &key);
+  }
+  std::map<std::string, int32_t> output_arg_name2size;
+  for (const auto& pair : user_conf.output()) {
+    output_arg_name2size.emplace(pair.first, pair.second.s_size());
+  }
+  for (const auto& pair : output_arg_name2size) {
+    key += pair.first + ":" + std::to_string(pair.second) + "\n";
+  }
+  // a shape change of any input makes a new key
+  std::map<std::string, int32_t> input_arg_name2size;
+  for (const auto& pair : user_conf.input()) {
+    input_arg_name2size.emplace(pair.first, pair.second.s_size());
+  }
+  for (const auto& pair : input_arg_name2size) {
+    FOR_RANGE(int32_t, i, 0, pair.second) {
+      const std::string& ibn = GenRepeatedBn(pair.first, i);
+      const BlobDesc* blob_desc = BlobDesc4BnInOp(ibn);
+      key += ibn + ":";
+      if (blob_desc != nullptr) {
+        BlobDescProto blob_desc_proto;
+        blob_desc->ToProto(&blob_desc_proto);
+        AppendDeterministicSerialization(blob_desc_proto, &key);
+      } else {
+        key += "\n";
+      }
+    }
+  }
+  return key;
+}
+
+const OpKernelObject::CachedKernel* OpKernelObject::FindCachedKernel(const std::string& key) {
+  const auto& iter = key2cached_kernel_it_.find(key);
+  if (iter == key2cached_kernel_it_.end()) { return nullptr; }
+  cached_kernels_.splice(cached_kernels_.begin(), cached_kernels_, iter->second);
+  return iter->second->second.get();
+}
+
+void OpKernelObject::AddCachedKernel(
+    const std::string& key, const Operator& op,
+    const std::function<BlobDesc*(const std::string&)>& BlobDesc4BnInOp) {
+  auto* cached_kernel = new CachedKernel();
+  cached_kernel->job_desc = job_desc_;
+  cached_kernel->kernel = kernel_;
+  const auto& AddObn = [&](const std::string& obn) {
+    const BlobDesc* blob_desc = BlobDesc4BnInOp(obn);
+    if (blob_desc == nullptr) { return; }
+    cached_kernel->obn7blob_desc.emplace_back(obn, std::make_unique<BlobDesc>(*blob_desc));
+  };
+  for (const std::string& obn : op.output_bns()) { AddObn(obn); }
+  for (const std::string& tmp_bn : op.tmp_bns()) { AddObn(tmp_bn); }
+  cached_kernels_.emplace_front(key, std::shared_ptr<const CachedKernel>(cached_kernel));
+  key2cached_kernel_it_[key] = cached_kernels_.begin();
+  if (cached_kernels_.size() > kMaxCachedKernelNum) {
+    key2cached_kernel_it_.erase(cached_kernels_.back().first);
+    cached_kernels_.pop_back();
+  }
+}
+
 Maybe<void> OpKernelObject::InferBlobDescs(
     const Operator& op, const std::function<BlobDesc*(const std::string&)>& BlobDesc4BnInOp,
     const SbpSignature* sbp_signature, const ParallelContext* parallel_ctx,
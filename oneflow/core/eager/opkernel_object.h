@@ -35,18 +35,15 @@ class OpKernelObject : public vm::Object {
   OpKernelObject(const OpKernelObject&) = delete;
   OpKernelObject(OpKernelObject&&) = delete;
   OpKernelObject(const OperatorConf& op_conf, const std::shared_ptr<const JobDesc>& job_desc,
-                 DeviceType device_type)
-      : op_conf_(op_conf),
-        job_desc_(job_desc),
-        device_type_(device_type),
-        kernel_(nullptr),
-        opkernel_state_(nullptr) {
-    CHECK(op_conf.has_user_conf());
-  }
+                 DeviceType device_type);
   ~OpKernelObject() override = default;
 
   const JobDesc& job_desc() const { return *job_desc_; }
 
+  // reuses this object for another stateless call, the cached kernels are kept
+  void ResetOpConf(const OperatorConf& op_conf, const std::shared_ptr<const JobDesc>& job_desc,
+                   DeviceType device_type);
+
   const std::string& op_name() const { return op_conf_.name(); }
   UserOpConf* mut_user_op_conf() { return op_conf_.mutable_user_conf(); }
 
@@ -72,11 +69,29 @@ class OpKernelObject : public vm::Object {
       const OpNodeSignatureDesc& op_node_signature, const ParallelContext* parallel_ctx,
       OpContext* op_ctx);
 
+  static constexpr size_t kMaxCachedKernelNum = 128;
+  struct CachedKernel {
+    std::shared_ptr<const JobDesc> job_desc;
+    std::shared_ptr<EagerKernel> kernel;
+    std::vector<std::pair<std::string, std::unique_ptr<const BlobDesc>>> obn7blob_desc;
+  };
+  std::string GenCachedKernelKey(
+      const OpNodeSignatureDesc& op_node_signature, const ParallelContext* parallel_ctx,
+      const std::function<BlobDesc*(const std::string&)>& BlobDesc4BnInOp) const;
+  const CachedKernel* FindCachedKernel(const std::string& key);
+  void AddCachedKernel(const std::string& key, const Operator& op,
+                       const std::function<BlobDesc*(const std::string&)>& BlobDesc4BnInOp);
+
   OperatorConf op_conf_;
   std::shared_ptr<const JobDesc> job_desc_;
+  std::string job_desc_key_;
   DeviceType device_type_;
-  std::unique_ptr<EagerKernel> kernel_;
+  std::shared_ptr<EagerKernel> kernel_;
   std::shared_ptr<user_op::OpKernelState> opkernel_state_;
+  // kernels and inferred output blob descs keyed by everything but the names of the op and blobs,
+  // the most recently used one is at the front
+  std::list<std::pair<std::string, std::shared_ptr<const CachedKernel>>> cached_kernels_;
+  HashMap<std::string, decltype(cached_kernels_)::iterator> key2cached_kernel_it_;
 };
 
 class SystemOpKernelObject : public vm::Object {
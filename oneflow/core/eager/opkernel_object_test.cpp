@@ -0,0 +1,227 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+// include sstream first to avoid some compiling error
+// caused by the following trick
+// reference: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=65899
+#include <sstream>
+#define private public
+#include "oneflow/core/eager/opkernel_object.h"
+#include "oneflow/core/eager/opkernel_instruction.msg.h"
+#include "oneflow/core/eager/opkernel_instruction_type.h"
+#include "oneflow/core/vm/vm_object.msg.h"
+#include "oneflow/core/vm/test_util.h"
+#include "oneflow/core/job/job_desc.h"
+#include "oneflow/core/job/placement.pb.h"
+#include "oneflow/core/operator/op_conf.pb.h"
+#include "oneflow/core/operator/op_attribute.pb.h"
+
+namespace oneflow {
+namespace eager {
+namespace test {
+
+namespace {
+
+OperatorConf NewTestOpConf(int32_t axis) {
+  OperatorConf op_conf;
+  op_conf.set_name("test_op");
+  UserOpConf* user_conf = op_conf.mutable_user_conf();
+  user_conf->set_op_type_name("TestSource");
+  (*user_conf->mutable_input())["in"].add_s("test_in/out_0");
+  (*user_conf->mutable_output())["out"].add_s("test_op/out_0");
+  (*user_conf->mutable_attr())["axis"].set_at_int32(axis);
+  (*user_conf->mutable_attr())["scale"].set_at_float(2);
+  return op_conf;
+}
+
+std::shared_ptr<const JobDesc> NewTestJobDesc(const std::string& job_name) {
+  JobConfigProto job_conf;
+  job_conf.set_job_name(job_name);
+  return std::make_shared<const JobDesc>(job_conf, 0);
+}
+
+std::string GenKey(const OpKernelObject& opkernel_obj, const Shape& in_shape) {
+  OpNodeSignatureDesc op_node_signature{OpNodeSignature()};
+  ParallelContext parallel_ctx;
+  parallel_ctx.set_parallel_id(0);
+  parallel_ctx.set_parallel_num(1);
+  BlobDesc in_blob_desc(in_shape, DataType::kFloat);
+  return opkernel_obj.GenCachedKernelKey(
+      op_node_signature, &parallel_ctx, [&](const std::string& bn_in_op) -> BlobDesc* {
+        return bn_in_op == GenRepeatedBn("in", 0) ? &in_blob_desc : nullptr;
+      });
+}
+
+OperatorConf NewReluOpConf(const std::string& op_name) {
+  OperatorConf op_conf;
+  op_conf.set_name(op_name);
+  UserOpConf* user_conf = op_conf.mutable_user_conf();
+  user_conf->set_op_type_name("relu");
+  (*user_conf->mutable_input())["in"].add_s("test_in/out_0");
+  (*user_conf->mutable_output())["out"].add_s(op_name + "/out_0");
+  return op_conf;
+}
+
+// blob descs of one stateless relu call, the out and tmp blob descs are to be inferred
+struct ReluCall {
+  explicit ReluCall(const Shape& in_shape)
+      : in(in_shape, DataType::kFloat),
+        out(DataType::kFloat),
+        tmp_buffer(DataType::kFloat),
+        op_node_signature(NewOpNodeSignature(in_shape)) {}
+
+  static OpNodeSignature NewOpNodeSignature(const Shape& in_shape) {
+    OpNodeSignature op_node_signature;
+    auto* bn_in_op2blob_desc =
+        op_node_signature.mutable_logical_blob_desc_signature()->mutable_bn_in_op2blob_desc();
+    BlobDesc(in_shape, DataType::kFloat).ToProto(&(*bn_in_op2blob_desc)["in_0"]);
+    BlobDesc(in_shape, DataType::kFloat).ToProto(&(*bn_in_op2blob_desc)["out_0"]);
+    return op_node_signature;
+  }
+
+  BlobDesc* BlobDesc4BnInOp(const std::string& bn_in_op) {
+    if (bn_in_op == "in_0") { return &in; }
+    if (bn_in_op == "out_0") { return &out; }
+    if (bn_in_op == "tmp_buffer_0") { return &tmp_buffer; }
+    return nullptr;
+  }
+
+  BlobDesc in;
+  BlobDesc out;
+  BlobDesc tmp_buffer;
+  OpNodeSignatureDesc op_node_signature;
+};
+
+// does what a stateless call instruction does to its shared opkernel object before the compute
+OpKernelObject* CallRelu(vm::RwMutexedObject* shared_opkernel, const std::string& op_name,
+                         const std::shared_ptr<const JobDesc>& job_desc, ReluCall* call) {
+  auto* opkernel_obj = CHECK_JUST(InitSharedOpKernel<OpKernelObject>(
+      shared_opkernel, NewReluOpConf(op_name), job_desc, DeviceType::kCPU));
+  ParallelContext parallel_ctx;
+  parallel_ctx.set_parallel_id(0);
+  parallel_ctx.set_parallel_num(1);
+  CHECK_JUST(opkernel_obj->ResetOpAndKernel(
+      call->op_node_signature, &parallel_ctx,
+      [call](const std::string& bn_in_op) { return call->BlobDesc4BnInOp(bn_in_op); }));
+  return opkernel_obj;
+}
+
+bool IsCached(const OpKernelObject& opkernel_obj, const Shape& in_shape) {
+  ReluCall call(in_shape);
+  ParallelContext parallel_ctx;
+  parallel_ctx.set_parallel_id(0);
+  parallel_ctx.set_parallel_num(1);
+  const std::string& key = opkernel_obj.GenCachedKernelKey(
+      call.op_node_signature, &parallel_ctx,
+      [&call](const std::string& bn_in_op) { return call.BlobDesc4BnInOp(bn_in_op); });
+  return opkernel_obj.key2cached_kernel_it_.count(key) > 0;
+}
+
+}  // namespace
+
+TEST(OpKernelObject, cached_kernel_key) {
+  vm::TestResourceDescScope scope(0, 1);
+  auto job_desc = NewTestJobDesc("test_job");
+  OpKernelObject opkernel_obj(NewTestOpConf(1), job_desc, DeviceType::kCPU);
+  const std::string key = GenKey(opkernel_obj, Shape({4, 8}));
+  // hit for the same call
+  ASSERT_EQ(GenKey(opkernel_obj, Shape({4, 8})), key);
+  // miss on a changed shape
+  ASSERT_NE(GenKey(opkernel_obj, Shape({4, 9})), key);
+  // miss on a changed attr
+  opkernel_obj.ResetOpConf(NewTestOpConf(0), job_desc, DeviceType::kCPU);
+  ASSERT_NE(GenKey(opkernel_obj, Shape({4, 8})), key);
+  // hit for another job desc object of the same content
+  auto same_job_desc = NewTestJobDesc("test_job");
+  opkernel_obj.ResetOpConf(NewTestOpConf(1), same_job_desc, DeviceType::kCPU);
+  ASSERT_EQ(GenKey(opkernel_obj, Shape({4, 8})), key);
+  // miss on a changed job conf
+  opkernel_obj.ResetOpConf(NewTestOpConf(1), NewTestJobDesc("another_job"), DeviceType::kCPU);
+  ASSERT_NE(GenKey(opkernel_obj, Shape({4, 8})), key);
+}
+
+TEST(OpKernelObject, find_cached_kernel) {
+  vm::TestResourceDescScope scope(0, 1);
+  auto job_desc = NewTestJobDesc("test_job");
+  OpKernelObject opkernel_obj(NewTestOpConf(1), job_desc, DeviceType::kCPU);
+  const std::string key = GenKey(opkernel_obj, Shape({4, 8}));
+  ASSERT_TRUE(opkernel_obj.FindCachedKernel(key) == nullptr);
+  auto cached_kernel = std::make_shared<const OpKernelObject::CachedKernel>();
+  opkernel_obj.cached_kernels_.emplace_front(key, cached_kernel);
+  opkernel_obj.key2cached_kernel_it_[key] = opkernel_obj.cached_kernels_.begin();
+  ASSERT_EQ(opkernel_obj.FindCachedKernel(GenKey(opkernel_obj, Shape({4, 8}))),
+            cached_kernel.get());
+  ASSERT_TRUE(opkernel_obj.FindCachedKernel(GenKey(opkernel_obj, Shape({2, 8}))) == nullptr);
+}
+
+TEST(OpKernelObject, init_shared_opkernel_reuses_cached_kernel) {
+  vm::TestResourceDescScope scope(0, 1);
+  auto job_desc = NewTestJobDesc("test_job");
+  auto shared_opkernel = ObjectMsgPtr<vm::RwMutexedObject>::New();
+  ReluCall first_call(Shape({4, 8}));
+  OpKernelObject* opkernel_obj =
+      CallRelu(shared_opkernel.Mutable(), "relu_0", job_desc, &first_call);
+  const EagerKernel* kernel = &opkernel_obj->kernel();
+  ASSERT_EQ(opkernel_obj->cached_kernels_.size(), 1);
+  ASSERT_EQ(first_call.out.shape(), Shape({4, 8}));
+  // another op of the same type and shape reuses both the object and its cached kernel
+  ReluCall second_call(Shape({4, 8}));
+  second_call.out = BlobDesc(Shape({1}), DataType::kInt8);
+  second_call.tmp_buffer = BlobDesc(Shape({1}), DataType::kInt8);
+  ASSERT_EQ(CallRelu(shared_opkernel.Mutable(), "relu_1", job_desc, &second_call), opkernel_obj);
+  ASSERT_EQ(opkernel_obj->op_name(), "relu_1");
+  ASSERT_EQ(&opkernel_obj->kernel(), kernel);
+  ASSERT_EQ(opkernel_obj->cached_kernels_.size(), 1);
+  // the out and tmp blob descs come from the cache instead of the inference
+  ASSERT_TRUE(second_call.out == first_call.out);
+  ASSERT_TRUE(second_call.tmp_buffer == first_call.tmp_buffer);
+}
+
+TEST(OpKernelObject, init_shared_opkernel_evicts_cached_kernel) {
+  vm::TestResourceDescScope scope(0, 1);
+  auto job_desc = NewTestJobDesc("test_job");
+  auto shared_opkernel = ObjectMsgPtr<vm::RwMutexedObject>::New();
+  const int64_t max_cached_kernel_num = OpKernelObject::kMaxCachedKernelNum;
+  OpKernelObject* opkernel_obj = nullptr;
+  FOR_RANGE(int64_t, i, 0, max_cached_kernel_num) {
+    ReluCall call(Shape({i + 1, 8}));
+    opkernel_obj = CallRelu(shared_opkernel.Mutable(), "relu_" + std::to_string(i), job_desc,
+                            &call);
+  }
+  ASSERT_EQ(opkernel_obj->cached_kernels_.size(), max_cached_kernel_num);
+  // a hit makes the oldest kernel the most recently used one
+  ReluCall hit_call(Shape({1, 8}));
+  CallRelu(shared_opkernel.Mutable(), "relu_hit", job_desc, &hit_call);
+  ASSERT_EQ(opkernel_obj->kernel().op_conf().name(), "relu_0");
+  // one more kernel evicts the least recently used one
+  ReluCall new_call(Shape({max_cached_kernel_num + 1, 8}));
+  CallRelu(shared_opkernel.Mutable(), "relu_new", job_desc, &new_call);
+  ASSERT_EQ(opkernel_obj->cached_kernels_.size(), max_cached_kernel_num);
+  ASSERT_EQ(opkernel_obj->key2cached_kernel_it_.size(), max_cached_kernel_num);
+  ASSERT_TRUE(IsCached(*opkernel_obj, Shape({1, 8})));
+  ASSERT_FALSE(IsCached(*opkernel_obj, Shape({2, 8})));
+  // the evicted kernel is rebuilt for the op of this call
+  ReluCall evicted_call(Shape({2, 8}));
+  CallRelu(shared_opkernel.Mutable(), "relu_rebuilt", job_desc, &evicted_call);
+  ASSERT_EQ(opkernel_obj->kernel().op_conf().name(), "relu_rebuilt");
+  ASSERT_EQ(evicted_call.out.shape(), Shape({2, 8}));
+  ASSERT_TRUE(IsCached(*opkernel_obj, Shape({2, 8})));
+  ASSERT_FALSE(IsCached(*opkernel_obj, Shape({3, 8})));
+  ASSERT_EQ(opkernel_obj->cached_kernels_.size(), max_cached_kernel_num);
+}
+
+}  // namespace test
+}  // namespace eager
+}  // namespace oneflow
@@ -17,6 +17,8 @@ limitations under the License.
 #include "oneflow/core/job/job_builder.h"
 #include "oneflow/core/job/mirrored_sig_infer_hint.h"
 #include "oneflow/core/operator/normal_model_update_op.h"
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 
 namespace oneflow {
 
@@ -45,6 +47,57 @@ void UpdateJobParallelViewConf(
   for (const auto& obn : op_node.op().output_bns()) { Update(obn); }
 }
 
+void AppendToSbpSignatureCacheKey(const PbMessage& msg, std::string* key) {
+  std::string serialized;
+  {
+    google::protobuf::io::StringOutputStream output_stream(&serialized);
+    google::protobuf::io::CodedOutputStream coded_stream(&output_stream);
+    // the attrs of user ops are maps, whose serialization is unordered by default
+    coded_stream.SetSerializationDeterministic(true);
+    CHECK(msg.SerializeToCodedStream(&coded_stream));
+  }
+  key->append(std::to_string(serialized.size())).append(":").append(serialized);
+}
+
+// the sbp signature of a user op only depends on its type and attrs, the infer hints of its
+// inputs and the signatures inferred before, all of which make the key of it, so that the
+// repeated ops of a model (e.g. the layers of a transformer) are inferred only once
+bool GenSbpSignatureCacheKey(const OpNode& op_node, const SbpSignature& sbp_sig_conf,
+                             const HashMap<std::string, SbpInferHint>& ibn2sbp_infer_hint,
+                             std::string* key) {
+  const Operator& op = op_node.op();
+  if (!op.op_conf().has_user_conf() || op_node.parallel_desc().parallel_num() == 1) {
+    return false;
+  }
+  UserOpConf user_conf(op.op_conf().user_conf());
+  for (auto& pair : *user_conf.mutable_input()) {
+    for (std::string& lbn : *pair.second.mutable_s()) { lbn.clear(); }
+  }
+  for (auto& pair : *user_conf.mutable_output()) {
+    for (std::string& lbn : *pair.second.mutable_s()) { lbn.clear(); }
+  }
+  key->append(std::to_string(op.op_conf().device_type())).append(":");
+  AppendToSbpSignatureCacheKey(user_conf, key);
+  AppendToSbpSignatureCacheKey(op_node.parallel_desc().parallel_conf(), key);
+  AppendToSbpSignatureCacheKey(sbp_sig_conf, key);
+  for (const std::string& ibn : op.input_bns()) {
+    const SbpInferHint& hint = ibn2sbp_infer_hint.at(ibn);
+    BlobDescProto blob_desc;
+    hint.logical_blob_desc().ToProto(&blob_desc);
+    AppendToSbpSignatureCacheKey(blob_desc, key);
+    AppendToSbpSignatureCacheKey(hint.parallel_desc().parallel_conf(), key);
+    AppendToSbpSignatureCacheKey(hint.sbp_parallel(), key);
+    AppendToSbpSignatureCacheKey(hint.batch_axis(), key);
+  }
+  auto AppendBnSignatures = [&](const std::string& bn) {
+    AppendToSbpSignatureCacheKey(*CHECK_JUST(op.BatchAxis4BnInOp(bn)), key);
+    AppendToSbpSignatureCacheKey(*CHECK_JUST(op.OptMirroredParallel4BnInOp(bn)), key);
+  };
+  for (const std::string& ibn : op.input_bns()) { AppendBnSignatures(ibn); }
+  for (const std::string& obn : op.output_bns()) { AppendBnSignatures(obn); }
+  return true;
+}
+
 }  // namespace
 
 std::string OpEdge::VisualStr() const {
@@ -481,7 +534,8 @@ void OpGraph::InferTimeShape() const {
   });
 }
 
-void OpGraph::InferOpNodeSbpSignature(OpNode* op_node, const SbpSignature& sbp_sig_conf) const {
+void OpGraph::InferOpNodeSbpSignature(OpNode* op_node, const SbpSignature& sbp_sig_conf,
+                                      HashMap<std::string, SbpSignature>* sbp_sig_cache) const {
   HashMap<std::string, SbpInferHint> ibn2sbp_infer_hint;
   for (const std::string& ibn : op_node->op().input_bns()) {
     const LogicalBlobId& lbi = op_node->op().BnInOp2Lbi(ibn);
@@ -493,11 +547,25 @@ void OpGraph::InferOpNodeSbpSignature(OpNode* op_node, const SbpSignature& sbp_s
     ibn2sbp_infer_hint.emplace(ibn,
                                SbpInferHint(parallel_desc, logical_blob_desc, sbp, batch_axis));
   }
-  const auto& BatchAxis4BnInOp = [&](const std::string& bn_in_op) -> Maybe<const OptInt64*> {
-    return op_node->op().BatchAxis4BnInOp(bn_in_op);
-  };
-  CHECK_JUST(InferOpSbpSignature(op_node->mut_op(), sbp_sig_conf, op_node->parallel_desc(),
-                                 ibn2sbp_infer_hint, BatchAxis4BnInOp));
+  std::string cache_key;
+  const bool cacheable =
+      sbp_sig_cache != nullptr
+      && GenSbpSignatureCacheKey(*op_node, sbp_sig_conf, ibn2sbp_infer_hint, &cache_key);
+  const SbpSignature* cached_sbp_sig = nullptr;
+  if (cacheable) {
+    const auto& cache_it = sbp_sig_cache->find(cache_key);
+    if (cache_it != sbp_sig_cache->end()) { cached_sbp_sig = &cache_it->second; }
+  }
+  if (cached_sbp_sig != nullptr) {
+    *op_node->mut_op()->mut_sbp_signature() = *cached_sbp_sig;
+  } else {
+    const auto& BatchAxis4BnInOp = [&](const std::string& bn_in_op) -> Maybe<const OptInt64*> {
+      return op_node->op().BatchAxis4BnInOp(bn_in_op);
+    };
+    CHECK_JUST(InferOpSbpSignature(op_node->mut_op(), sbp_sig_conf, op_node->parallel_desc(),
+                                   ibn2sbp_infer_hint, BatchAxis4BnInOp));
+    if (cacheable) { sbp_sig_cache->emplace(cache_key, op_node->sbp_signature()); }
+  }
   op_node->InitLbi2SbpParallel();
 }
 
@@ -567,6 +635,7 @@ Maybe<void> OpGraph::InferLogicalBlobDesc(const Job& job) const {
     oba2sbp_identical_obas[pair.first()].push_back(pair.second());
     oba2sbp_identical_obas[pair.second()].push_back(pair.first());
   }
+  HashMap<std::string, SbpSignature> sbp_sig_cache;
   JUST(TopoForEachNodeWithErrorCaptured([&](OpNode* op_node) -> Maybe<void> {
     // Infer ParallelSignature
     JUST(op_node->mut_op()->InferParallelSignatureIf());
@@ -598,7 +667,9 @@ Maybe<void> OpGraph::InferLogicalBlobDesc(const Job& job) const {
       const auto& iter = op_name2sbp_sig_conf.find(op_node->op().op_name());
       if (iter != op_name2sbp_sig_conf.end()) { sbp_sig_conf = iter->second; }
     }
-    InferOpNodeSbpSignature(op_node, sbp_sig_conf);
+    InferOpNodeSbpSignature(
+        op_node, sbp_sig_conf,
+        job.job_conf().enable_sbp_signature_cache() ? &sbp_sig_cache : nullptr);
     op_node->InferBlobParallelDesc();
     UpdateJobParallelViewConf(*op_node, oba2sbp_identical_obas, &job_parallel_view_conf);
     // Infer logical_blob_desc
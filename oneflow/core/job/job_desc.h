@@ -63,6 +63,12 @@ class JobDesc final {
   }
   bool prune_parallel_cast_ops() const { return job_conf_.prune_parallel_cast_ops(); }
   bool prune_cast_to_static_shape_ops() const { return job_conf_.prune_cast_to_static_shape_ops(); }
+  bool enable_multi_tensor_model_update() const {
+    return job_conf_.enable_multi_tensor_model_update();
+  }
+  bool enable_op_fusion() const { return job_conf_.enable_op_fusion(); }
+  bool enable_sbp_signature_cache() const { return job_conf_.enable_sbp_signature_cache(); }
+  bool enable_sbp_signature_search() const { return job_conf_.enable_sbp_signature_search(); }
   int64_t cudnn_buf_limit_mbyte() const { return job_conf_.cudnn_buf_limit_mbyte(); }
 
   bool enable_keep_header_only() const { return job_conf_.enable_keep_header_only(); }
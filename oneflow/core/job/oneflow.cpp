@@ -40,6 +40,7 @@ limitations under the License.
 #include "oneflow/core/vm/oneflow_vm.h"
 #include "oneflow/core/graph/plan_task_graph.h"
 #include "oneflow/core/graph/boxing/collective_boxing_util.h"
+#include "oneflow/core/thread/thread_manager.h"
 
 namespace std {
 
@@ -63,8 +64,12 @@ bool operator==(const ParallelBlobConf& lhs, const ParallelBlobConf& rhs) {
 
 namespace {
 
-std::string cluster_thrd_ids_key(const std::string& plan_name) {
-  return plan_name + "_cluster_thrd_ids";
+// tasks of a machine are pushed in chunks of this many tasks, every chunk is compressed and
+// pulled by itself, so that the chunks are handled in parallel on both sides
+constexpr size_t kSubPlanChunkTaskNum = 256;
+
+std::string cluster_sub_plan_chunk_num_key(const std::string& plan_name) {
+  return plan_name + "_cluster_sub_plan_chunk_num";
 }
 
 std::string net_topo_key(const std::string& plan_name) { return plan_name + "_net_topo"; }
@@ -75,8 +80,10 @@ std::string GetCollectiveBoxingPlanKey(const std::string& plan_name) {
   return plan_name + "_collective_boxing_plan";
 }
 
-std::string sub_plan_key(const std::string& plan_name, int64_t machine_id, int64_t thrd_id) {
-  return plan_name + "_" + std::to_string(machine_id) + "_" + std::to_string(thrd_id);
+std::string sub_plan_chunk_key(const std::string& plan_name, int64_t machine_id,
+                               int64_t chunk_id) {
+  return plan_name + "_" + std::to_string(machine_id) + "_sub_plan_chunk_"
+         + std::to_string(chunk_id);
 }
 
 std::string block7chunk_key(const std::string& plan_name, int64_t machine_id) {
@@ -84,32 +91,43 @@ std::string block7chunk_key(const std::string& plan_name, int64_t machine_id) {
 }
 
 void PushPlan(const std::string& plan_name, const Plan& plan) {
-  HashMap<int64_t, std::set<int64_t>> machine_id2thrd_id_set;
-  HashMap<std::pair<int64_t, int64_t>, std::vector<TaskProto>> mchn_thrd_id2task_protos;
+  // the tasks of every machine are ordered by thrd_id, the same as they are pulled
+  HashMap<int64_t, std::map<int64_t, std::vector<const TaskProto*>>> machine_id2thrd_id2tasks;
   HashMap<int64_t, MemBlockAndChunkList> machine_id2block7chunk;
 
   for (const auto& task : plan.task()) {
-    machine_id2thrd_id_set[task.machine_id()].insert(task.thrd_id());
-    mchn_thrd_id2task_protos[std::make_pair(task.machine_id(), task.thrd_id())].emplace_back(task);
+    machine_id2thrd_id2tasks[task.machine_id()][task.thrd_id()].push_back(&task);
   }
 
-  HashMap<int64_t, ThrdIds> machine_id2thrd_ids;
-  for (const auto& pair : machine_id2thrd_id_set) {
-    CHECK(machine_id2thrd_ids.emplace(pair.first, ThrdIds()).second);
-    std::vector<int64_t> thrd_id_vec(pair.second.begin(), pair.second.end());
-    *(machine_id2thrd_ids.at(pair.first).mutable_thrd_id()) = StdVec2PbRf(thrd_id_vec);
+  struct SubPlanChunk {
+    std::string key;
+    std::vector<const TaskProto*> tasks;
+  };
+  std::vector<SubPlanChunk> chunks;
+  ClusterSubPlanChunkNum cluster_chunk_num;
+  for (const auto& machine_pair : machine_id2thrd_id2tasks) {
+    const int64_t machine_id = machine_pair.first;
+    int64_t chunk_num = 0;
+    for (const auto& thrd_pair : machine_pair.second) {
+      for (const TaskProto* task : thrd_pair.second) {
+        if (chunk_num == 0 || chunks.back().tasks.size() == kSubPlanChunkTaskNum) {
+          chunks.push_back(SubPlanChunk{sub_plan_chunk_key(plan_name, machine_id, chunk_num), {}});
+          chunk_num += 1;
+        }
+        chunks.back().tasks.push_back(task);
+      }
+    }
+    (*cluster_chunk_num.mutable_machine_id2chunk_num())[machine_id] = chunk_num;
   }
-
-  ClusterThrdIds cluster_thrd_ids;
-  *(cluster_thrd_ids.mutable_machine_id2thrd_ids()) = HashMap2PbMap(machine_id2thrd_ids);
-  Global<CtrlClient>::Get()->PushKV(cluster_thrd_ids_key(plan_name), cluster_thrd_ids);
-
-  for (const auto& pair : mchn_thrd_id2task_protos) {
+  Global<CtrlClient>::Get()->PushBroadcastKV(cluster_sub_plan_chunk_num_key(plan_name),
+                                             cluster_chunk_num);
+  MultiThreadLoop(chunks.size(), [&](size_t i) {
     SubPlan sub_plan;
-    *(sub_plan.mutable_task()) = StdVec2PbRpf(pair.second);
-    Global<CtrlClient>::Get()->PushKV(sub_plan_key(plan_name, pair.first.first, pair.first.second),
-                                      sub_plan);
-  }
+    for (const TaskProto* task : chunks.at(i).tasks) { *sub_plan.add_task() = *task; }
+    std::string compressed;
+    PlanUtil::SerializeSubPlanCompressed(sub_plan, &compressed);
+    Global<CtrlClient>::Get()->PushKV(chunks.at(i).key, compressed);
+  });
 
   for (const auto& mem_block : plan.block_chunk_list().mem_block()) {
     *machine_id2block7chunk[mem_block.machine_id()].add_mem_block() = mem_block;
@@ -121,35 +139,43 @@ void PushPlan(const std::string& plan_name, const Plan& plan) {
     Global<CtrlClient>::Get()->PushKV(block7chunk_key(plan_name, pair.first), pair.second);
   }
 
-  Global<CtrlClient>::Get()->PushKV(net_topo_key(plan_name), plan.net_topo());
-  Global<CtrlClient>::Get()->PushKV(job_id2job_conf(plan_name), plan.job_confs());
-  Global<CtrlClient>::Get()->PushKV(GetCollectiveBoxingPlanKey(plan_name),
-                                    plan.collective_boxing_plan());
+  // every machine pulls these, so they are broadcast instead of all pulled from one server
+  Global<CtrlClient>::Get()->PushBroadcastKV(net_topo_key(plan_name), plan.net_topo());
+  Global<CtrlClient>::Get()->PushBroadcastKV(job_id2job_conf(plan_name), plan.job_confs());
+  Global<CtrlClient>::Get()->PushBroadcastKV(GetCollectiveBoxingPlanKey(plan_name),
+                                             plan.collective_boxing_plan());
 }
 
 void PullPlan(const std::string& plan_name, Plan* plan) {
-  ClusterThrdIds cluster_thrd_ids;
-  Global<CtrlClient>::Get()->PullKV(cluster_thrd_ids_key(plan_name), &cluster_thrd_ids);
-  PrintProtoToTextFile(cluster_thrd_ids, JoinPath(FLAGS_log_dir, cluster_thrd_ids_key(plan_name)));
-  HashMap<int64_t, ThrdIds> machine_id2thrd_ids;
-  machine_id2thrd_ids = PbMap2HashMap(cluster_thrd_ids.machine_id2thrd_ids());
+  const int64_t machine_num = Global<ResourceDesc, ForSession>::Get()->TotalMachineNum();
+  ClusterSubPlanChunkNum cluster_chunk_num;
+  Global<CtrlClient>::Get()->PullBroadcastKV(cluster_sub_plan_chunk_num_key(plan_name),
+                                             machine_num, &cluster_chunk_num);
+  PrintProtoToTextFile(cluster_chunk_num,
+                       JoinPath(FLAGS_log_dir, cluster_sub_plan_chunk_num_key(plan_name)));
   int64_t machine_id = Global<MachineCtx>::Get()->this_machine_id();
-  auto thrd_ids_it = machine_id2thrd_ids.find(machine_id);
-  CHECK(thrd_ids_it != machine_id2thrd_ids.end());
-  std::vector<int64_t> thrd_id_vec = PbRf2StdVec(thrd_ids_it->second.thrd_id());
-  for (auto thrd_id : thrd_id_vec) {
-    SubPlan sub_plan;
-    Global<CtrlClient>::Get()->PullKV(sub_plan_key(plan_name, machine_id, thrd_id), &sub_plan);
-    plan->mutable_task()->MergeFrom(sub_plan.task());
+  auto chunk_num_it = cluster_chunk_num.machine_id2chunk_num().find(machine_id);
+  CHECK(chunk_num_it != cluster_chunk_num.machine_id2chunk_num().end());
+  std::vector<SubPlan> sub_plans(chunk_num_it->second);
+  MultiThreadLoop(sub_plans.size(), [&](size_t i) {
+    std::string compressed;
+    Global<CtrlClient>::Get()->PullKV(sub_plan_chunk_key(plan_name, machine_id, i), &compressed);
+    PlanUtil::ParseSubPlanCompressed(compressed, &sub_plans.at(i));
+  });
+  int64_t task_num = 0;
+  for (const SubPlan& sub_plan : sub_plans) { task_num += sub_plan.task_size(); }
+  plan->mutable_task()->Reserve(task_num);
+  for (SubPlan& sub_plan : sub_plans) {
+    for (TaskProto& task : *sub_plan.mutable_task()) { plan->add_task()->Swap(&task); }
   }
   NetTopo net_topo;
-  Global<CtrlClient>::Get()->PullKV(net_topo_key(plan_name), &net_topo);
+  Global<CtrlClient>::Get()->PullBroadcastKV(net_topo_key(plan_name), machine_num, &net_topo);
   *(plan->mutable_net_topo()) = net_topo;
   JobConfs job_confs;
-  Global<CtrlClient>::Get()->PullKV(job_id2job_conf(plan_name), &job_confs);
+  Global<CtrlClient>::Get()->PullBroadcastKV(job_id2job_conf(plan_name), machine_num, &job_confs);
   *(plan->mutable_job_confs()) = job_confs;
-  Global<CtrlClient>::Get()->PullKV(GetCollectiveBoxingPlanKey(plan_name),
-                                    plan->mutable_collective_boxing_plan());
+  Global<CtrlClient>::Get()->PullBroadcastKV(GetCollectiveBoxingPlanKey(plan_name), machine_num,
+                                             plan->mutable_collective_boxing_plan());
   MemBlockAndChunkList block7chunk;
   Global<CtrlClient>::Get()->PullKV(block7chunk_key(plan_name, machine_id), &block7chunk);
   plan->mutable_block_chunk_list()->CopyFrom(block7chunk);
@@ -20,6 +20,7 @@ limitations under the License.
 #include "oneflow/core/memory/memory_case_util.h"
 #include "oneflow/core/register/runtime_register_desc.h"
 #include "oneflow/core/persistence/tee_persistent_log_stream.h"
+#include <zlib.h>
 
 namespace oneflow {
 
@@ -330,4 +331,34 @@ void PlanUtil::ToDotFile(const Plan& plan, const std::string& filepath) {
   log_stream << "}\n";
 }
 
+void PlanUtil::SerializeSubPlanCompressed(const SubPlan& sub_plan, std::string* compressed) {
+  std::string serialized;
+  CHECK(sub_plan.SerializeToString(&serialized));
+  // the size of the serialized sub plan is kept ahead of the zlib stream
+  const uint64_t serialized_size = serialized.size();
+  uLongf compressed_size = compressBound(serialized.size());
+  compressed->resize(sizeof(serialized_size) + compressed_size);
+  std::memcpy(&compressed->at(0), &serialized_size, sizeof(serialized_size));
+  // plans are highly redundant, so the fastest level already compresses well
+  CHECK_EQ(compress2(reinterpret_cast<Bytef*>(&compressed->at(sizeof(serialized_size))),
+                     &compressed_size, reinterpret_cast<const Bytef*>(serialized.data()),
+                     serialized.size(), Z_BEST_SPEED),
+           Z_OK);
+  compressed->resize(sizeof(serialized_size) + compressed_size);
+}
+
+void PlanUtil::ParseSubPlanCompressed(const std::string& compressed, SubPlan* sub_plan) {
+  uint64_t serialized_size = 0;
+  CHECK_GE(compressed.size(), sizeof(serialized_size));
+  std::memcpy(&serialized_size, compressed.data(), sizeof(serialized_size));
+  std::string serialized(serialized_size, '\0');
+  uLongf uncompressed_size = serialized_size;
+  CHECK_EQ(uncompress(reinterpret_cast<Bytef*>(&serialized[0]), &uncompressed_size,
+                      reinterpret_cast<const Bytef*>(compressed.data() + sizeof(serialized_size)),
+                      compressed.size() - sizeof(serialized_size)),
+           Z_OK);
+  CHECK_EQ(uncompressed_size, serialized_size);
+  CHECK(sub_plan->ParseFromString(serialized));
+}
+
 }  // namespace oneflow
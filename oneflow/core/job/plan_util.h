@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <functional>
 #include "oneflow/core/job/plan.pb.h"
+#include "oneflow/core/job/sub_plan.pb.h"
 
 namespace oneflow {
 
@@ -26,6 +27,9 @@ struct PlanUtil {
   static std::function<const TaskProto*(int64_t)> MakeGetterTaskProto4TaskId(const Plan& plan);
   static void CleanUselessMemBlockAndCheckValid(Plan* plan);
   static void ToDotFile(const Plan& plan, const std::string& filepath);
+  // zlib compressed SubPlan, for plans pushed through the control plane
+  static void SerializeSubPlanCompressed(const SubPlan& sub_plan, std::string* compressed);
+  static void ParseSubPlanCompressed(const std::string& compressed, SubPlan* sub_plan);
 };
 
 }  // namespace oneflow
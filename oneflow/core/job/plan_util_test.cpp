@@ -0,0 +1,57 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/common/util.h"
+#include "oneflow/core/job/plan_util.h"
+
+namespace oneflow {
+
+namespace {
+
+SubPlan GetSubPlan(int64_t task_num) {
+  SubPlan sub_plan;
+  for (int64_t i = 0; i < task_num; ++i) {
+    TaskProto* task = sub_plan.add_task();
+    task->set_task_type(TaskType::kNormalForward);
+    task->set_machine_id(1);
+    task->set_thrd_id(i % 8);
+    task->set_task_id(i);
+    task->set_job_id(0);
+    task->mutable_task_set_info()->set_area_id(AreaType::kDataForwardArea);
+    task->mutable_task_set_info()->set_chain_id(i);
+    task->mutable_task_set_info()->set_order_in_graph(i);
+    task->mutable_exec_sequence();
+    RegstDescIdSet* consumed = &(*task->mutable_consumed_regst_desc_id())["in"];
+    consumed->add_regst_desc_id(i + 1);
+  }
+  return sub_plan;
+}
+
+}  // namespace
+
+TEST(PlanUtil, sub_plan_compressed_round_trip) {
+  for (int64_t task_num : {0, 1, 4096}) {
+    const SubPlan sub_plan = GetSubPlan(task_num);
+    std::string compressed;
+    PlanUtil::SerializeSubPlanCompressed(sub_plan, &compressed);
+    SubPlan parsed;
+    PlanUtil::ParseSubPlanCompressed(compressed, &parsed);
+    ASSERT_EQ(parsed.task_size(), task_num);
+    ASSERT_EQ(parsed.SerializeAsString(), sub_plan.SerializeAsString());
+    if (task_num > 1) { ASSERT_LT(compressed.size(), sub_plan.ByteSizeLong()); }
+  }
+}
+
+}  // namespace oneflow
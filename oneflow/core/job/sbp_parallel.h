@@ -33,6 +33,9 @@ bool IsSbpSignatureContaining(const SbpSignature& bigger, const SbpSignature& sm
 void FilterSbpSignatureList(const SbpSignatureList& sbp_sig_list, const SbpSignature& sbp_sig_conf,
                             SbpSignatureList* filtered_sbp_sig_list);
 
+double ComputCopyCostBetweenTwoSbpParallel(const SbpInferHint& producer_sbp_infer_hint,
+                                           const SbpParallel& consumer_sbp_parallel);
+
 void SortSbpSignatureListByCopyCost(
     const SbpSignatureList& sbp_sig_list, const PbRpf<std::string>& ibns,
     const std::function<Maybe<const SbpInferHint*>(const std::string&)>& SbpInferHint4Ibn,
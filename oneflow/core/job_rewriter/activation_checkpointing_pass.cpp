@@ -0,0 +1,227 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/job_rewriter/op_graph_pass.h"
+#include "oneflow/core/framework/framework.h"
+
+namespace oneflow {
+
+namespace {
+
+const std::string kCheckpointingOpNamePrefix = "System-ActivationCheckpointing-";
+
+bool IsRecomputable(const OpNode* op_node) {
+  static const HashSet<std::string> nondeterministic_op_type_names = {
+      "random_mask_like", "coin_flip", "bernoulli", "generate_random_batch_permutation_indices",
+      "ofrecord_image_decoder_random_crop"};
+  const Operator& op = op_node->op();
+  if (!op.op_conf().has_user_conf()) { return false; }
+  if (nondeterministic_op_type_names.count(op.op_conf().user_conf().op_type_name()) > 0) {
+    return false;
+  }
+  if (op.input_bns().empty() || op.output_bns().empty()) { return false; }
+  // ops updating their inputs (e.g. the moving statistics of normalization) run only once
+  for (const std::string& ibn : op.input_bns()) {
+    if (op.InputBlobModifier4Ibn(ibn).is_mutable()) { return false; }
+  }
+  return true;
+}
+
+bool IsCheap(const OpNode* op_node) {
+  static const HashSet<std::string> cheap_op_type_names = {
+      "relu",      "gelu",       "tanh", "sigmoid", "leaky_relu", "bias_add",
+      "scalar_add", "scalar_mul", "cast", "add_n",   "multiply",   "dropout"};
+  return cheap_op_type_names.count(op_node->op().op_conf().user_conf().op_type_name()) > 0;
+}
+
+bool IsMarked(const OpNode* op_node, const ActivationCheckpointingConf& conf) {
+  const std::string& op_name = op_node->op().op_name();
+  for (const std::string& prefix : conf.op_name_prefix()) {
+    if (op_name.compare(0, prefix.size(), prefix) == 0) { return true; }
+  }
+  return conf.recompute_cheap_ops() && IsCheap(op_node);
+}
+
+class ActivationCheckpointingPass final : public OpGraphPass {
+ public:
+  ActivationCheckpointingPass() = default;
+  ~ActivationCheckpointingPass() override = default;
+  bool IsEnabled() const override {
+    return GlobalJobDesc().IsTrain()
+           && GlobalJobDesc().job_conf().has_activation_checkpointing_conf();
+  }
+  Maybe<void> Apply(const OpGraph& op_graph, JobBuilder* job_builder) const override;
+};
+
+// Forward ops of the checkpointed segments are cloned into the backward region, the backward
+// ops consume the activations of the clones, so that the activations of the original ops are
+// released at the end of the forward pass and only the inputs of the segments are kept.
+Maybe<void> ActivationCheckpointingPass::Apply(const OpGraph& op_graph,
+                                               JobBuilder* job_builder) const {
+  const ActivationCheckpointingConf& conf =
+      GlobalJobDesc().job_conf().activation_checkpointing_conf();
+  const auto ForEachDataAndCtrlInNode = [&](OpNode* node, const std::function<void(OpNode*)>& Fn) {
+    op_graph.ForEachDataAndCtrlInNode(node, Fn);
+  };
+  const auto ForEachDataAndCtrlOutNode = [&](OpNode* node,
+                                             const std::function<void(OpNode*)>& Fn) {
+    op_graph.ForEachDataAndCtrlOutNode(node, Fn);
+  };
+  // the forward ops are the ones the loss depends on, the backward ones depend on the loss
+  HashSet<std::string> loss_op_names;
+  for (const std::string& loss_lbn : GlobalJobDesc().job_conf().train_conf().loss_lbn()) {
+    loss_op_names.insert(GenLogicalBlobId(loss_lbn).op_name());
+  }
+  std::list<OpNode*> loss_nodes;
+  op_graph.ForEachNode([&](OpNode* node) {
+    if (loss_op_names.count(node->op().op_name()) > 0) { loss_nodes.push_back(node); }
+  });
+  CHECK_EQ_OR_RETURN(loss_nodes.size(), loss_op_names.size());
+  HashSet<const OpNode*> forward_nodes;
+  op_graph.BfsForEachNode(loss_nodes, ForEachDataAndCtrlInNode,
+                          [&](OpNode* node) { forward_nodes.insert(node); });
+  HashSet<const OpNode*> backward_nodes;
+  op_graph.BfsForEachNode(loss_nodes, ForEachDataAndCtrlOutNode,
+                          [&](OpNode* node) { backward_nodes.insert(node); });
+  for (const OpNode* loss_node : loss_nodes) { backward_nodes.erase(loss_node); }
+
+  HashSet<OpNode*> checkpointed_nodes;
+  op_graph.ForEachNode([&](OpNode* node) {
+    if (forward_nodes.count(node) == 0 || backward_nodes.count(node) > 0) { return; }
+    if (loss_op_names.count(node->op().op_name()) > 0) { return; }
+    if (IsRecomputable(node) && IsMarked(node, conf)) { checkpointed_nodes.insert(node); }
+  });
+
+  HashMap<std::string, OperatorConf> op_name2mut_op_conf;
+  auto MutOpConf4Node = [&](const OpNode* node) -> OperatorConf* {
+    const std::string& op_name = node->op().op_name();
+    auto it = op_name2mut_op_conf.find(op_name);
+    if (it == op_name2mut_op_conf.end()) {
+      it = op_name2mut_op_conf.emplace(op_name, node->op().op_conf()).first;
+    }
+    return &it->second;
+  };
+  auto ReplaceInputLbn = [](OperatorConf* op_conf, const std::string& ibn,
+                            const std::string& new_lbn) {
+    PbMessage* op_type_conf = MutableMessageInPbMessage(op_conf, op_conf->op_type_case());
+    const std::string old_lbn = GetInputLbnInOpCustomizedConf(*op_type_conf, ibn);
+    ReplaceInputLbnInOpCustomizedConf(op_type_conf, ibn, old_lbn, new_lbn);
+  };
+  auto CloneLbn = [](const LogicalBlobId& lbi) {
+    return GenLogicalBlobName(kCheckpointingOpNamePrefix + lbi.op_name(), lbi.blob_name());
+  };
+
+  int64_t recomputed_op_cnt = 0;
+  int64_t released_activation_bytes = 0;
+  HashSet<OpNode*> visited;
+  for (OpNode* seed : checkpointed_nodes) {
+    if (visited.count(seed) > 0) { continue; }
+    // a segment is a connected component of the checkpointed ops
+    HashSet<OpNode*> segment;
+    const auto ForEachSegmentNeighbor = [&](OpNode* node, const std::function<void(OpNode*)>& Fn) {
+      node->ForEachNodeOnInOutEdge([&](OpNode* neighbor) {
+        if (checkpointed_nodes.count(neighbor) > 0) { Fn(neighbor); }
+      });
+    };
+    op_graph.BfsForEachNode({seed}, ForEachSegmentNeighbor, [&](OpNode* node) {
+      segment.insert(node);
+      visited.insert(node);
+    });
+    // backward consumers of the activations inside the segment
+    std::list<OpNode*> backward_consumers;
+    HashSet<LogicalBlobId> released_lbis;
+    for (OpNode* node : segment) {
+      for (OpEdge* edge : node->out_edges()) {
+        if (backward_nodes.count(edge->dst_node()) == 0) { continue; }
+        if (std::find(backward_consumers.begin(), backward_consumers.end(), edge->dst_node())
+            == backward_consumers.end()) {
+          backward_consumers.push_back(edge->dst_node());
+        }
+        for (const LogicalBlobId& lbi : edge->lbis()) {
+          if (!released_lbis.insert(lbi).second) { continue; }
+          const BlobDesc& blob_desc = node->LogicalBlobDesc4Lbi(lbi);
+          released_activation_bytes +=
+              blob_desc.shape().elem_cnt() * GetSizeOfDataType(blob_desc.data_type());
+        }
+      }
+    }
+    if (backward_consumers.empty()) { continue; }
+    // the clones wait for the gradients arriving at the segment, except those which depend on
+    // the clones themselves
+    HashSet<const OpNode*> clone_dependents;
+    op_graph.BfsForEachNode(backward_consumers, ForEachDataAndCtrlOutNode,
+                            [&](OpNode* node) { clone_dependents.insert(node); });
+    HashSet<const OpNode*> gradient_producers;
+    for (OpNode* consumer : backward_consumers) {
+      for (OpEdge* edge : consumer->in_edges()) {
+        const OpNode* producer = edge->src_node();
+        if (backward_nodes.count(producer) == 0 || clone_dependents.count(producer) > 0) {
+          continue;
+        }
+        gradient_producers.insert(producer);
+      }
+    }
+    for (OpNode* node : segment) {
+      OperatorConf clone_conf(node->op().op_conf());
+      clone_conf.set_name(kCheckpointingOpNamePrefix + node->op().op_name());
+      bool is_segment_head = true;
+      for (OpEdge* edge : node->in_edges()) {
+        if (segment.count(edge->src_node()) == 0) { continue; }
+        is_segment_head = false;
+        for (const LogicalBlobId& lbi : edge->lbis()) {
+          for (const std::string& ibn : edge->lbi2ibns().at(lbi)) {
+            ReplaceInputLbn(&clone_conf, ibn, CloneLbn(lbi));
+          }
+        }
+      }
+      for (auto& pair : *clone_conf.mutable_user_conf()->mutable_output()) {
+        for (std::string& lbn : *pair.second.mutable_s()) {
+          lbn = CloneLbn(GenLogicalBlobId(lbn));
+        }
+      }
+      if (is_segment_head) {
+        for (const OpNode* producer : gradient_producers) {
+          if (producer->parallel_desc() != node->parallel_desc()) { continue; }
+          if (*producer->out_blob_time_shape() != *node->out_blob_time_shape()) { continue; }
+          clone_conf.add_ctrl_in_op_name(producer->op().op_name());
+        }
+      }
+      job_builder->AddOps(node->parallel_desc().parallel_conf(), {clone_conf});
+      recomputed_op_cnt += 1;
+      for (OpEdge* edge : node->out_edges()) {
+        if (backward_nodes.count(edge->dst_node()) == 0) { continue; }
+        for (const LogicalBlobId& lbi : edge->lbis()) {
+          for (const std::string& ibn : edge->lbi2ibns().at(lbi)) {
+            ReplaceInputLbn(MutOpConf4Node(edge->dst_node()), ibn, CloneLbn(lbi));
+          }
+        }
+      }
+    }
+  }
+  std::vector<OperatorConf> mut_op_confs;
+  for (const auto& pair : op_name2mut_op_conf) { mut_op_confs.push_back(pair.second); }
+  job_builder->MutOpsOnlyOnce(mut_op_confs);
+  // logical sizes, the actual saving depends on how the regsts share memory in the plan
+  LOG(INFO) << "activation checkpointing recomputes " << recomputed_op_cnt
+            << " ops and releases " << released_activation_bytes
+            << " logical bytes of activations before backward";
+  return Maybe<void>::Ok();
+}
+
+}  // namespace
+
+REGISTER_FUNCTION_PASS("ActivationCheckpointingPass", ActivationCheckpointingPass);
+
+}  // namespace oneflow
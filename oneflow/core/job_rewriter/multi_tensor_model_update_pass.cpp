@@ -0,0 +1,166 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/job_rewriter/op_graph_pass.h"
+#include "oneflow/core/job/job_desc.h"
+
+namespace oneflow {
+
+namespace {
+
+struct ModelUpdateOpInfo {
+  const OpNode* op_node;
+  const NormalModelUpdateOpUserConf* user_conf;
+  std::string model_diff;
+  std::string model;
+  std::string train_step;
+  std::string learning_rate;
+  float weight_decay;
+};
+
+bool GetModelUpdateOpInfo(const OpNode* op_node, ModelUpdateOpInfo* info) {
+  const OperatorConf& op_conf = op_node->op().op_conf();
+  info->op_node = op_node;
+#define GET_MODEL_UPDATE_OP_INFO(conf_name)     \
+  if (op_conf.has_##conf_name()) {              \
+    const auto& conf = op_conf.conf_name();     \
+    info->user_conf = &conf.user_conf();        \
+    info->model_diff = conf.model_diff();       \
+    info->model = conf.model();                 \
+    info->train_step = conf.train_step();       \
+    info->learning_rate = conf.learning_rate(); \
+    info->weight_decay = conf.weight_decay();   \
+    return true;                                \
+  }
+  GET_MODEL_UPDATE_OP_INFO(naive_model_update_conf);
+  GET_MODEL_UPDATE_OP_INFO(momentum_model_update_conf);
+  GET_MODEL_UPDATE_OP_INFO(adam_model_update_conf);
+#undef GET_MODEL_UPDATE_OP_INFO
+  return false;
+}
+
+bool IsMultiTensorModelUpdateSupported(const ModelUpdateOpInfo& info) {
+  const OpNode* op_node = info.op_node;
+  if (op_node->parallel_desc().device_type() != DeviceType::kCPU) { return false; }
+  // the fused op only has the all-broadcast sbp signature
+  for (const std::string& ibn : op_node->op().input_bns()) {
+    if (!op_node->SbpParallel4BnInOp(ibn).has_broadcast_parallel()) { return false; }
+  }
+  return true;
+}
+
+std::string GenMultiTensorModelUpdateGroupKey(const ModelUpdateOpInfo& info) {
+  const OpNode* op_node = info.op_node;
+  const BlobDesc& model = op_node->LogicalBlobDesc4Lbi(op_node->op().BnInOp2Lbi("model"));
+  std::string key;
+  key += std::to_string(op_node->op().op_conf().op_type_case()) + "\n";
+  key += std::to_string(model.data_type()) + "\n";
+  key += info.train_step + "\n";
+  key += info.learning_rate + "\n";
+  key += info.user_conf->SerializeAsString() + "\n";
+  key += op_node->parallel_desc().parallel_conf().SerializeAsString();
+  return key;
+}
+
+void BuildMultiTensorModelUpdateOpConf(const std::vector<ModelUpdateOpInfo>& infos,
+                                       OperatorConf* op_conf) {
+  const OperatorConf& first_op_conf = infos.front().op_node->op().op_conf();
+  op_conf->set_name("System-Optimizer-MultiTensor-" + NewUniqueId());
+  op_conf->set_scope_symbol_id(first_op_conf.scope_symbol_id());
+  MultiTensorModelUpdateOpConf* conf = op_conf->mutable_multi_tensor_model_update_conf();
+  *conf->mutable_user_conf() = *infos.front().user_conf;
+  conf->set_train_step(infos.front().train_step);
+  conf->set_learning_rate(infos.front().learning_rate);
+  HashSet<std::string> ctrl_in_op_names;
+  for (const ModelUpdateOpInfo& info : infos) {
+    const OperatorConf& old_op_conf = info.op_node->op().op_conf();
+    conf->add_model_diff(info.model_diff);
+    conf->add_model(info.model);
+    conf->add_weight_decay(info.weight_decay);
+    if (old_op_conf.has_momentum_model_update_conf()) {
+      conf->add_momentum(old_op_conf.momentum_model_update_conf().momentum());
+    } else if (old_op_conf.has_adam_model_update_conf()) {
+      const AdamModelUpdateOpConf& adam_conf = old_op_conf.adam_model_update_conf();
+      conf->add_m(adam_conf.m());
+      conf->add_v(adam_conf.v());
+      if (adam_conf.user_conf().adam_conf().do_bias_correction()) {
+        conf->add_beta1_t(adam_conf.beta1_t());
+        conf->add_beta2_t(adam_conf.beta2_t());
+      }
+    }
+    for (const std::string& ctrl_in_op_name : old_op_conf.ctrl_in_op_name()) {
+      if (ctrl_in_op_names.insert(ctrl_in_op_name).second) {
+        op_conf->add_ctrl_in_op_name(ctrl_in_op_name);
+      }
+    }
+  }
+}
+
+class MultiTensorModelUpdatePass final : public OpGraphPass {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(MultiTensorModelUpdatePass);
+  MultiTensorModelUpdatePass() = default;
+  ~MultiTensorModelUpdatePass() override = default;
+  bool IsEnabled() const override {
+    return GlobalJobDesc().IsTrain() && GlobalJobDesc().enable_multi_tensor_model_update();
+  }
+  Maybe<void> Apply(const OpGraph& op_graph, JobBuilder* job_builder) const override;
+};
+
+Maybe<void> MultiTensorModelUpdatePass::Apply(const OpGraph& op_graph,
+                                              JobBuilder* job_builder) const {
+  // an op used as a ctrl in op can not be replaced, its name is referenced by others
+  HashSet<std::string> ctrl_in_op_names;
+  op_graph.ForEachNode([&](const OpNode* op_node) {
+    for (const std::string& name : op_node->op().op_conf().ctrl_in_op_name()) {
+      ctrl_in_op_names.insert(name);
+    }
+  });
+  std::vector<std::string> group_keys;
+  HashMap<std::string, std::vector<ModelUpdateOpInfo>> group_key2infos;
+  op_graph.TopoForEachNode([&](const OpNode* op_node) {
+    ModelUpdateOpInfo info{};
+    if (!GetModelUpdateOpInfo(op_node, &info)) { return; }
+    if (!IsMultiTensorModelUpdateSupported(info)) { return; }
+    if (ctrl_in_op_names.find(op_node->op().op_name()) != ctrl_in_op_names.end()) { return; }
+    const std::string key = GenMultiTensorModelUpdateGroupKey(info);
+    auto it = group_key2infos.find(key);
+    if (it == group_key2infos.end()) {
+      group_keys.push_back(key);
+      it = group_key2infos.emplace(key, std::vector<ModelUpdateOpInfo>()).first;
+    }
+    it->second.push_back(info);
+  });
+  for (const std::string& key : group_keys) {
+    const std::vector<ModelUpdateOpInfo>& infos = group_key2infos.at(key);
+    if (infos.size() <= 1) { continue; }
+    OperatorConf multi_tensor_op_conf;
+    BuildMultiTensorModelUpdateOpConf(infos, &multi_tensor_op_conf);
+    std::vector<std::string> del_op_names;
+    for (const ModelUpdateOpInfo& info : infos) {
+      del_op_names.push_back(info.op_node->op().op_name());
+    }
+    job_builder->DelOps(del_op_names);
+    job_builder->AddOps(infos.front().op_node->parallel_desc().parallel_conf(),
+                        {multi_tensor_op_conf});
+  }
+  return Maybe<void>::Ok();
+}
+
+REGISTER_FUNCTION_PASS("MultiTensorModelUpdatePass", MultiTensorModelUpdatePass);
+
+}  // namespace
+
+}  // namespace oneflow
@@ -0,0 +1,185 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/job_rewriter/op_graph_pass.h"
+#include "oneflow/core/job_rewriter/op_fusion_pattern.h"
+
+namespace oneflow {
+
+namespace {
+
+std::map<std::string, const OpFusionPattern*>* PatternName2OpFusionPattern() {
+  static std::map<std::string, const OpFusionPattern*> pattern_name2pattern;
+  return &pattern_name2pattern;
+}
+
+}  // namespace
+
+void RegisterOpFusionPattern(const std::string& pattern_name, const OpFusionPattern* pattern) {
+  CHECK(PatternName2OpFusionPattern()->emplace(pattern_name, pattern).second);
+}
+
+void ForEachOpFusionPattern(
+    const std::function<void(const std::string&, const OpFusionPattern&)>& Handler) {
+  for (const auto& pair : *PatternName2OpFusionPattern()) { Handler(pair.first, *pair.second); }
+}
+
+OpFusionCtx::OpFusionCtx(const OpGraph& op_graph) : op_graph_(op_graph) {
+  op_graph.ForEachNode([&](const OpNode* op_node) {
+    for (const std::string& ctrl_in_op_name : op_node->op().op_conf().ctrl_in_op_name()) {
+      unremovable_op_names_.insert(ctrl_in_op_name);
+    }
+  });
+  if (GlobalJobDesc().IsTrain()) {
+    for (const std::string& loss_lbn : GlobalJobDesc().job_conf().train_conf().loss_lbn()) {
+      unremovable_op_names_.insert(GenLogicalBlobId(loss_lbn).op_name());
+    }
+  }
+}
+
+bool OpFusionCtx::IsTouched(const OpNode* op_node) const {
+  return touched_op_names_.find(op_node->op().op_name()) != touched_op_names_.end();
+}
+
+bool OpFusionCtx::IsRemovable(const OpNode* op_node) const {
+  const OperatorConf& op_conf = op_node->op().op_conf();
+  if (!op_conf.ctrl_in_op_name().empty()) { return false; }
+  return unremovable_op_names_.find(op_conf.name()) == unremovable_op_names_.end();
+}
+
+const OpNode* OpFusionCtx::FusibleProducer4Ibn(const OpNode* consumer, const std::string& ibn,
+                                               const std::string& op_type_name) const {
+  const OpNode* producer = &consumer->SrcNode4Ibn(ibn);
+  if (IsTouched(producer) || !IsRemovable(producer)) { return nullptr; }
+  const OperatorConf& producer_op_conf = producer->op().op_conf();
+  if (!producer_op_conf.has_user_conf()) { return nullptr; }
+  if (producer_op_conf.user_conf().op_type_name() != op_type_name) { return nullptr; }
+  if (producer->op().output_bns().size() != 1) { return nullptr; }
+  if (producer->out_edges().size() != 1) { return nullptr; }
+  if (producer->SoleOutEdge()->dst_node() != consumer) { return nullptr; }
+  if (producer->parallel_desc() != consumer->parallel_desc()) { return nullptr; }
+  const LogicalBlobId& lbi = consumer->op().BnInOp2Lbi(ibn);
+  if (producer->SbpParallel4Lbi(lbi) != consumer->SbpParallel4Lbi(lbi)) { return nullptr; }
+  return producer;
+}
+
+void OpFusionCtx::Fuse(const OpNode* consumer, const std::vector<const OpNode*>& producers,
+                       const OperatorConf& fused_op_conf,
+                       const SbpSignature& fused_sbp_signature) {
+  const std::string& op_name = consumer->op().op_name();
+  CHECK_EQ(fused_op_conf.name(), op_name);
+  CHECK(touched_op_names_.emplace(op_name).second);
+  for (const OpNode* producer : producers) {
+    // the same producer may feed several inputs of the consumer
+    if (touched_op_names_.emplace(producer->op().op_name()).second) {
+      removed_op_names_.push_back(producer->op().op_name());
+    }
+  }
+  op_name2fused_op_conf_[op_name] = fused_op_conf;
+  op_name2fused_sbp_signature_[op_name] = fused_sbp_signature;
+}
+
+void OpFusionCtx::Bypass(const std::vector<const OpNode*>& op_nodes, const LogicalBlobId& lbi,
+                         const LogicalBlobId& new_lbi) {
+  for (const OpNode* op_node : op_nodes) {
+    CHECK(touched_op_names_.emplace(op_node->op().op_name()).second);
+    removed_op_names_.push_back(op_node->op().op_name());
+  }
+  CHECK(lbn2bypassed_lbn_.emplace(GenLogicalBlobName(lbi), GenLogicalBlobName(new_lbi)).second);
+}
+
+std::string OpFusionCtx::BypassedLbn(const std::string& lbn) const {
+  std::string cur_lbn = lbn;
+  while (true) {
+    const auto& it = lbn2bypassed_lbn_.find(cur_lbn);
+    if (it == lbn2bypassed_lbn_.end()) { return cur_lbn; }
+    cur_lbn = it->second;
+  }
+}
+
+void OpFusionCtx::Apply(JobBuilder* job_builder) const {
+  const HashSet<std::string> removed_op_names(removed_op_names_.begin(), removed_op_names_.end());
+  std::vector<OperatorConf> mut_op_confs;
+  op_graph_.ForEachNode([&](const OpNode* op_node) {
+    const std::string& op_name = op_node->op().op_name();
+    if (removed_op_names.find(op_name) != removed_op_names.end()) { return; }
+    const auto& fused_it = op_name2fused_op_conf_.find(op_name);
+    const bool is_fused = fused_it != op_name2fused_op_conf_.end();
+    OperatorConf op_conf = is_fused ? fused_it->second : op_node->op().op_conf();
+    bool is_changed = is_fused;
+    if (is_fused) {
+      // the inputs of a fused op are not the ones in op graph any more
+      for (auto& pair : *op_conf.mutable_user_conf()->mutable_input()) {
+        for (std::string& lbn : *pair.second.mutable_s()) {
+          const std::string bypassed_lbn = BypassedLbn(lbn);
+          if (bypassed_lbn != lbn) {
+            lbn = bypassed_lbn;
+            is_changed = true;
+          }
+        }
+      }
+    } else if (!lbn2bypassed_lbn_.empty()) {
+      PbMessage* conf = MutableMessageInPbMessage(&op_conf, op_conf.op_type_case());
+      for (const std::string& ibn : op_node->op().input_bns()) {
+        const std::string lbn = GenLogicalBlobName(op_node->op().BnInOp2Lbi(ibn));
+        const std::string bypassed_lbn = BypassedLbn(lbn);
+        if (bypassed_lbn == lbn) { continue; }
+        ReplaceInputLbnInOpCustomizedConf(conf, ibn, lbn, bypassed_lbn);
+        is_changed = true;
+      }
+    }
+    if (is_changed) { mut_op_confs.push_back(op_conf); }
+  });
+  job_builder->DelOps(removed_op_names_);
+  job_builder->MutOpsOnlyOnce(mut_op_confs);
+  for (const auto& pair : op_name2fused_sbp_signature_) {
+    job_builder->AddSbpSignature4OpName(pair.first, pair.second);
+  }
+}
+
+namespace {
+
+class OpFusionPass final : public OpGraphPass {
+ public:
+  OpFusionPass() = default;
+  ~OpFusionPass() override = default;
+  bool IsEnabled() const override { return GlobalJobDesc().enable_op_fusion(); }
+  Maybe<void> Apply(const OpGraph& op_graph, JobBuilder* job_builder) const override;
+};
+
+Maybe<void> OpFusionPass::Apply(const OpGraph& op_graph, JobBuilder* job_builder) const {
+  OpFusionCtx ctx(op_graph);
+  std::map<std::string, int64_t> pattern_name2fused_cnt;
+  op_graph.TopoForEachNode([&](const OpNode* op_node) {
+    ForEachOpFusionPattern([&](const std::string& pattern_name, const OpFusionPattern& pattern) {
+      if (ctx.IsTouched(op_node)) { return; }
+      if (pattern.TryFuse(op_node, &ctx)) { pattern_name2fused_cnt[pattern_name] += 1; }
+    });
+  });
+  if (ctx.removed_op_cnt() == 0) { return Maybe<void>::Ok(); }
+  ctx.Apply(job_builder);
+  for (const auto& pair : pattern_name2fused_cnt) {
+    LOG(INFO) << "OpFusionPass: pattern " << pair.first << " matched " << pair.second
+              << " times";
+  }
+  LOG(INFO) << "OpFusionPass: removed " << ctx.removed_op_cnt() << " ops";
+  return Maybe<void>::Ok();
+}
+
+}  // namespace
+
+REGISTER_FUNCTION_PASS("OpFusionPass", OpFusionPass);
+
+}  // namespace oneflow
@@ -0,0 +1,84 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_JOB_REWRITER_OP_FUSION_PATTERN_H_
+#define ONEFLOW_CORE_JOB_REWRITER_OP_FUSION_PATTERN_H_
+
+#include "oneflow/core/graph/op_graph.h"
+#include "oneflow/core/job/job_builder.h"
+#include "oneflow/core/common/util.h"
+
+namespace oneflow {
+
+// Collects the rewrites of OpFusionPass. Every op takes part in one fusion at most, so the
+// patterns only see the original op graph and never conflict with each other.
+class OpFusionCtx final {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(OpFusionCtx);
+  explicit OpFusionCtx(const OpGraph& op_graph);
+  ~OpFusionCtx() = default;
+
+  bool IsTouched(const OpNode* op_node) const;
+  // Whether `op_node` could be removed from the job without losing any ctrl dependency or loss
+  bool IsRemovable(const OpNode* op_node) const;
+  // Returns the producer of `consumer`'s input `ibn` if it is an untouched, removable user op of
+  // `op_type_name` on the same placement whose sole output is read by `consumer` only and with
+  // the same sbp, so that it can be fused into `consumer`. Returns nullptr otherwise.
+  const OpNode* FusibleProducer4Ibn(const OpNode* consumer, const std::string& ibn,
+                                    const std::string& op_type_name) const;
+
+  // Replaces `consumer` with `fused_op_conf`, which keeps the name and the outputs of `consumer`,
+  // and removes `producers`
+  void Fuse(const OpNode* consumer, const std::vector<const OpNode*>& producers,
+            const OperatorConf& fused_op_conf, const SbpSignature& fused_sbp_signature);
+  // Removes `op_nodes` and makes the consumers of `lbi` read `new_lbi` instead
+  void Bypass(const std::vector<const OpNode*>& op_nodes, const LogicalBlobId& lbi,
+              const LogicalBlobId& new_lbi);
+
+  int64_t removed_op_cnt() const { return removed_op_names_.size(); }
+  void Apply(JobBuilder* job_builder) const;
+
+ private:
+  std::string BypassedLbn(const std::string& lbn) const;
+
+  const OpGraph& op_graph_;
+  HashSet<std::string> unremovable_op_names_;
+  HashSet<std::string> touched_op_names_;
+  std::vector<std::string> removed_op_names_;
+  HashMap<std::string, OperatorConf> op_name2fused_op_conf_;
+  HashMap<std::string, SbpSignature> op_name2fused_sbp_signature_;
+  HashMap<std::string, std::string> lbn2bypassed_lbn_;
+};
+
+class OpFusionPattern {
+ public:
+  OpFusionPattern() = default;
+  virtual ~OpFusionPattern() = default;
+
+  // Tries to fuse the subgraph ending at `op_node`. Returns true if it is recorded into `ctx`.
+  virtual bool TryFuse(const OpNode* op_node, OpFusionCtx* ctx) const = 0;
+};
+
+#define REGISTER_OP_FUSION_PATTERN(pattern_name, pattern_type) \
+  COMMAND(RegisterOpFusionPattern(pattern_name, new pattern_type))
+
+void RegisterOpFusionPattern(const std::string& pattern_name, const OpFusionPattern* pattern);
+// Patterns are visited in the order of their names, so the rewrite is deterministic
+void ForEachOpFusionPattern(
+    const std::function<void(const std::string&, const OpFusionPattern&)>& Handler);
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_JOB_REWRITER_OP_FUSION_PATTERN_H_
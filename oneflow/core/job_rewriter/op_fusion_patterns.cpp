@@ -0,0 +1,189 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/job_rewriter/op_fusion_pattern.h"
+#include "oneflow/core/framework/framework.h"
+
+namespace oneflow {
+
+namespace {
+
+const std::string& UserOpTypeName(const OpNode* op_node) {
+  static const std::string empty;
+  const OperatorConf& op_conf = op_node->op().op_conf();
+  return op_conf.has_user_conf() ? op_conf.user_conf().op_type_name() : empty;
+}
+
+DataType DataType4Bn(const OpNode* op_node, const std::string& bn) {
+  return op_node->LogicalBlobDesc4Lbi(op_node->op().BnInOp2Lbi(bn)).data_type();
+}
+
+// the fused ops only have cpu kernels for now
+bool IsCpuFloatingPointOp(const OpNode* op_node, const std::string& obn) {
+  if (op_node->parallel_desc().device_type() != DeviceType::kCPU) { return false; }
+  const DataType data_type = DataType4Bn(op_node, obn);
+  return data_type == DataType::kFloat || data_type == DataType::kDouble;
+}
+
+// bias_add -> relu/gelu  =>  fused_bias_add_activation
+class BiasAddActivationFusionPattern final : public OpFusionPattern {
+ public:
+  bool TryFuse(const OpNode* op_node, OpFusionCtx* ctx) const override {
+    const std::string& op_type_name = UserOpTypeName(op_node);
+    if (op_type_name != "relu" && op_type_name != "gelu") { return false; }
+    if (!IsCpuFloatingPointOp(op_node, "out_0")) { return false; }
+    // gelu_grad reads the input of gelu, so bias_add is kept in that case
+    const OpNode* bias_add = ctx->FusibleProducer4Ibn(op_node, "in_0", "bias_add");
+    if (bias_add == nullptr) { return false; }
+    const user_op::UserOpConfWrapper bias_add_conf(bias_add->op().op_conf());
+    const user_op::UserOpConfWrapper fused_op =
+        user_op::UserOpConfWrapperBuilder(op_node->op().op_name())
+            .Op("fused_bias_add_activation")
+            .Input("a", bias_add_conf.input("a", 0))
+            .Input("b", bias_add_conf.input("b", 0))
+            .Output("out")
+            .Attr<int32_t>("axis", bias_add_conf.attr<int32_t>("axis"))
+            .Attr<std::string>("activation", op_type_name)
+            .Build();
+    OperatorConf fused_op_conf = op_node->op().op_conf();
+    *fused_op_conf.mutable_user_conf() = fused_op.op_conf().user_conf();
+    SbpSignature fused_sbp_signature;
+    auto* bn2sbp = fused_sbp_signature.mutable_bn_in_op2sbp_parallel();
+    (*bn2sbp)["a_0"] = bias_add->SbpParallel4BnInOp("a_0");
+    (*bn2sbp)["b_0"] = bias_add->SbpParallel4BnInOp("b_0");
+    (*bn2sbp)["out_0"] = op_node->SbpParallel4BnInOp("out_0");
+    ctx->Fuse(op_node, {bias_add}, fused_op_conf, fused_sbp_signature);
+    return true;
+  }
+};
+
+// scalar_mul -> add_n  =>  fused_scale_add_n
+class ScaleAddNFusionPattern final : public OpFusionPattern {
+ public:
+  bool TryFuse(const OpNode* op_node, OpFusionCtx* ctx) const override {
+    if (UserOpTypeName(op_node) != "add_n") { return false; }
+    if (!IsCpuFloatingPointOp(op_node, "out_0")) { return false; }
+    const DataType data_type = DataType4Bn(op_node, "out_0");
+    const user_op::UserOpConfWrapper add_n_conf(op_node->op().op_conf());
+    user_op::UserOpConfWrapperBuilder builder(op_node->op().op_name());
+    builder.Op("fused_scale_add_n").Output("out");
+    std::vector<const OpNode*> scalar_muls;
+    std::vector<float> scales;
+    SbpSignature fused_sbp_signature;
+    auto* bn2sbp = fused_sbp_signature.mutable_bn_in_op2sbp_parallel();
+    FOR_RANGE(int32_t, i, 0, add_n_conf.input_size("in")) {
+      const std::string ibn = GenRepeatedBn("in", i);
+      const OpNode* scalar_mul = ctx->FusibleProducer4Ibn(op_node, ibn, "scalar_mul");
+      float scale = 1;
+      if (scalar_mul != nullptr) {
+        const user_op::UserOpConfWrapper scalar_mul_conf(scalar_mul->op().op_conf());
+        double operand = 0;
+        if (scalar_mul_conf.attr<bool>("has_int_operand")) {
+          operand = static_cast<double>(scalar_mul_conf.attr<int64_t>("int_operand"));
+        } else if (scalar_mul_conf.attr<bool>("has_float_operand")) {
+          operand = scalar_mul_conf.attr<double>("float_operand");
+        }
+        scale = static_cast<float>(operand);
+        // scalar_mul scales a double blob by the double operand, which "scales" may not hold
+        if (data_type == DataType::kDouble && static_cast<double>(scale) != operand) {
+          scalar_mul = nullptr;
+          scale = 1;
+        }
+      }
+      if (scalar_mul == nullptr) {
+        builder.Input("in", add_n_conf.input("in", i));
+        (*bn2sbp)[ibn] = op_node->SbpParallel4BnInOp(ibn);
+      } else {
+        builder.Input("in", user_op::UserOpConfWrapper(scalar_mul->op().op_conf()).input("in", 0));
+        (*bn2sbp)[ibn] = scalar_mul->SbpParallel4BnInOp("in_0");
+        scalar_muls.push_back(scalar_mul);
+      }
+      scales.push_back(scale);
+    }
+    if (scalar_muls.empty()) { return false; }
+    (*bn2sbp)["out_0"] = op_node->SbpParallel4BnInOp("out_0");
+    OperatorConf fused_op_conf = op_node->op().op_conf();
+    *fused_op_conf.mutable_user_conf() =
+        builder.Attr<std::vector<float>>("scales", scales).Build().op_conf().user_conf();
+    ctx->Fuse(op_node, scalar_muls, fused_op_conf, fused_sbp_signature);
+    return true;
+  }
+};
+
+// whether every value of `from` is exactly representable in `to`
+bool IsLosslessCast(DataType from, DataType to) {
+  if (from == to) { return true; }
+  switch (from) {
+    case DataType::kInt8:
+    case DataType::kUInt8:
+      return to == DataType::kInt32 || to == DataType::kInt64 || to == DataType::kFloat
+             || to == DataType::kDouble;
+    case DataType::kInt32: return to == DataType::kInt64 || to == DataType::kDouble;
+    case DataType::kFloat16: return to == DataType::kFloat || to == DataType::kDouble;
+    case DataType::kFloat: return to == DataType::kDouble;
+    default: return false;
+  }
+}
+
+// the cast kernels only convert float16 from and to float
+bool IsCastSupported(DataType from, DataType to) {
+  if (from != DataType::kFloat16 && to != DataType::kFloat16) { return true; }
+  return (from == DataType::kFloat && to == DataType::kFloat16)
+         || (from == DataType::kFloat16 && to == DataType::kFloat);
+}
+
+// cast(A -> A)  =>  nothing
+// cast(A -> B) -> cast(B -> C), where A -> B is lossless  =>  cast(A -> C), or nothing if A == C
+class CastChainFusionPattern final : public OpFusionPattern {
+ public:
+  bool TryFuse(const OpNode* op_node, OpFusionCtx* ctx) const override {
+    if (UserOpTypeName(op_node) != "cast") { return false; }
+    const LogicalBlobId& in_lbi = op_node->op().BnInOp2Lbi("in_0");
+    const LogicalBlobId& out_lbi = op_node->op().BnInOp2Lbi("out_0");
+    const DataType out_data_type = DataType4Bn(op_node, "out_0");
+    if (DataType4Bn(op_node, "in_0") == out_data_type) {
+      if (!ctx->IsRemovable(op_node)) { return false; }
+      ctx->Bypass({op_node}, out_lbi, in_lbi);
+      return true;
+    }
+    const OpNode* producer = ctx->FusibleProducer4Ibn(op_node, "in_0", "cast");
+    if (producer == nullptr) { return false; }
+    const DataType in_data_type = DataType4Bn(producer, "in_0");
+    if (!IsLosslessCast(in_data_type, DataType4Bn(producer, "out_0"))) { return false; }
+    const LogicalBlobId& producer_in_lbi = producer->op().BnInOp2Lbi("in_0");
+    if (in_data_type == out_data_type) {
+      if (!ctx->IsRemovable(op_node)) { return false; }
+      ctx->Bypass({producer, op_node}, out_lbi, producer_in_lbi);
+      return true;
+    }
+    if (!IsCastSupported(in_data_type, out_data_type)) { return false; }
+    OperatorConf fused_op_conf = op_node->op().op_conf();
+    (*fused_op_conf.mutable_user_conf()->mutable_input())["in"].set_s(
+        0, GenLogicalBlobName(producer_in_lbi));
+    SbpSignature fused_sbp_signature = op_node->sbp_signature();
+    (*fused_sbp_signature.mutable_bn_in_op2sbp_parallel())["in_0"] =
+        producer->SbpParallel4BnInOp("in_0");
+    ctx->Fuse(op_node, {producer}, fused_op_conf, fused_sbp_signature);
+    return true;
+  }
+};
+
+}  // namespace
+
+REGISTER_OP_FUSION_PATTERN("BiasAddActivation", BiasAddActivationFusionPattern);
+REGISTER_OP_FUSION_PATTERN("CastChain", CastChainFusionPattern);
+REGISTER_OP_FUSION_PATTERN("ScaleAddN", ScaleAddNFusionPattern);
+
+}  // namespace oneflow
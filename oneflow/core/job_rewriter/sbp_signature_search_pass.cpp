@@ -0,0 +1,153 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/job_rewriter/op_graph_pass.h"
+#include "oneflow/core/job/job_desc.h"
+#include "oneflow/core/job/sbp_parallel.h"
+
+namespace oneflow {
+
+namespace {
+
+const int32_t kMaxSbpSignatureSearchRoundNum = 8;
+
+bool IsSbpSignatureSearchable(const OpNode& op_node, const Job& job,
+                              const HashSet<std::string>& op_names_with_identical_sbp) {
+  const Operator& op = op_node.op();
+  if (!op.op_conf().has_user_conf()) { return false; }
+  if (op_node.parallel_desc().parallel_num() == 1) { return false; }
+  // the signatures set by users or other passes are kept as they are
+  const auto& op_name2sbp_sig_conf = job.job_parallel_view_conf().op_name2sbp_signature_conf();
+  if (op_name2sbp_sig_conf.find(op.op_name()) != op_name2sbp_sig_conf.end()) { return false; }
+  if (op_names_with_identical_sbp.find(op.op_name()) != op_names_with_identical_sbp.end()) {
+    return false;
+  }
+  for (const std::string& ibn : op.input_bns()) {
+    if (CHECK_JUST(op.OptMirroredParallel4BnInOp(ibn))->has_mirrored_parallel()) { return false; }
+  }
+  for (const std::string& obn : op.output_bns()) {
+    if (CHECK_JUST(op.OptMirroredParallel4BnInOp(obn))->has_mirrored_parallel()) { return false; }
+  }
+  return true;
+}
+
+// Every op node infers its sbp signature greedily, from the signatures of its producers only.
+// This pass starts from those signatures and, node by node, moves the user ops to the signature
+// with the least copy cost to both their producers and their consumers, until no move lowers the
+// total copy cost of the job. The results are set as the sbp signature confs of the ops.
+class SbpSignatureSearchPass final : public OpGraphPass {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(SbpSignatureSearchPass);
+  SbpSignatureSearchPass() = default;
+  ~SbpSignatureSearchPass() override = default;
+  bool IsEnabled() const override { return GlobalJobDesc().enable_sbp_signature_search(); }
+  Maybe<void> Apply(const OpGraph& op_graph, Job* job) const override;
+};
+
+Maybe<void> SbpSignatureSearchPass::Apply(const OpGraph& op_graph, Job* job) const {
+  HashSet<std::string> op_names_with_identical_sbp;
+  for (const auto& pair : job->helper().identical_sbp_oba_pairs().pair()) {
+    op_names_with_identical_sbp.insert(pair.first().op_name());
+    op_names_with_identical_sbp.insert(pair.second().op_name());
+  }
+  std::vector<const OpNode*> searchable_nodes;
+  HashMap<const OpNode*, SbpSignatureList> node2sbp_sig_list;
+  HashMap<const OpNode*, SbpSignature> node2sbp_sig;
+  op_graph.TopoForEachNode([&](OpNode* op_node) {
+    if (!IsSbpSignatureSearchable(*op_node, *job, op_names_with_identical_sbp)) { return; }
+    auto LogicalBlobDesc4Ibn = [&](const std::string& ibn) -> Maybe<const BlobDesc*> {
+      return &op_node->LogicalBlobDesc4Lbi(op_node->op().BnInOp2Lbi(ibn));
+    };
+    SbpSignatureList* sbp_sig_list = &node2sbp_sig_list[op_node];
+    CHECK_JUST(op_node->op().GetSbpSignaturesIf(LogicalBlobDesc4Ibn, op_node->parallel_desc(),
+                                                sbp_sig_list));
+    searchable_nodes.push_back(op_node);
+    node2sbp_sig.emplace(op_node, op_node->sbp_signature());
+  });
+  if (searchable_nodes.empty()) { return Maybe<void>::Ok(); }
+
+  auto SbpParallel4Bn = [&](const OpNode* op_node, const std::string& bn) -> const SbpParallel& {
+    const auto& it = node2sbp_sig.find(op_node);
+    if (it == node2sbp_sig.end()) { return op_node->SbpParallel4BnInOp(bn); }
+    return it->second.bn_in_op2sbp_parallel().at(bn);
+  };
+  auto CopyCost = [&](const OpNode* producer, const LogicalBlobId& lbi,
+                      const SbpParallel& producer_sbp_parallel,
+                      const SbpParallel& consumer_sbp_parallel) -> double {
+    const SbpInferHint producer_sbp_infer_hint(&producer->parallel_desc(),
+                                               &producer->LogicalBlobDesc4Lbi(lbi),
+                                               &producer_sbp_parallel,
+                                               CHECK_JUST(producer->BatchAxis4Lbi(lbi)));
+    return ComputCopyCostBetweenTwoSbpParallel(producer_sbp_infer_hint, consumer_sbp_parallel);
+  };
+  // the copy cost of all the edges of op_node if it takes sbp_signature
+  auto CopyCost4SbpSig = [&](const OpNode* op_node, const SbpSignature& sbp_signature) -> double {
+    const auto& bn2sbp_parallel = sbp_signature.bn_in_op2sbp_parallel();
+    double cost = 0;
+    for (const std::string& ibn : op_node->op().input_bns()) {
+      const LogicalBlobId& lbi = op_node->op().BnInOp2Lbi(ibn);
+      const OpNode* producer = &op_node->SrcNode4Ibn(ibn);
+      const std::string& obn = *CHECK_JUST(producer->op().obn4lbi(lbi));
+      cost += CopyCost(producer, lbi, SbpParallel4Bn(producer, obn), bn2sbp_parallel.at(ibn));
+    }
+    for (const OpEdge* edge : op_node->out_edges()) {
+      for (const LogicalBlobId& lbi : edge->lbis()) {
+        const SbpParallel& sbp_parallel = bn2sbp_parallel.at(edge->lbi2obn().at(lbi));
+        for (const std::string& ibn : edge->lbi2ibns().at(lbi)) {
+          cost += CopyCost(op_node, lbi, sbp_parallel, SbpParallel4Bn(edge->dst_node(), ibn));
+        }
+      }
+    }
+    return cost;
+  };
+
+  bool changed = false;
+  FOR_RANGE(int32_t, round, 0, kMaxSbpSignatureSearchRoundNum) {
+    bool changed_in_round = false;
+    for (const OpNode* op_node : searchable_nodes) {
+      SbpSignature* sbp_signature = &node2sbp_sig.at(op_node);
+      double min_cost = CopyCost4SbpSig(op_node, *sbp_signature);
+      const SbpSignature* best_sbp_signature = nullptr;
+      for (const SbpSignature& candidate : node2sbp_sig_list.at(op_node).sbp_signature()) {
+        const double cost = CopyCost4SbpSig(op_node, candidate);
+        // only strict improvements are taken, so that the search ends and ties keep the choice
+        // of the greedy inference
+        if (cost < min_cost) {
+          min_cost = cost;
+          best_sbp_signature = &candidate;
+        }
+      }
+      if (best_sbp_signature == nullptr) { continue; }
+      *sbp_signature = *best_sbp_signature;
+      changed_in_round = true;
+    }
+    if (!changed_in_round) { break; }
+    changed = true;
+  }
+  if (!changed) { return Maybe<void>::Ok(); }
+  // all the searched signatures are set, otherwise the ops left unset would be inferred
+  // greedily again from the new signatures of their producers
+  JobBuilder job_builder(job);
+  for (const OpNode* op_node : searchable_nodes) {
+    job_builder.AddSbpSignature4OpName(op_node->op().op_name(), node2sbp_sig.at(op_node));
+  }
+  return Maybe<void>::Ok();
+}
+
+REGISTER_FUNCTION_PASS("SbpSignatureSearchPass", SbpSignatureSearchPass);
+
+}  // namespace
+
+}  // namespace oneflow
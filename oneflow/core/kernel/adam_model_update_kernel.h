@@ -46,6 +46,35 @@ class AdamMdUpdateKernelUtil final {
                                T* beta2_t);
 };
 
+template<typename T>
+class AdamMdUpdateKernelUtil<DeviceType::kCPU, T> final {
+ public:
+  static void UpdateModel(DeviceCtx*, int64_t n, const float* learning_rate, T weight_decay,
+                          T beta1, T beta2, T epsilon, bool do_bias_correction,
+                          const int64_t* train_step, const T* beta1_t, const T* beta2_t,
+                          const T* model_diff, T* model, T* m, T* v) {
+    // moments and model are updated in a single pass, the scalars are loaded out of the loop
+    const T lr = static_cast<T>(*learning_rate);
+    const T m_denominator = do_bias_correction ? 1 - *beta1_t : static_cast<T>(1);
+    const T v_denominator = do_bias_correction ? 1 - *beta2_t : static_cast<T>(1);
+    for (int64_t i = 0; i < n; ++i) {
+      const T model_diff_i = model_diff[i];
+      const T m_i = (beta1 * m[i] + (1 - beta1) * model_diff_i) / m_denominator;
+      const T v_i = (beta2 * v[i] + (1 - beta2) * model_diff_i * model_diff_i) / v_denominator;
+      m[i] = m_i;
+      v[i] = v_i;
+      model[i] = model[i] - lr * (m_i / (std::sqrt(v_i) + epsilon) + weight_decay * model[i]);
+    }
+  }
+  static void DoBiasCorrection(DeviceCtx*, const int64_t* train_step, const T beta1, const T beta2,
+                               T* beta1_t, T* beta2_t) {
+    if (*train_step != 0) {
+      *beta1_t *= beta1;
+      *beta2_t *= beta2;
+    }
+  }
+};
+
 DECLARE_MDUPDT_KERNEL_CREATOR(Adam);
 
 }  // namespace oneflow
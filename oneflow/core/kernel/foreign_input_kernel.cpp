@@ -29,11 +29,21 @@ void ForeignInputKernel::ForwardDataContent(
                                    ->TryReceive(&foreign_job_instance);
   CHECK_NE(buffer_status, kBufferStatusEmpty);
   if (buffer_status == kBufferStatusSuccess) {
+    ResetBodyToRegstMemory(BnInOp2Blob("out"));
     OfBlob ofblob(ctx.device_ctx, BnInOp2Blob("out"));
     foreign_job_instance->PushBlob(reinterpret_cast<uint64_t>(&ofblob));
   }
 }
 
+void ForeignInputKernel::ResetBodyToRegstMemory(Blob* blob) const {
+  auto it = blob2regst_body_ptr_.find(blob);
+  if (it == blob2regst_body_ptr_.end()) {
+    blob2regst_body_ptr_.emplace(blob, blob->ForceMutDptr<char>());
+  } else if (blob->dptr<char>() != it->second) {
+    blob->reset_dptr(it->second);
+  }
+}
+
 REGISTER_KERNEL(OperatorConf::kForeignInputConf, ForeignInputKernel);
 
 }  // namespace oneflow
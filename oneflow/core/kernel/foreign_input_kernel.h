@@ -34,6 +34,11 @@ class ForeignInputKernel final : public KernelIf<DeviceType::kCPU> {
  private:
   void ForwardDataContent(const KernelCtx& ctx,
                           std::function<Blob*(const std::string&)> BnInOp2Blob) const override;
+  void ResetBodyToRegstMemory(Blob* blob) const;
+
+  // The foreign side may lend its buffer as the body of `out` for one piece, so the body is
+  // pointed back to the regst memory before every push.
+  mutable HashMap<const Blob*, char*> blob2regst_body_ptr_;
 };
 
 }  // namespace oneflow
@@ -0,0 +1,88 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include <sstream>
+#define private public
+#include "oneflow/core/kernel/foreign_input_kernel.h"
+#include "oneflow/core/common/buffer_manager.h"
+#include "oneflow/core/job/foreign_job_instance.h"
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+class LendingJobInstance final : public ForeignJobInstance {
+ public:
+  LendingJobInstance(std::vector<float>* lent, const char** body_ptr_at_push)
+      : lent_(lent), body_ptr_at_push_(body_ptr_at_push) {}
+
+  void PushBlob(uint64_t ofblob_ptr) const override {
+    auto* of_blob = reinterpret_cast<OfBlob*>(ofblob_ptr);
+    *body_ptr_at_push_ = of_blob->blob_->dptr<char>();
+    if (lent_ == nullptr) { return; }
+    of_blob->LendBody(reinterpret_cast<char*>(lent_->data()), lent_->size() * sizeof(float));
+  }
+
+ private:
+  std::vector<float>* lent_;
+  const char** body_ptr_at_push_;
+};
+
+}  // namespace
+
+TEST(ForeignInputKernel, lent_body_reset_to_regst_memory) {
+  const std::string buffer_name = GetForeignInputBufferName("test_job");
+  Global<BlobAccessCheckerIf<true, true>>::New();
+  Global<BufferMgr<std::shared_ptr<ForeignJobInstance>>>::New();
+  auto* buffer = Global<BufferMgr<std::shared_ptr<ForeignJobInstance>>>::Get();
+  buffer->NewBuffer(buffer_name, 2);
+
+  RtBlobDesc blob_desc(BlobDesc(Shape({2, 3}), DataType::kFloat));
+  std::vector<char> header(blob_desc.ByteSizeOfBlobHeader());
+  std::vector<float> regst_body(6);
+  std::vector<float> lent(6);
+  MemoryCase mem_case;
+  mem_case.mutable_host_mem();
+  Blob blob(mem_case, &blob_desc, header.data(), reinterpret_cast<char*>(regst_body.data()));
+  const char* regst_body_ptr = reinterpret_cast<const char*>(regst_body.data());
+
+  ForeignInputKernel kernel;
+  kernel.kernel_conf_.mutable_op_attribute()
+      ->mutable_op_conf()
+      ->mutable_foreign_input_conf()
+      ->set_ofblob_buffer_name(buffer_name);
+  KernelCtx ctx;
+  auto BnInOp2Blob = [&](const std::string& bn) -> Blob* { return &blob; };
+
+  const char* body_ptr_at_push = nullptr;
+  buffer->Get(buffer_name)->Send(std::make_shared<LendingJobInstance>(&lent, &body_ptr_at_push));
+  kernel.Forward(ctx, BnInOp2Blob);
+  ASSERT_EQ(body_ptr_at_push, regst_body_ptr);
+  ASSERT_EQ(blob.dptr<char>(), reinterpret_cast<const char*>(lent.data()));
+
+  buffer->Get(buffer_name)->Send(std::make_shared<LendingJobInstance>(nullptr, &body_ptr_at_push));
+  kernel.Forward(ctx, BnInOp2Blob);
+  ASSERT_EQ(body_ptr_at_push, regst_body_ptr);
+  ASSERT_EQ(blob.dptr<char>(), regst_body_ptr);
+
+  Global<BufferMgr<std::shared_ptr<ForeignJobInstance>>>::Delete();
+  Global<BlobAccessCheckerIf<true, true>>::Delete();
+}
+
+}  // namespace test
+
+}  // namespace oneflow
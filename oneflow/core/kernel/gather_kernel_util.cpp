@@ -14,6 +14,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include "oneflow/core/kernel/gather_kernel_util.h"
+#include "oneflow/core/kernel/util/host_elementwise.h"
 
 namespace oneflow {
 
@@ -68,6 +69,10 @@ struct GatherKernelUtilImpl<DeviceType::kCPU, T, K> final {
                       const Shape& flat_in_shape, T* out, const int64_t offset);
 };
 
+// rows of the table are prefetched this many indices ahead, since the indices of an embedding
+// lookup are random and each row is usually a miss
+constexpr int64_t kGatherPrefetchDistance = 4;
+
 template<typename T, typename K>
 void GatherKernelUtilImpl<DeviceType::kCPU, T, K>::Forward(DeviceCtx* ctx, const K* indices,
                                                            int64_t num_indices, const T* in,
@@ -76,19 +81,29 @@ void GatherKernelUtilImpl<DeviceType::kCPU, T, K>::Forward(DeviceCtx* ctx, const
   const int64_t outer_dim_size = flat_in_shape.At(0);
   const int64_t gather_dim_size = flat_in_shape.At(1);
   const int64_t inner_dim_size = flat_in_shape.At(2);
-  FOR_RANGE(int64_t, outer_idx, 0, outer_dim_size) {
-    FOR_RANGE(int64_t, i, 0, num_indices) {
-      CHECK_GE(indices[i], 0);
-      const int64_t idx = indices[i] - offset;
-      T* to = out + outer_idx * num_indices * inner_dim_size + i * inner_dim_size;
-      if (idx >= 0 && idx < gather_dim_size) {
-        const T* from = in + outer_idx * gather_dim_size * inner_dim_size + idx * inner_dim_size;
-        std::copy(from, from + inner_dim_size, to);
-      } else {
-        std::memset(to, 0, inner_dim_size * sizeof(K));
-      }
-    }
-  }
+  // every row of out is copied as a whole, the rows are split across the thread pool
+  host_elementwise::ParallelForRows(
+      outer_dim_size * num_indices, inner_dim_size, [&](int64_t begin, int64_t end) {
+        for (int64_t row = begin; row < end; ++row) {
+          const int64_t outer_idx = row / num_indices;
+          const int64_t i = row - outer_idx * num_indices;
+          const T* in_i = in + outer_idx * gather_dim_size * inner_dim_size;
+          if (i + kGatherPrefetchDistance < num_indices) {
+            const int64_t next_idx = indices[i + kGatherPrefetchDistance] - offset;
+            if (next_idx >= 0 && next_idx < gather_dim_size) {
+              __builtin_prefetch(in_i + next_idx * inner_dim_size);
+            }
+          }
+          CHECK_GE(indices[i], 0);
+          const int64_t idx = indices[i] - offset;
+          T* to = out + row * inner_dim_size;
+          if (idx >= 0 && idx < gather_dim_size) {
+            std::memcpy(to, in_i + idx * inner_dim_size, inner_dim_size * sizeof(T));
+          } else {
+            std::memset(to, 0, inner_dim_size * sizeof(T));
+          }
+        }
+      });
 }
 
 #define INITIATE_GATHER_KERNEL_UTIL_CPU_IMPL(in_type_pair, index_type_pair)              \
@@ -18,6 +18,7 @@ limitations under the License.
 #include "oneflow/core/register/register_manager.h"
 #include "oneflow/core/kernel/kernel.h"
 #include "oneflow/core/memory/memory_case.pb.h"
+#include "oneflow/core/kernel/util/host_elementwise.h"
 
 namespace oneflow {
 
@@ -359,7 +360,7 @@ KU_IF_METHOD Replicate(DeviceCtx* ctx, const int64_t n, T* y, const T* x) {
   for (int64_t i = 0; i < n; ++i) { y[i] = *x; }
 }
 KU_IF_METHOD AddByScalar(DeviceCtx* ctx, const int64_t n, const T* x, const T y, T* z) {
-  for (int64_t i = 0; i < n; ++i) { z[i] = x[i] + y; }
+  host_elementwise::Unary([y](const T x) { return x + y; }, n, z, x);
 }
 KU_IF_METHOD MulByScalarPara(DeviceCtx* ctx, const int64_t n, const T* x, const T y, T* z) {
   for (int64_t i = 0; i < n; ++i) { z[i] = x[i] * y; }
@@ -45,20 +45,6 @@ void MomentumMdUpdateKernel<device_type, T>::UpdateModel(
       momentum_blob->mut_dptr<T>());
 }
 
-template<typename T>
-class MomentumMdUpdateKernelUtil<DeviceType::kCPU, T> final {
- public:
-  static void UpdateModel(DeviceCtx*, int64_t n, T beta, const int64_t* train_step,
-                          const float* learning_rate, T weight_decay, const T* model_diff, T* model,
-                          T* momentum) {
-    for (int64_t i = 0; i != n; ++i) {
-      T next_momentum = beta * momentum[i] - *learning_rate * model_diff[i];
-      momentum[i] = next_momentum;
-      model[i] = model[i] + next_momentum - *learning_rate * weight_decay * model[i];
-    }
-  }
-};
-
 DEFINE_MDUPDT_KERNEL_CREATOR(Momentum);
 
 ADD_DEFAULT_KERNEL_CREATOR(OperatorConf::kMomentumModelUpdateConf, MomentumMdUpdateKernel,
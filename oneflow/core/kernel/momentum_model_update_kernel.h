@@ -45,6 +45,23 @@ class MomentumMdUpdateKernelUtil final {
                           T* momentum);
 };
 
+template<typename T>
+class MomentumMdUpdateKernelUtil<DeviceType::kCPU, T> final {
+ public:
+  static void UpdateModel(DeviceCtx*, int64_t n, T beta, const int64_t* train_step,
+                          const float* learning_rate, T weight_decay, const T* model_diff, T* model,
+                          T* momentum) {
+    // read before the loop, momentum[i] and model[i] are stored in every iteration and the
+    // compiler would reload *learning_rate after each of them
+    const T lr = static_cast<T>(*learning_rate);
+    for (int64_t i = 0; i != n; ++i) {
+      T next_momentum = beta * momentum[i] - lr * model_diff[i];
+      momentum[i] = next_momentum;
+      model[i] = model[i] + next_momentum - lr * weight_decay * model[i];
+    }
+  }
+};
+
 DECLARE_MDUPDT_KERNEL_CREATOR(Momentum);
 
 }  // namespace oneflow
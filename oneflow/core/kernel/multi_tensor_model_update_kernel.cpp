@@ -0,0 +1,144 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/kernel/kernel.h"
+#include "oneflow/core/kernel/naive_model_update_kernel.h"
+#include "oneflow/core/kernel/momentum_model_update_kernel.h"
+#include "oneflow/core/kernel/adam_model_update_kernel.h"
+#include "oneflow/core/kernel/util/host_elementwise.h"
+
+namespace oneflow {
+
+namespace {
+
+// the elements of all the models are laid in a row, [model_elem_offset[i], model_elem_offset[i+1])
+// is the range of the i-th model. Handler(i, begin, n) is called on every piece of a model which
+// falls into [begin, end)
+void ForEachModelPiece(const std::vector<int64_t>& model_elem_offset, int64_t begin, int64_t end,
+                       const std::function<void(int32_t, int64_t, int64_t)>& Handler) {
+  const int32_t num_models = model_elem_offset.size() - 1;
+  int32_t i =
+      std::upper_bound(model_elem_offset.cbegin(), model_elem_offset.cend(), begin)
+      - model_elem_offset.cbegin() - 1;
+  for (; i < num_models && model_elem_offset.at(i) < end; ++i) {
+    const int64_t piece_begin = std::max(begin, model_elem_offset.at(i));
+    const int64_t piece_end = std::min(end, model_elem_offset.at(i + 1));
+    if (piece_end > piece_begin) {
+      Handler(i, piece_begin - model_elem_offset.at(i), piece_end - piece_begin);
+    }
+  }
+}
+
+}  // namespace
+
+template<typename T>
+class MultiTensorMdUpdateKernel final : public KernelIf<DeviceType::kCPU> {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(MultiTensorMdUpdateKernel);
+  MultiTensorMdUpdateKernel() = default;
+  ~MultiTensorMdUpdateKernel() override = default;
+
+ private:
+  void Forward(const KernelCtx& ctx,
+               std::function<Blob*(const std::string&)> BnInOp2Blob) const override {
+    ForwardDataContent(ctx, BnInOp2Blob);
+  }
+  void ForwardDataContent(const KernelCtx& ctx,
+                          std::function<Blob*(const std::string&)> BnInOp2Blob) const override;
+};
+
+template<typename T>
+void MultiTensorMdUpdateKernel<T>::ForwardDataContent(
+    const KernelCtx& ctx, std::function<Blob*(const std::string&)> BnInOp2Blob) const {
+  const auto& conf = this->op_conf().multi_tensor_model_update_conf();
+  const NormalModelUpdateOpUserConf& user_conf = conf.user_conf();
+  const int32_t num_models = conf.model_size();
+  const int64_t* train_step = BnInOp2Blob("train_step")->dptr<int64_t>();
+  const float* learning_rate = BnInOp2Blob("learning_rate")->dptr<float>();
+  auto MutPtrs4Prefix = [&](const std::string& prefix) {
+    std::vector<T*> ptrs(num_models);
+    FOR_RANGE(int32_t, i, 0, num_models) {
+      ptrs.at(i) = BnInOp2Blob(GenRepeatedBn(prefix, i))->mut_dptr<T>();
+    }
+    return ptrs;
+  };
+  std::vector<const T*> model_diff(num_models);
+  std::vector<int64_t> model_elem_offset(num_models + 1, 0);
+  FOR_RANGE(int32_t, i, 0, num_models) {
+    const Blob* model_diff_blob = BnInOp2Blob(GenRepeatedBn("model_diff", i));
+    model_diff.at(i) = model_diff_blob->dptr<T>();
+    model_elem_offset.at(i + 1) = model_elem_offset.at(i) + model_diff_blob->shape().elem_cnt();
+  }
+  const std::vector<T*> model = MutPtrs4Prefix("model");
+  std::function<void(int32_t, int64_t, int64_t)> UpdateModelPiece;
+  std::vector<T*> momentum;
+  std::vector<T*> m;
+  std::vector<T*> v;
+  std::vector<T*> beta1_t;
+  std::vector<T*> beta2_t;
+  if (user_conf.has_naive_conf()) {
+    UpdateModelPiece = [&](int32_t i, int64_t offset, int64_t n) {
+      NaiveMdUpdateKernelUtil<DeviceType::kCPU, T>::UpdateModel(
+          ctx.device_ctx, n, learning_rate, static_cast<T>(conf.weight_decay(i)),
+          model_diff.at(i) + offset, model.at(i) + offset);
+    };
+  } else if (user_conf.has_momentum_conf()) {
+    momentum = MutPtrs4Prefix("momentum");
+    const T beta = static_cast<T>(user_conf.momentum_conf().beta());
+    UpdateModelPiece = [&, beta](int32_t i, int64_t offset, int64_t n) {
+      MomentumMdUpdateKernelUtil<DeviceType::kCPU, T>::UpdateModel(
+          ctx.device_ctx, n, beta, train_step, learning_rate,
+          static_cast<T>(conf.weight_decay(i)), model_diff.at(i) + offset, model.at(i) + offset,
+          momentum.at(i) + offset);
+    };
+  } else if (user_conf.has_adam_conf()) {
+    const AdamModelUpdateConf& adam_conf = user_conf.adam_conf();
+    const T beta1 = static_cast<T>(adam_conf.beta1());
+    const T beta2 = static_cast<T>(adam_conf.beta2());
+    const T epsilon = static_cast<T>(adam_conf.epsilon());
+    const bool do_bias_correction = adam_conf.do_bias_correction();
+    m = MutPtrs4Prefix("m");
+    v = MutPtrs4Prefix("v");
+    if (do_bias_correction) {
+      beta1_t = MutPtrs4Prefix("beta1_t");
+      beta2_t = MutPtrs4Prefix("beta2_t");
+      FOR_RANGE(int32_t, i, 0, num_models) {
+        AdamMdUpdateKernelUtil<DeviceType::kCPU, T>::DoBiasCorrection(
+            ctx.device_ctx, train_step, beta1, beta2, beta1_t.at(i), beta2_t.at(i));
+      }
+    }
+    UpdateModelPiece = [&, beta1, beta2, epsilon, do_bias_correction](int32_t i, int64_t offset,
+                                                                       int64_t n) {
+      AdamMdUpdateKernelUtil<DeviceType::kCPU, T>::UpdateModel(
+          ctx.device_ctx, n, learning_rate, static_cast<T>(conf.weight_decay(i)), beta1, beta2,
+          epsilon, do_bias_correction, train_step,
+          (do_bias_correction ? beta1_t.at(i) : nullptr),
+          (do_bias_correction ? beta2_t.at(i) : nullptr), model_diff.at(i) + offset,
+          model.at(i) + offset, m.at(i) + offset, v.at(i) + offset);
+    };
+  } else {
+    UNIMPLEMENTED();
+  }
+  // the models are split evenly by elements rather than by tensors, so that a thread of
+  // Global<ThreadPool> may update many small models and a big model may be updated by many threads
+  host_elementwise::ParallelFor(model_elem_offset.back(), [&](int64_t begin, int64_t end) {
+    ForEachModelPiece(model_elem_offset, begin, end, UpdateModelPiece);
+  });
+}
+
+ADD_CPU_DEFAULT_KERNEL_CREATOR(OperatorConf::kMultiTensorModelUpdateConf,
+                               MultiTensorMdUpdateKernel, FLOATING_DATA_TYPE_SEQ);
+
+}  // namespace oneflow
@@ -34,17 +34,6 @@ const PbMessage& NaiveMdUpdateKernel<device_type, T>::GetCustomizedOpConf() cons
   return this->op_conf().naive_model_update_conf();
 }
 
-template<typename T>
-class NaiveMdUpdateKernelUtil<DeviceType::kCPU, T> final {
- public:
-  static void UpdateModel(DeviceCtx*, const int64_t n, const float* learning_rate, T weight_decay,
-                          const T* model_diff, T* model) {
-    for (int64_t i = 0; i != n; ++i) {
-      model[i] = model[i] - *learning_rate * (model_diff[i] + weight_decay * model[i]);
-    }
-  }
-};
-
 DEFINE_MDUPDT_KERNEL_CREATOR(Naive);
 
 ADD_DEFAULT_KERNEL_CREATOR(OperatorConf::kNaiveModelUpdateConf, NaiveMdUpdateKernel,
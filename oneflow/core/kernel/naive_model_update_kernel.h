@@ -42,6 +42,19 @@ class NaiveMdUpdateKernelUtil final {
                           const T* model_diff, T* model);
 };
 
+template<typename T>
+class NaiveMdUpdateKernelUtil<DeviceType::kCPU, T> final {
+ public:
+  static void UpdateModel(DeviceCtx*, const int64_t n, const float* learning_rate, T weight_decay,
+                          const T* model_diff, T* model) {
+    // hoisted out of the loop, as the stores to model[i] might otherwise change *learning_rate
+    const T lr = static_cast<T>(*learning_rate);
+    for (int64_t i = 0; i != n; ++i) {
+      model[i] = model[i] - lr * (model_diff[i] + weight_decay * model[i]);
+    }
+  }
+};
+
 DECLARE_MDUPDT_KERNEL_CREATOR(Naive);
 
 }  // namespace oneflow
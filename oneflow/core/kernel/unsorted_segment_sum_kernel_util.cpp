@@ -14,6 +14,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include "oneflow/core/kernel/unsorted_segment_sum_kernel_util.h"
+#include "oneflow/core/kernel/util/host_elementwise.h"
 
 namespace oneflow {
 
@@ -25,23 +26,45 @@ struct UnsortedSegmentSumKernelUtil<DeviceType::kCPU, T, K> final {
                                  int64_t segment_id_offset, T* out);
 };
 
+// The segments of out are split into ranges across the thread pool. Every task scans all the
+// segment ids but only accumulates the rows of the segments in its range, so no two threads write
+// to the same row, no partial sums are allocated, and the sums are added in the same order as a
+// single thread does.
 template<typename T, typename K>
 void UnsortedSegmentSumKernelUtil<DeviceType::kCPU, T, K>::UnsortedSegmentSum(
     DeviceCtx* ctx, const K* segment_ids, const T* data, int64_t num_segment_ids,
     int64_t num_segments, int64_t outer_dim_size, int64_t inner_dim_size, int64_t segment_id_offset,
     T* out) {
-  FOR_RANGE(int64_t, outer_idx, 0, outer_dim_size) {
+  FOR_RANGE(int64_t, i, 0, num_segment_ids) { CHECK_GE(segment_ids[i], 0); }
+  const int64_t parallel_num =
+      host_elementwise::GetParallelNum(outer_dim_size * num_segment_ids * inner_dim_size);
+  const int64_t segment_part_num =
+      std::max<int64_t>(std::min(parallel_num / outer_dim_size, num_segments), 1);
+  const BalancedSplitter segment_bs(num_segments, segment_part_num);
+  auto SumSegmentRange = [&](int64_t outer_idx, const Range& segment_range) {
+    const T* data_i = data + outer_idx * num_segment_ids * inner_dim_size;
+    T* out_i = out + outer_idx * num_segments * inner_dim_size;
     FOR_RANGE(int64_t, i, 0, num_segment_ids) {
-      CHECK_GE(segment_ids[i], 0);
       const int64_t idx = segment_ids[i] - segment_id_offset;
-      T* to = out + outer_idx * num_segments * inner_dim_size + idx * inner_dim_size;
-      if (idx >= 0 && idx < num_segments) {
-        const T* from = data + outer_idx * num_segment_ids * inner_dim_size + i * inner_dim_size;
-        std::transform(from, from + inner_dim_size, to, to, std::plus<T>());
+      if (idx >= segment_range.begin() && idx < segment_range.end()) {
+        const T* from = data_i + i * inner_dim_size;
+        T* to = out_i + idx * inner_dim_size;
+        for (int64_t j = 0; j < inner_dim_size; ++j) { to[j] += from[j]; }
       }
     }
+  };
+  const int64_t task_num = outer_dim_size * segment_part_num;
+  if (parallel_num == 1) {
+    FOR_RANGE(int64_t, outer_idx, 0, outer_dim_size) {
+      SumSegmentRange(outer_idx, Range(0, num_segments));
+    }
+  } else {
+    MultiThreadLoop(task_num, [&](size_t task_id) {
+      SumSegmentRange(task_id / segment_part_num, segment_bs.At(task_id % segment_part_num));
+    });
   }
 }
+
 #define INITIATE_UNSORTED_SEGMENT_SUM_KERNEL_UTIL_CPU(in_type_pair, index_type_pair)             \
   template struct UnsortedSegmentSumKernelUtil<DeviceType::kCPU, OF_PP_PAIR_FIRST(in_type_pair), \
                                                OF_PP_PAIR_FIRST(index_type_pair)>;
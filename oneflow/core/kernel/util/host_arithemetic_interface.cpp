@@ -14,6 +14,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include "oneflow/core/kernel/util/host_arithemetic_interface.h"
+#include "oneflow/core/kernel/util/host_elementwise.h"
 #include "oneflow/core/register/blob.h"
 #include "oneflow/core/operator/op_conf_util.h"
 
@@ -141,7 +142,7 @@ void ArithemeticIf<DeviceType::kCPU>::InitializeWithConstConf(
 #define MUL_BY_SCALAR(T)                                                                         \
   void ArithemeticIf<DeviceType::kCPU>::MulByScalar(DeviceCtx* ctx, const int64_t n, const T* x, \
                                                     const T y, T* z) {                           \
-    for (int64_t i = 0; i < n; ++i) { z[i] = x[i] * y; }                                         \
+    host_elementwise::Unary([y](const T x) { return x * y; }, n, z, x);                          \
   }
 
 MUL_BY_SCALAR(float);
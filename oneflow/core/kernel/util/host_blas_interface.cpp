@@ -15,6 +15,8 @@ limitations under the License.
 */
 #include "oneflow/core/kernel/util/host_blas_interface.h"
 #include "oneflow/core/register/blob.h"
+#include "oneflow/core/common/balanced_splitter.h"
+#include "oneflow/core/thread/thread_manager.h"
 
 namespace oneflow {
 
@@ -52,17 +54,89 @@ static void AxpyImpl(DeviceCtx* ctx, const int n, const T alpha, const T* x, con
   }
 }
 
+// every task dispatched to Global<ThreadPool> does kBatchedGemmGrainSize multiply-adds at least
+constexpr int64_t kBatchedGemmGrainSize = 1 << 20;
+#ifndef WITH_MKL
+// the gemms at least this large are left to the threading of the blas library itself
+constexpr int64_t kBlasThreadedGemmSize = 1 << 24;
+#endif
+
+int64_t GetBatchedGemmParallelNum(int batch_size, int m, int n, int k) {
+  const ThreadPool* thread_pool = Global<ThreadPool>::Get();
+  if (thread_pool == nullptr || batch_size <= 1) { return 1; }
+  const int64_t gemm_size = static_cast<int64_t>(m) * n * k;
+#ifndef WITH_MKL
+  if (gemm_size >= kBlasThreadedGemmSize) { return 1; }
+#endif
+  const int64_t thread_num = thread_pool->thread_num();
+  return std::max<int64_t>(
+      std::min<int64_t>({thread_num, batch_size, gemm_size * batch_size / kBatchedGemmGrainSize}),
+      1);
+}
+
+#ifdef WITH_MKL
+void GemmBatch(enum CBLAS_TRANSPOSE trans_a, enum CBLAS_TRANSPOSE trans_b, int m, int n, int k,
+               float alpha, const float** a_array, int lda, const float** b_array, int ldb,
+               float beta, float** c_array, int ldc, int group_size) {
+  cblas_sgemm_batch(CblasRowMajor, &trans_a, &trans_b, &m, &n, &k, &alpha, a_array, &lda, b_array,
+                    &ldb, &beta, c_array, &ldc, 1, &group_size);
+}
+
+void GemmBatch(enum CBLAS_TRANSPOSE trans_a, enum CBLAS_TRANSPOSE trans_b, int m, int n, int k,
+               double alpha, const double** a_array, int lda, const double** b_array, int ldb,
+               double beta, double** c_array, int ldc, int group_size) {
+  cblas_dgemm_batch(CblasRowMajor, &trans_a, &trans_b, &m, &n, &k, &alpha, a_array, &lda, b_array,
+                    &ldb, &beta, c_array, &ldc, 1, &group_size);
+}
+#endif  // WITH_MKL
+
+// The batch entries are split across Global<ThreadPool>, since each gemm of a batch_matmul is
+// usually too small for the blas library to thread it. With MKL every part is done by a single
+// cblas_?gemm_batch call, whose pointer arrays are kept in buf (3 * batch_size pointers).
 template<typename T>
 void BatchedGemmImpl(DeviceCtx* ctx, const enum CBLAS_ORDER order,
                      const enum CBLAS_TRANSPOSE trans_a, const enum CBLAS_TRANSPOSE trans_b,
                      int batch_size, int m, int n, int k, const T alpha, const T* a, const T* b,
                      const T beta, T* c, T** buf) {
-  const int a_stride = m * k;
-  const int b_stride = k * n;
-  const int c_stride = m * n;
-  FOR_RANGE(int32_t, i, 0, batch_size) {
-    BlasIf<DeviceType::kCPU>::OFGemm(ctx, trans_a, trans_b, m, n, k, alpha, a + i * a_stride,
-                                     b + i * b_stride, beta, c + i * c_stride);
+  const int64_t a_stride = static_cast<int64_t>(m) * k;
+  const int64_t b_stride = static_cast<int64_t>(k) * n;
+  const int64_t c_stride = static_cast<int64_t>(m) * n;
+#ifdef WITH_MKL
+  CHECK_EQ(order, CblasRowMajor);
+  std::vector<T*> ptr_vec;
+  if (buf == nullptr) {
+    ptr_vec.resize(3 * batch_size);
+    buf = ptr_vec.data();
+  }
+  const T** a_array = const_cast<const T**>(buf);
+  const T** b_array = const_cast<const T**>(buf + batch_size);
+  T** c_array = buf + 2 * batch_size;
+  const int lda = (trans_a == CblasNoTrans) ? k : m;
+  const int ldb = (trans_b == CblasNoTrans) ? n : k;
+  const int ldc = n;
+#endif
+  auto GemmRange = [&](int64_t begin, int64_t end) {
+#ifdef WITH_MKL
+    FOR_RANGE(int64_t, i, begin, end) {
+      a_array[i] = a + i * a_stride;
+      b_array[i] = b + i * b_stride;
+      c_array[i] = c + i * c_stride;
+    }
+    GemmBatch(trans_a, trans_b, m, n, k, alpha, a_array + begin, lda, b_array + begin, ldb, beta,
+              c_array + begin, ldc, end - begin);
+#else
+    FOR_RANGE(int64_t, i, begin, end) {
+      Gemm<T>(ctx, order, trans_a, trans_b, m, n, k, alpha, a + i * a_stride, b + i * b_stride,
+              beta, c + i * c_stride);
+    }
+#endif
+  };
+  const int64_t parallel_num = GetBatchedGemmParallelNum(batch_size, m, n, k);
+  if (parallel_num == 1) {
+    GemmRange(0, batch_size);
+  } else {
+    const BalancedSplitter bs(batch_size, parallel_num);
+    MultiThreadLoop(parallel_num, [&](size_t i) { GemmRange(bs.At(i).begin(), bs.At(i).end()); });
   }
 }
 
@@ -0,0 +1,71 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/kernel/util/host_blas_interface.h"
+#include "oneflow/core/thread/thread_pool.h"
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+void TestBatchedGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b, int batch_size, int m,
+                     int n, int k) {
+  std::vector<float> a(batch_size * m * k);
+  std::vector<float> b(batch_size * k * n);
+  FOR_RANGE(size_t, i, 0, a.size()) { a.at(i) = static_cast<float>(i % 7) - 3; }
+  FOR_RANGE(size_t, i, 0, b.size()) { b.at(i) = static_cast<float>(i % 5) - 2; }
+  std::vector<float> c(batch_size * m * n, 1);
+  std::vector<float*> buf(3 * batch_size);
+  BlasIf<DeviceType::kCPU>::OFBatchedGemm(nullptr, trans_a, trans_b, batch_size, m, n, k, 1.0f,
+                                          a.data(), b.data(), 0.0f, c.data(), buf.data());
+  FOR_RANGE(int, bi, 0, batch_size) {
+    const float* a_i = a.data() + bi * m * k;
+    const float* b_i = b.data() + bi * k * n;
+    FOR_RANGE(int, i, 0, m) {
+      FOR_RANGE(int, j, 0, n) {
+        float sum = 0;
+        FOR_RANGE(int, l, 0, k) {
+          const float a_il = trans_a == CblasNoTrans ? a_i[i * k + l] : a_i[l * m + i];
+          const float b_lj = trans_b == CblasNoTrans ? b_i[l * n + j] : b_i[j * k + l];
+          sum += a_il * b_lj;
+        }
+        ASSERT_FLOAT_EQ(c.at((bi * m + i) * n + j), sum);
+      }
+    }
+  }
+}
+
+void TestBatchedGemms() {
+  TestBatchedGemm(CblasNoTrans, CblasNoTrans, 1, 3, 4, 5);
+  TestBatchedGemm(CblasNoTrans, CblasTrans, 24, 32, 32, 16);
+  TestBatchedGemm(CblasTrans, CblasNoTrans, 7, 17, 9, 33);
+  TestBatchedGemm(CblasTrans, CblasTrans, 96, 64, 64, 64);
+}
+
+}  // namespace
+
+TEST(HostBlasInterface, batched_gemm_without_thread_pool) { TestBatchedGemms(); }
+
+TEST(HostBlasInterface, batched_gemm_with_thread_pool) {
+  Global<ThreadPool>::New(4);
+  TestBatchedGemms();
+  Global<ThreadPool>::Delete();
+}
+
+}  // namespace test
+
+}  // namespace oneflow
@@ -14,6 +14,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include "oneflow/core/kernel/util/host_dnn_interface.h"
+#include "oneflow/core/kernel/util/host_elementwise.h"
 
 namespace oneflow {
 
@@ -21,38 +22,40 @@ namespace {
 
 template<typename T>
 static void ReluImpl(DeviceCtx* ctx, const int64_t n, const T* x, T* y) {
-  T zero = GetZeroVal<T>();
-  for (int64_t i = 0; i != n; ++i) { y[i] = std::max(x[i], zero); }
+  const T zero = GetZeroVal<T>();
+  host_elementwise::Unary([zero](const T x) { return std::max(x, zero); }, n, y, x);
 }
 
 template<typename T>
 static void ReluBackwardImpl(DeviceCtx* ctx, const int64_t n, const T* x, const T* y, const T* dy,
                              T* dx) {
-  T zero = GetZeroVal<T>();
-  for (int64_t i = 0; i != n; ++i) { dx[i] = (y[i] > zero) * dy[i]; }
+  const T zero = GetZeroVal<T>();
+  host_elementwise::Binary([zero](const T y, const T dy) { return (y > zero) * dy; }, n, dx, y,
+                           dy);
 }
 
 template<typename T>
 static void SigmoidImpl(DeviceCtx* ctx, int64_t n, const T* x, T* y) {
-  T half = static_cast<T>(0.5);
-  for (int64_t i = 0; i != n; ++i) { y[i] = half * std::tanh(half * x[i]) + half; }
+  const T half = static_cast<T>(0.5);
+  host_elementwise::Unary([half](const T x) { return half * std::tanh(half * x) + half; }, n, y,
+                          x);
 }
 
 template<typename T>
 static void SigmoidBackwardImpl(DeviceCtx* ctx, const int64_t n, const T* x, const T* y,
                                 const T* dy, T* dx) {
-  for (int64_t i = 0; i != n; ++i) { dx[i] = y[i] * (1 - y[i]) * dy[i]; }
+  host_elementwise::Binary([](const T y, const T dy) { return y * (1 - y) * dy; }, n, dx, y, dy);
 }
 
 template<typename T>
 static void TanHImpl(DeviceCtx* ctx, int64_t n, const T* x, T* y) {
-  for (int64_t i = 0; i != n; ++i) { y[i] = std::tanh(x[i]); }
+  host_elementwise::Unary([](const T x) { return std::tanh(x); }, n, y, x);
 }
 
 template<typename T>
 static void TanHBackwardImpl(DeviceCtx* ctx, const int64_t n, const T* x, const T* y, const T* dy,
                              T* dx) {
-  for (int64_t i = 0; i != n; ++i) { dx[i] = (1 - y[i] * y[i]) * dy[i]; }
+  host_elementwise::Binary([](const T y, const T dy) { return (1 - y * y) * dy; }, n, dx, y, dy);
 }
 
 }  // namespace
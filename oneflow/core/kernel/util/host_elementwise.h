@@ -0,0 +1,89 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_KERNEL_UTIL_HOST_ELEMENTWISE_H_
+#define ONEFLOW_CORE_KERNEL_UTIL_HOST_ELEMENTWISE_H_
+
+#include "oneflow/core/common/util.h"
+#include "oneflow/core/common/balanced_splitter.h"
+#include "oneflow/core/thread/thread_manager.h"
+
+namespace oneflow {
+
+namespace host_elementwise {
+
+// every task dispatched to Global<ThreadPool> handles kGrainSize elements at least, so that the
+// cost of dispatching is small compared with the work of the task
+constexpr int64_t kGrainSize = 32768;
+
+inline int64_t GetParallelNum(int64_t n) {
+  const ThreadPool* thread_pool = Global<ThreadPool>::Get();
+  if (thread_pool == nullptr) { return 1; }
+  const int64_t thread_num = thread_pool->thread_num();
+  return std::max<int64_t>(std::min<int64_t>(thread_num, n / kGrainSize), 1);
+}
+
+// splits [0, n) into contiguous chunks and runs Handler(begin, end) on each of them
+inline void ParallelFor(int64_t n, const std::function<void(int64_t begin, int64_t end)>& Handler) {
+  const int64_t parallel_num = GetParallelNum(n);
+  if (parallel_num == 1) {
+    Handler(0, n);
+    return;
+  }
+  const BalancedSplitter bs(n, parallel_num);
+  MultiThreadLoop(parallel_num, [&](size_t i) { Handler(bs.At(i).begin(), bs.At(i).end()); });
+}
+
+// splits [0, num_rows) into contiguous chunks by the total elements of the rows, so that short
+// rows are grouped and long rows are not serialized
+inline void ParallelForRows(int64_t num_rows, int64_t row_size,
+                            const std::function<void(int64_t begin, int64_t end)>& Handler) {
+  const int64_t parallel_num = std::min(GetParallelNum(num_rows * row_size), num_rows);
+  if (parallel_num <= 1) {
+    Handler(0, num_rows);
+    return;
+  }
+  const BalancedSplitter bs(num_rows, parallel_num);
+  MultiThreadLoop(parallel_num, [&](size_t i) { Handler(bs.At(i).begin(), bs.At(i).end()); });
+}
+
+// The loops below are unit stride with int64_t counters and call the functor by value, so the
+// functor is inlined and the loop auto-vectorized. r may alias the inputs (inplace ops).
+template<typename FunctorT, typename R, typename A>
+void Unary(FunctorT functor, int64_t n, R* r, const A* a) {
+  ParallelFor(n, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) { r[i] = functor(a[i]); }
+  });
+}
+
+template<typename FunctorT, typename R, typename A, typename B>
+void Binary(FunctorT functor, int64_t n, R* r, const A* a, const B* b) {
+  ParallelFor(n, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) { r[i] = functor(a[i], b[i]); }
+  });
+}
+
+template<typename FunctorT, typename R, typename A, typename B, typename C>
+void Ternary(FunctorT functor, int64_t n, R* r, const A* a, const B* b, const C* c) {
+  ParallelFor(n, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) { r[i] = functor(a[i], b[i], c[i]); }
+  });
+}
+
+}  // namespace host_elementwise
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_KERNEL_UTIL_HOST_ELEMENTWISE_H_
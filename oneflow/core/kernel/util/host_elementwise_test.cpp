@@ -0,0 +1,68 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/kernel/util/host_elementwise.h"
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+void TestElementwise(int64_t n) {
+  std::vector<int64_t> a(n);
+  std::vector<int64_t> b(n);
+  std::vector<int64_t> c(n);
+  FOR_RANGE(int64_t, i, 0, n) {
+    a.at(i) = i;
+    b.at(i) = 2 * i;
+    c.at(i) = 3 * i;
+  }
+  std::vector<int64_t> r(n, -1);
+  host_elementwise::Unary([](int64_t a) { return a + 1; }, n, r.data(), a.data());
+  FOR_RANGE(int64_t, i, 0, n) { ASSERT_EQ(r.at(i), i + 1); }
+  host_elementwise::Binary([](int64_t a, int64_t b) { return a + b; }, n, r.data(), a.data(),
+                           b.data());
+  FOR_RANGE(int64_t, i, 0, n) { ASSERT_EQ(r.at(i), 3 * i); }
+  host_elementwise::Ternary([](int64_t a, int64_t b, int64_t c) { return a + b + c; }, n,
+                            r.data(), a.data(), b.data(), c.data());
+  FOR_RANGE(int64_t, i, 0, n) { ASSERT_EQ(r.at(i), 6 * i); }
+  // inplace
+  host_elementwise::Unary([](int64_t a) { return -a; }, n, a.data(), a.data());
+  FOR_RANGE(int64_t, i, 0, n) { ASSERT_EQ(a.at(i), -i); }
+}
+
+}  // namespace
+
+TEST(HostElementwise, without_thread_pool) {
+  TestElementwise(0);
+  TestElementwise(1);
+  TestElementwise(host_elementwise::kGrainSize * 3 + 7);
+}
+
+TEST(HostElementwise, with_thread_pool) {
+  Global<ThreadPool>::New(4);
+  ASSERT_EQ(host_elementwise::GetParallelNum(host_elementwise::kGrainSize - 1), 1);
+  ASSERT_EQ(host_elementwise::GetParallelNum(host_elementwise::kGrainSize * 2), 2);
+  ASSERT_EQ(host_elementwise::GetParallelNum(host_elementwise::kGrainSize * 100), 4);
+  TestElementwise(0);
+  TestElementwise(host_elementwise::kGrainSize - 1);
+  TestElementwise(host_elementwise::kGrainSize * 5 + 3);
+  Global<ThreadPool>::Delete();
+}
+
+}  // namespace test
+
+}  // namespace oneflow
@@ -0,0 +1,128 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/operator/operator.h"
+#include "oneflow/core/graph/logical_node.h"
+
+namespace oneflow {
+
+class MultiTensorModelUpdateOp final : public Operator {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(MultiTensorModelUpdateOp);
+  MultiTensorModelUpdateOp() = default;
+  ~MultiTensorModelUpdateOp() override = default;
+
+  LogicalNode* NewProperLogicalNode() const override { return new OptimizerLogicalNode; }
+
+ private:
+  void InitFromOpConf() override;
+  const PbMessage& GetCustomizedConf() const override;
+  Maybe<void> InferBlobDescs(std::function<BlobDesc*(const std::string&)> GetBlobDesc4BnInOp,
+                             const ParallelContext* parallel_ctx) const override;
+  Maybe<void> InferBatchAxis(
+      std::function<OptInt64*(const std::string&)> BatchAxis4BnInOp) const override {
+    return Maybe<void>::Ok();
+  }
+  Maybe<void> GetSbpSignatures(
+      const std::function<Maybe<const BlobDesc*>(const std::string&)>& LogicalBlobDesc4Ibn,
+      SbpSignatureList* sbp_sig_list) const override {
+    // only the all-broadcast signature added by Operator::GetSbpSignaturesIf is valid
+    return Maybe<void>::Ok();
+  }
+
+  void EnrollRepeatedMutableInputBn(const std::string& ibn_prefix, int32_t num);
+};
+
+void MultiTensorModelUpdateOp::InitFromOpConf() {
+  const auto& conf = op_conf().multi_tensor_model_update_conf();
+  const int32_t num_models = conf.model_size();
+  CHECK_GT(num_models, 0);
+  CHECK_EQ(conf.model_diff_size(), num_models);
+  CHECK_EQ(conf.weight_decay_size(), num_models);
+  // the kernel data type is inferred from model_diff, so it must be enrolled first
+  EnrollRepeatedInputBn("model_diff", num_models, false);
+  EnrollRepeatedMutableInputBn("model", num_models);
+  EnrollInputBn("learning_rate", false);
+  EnrollInputBn("train_step", false);
+  const NormalModelUpdateOpUserConf& user_conf = conf.user_conf();
+  if (user_conf.has_naive_conf()) {
+    // nothing else
+  } else if (user_conf.has_momentum_conf()) {
+    CHECK_GE(user_conf.momentum_conf().beta(), 0);
+    CHECK_LT(user_conf.momentum_conf().beta(), 1);
+    CHECK_EQ(conf.momentum_size(), num_models);
+    EnrollRepeatedMutableInputBn("momentum", num_models);
+  } else if (user_conf.has_adam_conf()) {
+    const AdamModelUpdateConf& adam_conf = user_conf.adam_conf();
+    CHECK_GE(adam_conf.beta1(), 0);
+    CHECK_LT(adam_conf.beta1(), 1);
+    CHECK_GE(adam_conf.beta2(), 0);
+    CHECK_LT(adam_conf.beta2(), 1);
+    CHECK_EQ(conf.m_size(), num_models);
+    CHECK_EQ(conf.v_size(), num_models);
+    EnrollRepeatedMutableInputBn("m", num_models);
+    EnrollRepeatedMutableInputBn("v", num_models);
+    if (adam_conf.do_bias_correction()) {
+      CHECK_EQ(conf.beta1_t_size(), num_models);
+      CHECK_EQ(conf.beta2_t_size(), num_models);
+      EnrollRepeatedMutableInputBn("beta1_t", num_models);
+      EnrollRepeatedMutableInputBn("beta2_t", num_models);
+    }
+  } else {
+    UNIMPLEMENTED() << "multi tensor model update does not support "
+                    << user_conf.normal_mdupdt_case();
+  }
+}
+
+void MultiTensorModelUpdateOp::EnrollRepeatedMutableInputBn(const std::string& ibn_prefix,
+                                                            int32_t num) {
+  FOR_RANGE(int32_t, i, 0, num) {
+    EnrollInputBn(GenRepeatedBn(ibn_prefix, i), false)->set_is_mutable(true);
+  }
+}
+
+const PbMessage& MultiTensorModelUpdateOp::GetCustomizedConf() const {
+  return op_conf().multi_tensor_model_update_conf();
+}
+
+Maybe<void> MultiTensorModelUpdateOp::InferBlobDescs(
+    std::function<BlobDesc*(const std::string&)> GetBlobDesc4BnInOp,
+    const ParallelContext* parallel_ctx) const {
+  const auto& conf = op_conf().multi_tensor_model_update_conf();
+  const NormalModelUpdateOpUserConf& user_conf = conf.user_conf();
+  const DataType data_type = GetBlobDesc4BnInOp(GenRepeatedBn("model", 0))->data_type();
+  FOR_RANGE(int32_t, i, 0, conf.model_size()) {
+    const BlobDesc* model = GetBlobDesc4BnInOp(GenRepeatedBn("model", i));
+    CHECK_EQ_OR_RETURN(model->data_type(), data_type);
+    const BlobDesc* model_diff = GetBlobDesc4BnInOp(GenRepeatedBn("model_diff", i));
+    CHECK_EQ_OR_RETURN(model_diff->shape(), model->shape());
+    CHECK_EQ_OR_RETURN(model_diff->data_type(), data_type);
+    if (user_conf.has_momentum_conf()) {
+      CHECK_OR_RETURN(*GetBlobDesc4BnInOp(GenRepeatedBn("momentum", i)) == *model);
+    } else if (user_conf.has_adam_conf()) {
+      CHECK_OR_RETURN(*GetBlobDesc4BnInOp(GenRepeatedBn("m", i)) == *model);
+      CHECK_OR_RETURN(*GetBlobDesc4BnInOp(GenRepeatedBn("v", i)) == *model);
+      if (user_conf.adam_conf().do_bias_correction()) {
+        CHECK_EQ_OR_RETURN(GetBlobDesc4BnInOp(GenRepeatedBn("beta1_t", i))->shape(), Shape({1}));
+        CHECK_EQ_OR_RETURN(GetBlobDesc4BnInOp(GenRepeatedBn("beta2_t", i))->shape(), Shape({1}));
+      }
+    }
+  }
+  return Maybe<void>::Ok();
+}
+
+REGISTER_OP(OperatorConf::kMultiTensorModelUpdateConf, MultiTensorModelUpdateOp);
+
+}  // namespace oneflow
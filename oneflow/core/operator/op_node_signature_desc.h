@@ -30,6 +30,7 @@ class OpNodeSignatureDesc final {
   OpNodeSignatureDesc(OpNodeSignatureDesc&&) = delete;
   OpNodeSignatureDesc(const OpNodeSignature& op_node_signature);
 
+  const OpNodeSignature& op_node_signature() const { return op_node_signature_; }
   const SbpSignature& sbp_signature() const { return op_node_signature_.sbp_signature(); }
   const ParallelSignature& parallel_signature() const {
     return op_node_signature_.parallel_signature();
@@ -62,6 +62,12 @@ class OfBlob final {
   template<typename T>
   void StaticTensorAutoMemCopyFrom(const T* ptr, int64_t len) const;
 
+  // The body of a static host blob is a plain contiguous buffer, which can be replaced by a
+  // buffer lent from the foreign side. The lent buffer must outlive all the consumers of the blob.
+  bool IsBodyHostAccessible() const;
+  int64_t ByteSizeOfBody() const { return blob_->blob_desc().ByteSizeOfBlobBody(); }
+  void LendBody(char* ptr, int64_t byte_size) const;
+
  private:
   void ClearShape(FullyMutTensorView* tensor) const;
 
@@ -121,6 +127,18 @@ inline void OfBlob::CurTensorCopyShapeTo(int64_t* ptr, int64_t num_axis) const {
   MutShapeView(ptr, num_axis).set_shape(cur_tensor_->shape());
 }
 
+inline bool OfBlob::IsBodyHostAccessible() const {
+  return blob_->mem_case().has_host_mem() && !is_dynamic() && !is_tensor_list();
+}
+
+inline void OfBlob::LendBody(char* ptr, int64_t byte_size) const {
+  CHECK(IsBodyHostAccessible());
+  CHECK_EQ(byte_size, ByteSizeOfBody());
+  CHECK_EQ(reinterpret_cast<uintptr_t>(ptr) % GetSizeOfDataType(blob_->data_type()), 0);
+  blob_->blob_access_checker()->CheckBodyMutable();
+  blob_->reset_dptr(ptr);
+}
+
 inline void OfBlob::ClearShape(FullyMutTensorView* tensor) const {
   if (tensor == nullptr) { return; }
   std::vector<int64_t> zeros(NumAxes(), 0LL);
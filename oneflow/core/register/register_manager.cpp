@@ -22,6 +22,7 @@ limitations under the License.
 #include "oneflow/core/job/machine_context.h"
 #include "oneflow/core/memory/memory_case.pb.h"
 #include "oneflow/core/memory/memory_allocator.h"
+#include "oneflow/core/thread/thread_placement.h"
 
 namespace oneflow {
 
@@ -33,6 +34,19 @@ void CheckBlobInRegstNotDisabled(const RegstDescProto& regst_desc) {
         == false);
 }
 
+HashMap<int64_t, int64_t> GetMemBlockId2ProducerThrdId(const Plan& plan, int64_t machine_id) {
+  HashMap<int64_t, int64_t> mem_block_id2thrd_id;
+  for (const TaskProto& task : plan.task()) {
+    if (task.machine_id() != machine_id) { continue; }
+    for (const auto& pair : task.produced_regst_desc()) {
+      const int64_t mem_block_id = pair.second.mem_block_id();
+      if (mem_block_id == -1) { continue; }
+      mem_block_id2thrd_id.emplace(mem_block_id, task.thrd_id());
+    }
+  }
+  return mem_block_id2thrd_id;
+}
+
 }  // namespace
 
 RegstMgr::RegstMgr(const Plan& plan) {
@@ -44,6 +58,8 @@ RegstMgr::RegstMgr(const Plan& plan) {
     char* chunk_ptr = Global<MemoryAllocator>::Get()->Allocate(chunk.mem_case(), chunk.mem_size());
     CHECK(chunk_id2ptr.emplace(chunk.chunk_id(), chunk_ptr).second);
   }
+  const HashMap<int64_t, int64_t> mem_block_id2thrd_id =
+      GetMemBlockId2ProducerThrdId(plan, this_machine_id);
   for (const MemBlockProto& mem_block : plan.block_chunk_list().mem_block()) {
     if (mem_block.machine_id() != this_machine_id) { continue; }
     if (mem_block.mem_size() == 0) { continue; }
@@ -52,6 +68,16 @@ RegstMgr::RegstMgr(const Plan& plan) {
       CHECK(mem_block.has_chunk_offset());
       CHECK(chunk_id2ptr.find(mem_block.chunk_id()) != chunk_id2ptr.end());
       mem_block_ptr = chunk_id2ptr.at(mem_block.chunk_id()) + mem_block.chunk_offset();
+    } else if (mem_block.mem_case().has_host_mem()
+               && !mem_block.mem_case().host_mem().has_cuda_pinned_mem()
+               && mem_block_id2thrd_id.find(mem_block.mem_block_id())
+                      != mem_block_id2thrd_id.end()) {
+      // first touched on the numa node of the thread producing the regsts
+      const int64_t thrd_id = mem_block_id2thrd_id.at(mem_block.mem_block_id());
+      Global<ThreadPlacement>::Get()->RunOnNumaNode4ActorThrdId(thrd_id, [&]() {
+        mem_block_ptr =
+            Global<MemoryAllocator>::Get()->Allocate(mem_block.mem_case(), mem_block.mem_size());
+      });
     } else {
       mem_block_ptr =
           Global<MemoryAllocator>::Get()->Allocate(mem_block.mem_case(), mem_block.mem_size());
@@ -0,0 +1,255 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/thread/thread_placement.h"
+#include "oneflow/core/thread/thread_pool.h"
+#include "oneflow/core/common/blocking_counter.h"
+#include "oneflow/core/common/platform.h"
+#include "oneflow/core/device/cuda_util.h"
+#include "oneflow/core/job/id_manager.h"
+#ifdef PLATFORM_POSIX
+#include <dirent.h>
+#include <sched.h>
+#endif
+
+namespace oneflow {
+
+namespace {
+
+#ifdef PLATFORM_POSIX
+
+std::vector<int32_t> GetAllowedCpus() {
+  cpu_set_t cpu_set;
+  CHECK_EQ(sched_getaffinity(0, sizeof(cpu_set_t), &cpu_set), 0);
+  std::vector<int32_t> cpus;
+  FOR_RANGE(int32_t, cpu, 0, CPU_SETSIZE) {
+    if (CPU_ISSET(cpu, &cpu_set)) { cpus.push_back(cpu); }
+  }
+  return cpus;
+}
+
+void SetCpuAffinity(const std::vector<int32_t>& cpus) {
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int32_t cpu : cpus) { CPU_SET(cpu, &cpu_set); }
+  CHECK_EQ(sched_setaffinity(0, sizeof(cpu_set_t), &cpu_set), 0);
+}
+
+// Returns node id to its cpus which the process is allowed to run on
+std::map<int32_t, std::vector<int32_t>> GetNumaTopology(const std::vector<int32_t>& allowed_cpus) {
+  std::map<int32_t, std::vector<int32_t>> node_id2cpus;
+  const std::string node_dir = "/sys/devices/system/node";
+  DIR* dir = opendir(node_dir.c_str());
+  if (dir == nullptr) { return node_id2cpus; }
+  const HashSet<int32_t> allowed(allowed_cpus.begin(), allowed_cpus.end());
+  while (const struct dirent* entry = readdir(dir)) {
+    const std::string name = entry->d_name;
+    if (name.compare(0, 4, "node") != 0 || name.size() == 4
+        || !std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+      continue;
+    }
+    std::ifstream is(node_dir + "/" + name + "/cpulist");
+    std::string cpu_list;
+    if (!std::getline(is, cpu_list).good()) { continue; }
+    std::vector<int32_t> cpus;
+    for (int32_t cpu : ParseCpuList(cpu_list)) {
+      if (allowed.count(cpu) > 0) { cpus.push_back(cpu); }
+    }
+    // memory only nodes or nodes out of the cpuset of the process
+    if (cpus.empty()) { continue; }
+    node_id2cpus.emplace(std::stoi(name.substr(4)), cpus);
+  }
+  closedir(dir);
+  return node_id2cpus;
+}
+
+#endif
+
+}  // namespace
+
+std::vector<int32_t> ParseCpuList(const std::string& cpu_list) {
+  std::vector<int32_t> cpus;
+  std::istringstream ss(cpu_list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty() || range == "\n") { continue; }
+    const size_t dash_pos = range.find('-');
+    const int32_t first = std::stoi(range.substr(0, dash_pos));
+    const int32_t last =
+        dash_pos == std::string::npos ? first : std::stoi(range.substr(dash_pos + 1));
+    FOR_RANGE(int32_t, cpu, first, last + 1) { cpus.push_back(cpu); }
+  }
+  return cpus;
+}
+
+std::string FormatCpuList(const std::vector<int32_t>& cpus) {
+  std::string ret;
+  for (size_t i = 0; i < cpus.size();) {
+    size_t j = i;
+    while (j + 1 < cpus.size() && cpus.at(j + 1) == cpus.at(j) + 1) { ++j; }
+    if (!ret.empty()) { ret += ","; }
+    ret += std::to_string(cpus.at(i));
+    if (j > i) { ret += "-" + std::to_string(cpus.at(j)); }
+    i = j + 1;
+  }
+  return ret;
+}
+
+ThreadPlacement::ThreadPlacement(const ThreadPlacementConf& conf)
+    : conf_(conf), pinned_thread_pool_(nullptr) {
+#ifdef PLATFORM_POSIX
+  const std::vector<int32_t> allowed_cpus = GetAllowedCpus();
+  for (auto& pair : GetNumaTopology(allowed_cpus)) {
+    node_ids_.push_back(pair.first);
+    node2cpus_.push_back(std::move(pair.second));
+  }
+  if (node2cpus_.empty()) {
+    node_ids_.push_back(0);
+    node2cpus_.push_back(allowed_cpus);
+  }
+  FOR_RANGE(int32_t, i, 0, numa_node_num()) {
+    LOG(INFO) << "numa node " << node_ids_.at(i) << ": cpus " << FormatCpuList(node2cpus_.at(i));
+  }
+#else
+  if (conf_.enable_thread_pinning() || conf_.enable_numa_aware_host_malloc()) {
+    LOG(WARNING) << "thread placement is only supported on posix platforms";
+  }
+  conf_.set_enable_thread_pinning(false);
+  conf_.set_enable_numa_aware_host_malloc(false);
+#endif
+}
+
+ThreadPlacement::~ThreadPlacement() { UnpinThreadPool(); }
+
+int32_t ThreadPlacement::NumaNode4ActorThrdId(int64_t thrd_id) const {
+  const IDMgr* id_mgr = Global<IDMgr>::Get();
+  if (id_mgr->GetDeviceTypeFromThrdId(thrd_id) == DeviceType::kGPU) {
+    // the node sharing the most cpus with the device
+    const std::vector<int32_t> cpus = Cpus4ActorThrdId(thrd_id);
+    const HashSet<int32_t> cpu_set(cpus.begin(), cpus.end());
+    int32_t best_node = 0;
+    size_t best_cnt = 0;
+    FOR_RANGE(int32_t, i, 0, numa_node_num()) {
+      size_t cnt = std::count_if(node2cpus_.at(i).begin(), node2cpus_.at(i).end(),
+                                 [&](int32_t cpu) { return cpu_set.count(cpu) > 0; });
+      if (cnt > best_cnt) {
+        best_node = i;
+        best_cnt = cnt;
+      }
+    }
+    return best_node;
+  }
+  const int64_t cpu_thrd_id_begin = id_mgr->GetCpuDeviceThrdId(0);
+  if (thrd_id < id_mgr->CommNetThrdId()) {
+    return (thrd_id - cpu_thrd_id_begin) % numa_node_num();
+  }
+  // the comm net thread and the persistence threads created after it
+  return conf_.io_numa_node() % numa_node_num();
+}
+
+std::vector<int32_t> ThreadPlacement::Cpus4ActorThrdId(int64_t thrd_id) const {
+#if defined(WITH_CUDA) && defined(PLATFORM_POSIX)
+  const IDMgr* id_mgr = Global<IDMgr>::Get();
+  if (id_mgr->GetDeviceTypeFromThrdId(thrd_id) == DeviceType::kGPU) {
+    cpu_set_t cpu_set;
+    CudaDeviceGetCpuAffinity(id_mgr->GetGpuPhyIdFromThrdId(thrd_id), &cpu_set);
+    std::vector<int32_t> cpus;
+    for (const auto& node_cpus : node2cpus_) {
+      for (int32_t cpu : node_cpus) {
+        if (CPU_ISSET(cpu, &cpu_set)) { cpus.push_back(cpu); }
+      }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    if (!cpus.empty()) { return cpus; }
+  }
+#endif
+  return node2cpus_.at(NumaNode4ActorThrdId(thrd_id));
+}
+
+void ThreadPlacement::PinActorThread(int64_t thrd_id) const {
+  if (!conf_.enable_thread_pinning()) { return; }
+#ifdef PLATFORM_POSIX
+  const std::vector<int32_t> cpus = Cpus4ActorThrdId(thrd_id);
+  SetCpuAffinity(cpus);
+  LOG(INFO) << "actor thread " << thrd_id << " pinned to cpus " << FormatCpuList(cpus);
+#endif
+}
+
+void ThreadPlacement::PinIoThread() const {
+  if (!conf_.enable_thread_pinning()) { return; }
+#ifdef PLATFORM_POSIX
+  SetCpuAffinity(node2cpus_.at(conf_.io_numa_node() % numa_node_num()));
+#endif
+}
+
+void ThreadPlacement::PinThreadPool(ThreadPool* thread_pool) {
+  if (!conf_.enable_thread_pinning()) { return; }
+#ifdef PLATFORM_POSIX
+  CHECK(pinned_thread_pool_ == nullptr);
+  std::vector<int32_t> all_cpus;
+  for (const auto& cpus : node2cpus_) { all_cpus.insert(all_cpus.end(), cpus.begin(), cpus.end()); }
+  const int32_t thread_num = thread_pool->thread_num();
+  pool_thread2saved_cpus_.resize(thread_num);
+  BlockingCounter bc(thread_num);
+  FOR_RANGE(int32_t, i, 0, thread_num) {
+    const int32_t cpu = all_cpus.at(i % all_cpus.size());
+    std::vector<int32_t>* saved_cpus = &pool_thread2saved_cpus_.at(i);
+    thread_pool->AddWorkToThread(i, [cpu, saved_cpus, &bc]() {
+      *saved_cpus = GetAllowedCpus();
+      SetCpuAffinity({cpu});
+      bc.Decrease();
+    });
+  }
+  bc.WaitUntilCntEqualZero();
+  pinned_thread_pool_ = thread_pool;
+  all_cpus.resize(std::min<size_t>(all_cpus.size(), thread_num));
+  LOG(INFO) << thread_num << " compute threads pinned to cpus " << FormatCpuList(all_cpus);
+#endif
+}
+
+void ThreadPlacement::UnpinThreadPool() {
+  if (pinned_thread_pool_ == nullptr) { return; }
+#ifdef PLATFORM_POSIX
+  // the pool outlives the runtime, so that it must not stay pinned by the conf of this session
+  const int32_t thread_num = pinned_thread_pool_->thread_num();
+  BlockingCounter bc(thread_num);
+  FOR_RANGE(int32_t, i, 0, thread_num) {
+    const std::vector<int32_t>* saved_cpus = &pool_thread2saved_cpus_.at(i);
+    pinned_thread_pool_->AddWorkToThread(i, [saved_cpus, &bc]() {
+      SetCpuAffinity(*saved_cpus);
+      bc.Decrease();
+    });
+  }
+  bc.WaitUntilCntEqualZero();
+#endif
+  pinned_thread_pool_ = nullptr;
+  pool_thread2saved_cpus_.clear();
+}
+
+void ThreadPlacement::RunOnNumaNode4ActorThrdId(int64_t thrd_id,
+                                                const std::function<void()>& Handler) const {
+  if (!conf_.enable_numa_aware_host_malloc()) { return Handler(); }
+#ifdef PLATFORM_POSIX
+  cpu_set_t saved_cpu_set;
+  CHECK_EQ(sched_getaffinity(0, sizeof(cpu_set_t), &saved_cpu_set), 0);
+  SetCpuAffinity(node2cpus_.at(NumaNode4ActorThrdId(thrd_id)));
+  Handler();
+  CHECK_EQ(sched_setaffinity(0, sizeof(cpu_set_t), &saved_cpu_set), 0);
+#else
+  Handler();
+#endif
+}
+
+}  // namespace oneflow
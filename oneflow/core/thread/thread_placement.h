@@ -0,0 +1,73 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_THREAD_THREAD_PLACEMENT_H_
+#define ONEFLOW_CORE_THREAD_THREAD_PLACEMENT_H_
+
+#include "oneflow/core/common/util.h"
+#include "oneflow/core/job/resource.pb.h"
+
+namespace oneflow {
+
+class ThreadPool;
+
+// Places the threads of this process on the cpus by the numa topology of the machine:
+//   - a gpu actor thread runs on the cpus close to its device,
+//   - the cpu actor threads are spread over the numa nodes,
+//   - the comm net pollers, the comm net actor thread and the persistence actor threads (record
+//     loading, foreign io, ticks) run on `io_numa_node`,
+//   - every compute thread is pinned to one cpu, filling the numa nodes in order. The data
+//     decoding kernels run on the cpu actor threads and this pool, there are no other workers.
+// All the cpus the process is allowed to run on are regarded as one numa node if the topology
+// is unavailable.
+class ThreadPlacement final {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(ThreadPlacement);
+  explicit ThreadPlacement(const ThreadPlacementConf& conf);
+  // the pinned thread pool gets back its former affinity
+  ~ThreadPlacement();
+
+  int32_t numa_node_num() const { return node2cpus_.size(); }
+  int32_t NumaNode4ActorThrdId(int64_t thrd_id) const;
+
+  // Pin the calling thread, no-op if thread pinning is disabled
+  void PinActorThread(int64_t thrd_id) const;
+  void PinIoThread() const;
+  void PinThreadPool(ThreadPool* thread_pool);
+
+  // Runs `Handler` with the calling thread bound to the cpus of the numa node of actor thread
+  // `thrd_id` if numa aware host malloc is enabled, so that the pages first touched by `Handler`
+  // are allocated on that node.
+  void RunOnNumaNode4ActorThrdId(int64_t thrd_id, const std::function<void()>& Handler) const;
+
+ private:
+  std::vector<int32_t> Cpus4ActorThrdId(int64_t thrd_id) const;
+  void UnpinThreadPool();
+
+  ThreadPlacementConf conf_;
+  std::vector<int32_t> node_ids_;
+  std::vector<std::vector<int32_t>> node2cpus_;
+  ThreadPool* pinned_thread_pool_;
+  std::vector<std::vector<int32_t>> pool_thread2saved_cpus_;
+};
+
+// Parses the cpu list format of sysfs, e.g. "0-15,32-47"
+std::vector<int32_t> ParseCpuList(const std::string& cpu_list);
+// The inverse of ParseCpuList for sorted cpus
+std::string FormatCpuList(const std::vector<int32_t>& cpus);
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_THREAD_THREAD_PLACEMENT_H_
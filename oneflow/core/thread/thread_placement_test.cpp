@@ -0,0 +1,83 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/thread/thread_placement.h"
+#include "oneflow/core/thread/thread_pool.h"
+#include "oneflow/core/common/blocking_counter.h"
+#include "oneflow/core/common/platform.h"
+#ifdef PLATFORM_POSIX
+#include <sched.h>
+#endif
+
+namespace oneflow {
+
+TEST(ThreadPlacement, parse_cpu_list) {
+  ASSERT_EQ(ParseCpuList("0"), std::vector<int32_t>({0}));
+  ASSERT_EQ(ParseCpuList("0-3"), std::vector<int32_t>({0, 1, 2, 3}));
+  ASSERT_EQ(ParseCpuList("0-1,4,6-7\n"), std::vector<int32_t>({0, 1, 4, 6, 7}));
+  ASSERT_EQ(ParseCpuList("16-17,48-49"), std::vector<int32_t>({16, 17, 48, 49}));
+  ASSERT_TRUE(ParseCpuList("").empty());
+  ASSERT_TRUE(ParseCpuList("\n").empty());
+}
+
+TEST(ThreadPlacement, format_cpu_list) {
+  ASSERT_EQ(FormatCpuList({}), "");
+  ASSERT_EQ(FormatCpuList({3}), "3");
+  ASSERT_EQ(FormatCpuList({0, 1, 2, 3}), "0-3");
+  ASSERT_EQ(FormatCpuList({0, 1, 4, 6, 7}), "0-1,4,6-7");
+  ASSERT_EQ(FormatCpuList({1, 3, 5}), "1,3,5");
+  for (const std::string& cpu_list : {"0-15,32-47", "2,4-5,9", "7"}) {
+    ASSERT_EQ(FormatCpuList(ParseCpuList(cpu_list)), cpu_list);
+  }
+}
+
+#ifdef PLATFORM_POSIX
+
+namespace {
+
+std::vector<int32_t> GetThreadPoolCpuNums(ThreadPool* thread_pool) {
+  std::vector<int32_t> cpu_nums(thread_pool->thread_num());
+  BlockingCounter bc(thread_pool->thread_num());
+  FOR_RANGE(int32_t, i, 0, thread_pool->thread_num()) {
+    thread_pool->AddWorkToThread(i, [i, &cpu_nums, &bc]() {
+      cpu_set_t cpu_set;
+      CHECK_EQ(sched_getaffinity(0, sizeof(cpu_set_t), &cpu_set), 0);
+      cpu_nums.at(i) = CPU_COUNT(&cpu_set);
+      bc.Decrease();
+    });
+  }
+  bc.WaitUntilCntEqualZero();
+  return cpu_nums;
+}
+
+}  // namespace
+
+TEST(ThreadPlacement, unpin_thread_pool) {
+  ThreadPool thread_pool(2);
+  const std::vector<int32_t> cpu_nums = GetThreadPoolCpuNums(&thread_pool);
+  ThreadPlacementConf conf;
+  conf.set_enable_thread_pinning(true);
+  {
+    ThreadPlacement thread_placement(conf);
+    thread_placement.PinThreadPool(&thread_pool);
+    ASSERT_EQ(GetThreadPoolCpuNums(&thread_pool), std::vector<int32_t>({1, 1}));
+  }
+  // the destructor restores the affinity of the pool threads
+  ASSERT_EQ(GetThreadPoolCpuNums(&thread_pool), cpu_nums);
+}
+
+#endif
+
+}  // namespace oneflow
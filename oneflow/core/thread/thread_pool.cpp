@@ -41,4 +41,8 @@ void ThreadPool::AddWork(const std::function<void()>& work) {
   work_chans_.at(cur_chan_idx).Send(work);
 }
 
+void ThreadPool::AddWorkToThread(int32_t thread_idx, const std::function<void()>& work) {
+  work_chans_.at(thread_idx).Send(work);
+}
+
 }  // namespace oneflow
@@ -30,6 +30,8 @@ class ThreadPool final {
 
   int32_t thread_num() const { return threads_.size(); }
   void AddWork(const std::function<void()>& work);
+  // Runs `work` on the `thread_idx`-th thread of the pool, e.g. to set up the thread itself
+  void AddWorkToThread(int32_t thread_idx, const std::function<void()>& work);
 
  private:
   std::vector<Channel<std::function<void()>>> work_chans_;
@@ -62,6 +62,36 @@ TEST(HostStreamType, basic) {
   ASSERT_TRUE(instruction == nullptr);
 }
 
+TEST(HostStreamType, preschedule) {
+  auto vm_desc = ObjectMsgPtr<VmDesc>::New(TestUtil::NewVmResourceDesc().Get());
+  TestUtil::AddStreamDescByInstrNames(vm_desc.Mutable(), {"NewObject", "Malloc"});
+  auto vm = ObjectMsgPtr<VirtualMachine>::New(vm_desc.Get());
+  InstructionMsgList list;
+  int64_t object_id = TestUtil::NewObject(&list, "cpu", "0:0");
+  FOR_RANGE(int, i, 0, 4) {
+    list.EmplaceBack(
+        NewInstruction("CudaMallocHost")->add_mut_operand(object_id)->add_int64_operand(1024));
+    list.EmplaceBack(NewInstruction("CudaFreeHost")->add_mut_operand(object_id));
+  }
+  vm->Receive(&list);
+  int64_t max_prescheduled_instruction_cnt = 0;
+  int64_t schedule_cnt = 0;
+  while (!vm->Empty()) {
+    vm->Schedule();
+    ++schedule_cnt;
+    max_prescheduled_instruction_cnt =
+        std::max(max_prescheduled_instruction_cnt, vm->prescheduled_instruction_cnt());
+    OBJECT_MSG_LIST_FOR_EACH_PTR(vm->mut_thread_ctx_list(), t) { t->TryReceiveAndRun(); }
+  }
+  // the malloc/free chain on the same stream is dispatched in one Schedule(): the first
+  // instruction once the object is created, and the other 7 right behind it. Dispatching one
+  // link per Schedule() would take 8 rounds for the chain alone.
+  ASSERT_EQ(max_prescheduled_instruction_cnt, 7);
+  ASSERT_LT(schedule_cnt, 8);
+  ASSERT_EQ(vm->waiting_instruction_list().size(), 0);
+  ASSERT_EQ(vm->active_stream_list().size(), 0);
+}
+
 TEST(HostStreamType, two_device) {
   int64_t parallel_num = 2;
   auto vm_desc = ObjectMsgPtr<VmDesc>::New(TestUtil::NewVmResourceDesc().Get());
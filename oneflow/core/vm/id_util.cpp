@@ -73,6 +73,11 @@ bool IdUtil::IsObjectId(int64_t object_id) { return object_id < kObjectIdMaximum
 
 bool IdUtil::IsSymbolId(int64_t symbol_id) { return symbol_id > kObjectIdMaximumValue; }
 
+int64_t IdUtil::GetValueSymbolIndex(int64_t symbol_id) {
+  if (!IsSymbolId(symbol_id)) { return -1; }
+  return (symbol_id - kObjectIdMaximumValue) / kMachineNumberLimit - 1;
+}
+
 int64_t IdUtil::GetTypeId(int64_t id) {
   if (IsTypeId(id)) { return id; }
   return -id;
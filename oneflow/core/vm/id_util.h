@@ -49,6 +49,10 @@ struct IdUtil final {
   // type symbol id or value symbol id
   static bool IsSymbolId(int64_t symbol_id);
 
+  // index of the counter value which a value symbol id is generated from, -1 for other ids.
+  // The indices are dense since all the object ids and symbol ids share the same counter
+  static int64_t GetValueSymbolIndex(int64_t symbol_id);
+
   // type object id or type symbol id
   static int64_t GetTypeId(int64_t id);
   static bool IsTypeId(int64_t id);
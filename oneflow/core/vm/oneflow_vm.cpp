@@ -13,23 +13,127 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 */
+#include <chrono>
 #include "oneflow/core/vm/oneflow_vm.h"
 
 namespace oneflow {
 
+namespace {
+
+// instructions completed asynchronously by devices (e.g. cuda events) wake nobody up,
+// the scheduler polls them at this interval while the vm is not empty
+constexpr std::chrono::microseconds kDonePollInterval(50);
+
+}  // namespace
+
 OneflowVM::OneflowVM(const Resource& resource, int64_t this_machine_id)
-    : vm_(ObjectMsgPtr<vm::VirtualMachine>::New(vm::MakeVmDesc(resource, this_machine_id).Get())) {
+    : OneflowVM(vm::MakeVmDesc(resource, this_machine_id).Get()) {}
+
+OneflowVM::OneflowVM(const vm::VmDesc& vm_desc)
+    : vm_(ObjectMsgPtr<vm::VirtualMachine>::New(vm_desc)),
+      received_seq_(0),
+      done_seq_(0),
+      stream_thread_run_cnt_(0),
+      exiting_(false) {
   OBJECT_MSG_LIST_UNSAFE_FOR_EACH_PTR(vm_->mut_thread_ctx_list(), thread_ctx) {
-    auto thread_pool = std::make_unique<ThreadPool>(1);
-    CHECK(thread_ctx2thread_pool_.emplace(thread_ctx, std::move(thread_pool)).second);
+    // blocks on the pending instruction list of thread_ctx until it is closed
+    stream_threads_.emplace_back(
+        [this, thread_ctx]() { thread_ctx->LoopRun([this]() { NotifyStreamThreadRun(); }); });
+  }
+  schedule_thread_ = std::thread(&OneflowVM::ScheduleLoop, this);
+}
+
+OneflowVM::~OneflowVM() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    exiting_ = true;
+  }
+  schedule_cond_.notify_one();
+  schedule_thread_.join();
+  OBJECT_MSG_LIST_UNSAFE_FOR_EACH_PTR(vm_->mut_thread_ctx_list(), thread_ctx) {
+    thread_ctx->mut_pending_instruction_list()->Close();
+  }
+  for (std::thread& stream_thread : stream_threads_) { stream_thread.join(); }
+}
+
+int64_t OneflowVM::Receive(vm::VirtualMachine::InstructionMsgList* instr_msg_list) {
+  int64_t received_seq = 0;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    CHECK(!exiting_);
+    vm_->Receive(instr_msg_list);
+    received_seq = ++received_seq_;
+  }
+  schedule_cond_.notify_one();
+  return received_seq;
+}
+
+void OneflowVM::WaitUntilDone(int64_t received_seq) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_cond_.wait(lock, [&]() { return done_seq_ >= received_seq; });
+}
+
+bool OneflowVM::IsDone(int64_t received_seq) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return done_seq_ >= received_seq;
+}
+
+void OneflowVM::AddDoneCallback(int64_t received_seq, const std::function<void()>& Callback) {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (done_seq_ < received_seq) {
+      received_seq2done_callbacks_.emplace(received_seq, Callback);
+      return;
+    }
+  }
+  Callback();
+}
+
+void OneflowVM::NotifyStreamThreadRun() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++stream_thread_run_cnt_;
   }
+  schedule_cond_.notify_one();
 }
 
-void OneflowVM::TryReceiveAndRun() {
-  for (auto& pair : thread_ctx2thread_pool_) {
-    vm::ThreadCtx* thread_ctx = pair.first;
-    if (thread_ctx->mut_pending_instruction_list()->Empty()) { continue; }
-    pair.second->AddWork([thread_ctx]() { thread_ctx->TryReceiveAndRun(); });
+void OneflowVM::ScheduleLoop() {
+  vm::VirtualMachine* vm = vm_.Mutable();
+  while (true) {
+    int64_t received_seq = 0;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      received_seq = received_seq_;
+    }
+    if (!vm->Empty()) {
+      vm->Schedule();
+      // sleep until a stream thread has run instructions or new instructions are received.
+      // runs counted during Schedule() wake up immediately, so no notification is lost
+      std::unique_lock<std::mutex> lock(mutex_);
+      schedule_cond_.wait_for(lock, kDonePollInterval, [&]() {
+        return stream_thread_run_cnt_ > 0 || received_seq_ != received_seq;
+      });
+      stream_thread_run_cnt_ = 0;
+      continue;
+    }
+    // all the instructions received no later than received_seq are done
+    std::vector<std::function<void()>> callbacks;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      done_seq_ = received_seq;
+      auto end = received_seq2done_callbacks_.upper_bound(done_seq_);
+      for (auto it = received_seq2done_callbacks_.begin(); it != end; ++it) {
+        callbacks.push_back(it->second);
+      }
+      received_seq2done_callbacks_.erase(received_seq2done_callbacks_.begin(), end);
+      done_cond_.notify_all();
+      if (callbacks.empty()) {
+        // idle, sleep until new instructions are received instead of polling
+        schedule_cond_.wait(lock, [&]() { return received_seq_ != received_seq || exiting_; });
+        if (received_seq_ == received_seq) { break; }
+      }
+    }
+    for (const auto& Callback : callbacks) { Callback(); }
   }
 }
 
@@ -16,31 +16,50 @@ limitations under the License.
 #ifndef ONEFLOW_CORE_VM_ONEFLOW_VM_H_
 #define ONEFLOW_CORE_VM_ONEFLOW_VM_H_
 
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 #include "oneflow/core/vm/interpret_type.h"
 #include "oneflow/core/vm/vm_desc.msg.h"
 #include "oneflow/core/vm/virtual_machine.msg.h"
-#include "oneflow/core/thread/thread_pool.h"
 
 namespace oneflow {
 
-namespace vm {
-
-class ThreadCtx;
-}
-
 class OneflowVM final {
  public:
   OneflowVM(const OneflowVM&) = delete;
   OneflowVM(OneflowVM&&) = delete;
   OneflowVM(const Resource& resource, int64_t this_machine_id);
-  ~OneflowVM() = default;
+  explicit OneflowVM(const vm::VmDesc& vm_desc);
+  ~OneflowVM();
 
-  vm::VirtualMachine* mut_vm() { return vm_.Mutable(); }
-  void TryReceiveAndRun();
+  // the instructions are scheduled on a dedicated thread, Receive returns without waiting for them.
+  // the returned sequence number identifies this batch of instructions
+  int64_t Receive(vm::VirtualMachine::InstructionMsgList* instr_msg_list);
+  // blocks until all the instructions received no later than received_seq are done
+  void WaitUntilDone(int64_t received_seq);
+  // returns immediately, true if all the instructions received no later than received_seq are done
+  bool IsDone(int64_t received_seq);
+  // Callback is called on the scheduler thread once received_seq is done
+  void AddDoneCallback(int64_t received_seq, const std::function<void()>& Callback);
 
  private:
+  void ScheduleLoop();
+  void NotifyStreamThreadRun();
+
   ObjectMsgPtr<vm::VirtualMachine> vm_;
-  HashMap<vm::ThreadCtx*, std::unique_ptr<ThreadPool>> thread_ctx2thread_pool_;
+  std::vector<std::thread> stream_threads_;
+  std::thread schedule_thread_;
+
+  std::mutex mutex_;
+  // notified on new instructions received and on instructions run by the stream threads
+  std::condition_variable schedule_cond_;
+  std::condition_variable done_cond_;
+  int64_t received_seq_;
+  int64_t done_seq_;
+  int64_t stream_thread_run_cnt_;
+  bool exiting_;
+  std::multimap<int64_t, std::function<void()>> received_seq2done_callbacks_;
 };
 
 }  // namespace oneflow
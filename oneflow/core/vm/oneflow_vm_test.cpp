@@ -0,0 +1,78 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include <atomic>
+#include "oneflow/core/vm/oneflow_vm.h"
+#include "oneflow/core/vm/vm_util.h"
+#include "oneflow/core/vm/instruction.msg.h"
+#include "oneflow/core/vm/vm_desc.msg.h"
+#include "oneflow/core/vm/test_util.h"
+#include "oneflow/core/common/util.h"
+
+namespace oneflow {
+namespace vm {
+
+namespace test {
+
+namespace {
+
+using InstructionMsgList = OBJECT_MSG_LIST(InstructionMsg, instr_msg_link);
+
+int64_t ReceiveNops(OneflowVM* oneflow_vm, int64_t nop_num) {
+  InstructionMsgList list;
+  FOR_RANGE(int64_t, i, 0, nop_num) { list.EmplaceBack(NewInstruction("Nop")); }
+  return oneflow_vm->Receive(&list);
+}
+
+}  // namespace
+
+TEST(OneflowVM, submit_without_waiting) {
+  auto vm_desc = ObjectMsgPtr<VmDesc>::New(TestUtil::NewVmResourceDesc().Get());
+  TestUtil::AddStreamDescByInstrNames(vm_desc.Mutable(), {"Nop"});
+  OneflowVM oneflow_vm(vm_desc.Get());
+  std::atomic<int64_t> done_cnt(0);
+  int64_t first_seq = ReceiveNops(&oneflow_vm, 16);
+  oneflow_vm.AddDoneCallback(first_seq, [&]() { ++done_cnt; });
+  int64_t last_seq = 0;
+  FOR_RANGE(int, i, 0, 8) { last_seq = ReceiveNops(&oneflow_vm, 16); }
+  ASSERT_GT(last_seq, first_seq);
+  oneflow_vm.AddDoneCallback(last_seq, [&]() { ++done_cnt; });
+  oneflow_vm.WaitUntilDone(last_seq);
+  // waiting on a later sequence number covers all the earlier ones
+  ASSERT_TRUE(oneflow_vm.IsDone(first_seq));
+  ASSERT_TRUE(oneflow_vm.IsDone(last_seq));
+  // callbacks are called on the scheduler thread after done_seq is published
+  while (done_cnt < 2) { std::this_thread::yield(); }
+  // callbacks added after done are called at once
+  oneflow_vm.AddDoneCallback(first_seq, [&]() { ++done_cnt; });
+  ASSERT_EQ(done_cnt, 3);
+}
+
+TEST(OneflowVM, idle_after_done) {
+  auto vm_desc = ObjectMsgPtr<VmDesc>::New(TestUtil::NewVmResourceDesc().Get());
+  TestUtil::AddStreamDescByInstrNames(vm_desc.Mutable(), {"Nop"});
+  OneflowVM oneflow_vm(vm_desc.Get());
+  FOR_RANGE(int, i, 0, 4) {
+    int64_t seq = ReceiveNops(&oneflow_vm, 1);
+    oneflow_vm.WaitUntilDone(seq);
+    ASSERT_TRUE(oneflow_vm.IsDone(seq));
+    ASSERT_FALSE(oneflow_vm.IsDone(seq + 1));
+  }
+}
+
+}  // namespace test
+
+}  // namespace vm
+}  // namespace oneflow
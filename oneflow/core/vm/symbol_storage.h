@@ -16,9 +16,12 @@ limitations under the License.
 #ifndef ONEFLOW_CORE_VM_STORAGE_H_
 #define ONEFLOW_CORE_VM_STORAGE_H_
 
+#include <array>
+#include <atomic>
 #include <mutex>
 #include "oneflow/core/common/util.h"
 #include "oneflow/core/common/maybe.h"
+#include "oneflow/core/vm/id_util.h"
 
 namespace oneflow {
 
@@ -40,20 +43,28 @@ struct ConstructArgType4Symbol<OpNodeSignatureDesc> final {
   using type = OpNodeSignature;
 };
 
+template<>
+struct ConstructArgType4Symbol<ParallelDesc> final {
+  using type = ParallelConf;
+};
+
 template<typename T>
 class SymbolStorage final {
  public:
+  using ConstructArgType = typename ConstructArgType4Symbol<T>::type;
+
   SymbolStorage(const SymbolStorage&) = delete;
   SymbolStorage(SymbolStorage&&) = delete;
 
-  SymbolStorage() = default;
-  ~SymbolStorage() = default;
-
-  bool Has(int64_t logical_object_id) const {
-    std::unique_lock<std::mutex> lock(mutex_);
-    return logical_object_id2data_.find(logical_object_id) != logical_object_id2data_.end();
+  SymbolStorage() {
+    for (auto& chunk : chunks_) { chunk.store(nullptr, std::memory_order_relaxed); }
+  }
+  ~SymbolStorage() {
+    for (auto& chunk : chunks_) { delete[] chunk.load(std::memory_order_relaxed); }
   }
 
+  bool Has(int64_t logical_object_id) const { return FindPtr(logical_object_id) != nullptr; }
+
   Maybe<const T*> MaybeGet(int64_t logical_object_id) const {
     return JUST(MaybeGetPtr(logical_object_id)).get();
   }
@@ -61,38 +72,152 @@ class SymbolStorage final {
   const T& Get(int64_t logical_object_id) const { return *GetPtr(logical_object_id); }
 
   Maybe<T> MaybeGetPtr(int64_t logical_object_id) const {
-    std::unique_lock<std::mutex> lock(mutex_);
-    const auto& iter = logical_object_id2data_.find(logical_object_id);
-    CHECK_OR_RETURN(iter != logical_object_id2data_.end())
-        << "logical_object_id: " << logical_object_id;
-    return iter->second;
+    const auto* ptr = FindPtr(logical_object_id);
+    CHECK_OR_RETURN(ptr != nullptr) << "logical_object_id: " << logical_object_id;
+    return *ptr;
   }
 
   const std::shared_ptr<T>& GetPtr(int64_t logical_object_id) const {
-    std::unique_lock<std::mutex> lock(mutex_);
-    const auto& iter = logical_object_id2data_.find(logical_object_id);
-    CHECK(iter != logical_object_id2data_.end());
-    return iter->second;
+    const auto* ptr = FindPtr(logical_object_id);
+    CHECK(ptr != nullptr) << "logical_object_id: " << logical_object_id;
+    return *ptr;
   }
 
-  void Add(int64_t logical_object_id, const typename ConstructArgType4Symbol<T>::type& data) {
+  void Add(int64_t logical_object_id, const ConstructArgType& data) {
     CHECK_GT(logical_object_id, 0);
     const auto& ptr = std::make_shared<T>(data);
     std::unique_lock<std::mutex> lock(mutex_);
-    CHECK(logical_object_id2data_.emplace(logical_object_id, ptr).second);
+    AddWithLockHeld(logical_object_id, ptr);
+  }
+  // Symbols are constructed before the lock is taken, and the lock is taken only once for all
+  // of them.
+  void BatchAdd(const std::vector<std::pair<int64_t, const ConstructArgType*>>& id7data) {
+    std::vector<std::shared_ptr<T>> ptrs;
+    ptrs.reserve(id7data.size());
+    for (const auto& pair : id7data) {
+      CHECK_GT(pair.first, 0);
+      ptrs.push_back(std::make_shared<T>(*pair.second));
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    FOR_RANGE(int64_t, i, 0, id7data.size()) { AddWithLockHeld(id7data.at(i).first, ptrs.at(i)); }
   }
+  // A symbol must not be cleared while it's being read.
   void Clear(int64_t logical_object_id) {
     std::unique_lock<std::mutex> lock(mutex_);
-    logical_object_id2data_.erase(logical_object_id);
+    Slot* slot = MutSlot(logical_object_id);
+    if (slot != nullptr && slot->symbol_id.load(std::memory_order_relaxed) == logical_object_id) {
+      slot->symbol_id.store(0, std::memory_order_release);
+      slot->data.reset();
+      --size_;
+    } else if (logical_object_id2data_.erase(logical_object_id) > 0) {
+      map_size_.store(logical_object_id2data_.size(), std::memory_order_release);
+      --size_;
+    }
   }
   void ClearAll() {
     std::unique_lock<std::mutex> lock(mutex_);
+    for (auto& chunk : chunks_) {
+      Slot* slots = chunk.load(std::memory_order_relaxed);
+      if (slots == nullptr) { continue; }
+      FOR_RANGE(int64_t, i, 0, kChunkSize) {
+        slots[i].symbol_id.store(0, std::memory_order_release);
+        slots[i].data.reset();
+      }
+    }
     logical_object_id2data_.clear();
+    map_size_.store(0, std::memory_order_release);
+    size_ = 0;
+  }
+
+  // Number of the stored symbols
+  size_t size() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return size_;
+  }
+  // Bytes held by the table and the symbol objects, the heap memory owned by the symbol objects
+  // is not counted.
+  size_t ByteSize() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    size_t byte_size = sizeof(*this) + size_ * sizeof(T);
+    for (const auto& chunk : chunks_) {
+      if (chunk.load(std::memory_order_relaxed) == nullptr) { continue; }
+      byte_size += sizeof(Slot) * kChunkSize;
+    }
+    using MapEntry = std::pair<int64_t, std::shared_ptr<T>>;
+    return byte_size + logical_object_id2data_.size() * sizeof(MapEntry);
   }
 
  private:
+  // Symbol ids are generated from a dense counter, so the symbols are stored in slots indexed by
+  // the counter value. The slots are allocated by chunks which are never moved or freed before
+  // destruction, so readers find a symbol without taking any lock. A slot is published by the
+  // release store of its `symbol_id` after `data` is set. Ids out of the range of the slots, and
+  // ids whose slot is taken by another id (the index drops the machine bits of the ids), are kept
+  // in `logical_object_id2data_` instead.
+  static const int64_t kChunkSize = 4096;
+  static const int64_t kMaxChunkNum = 4096;
+
+  struct Slot {
+    std::atomic<int64_t> symbol_id{0};
+    std::shared_ptr<T> data;
+  };
+
+  const std::shared_ptr<T>* FindPtr(int64_t logical_object_id) const {
+    int64_t index = IdUtil::GetValueSymbolIndex(logical_object_id);
+    if (index >= 0 && index < kChunkSize * kMaxChunkNum) {
+      const Slot* slots = chunks_[index / kChunkSize].load(std::memory_order_acquire);
+      if (slots != nullptr) {
+        const Slot& slot = slots[index % kChunkSize];
+        if (slot.symbol_id.load(std::memory_order_acquire) == logical_object_id) {
+          return &slot.data;
+        }
+      }
+      // the lock is not taken unless some id has been kept in the map
+      if (map_size_.load(std::memory_order_acquire) == 0) { return nullptr; }
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    const auto& iter = logical_object_id2data_.find(logical_object_id);
+    if (iter == logical_object_id2data_.end()) { return nullptr; }
+    return &iter->second;
+  }
+
+  // Returns nullptr if `logical_object_id` is out of the range of the slots.
+  Slot* MutSlot(int64_t logical_object_id) {
+    int64_t index = IdUtil::GetValueSymbolIndex(logical_object_id);
+    if (index < 0 || index >= kChunkSize * kMaxChunkNum) { return nullptr; }
+    auto* chunk = &chunks_[index / kChunkSize];
+    Slot* slots = chunk->load(std::memory_order_relaxed);
+    if (slots == nullptr) {
+      slots = new Slot[kChunkSize];
+      chunk->store(slots, std::memory_order_release);
+    }
+    return &slots[index % kChunkSize];
+  }
+
+  void AddWithLockHeld(int64_t logical_object_id, const std::shared_ptr<T>& ptr) {
+    Slot* slot = MutSlot(logical_object_id);
+    const int64_t slot_symbol_id =
+        slot == nullptr ? 0 : slot->symbol_id.load(std::memory_order_relaxed);
+    CHECK_NE(slot_symbol_id, logical_object_id) << "logical_object_id: " << logical_object_id;
+    if (slot != nullptr && slot_symbol_id == 0
+        && logical_object_id2data_.count(logical_object_id) == 0) {
+      slot->data = ptr;
+      slot->symbol_id.store(logical_object_id, std::memory_order_release);
+    } else {
+      CHECK(logical_object_id2data_.emplace(logical_object_id, ptr).second)
+          << "logical_object_id: " << logical_object_id;
+      map_size_.store(logical_object_id2data_.size(), std::memory_order_release);
+    }
+    ++size_;
+  }
+
+  // Guards the writers, and the readers of `logical_object_id2data_`
   mutable std::mutex mutex_;
+  std::array<std::atomic<Slot*>, kMaxChunkNum> chunks_;
   HashMap<int64_t, std::shared_ptr<T>> logical_object_id2data_;
+  // size of `logical_object_id2data_` for the readers not holding the lock
+  std::atomic<size_t> map_size_{0};
+  size_t size_ = 0;
 };
 
 }  // namespace vm
@@ -0,0 +1,96 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include <thread>
+#include "oneflow/core/vm/symbol_storage.h"
+#include "oneflow/core/vm/id_util.h"
+
+namespace oneflow {
+namespace vm {
+namespace test {
+
+TEST(SymbolStorage, add_get_clear) {
+  SymbolStorage<std::string> storage;
+  int64_t symbol_id = IdUtil::NewLogicalSymbolId();
+  ASSERT_GE(IdUtil::GetValueSymbolIndex(symbol_id), 0);
+  ASSERT_FALSE(storage.Has(symbol_id));
+  storage.Add(symbol_id, "foobar");
+  ASSERT_TRUE(storage.Has(symbol_id));
+  ASSERT_EQ(storage.Get(symbol_id), "foobar");
+  ASSERT_EQ(storage.size(), 1);
+  storage.Clear(symbol_id);
+  ASSERT_FALSE(storage.Has(symbol_id));
+  ASSERT_EQ(storage.size(), 0);
+}
+
+TEST(SymbolStorage, out_of_dense_range) {
+  SymbolStorage<std::string> storage;
+  // not generated from the id counter, kept in the fallback map
+  int64_t symbol_id = 9527;
+  ASSERT_EQ(IdUtil::GetValueSymbolIndex(symbol_id), -1);
+  storage.Add(symbol_id, "foobar");
+  ASSERT_EQ(storage.Get(symbol_id), "foobar");
+  ASSERT_TRUE(CHECK_JUST(storage.MaybeGet(symbol_id)) != nullptr);
+  ASSERT_FALSE(storage.MaybeGet(symbol_id + 1).IsOk());
+}
+
+TEST(SymbolStorage, slot_taken_by_another_machine) {
+  SymbolStorage<std::string> storage;
+  int64_t symbol_id = IdUtil::NewLogicalSymbolId();
+  // differs from `symbol_id` only in the machine bits, so both ids share one slot
+  int64_t other_symbol_id = symbol_id - 1;
+  ASSERT_EQ(IdUtil::GetValueSymbolIndex(other_symbol_id), IdUtil::GetValueSymbolIndex(symbol_id));
+  storage.Add(symbol_id, "foo");
+  storage.Add(other_symbol_id, "bar");
+  ASSERT_EQ(storage.size(), 2);
+  ASSERT_EQ(storage.Get(symbol_id), "foo");
+  ASSERT_EQ(storage.Get(other_symbol_id), "bar");
+  storage.Clear(symbol_id);
+  ASSERT_FALSE(storage.Has(symbol_id));
+  ASSERT_EQ(storage.Get(other_symbol_id), "bar");
+  storage.Clear(other_symbol_id);
+  ASSERT_FALSE(storage.Has(other_symbol_id));
+  ASSERT_EQ(storage.size(), 0);
+}
+
+TEST(SymbolStorage, batch_add_and_concurrent_get) {
+  SymbolStorage<std::string> storage;
+  std::vector<std::string> strs;
+  std::vector<int64_t> symbol_ids;
+  FOR_RANGE(int64_t, i, 0, 10000) {
+    strs.push_back(std::to_string(i));
+    symbol_ids.push_back(IdUtil::NewLogicalSymbolId());
+  }
+  std::vector<std::pair<int64_t, const std::string*>> batch;
+  FOR_RANGE(int64_t, i, 0, strs.size()) { batch.emplace_back(symbol_ids.at(i), &strs.at(i)); }
+  storage.BatchAdd(batch);
+  ASSERT_EQ(storage.size(), strs.size());
+  ASSERT_GT(storage.ByteSize(), strs.size() * sizeof(std::string));
+  std::vector<std::thread> threads;
+  std::atomic<int64_t> mismatch_cnt(0);
+  FOR_RANGE(int64_t, t, 0, 4) {
+    threads.emplace_back([&]() {
+      FOR_RANGE(int64_t, i, 0, strs.size()) {
+        if (storage.Get(symbol_ids.at(i)) != strs.at(i)) { ++mismatch_cnt; }
+      }
+    });
+  }
+  for (auto& thread : threads) { thread.join(); }
+  ASSERT_EQ(mismatch_cnt, 0);
+}
+
+}  // namespace test
+}  // namespace vm
+}  // namespace oneflow
@@ -29,6 +29,8 @@ OBJECT_MSG_BEGIN(ThreadCtx);
     set_stream_rt_desc(&stream_rt_desc);
   }
   OF_PUBLIC void LoopRun();
+  // AfterRun is called every time a batch of instructions has been run
+  OF_PUBLIC void LoopRun(const std::function<void()>& AfterRun);
   // fields
   OBJECT_MSG_DEFINE_PTR(const StreamRtDesc, stream_rt_desc); 
 
@@ -37,6 +39,8 @@ OBJECT_MSG_BEGIN(ThreadCtx);
   OBJECT_MSG_DEFINE_LIST_HEAD(Stream, thread_ctx_stream_link, stream_list);
   OBJECT_MSG_DEFINE_CONDITION_LIST_HEAD(Instruction, pending_instruction_link,
                                         pending_instruction_list);
+  // only accessed by the scheduler thread, moved to pending_instruction_list in one batch
+  OBJECT_MSG_DEFINE_LIST_HEAD(Instruction, pending_instruction_link, dispatched_instruction_list);
 
   OF_PRIVATE ObjectMsgConditionListStatus ReceiveAndRun();
   OF_PUBLIC ObjectMsgConditionListStatus TryReceiveAndRun();
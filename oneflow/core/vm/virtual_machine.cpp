@@ -318,22 +318,35 @@ void VirtualMachine::FilterReadyInstructions(NewInstructionList* new_instruction
 
 void VirtualMachine::DispatchAndPrescheduleInstructions(
     ReadyInstructionList* ready_instruction_list) {
-  PrescheduledInstructionList prescheduled;
+  int64_t prescheduled_instruction_cnt = 0;
   auto* active_stream_list = mut_active_stream_list();
-  OBJECT_MSG_LIST_FOR_EACH_PTR(ready_instruction_list, instruction) {
-    auto* stream = instruction->mut_stream();
-    ready_instruction_list->MoveToDstBack(instruction, stream->mut_running_instruction_list());
-    if (stream->is_active_stream_link_empty()) { active_stream_list->PushBack(stream); }
-    const auto& stream_type = stream->stream_type();
-    if (stream_type.SharingVirtualMachineThread()) {
-      stream_type.Run(this, instruction);
-    } else {
-      stream->mut_thread_ctx()->mut_pending_instruction_list()->PushBack(instruction);
+  // a stream runs its instructions in order, so an instruction only waiting for instructions on
+  // the same stream is dispatched right after them instead of in the next Schedule()
+  while (!ready_instruction_list->empty()) {
+    PrescheduledInstructionList prescheduled;
+    OBJECT_MSG_LIST_FOR_EACH_PTR(ready_instruction_list, instruction) {
+      auto* stream = instruction->mut_stream();
+      ready_instruction_list->MoveToDstBack(instruction, stream->mut_running_instruction_list());
+      if (stream->is_active_stream_link_empty()) { active_stream_list->PushBack(stream); }
+      const auto& stream_type = stream->stream_type();
+      if (stream_type.SharingVirtualMachineThread()) {
+        stream_type.Run(this, instruction);
+      } else {
+        stream->mut_thread_ctx()->mut_dispatched_instruction_list()->PushBack(instruction);
+      }
+      TryMoveWaitingToReady(instruction, &prescheduled,
+                            [stream](Instruction* dst) { return &dst->stream() == stream; });
     }
-    TryMoveWaitingToReady(instruction, &prescheduled,
-                          [stream](Instruction* dst) { return &dst->stream() == stream; });
+    prescheduled_instruction_cnt += prescheduled.size();
+    prescheduled.MoveTo(ready_instruction_list);
+  }
+  // wake up each thread once for all the instructions dispatched to it
+  OBJECT_MSG_LIST_FOR_EACH_PTR(mut_thread_ctx_list(), thread_ctx) {
+    auto* dispatched_instruction_list = thread_ctx->mut_dispatched_instruction_list();
+    if (dispatched_instruction_list->empty()) { continue; }
+    thread_ctx->mut_pending_instruction_list()->MoveFrom(dispatched_instruction_list);
   }
-  prescheduled.MoveTo(ready_instruction_list);
+  set_prescheduled_instruction_cnt(prescheduled_instruction_cnt);
 }
 
 template<typename ReadyList, typename IsEdgeReadyT>
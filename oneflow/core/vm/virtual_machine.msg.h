@@ -52,6 +52,9 @@ OBJECT_MSG_BEGIN(VirtualMachine);
   OBJECT_MSG_DEFINE_OPTIONAL(VmResourceDesc, vm_resource_desc);
   OBJECT_MSG_DEFINE_STRUCT(Range, machine_id_range);
   OBJECT_MSG_DEFINE_PTR(ObjectMsgAllocator, vm_thread_only_allocator);
+  // the number of instructions dispatched together with the instructions they depend on in the
+  // last Schedule()
+  OBJECT_MSG_DEFINE_OPTIONAL(int64_t, prescheduled_instruction_cnt);
 
   //links
   OBJECT_MSG_DEFINE_MUTEXED_LIST_HEAD(InstructionMsg, instr_msg_link, pending_msg_list);
@@ -41,20 +41,26 @@ Maybe<void> Run(const std::string& instruction_list_str) {
 }
 
 Maybe<void> Run(const InstructionListProto& instruction_list_proto) {
+  return WaitUntilDone(JUST(Submit(instruction_list_proto)));
+}
+
+Maybe<int64_t> Submit(const InstructionListProto& instruction_list_proto) {
   InstructionMsgList instr_msg_list;
   for (const auto& instr_proto : instruction_list_proto.instruction()) {
     auto instr_msg = ObjectMsgPtr<InstructionMsg>::New(instr_proto);
     instr_msg_list.EmplaceBack(std::move(instr_msg));
   }
-  auto* oneflow_vm = JUST(GlobalMaybe<OneflowVM>());
-  auto* vm = oneflow_vm->mut_vm();
-  vm->Receive(&instr_msg_list);
-  while (!vm->Empty()) {
-    vm->Schedule();
-    oneflow_vm->TryReceiveAndRun();
-  }
+  return JUST(GlobalMaybe<OneflowVM>())->Receive(&instr_msg_list);
+}
+
+Maybe<void> WaitUntilDone(int64_t submitted_seq) {
+  JUST(GlobalMaybe<OneflowVM>())->WaitUntilDone(submitted_seq);
   return Maybe<void>::Ok();
 }
 
+Maybe<bool> IsDone(int64_t submitted_seq) {
+  return JUST(GlobalMaybe<OneflowVM>())->IsDone(submitted_seq);
+}
+
 }  // namespace vm
 }  // namespace oneflow
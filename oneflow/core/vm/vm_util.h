@@ -30,6 +30,11 @@ ObjectMsgPtr<InstructionMsg> NewInstruction(const std::string& instr_type_name);
 Maybe<void> Run(const std::string& instruction_list_proto_str);
 Maybe<void> Run(const InstructionListProto& instruction_list_proto);
 
+// returns without waiting for the instructions, the returned sequence number is for WaitUntilDone
+Maybe<int64_t> Submit(const InstructionListProto& instruction_list_proto);
+Maybe<void> WaitUntilDone(int64_t submitted_seq);
+Maybe<bool> IsDone(int64_t submitted_seq);
+
 }  // namespace vm
 }  // namespace oneflow
 
@@ -15,9 +15,106 @@ limitations under the License.
 */
 #include "oneflow/core/framework/framework.h"
 #include "oneflow/core/kernel/new_kernel_util.h"
+#include "oneflow/core/kernel/util/host_elementwise.h"
 
 namespace oneflow {
 
+namespace {
+
+// instances at least this large are sorted by radix sort, smaller ones by std::sort
+constexpr int32_t kMinRadixSortSize = 1024;
+constexpr int32_t kRadixBits = 8;
+constexpr int32_t kRadixSize = 1 << kRadixBits;
+
+// maps the values to unsigned keys of the same order
+template<typename T, typename Enable = void>
+struct RadixKeyTrait;
+
+template<typename T>
+struct RadixKeyTrait<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+  using KeyType = typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type;
+  static KeyType Key(T value) {
+    // -0.0 and 0.0 are equal, so they have to get the same key
+    if (value == 0) { value = 0; }
+    KeyType bits;
+    std::memcpy(&bits, &value, sizeof(T));
+    const KeyType sign_mask = static_cast<KeyType>(1) << (sizeof(T) * 8 - 1);
+    return (bits & sign_mask) ? ~bits : (bits | sign_mask);
+  }
+};
+
+template<typename T>
+struct RadixKeyTrait<T, typename std::enable_if<std::is_integral<T>::value>::type> {
+  using KeyType = typename std::make_unsigned<T>::type;
+  static KeyType Key(T value) {
+    const KeyType sign_mask = static_cast<KeyType>(1) << (sizeof(T) * 8 - 1);
+    return static_cast<KeyType>(value) ^ sign_mask;
+  }
+};
+
+// LSD radix sort of the indices of in_ptr[0, n). Every pass is stable, so equal values keep the
+// order of their indices, which is the same tie-breaking as the std::sort path. The passes whose
+// digit is the same for all the keys are skipped.
+template<typename T>
+void RadixArgSort(const T* in_ptr, int32_t n, bool is_descending,
+                  std::vector<typename RadixKeyTrait<T>::KeyType>* key_buf,
+                  std::vector<int32_t>* index_buf, int32_t* out_ptr) {
+  using KeyType = typename RadixKeyTrait<T>::KeyType;
+  key_buf->resize(2 * n);
+  index_buf->resize(n);
+  KeyType* keys = key_buf->data();
+  KeyType* keys_alt = key_buf->data() + n;
+  int32_t* indices = out_ptr;
+  int32_t* indices_alt = index_buf->data();
+  constexpr int32_t kPassNum = sizeof(KeyType) * 8 / kRadixBits;
+  std::vector<int32_t> histograms(kPassNum * kRadixSize, 0);
+  FOR_RANGE(int32_t, i, 0, n) {
+    const KeyType key = is_descending ? ~RadixKeyTrait<T>::Key(in_ptr[i])
+                                      : RadixKeyTrait<T>::Key(in_ptr[i]);
+    keys[i] = key;
+    indices[i] = i;
+    FOR_RANGE(int32_t, pass, 0, kPassNum) {
+      histograms[pass * kRadixSize + ((key >> (pass * kRadixBits)) & (kRadixSize - 1))] += 1;
+    }
+  }
+  FOR_RANGE(int32_t, pass, 0, kPassNum) {
+    int32_t* histogram = histograms.data() + pass * kRadixSize;
+    const int32_t shift = pass * kRadixBits;
+    if (histogram[(keys[0] >> shift) & (kRadixSize - 1)] == n) { continue; }
+    int32_t offset = 0;
+    FOR_RANGE(int32_t, d, 0, kRadixSize) {
+      const int32_t cnt = histogram[d];
+      histogram[d] = offset;
+      offset += cnt;
+    }
+    FOR_RANGE(int32_t, i, 0, n) {
+      const int32_t pos = histogram[(keys[i] >> shift) & (kRadixSize - 1)]++;
+      keys_alt[pos] = keys[i];
+      indices_alt[pos] = indices[i];
+    }
+    std::swap(keys, keys_alt);
+    std::swap(indices, indices_alt);
+  }
+  if (indices != out_ptr) { std::copy(indices, indices + n, out_ptr); }
+}
+
+template<typename T>
+void StdArgSort(const T* in_ptr, int32_t n, bool is_descending, int32_t* out_ptr) {
+  std::iota(out_ptr, out_ptr + n, 0);
+  auto comp = [&](const int32_t lhs, const int32_t rhs) {
+    const T l = in_ptr[lhs];
+    const T r = in_ptr[rhs];
+    if (l == r) {
+      return lhs < rhs;
+    } else {
+      return is_descending ? l > r : l < r;
+    }
+  };
+  std::sort(out_ptr, out_ptr + n, comp);
+}
+
+}  // namespace
+
 template<typename T>
 class CpuArgSortKernel final : public user_op::OpKernel {
  public:
@@ -32,29 +129,28 @@ class CpuArgSortKernel final : public user_op::OpKernel {
     const int32_t instance_size = in->shape().At(in->shape().NumAxes() - 1);
     const int32_t instance_num = in->shape().elem_cnt() / instance_size;
     const std::string& direction = ctx->Attr<std::string>("direction");
-    const bool is_ascending = direction == "ASCENDING";
+    CHECK(direction == "ASCENDING" || direction == "DESCENDING");
     const bool is_descending = direction == "DESCENDING";
-    FOR_RANGE(int32_t, i, 0, instance_num) {
-      const T* in_ptr_i = in->dptr<T>() + i * instance_size;
-      int32_t* out_ptr_i = out->mut_dptr<int32_t>() + i * instance_size;
-      std::iota(out_ptr_i, out_ptr_i + instance_size, 0);
-      auto comp = [&](const int32_t lhs, const int32_t rhs) {
-        const T l = in_ptr_i[lhs];
-        const T r = in_ptr_i[rhs];
-        if (l == r) {
-          return lhs < rhs;
-        } else {
-          if (is_ascending) {
-            return l < r;
-          } else if (is_descending) {
-            return l > r;
-          } else {
-            UNIMPLEMENTED();
+    const T* in_ptr = in->dptr<T>();
+    int32_t* out_ptr = out->mut_dptr<int32_t>();
+    // the instances are split across the thread pool, each thread keeps its own radix buffers
+    host_elementwise::ParallelFor(
+        static_cast<int64_t>(instance_num) * instance_size, [&](int64_t begin, int64_t end) {
+          const int32_t first = (begin + instance_size - 1) / instance_size;
+          const int32_t last = (end + instance_size - 1) / instance_size;
+          std::vector<typename RadixKeyTrait<T>::KeyType> key_buf;
+          std::vector<int32_t> index_buf;
+          FOR_RANGE(int32_t, i, first, last) {
+            const T* in_ptr_i = in_ptr + i * instance_size;
+            int32_t* out_ptr_i = out_ptr + i * instance_size;
+            if (instance_size >= kMinRadixSortSize) {
+              RadixArgSort(in_ptr_i, instance_size, is_descending, &key_buf, &index_buf,
+                           out_ptr_i);
+            } else {
+              StdArgSort(in_ptr_i, instance_size, is_descending, out_ptr_i);
+            }
           }
-        }
-      };
-      std::sort(out_ptr_i, out_ptr_i + instance_size, comp);
-    }
+        });
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
 };
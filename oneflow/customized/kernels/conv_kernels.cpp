@@ -16,6 +16,9 @@ limitations under the License.
 #include "oneflow/core/framework/framework.h"
 #include "oneflow/customized/ops/nn_util.h"
 #include "oneflow/core/kernel/new_kernel_util.h"
+#include "oneflow/core/common/blas.h"
+#include "oneflow/core/thread/thread_manager.h"
+#include "oneflow/core/common/balanced_splitter.h"
 
 namespace oneflow {
 
@@ -33,25 +36,27 @@ using Col2ImFunc = void (*)(const T* col_buf, const ShapeView& in_shape,
                             const int32_t* strides, const int32_t* dilation_rate,
                             const int32_t* padding_before, T* in_diff_ptr);
 
+// lda, ldb and ldc are the leading dimensions of the row major a, b and c in memory, which
+// differ from the default ones for a group of channels in channels last images
 template<typename T>
 using GemmFunc = void (*)(enum CBLAS_TRANSPOSE trans_a, enum CBLAS_TRANSPOSE trans_b, const int m,
-                          const int n, const int k, const T alpha, const T* a, const T* b,
-                          const T beta, T* c);
+                          const int n, const int k, const T alpha, const T* a, const int lda,
+                          const T* b, const int ldb, const T beta, T* c, const int ldc);
 
 template<typename T>
 void Gemm4ChannelFirst(enum CBLAS_TRANSPOSE trans_a, enum CBLAS_TRANSPOSE trans_b, const int m,
-                       const int n, const int k, const T alpha, const T* a, const T* b,
-                       const T beta, T* c) {
-  NewKernelUtil<DeviceType::kCPU>::OFGemm(nullptr, trans_a, trans_b, m, n, k, alpha, a, b, beta, c);
+                       const int n, const int k, const T alpha, const T* a, const int lda,
+                       const T* b, const int ldb, const T beta, T* c, const int ldc) {
+  cblas_gemm<T>(CblasRowMajor, trans_a, trans_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
 }
 
 template<typename T>
 void Gemm4ChannelLast(enum CBLAS_TRANSPOSE trans_a, enum CBLAS_TRANSPOSE trans_b, const int m,
-                      const int n, const int k, const T alpha, const T* a, const T* b, const T beta,
-                      T* c) {
+                      const int n, const int k, const T alpha, const T* a, const int lda,
+                      const T* b, const int ldb, const T beta, T* c, const int ldc) {
   trans_a = (trans_a == CblasNoTrans) ? CblasTrans : CblasNoTrans;
   trans_b = (trans_b == CblasNoTrans) ? CblasTrans : CblasNoTrans;
-  NewKernelUtil<DeviceType::kCPU>::OFGemm(nullptr, trans_b, trans_a, n, m, k, alpha, b, a, beta, c);
+  cblas_gemm<T>(CblasRowMajor, trans_b, trans_a, n, m, k, alpha, b, ldb, a, lda, beta, c, ldc);
 }
 
 template<typename T>
@@ -306,7 +311,13 @@ struct ConvOpKernelState final : public user_op::OpKernelState {
 
   enum CBLAS_TRANSPOSE is_out_diff_need_trans_;
   int32_t idx_offset_;
+  int32_t groups_;
   bool is_dynamic_;
+  // 1x1 kernel with stride 1 and no padding: the col buf is the image itself
+  bool is_1x1_;
+  // elem cnt of one col buf / bias multiplier, calculated with the static shapes
+  int64_t col_buf_elem_cnt_;
+  int64_t bias_mul_elem_cnt_;
 
   void Update(const ShapeView& x_shape, const ShapeView& out_shape) {
     auto Gen5DShape = [](const ShapeView& shape, int32_t idx_offset) -> Shape {
@@ -322,8 +333,83 @@ struct ConvOpKernelState final : public user_op::OpKernelState {
       out_5d_shape_ = Gen5DShape(out_shape, idx_offset_);
     }
   }
+
+  // an image is a [c, od * oh * ow] matrix in channels first and a [od * oh * ow, c] one in
+  // channels last, returns its leading dimension
+  int64_t ImgLd(const Shape& shape_5d) const {
+    return idx_offset_ == 2 ? shape_5d.Count(2) : shape_5d.At(4);
+  }
+
+  // offset of the first channel of a group in an image
+  int64_t ImgGroupOffset(const Shape& shape_5d, int64_t group_id) const {
+    const int64_t group_channels = shape_5d.At(idx_offset_ == 2 ? 1 : 4) / groups_;
+    return group_id * group_channels * (idx_offset_ == 2 ? shape_5d.Count(2) : 1);
+  }
 };
 
+bool IsConv1x1(const std::vector<int32_t>& kernel_size, const std::vector<int32_t>& strides,
+               const std::vector<int32_t>& padding_before) {
+  auto IsAllEqual = [](const std::vector<int32_t>& vec, int32_t val) {
+    return std::all_of(vec.cbegin(), vec.cend(), [val](int32_t x) { return x == val; });
+  };
+  return IsAllEqual(kernel_size, 1) && IsAllEqual(strides, 1) && IsAllEqual(padding_before, 0);
+}
+
+template<typename ContextT>
+bool IsConv1x1(ContextT* ctx) {
+  return IsConv1x1(ctx->template Attr<std::vector<int32_t>>("kernel_size"),
+                   ctx->template Attr<std::vector<int32_t>>("strides"),
+                   ctx->template Attr<std::vector<int32_t>>("padding_before"));
+}
+
+// the images of a batch are split into at most GetConvParallelNum parts, every part is computed
+// by one thread of Global<ThreadPool> with its own col buf
+int64_t GetConvParallelNum(int64_t batch_size) {
+  const ThreadPool* thread_pool = Global<ThreadPool>::Get();
+  const int64_t thread_num = thread_pool == nullptr ? 1 : thread_pool->thread_num();
+  return std::max<int64_t>(std::min<int64_t>(batch_size, thread_num), 1);
+}
+
+// tmp_buffer is inferred on the static shapes and maybe by another process, so the parallel num
+// used in Compute is also limited by how many parts the tmp_buffer can hold
+int64_t GetConvParallelNum(int64_t batch_size, const user_op::Tensor* buf, size_t buf_offset,
+                           size_t part_buf_size, size_t shared_buf_size) {
+  int64_t parallel_num = GetConvParallelNum(batch_size);
+  if (part_buf_size > 0) {
+    const size_t buf_size = buf == nullptr ? 0 : buf->shape().elem_cnt() - buf_offset;
+    const int64_t part_capacity = (buf_size + shared_buf_size) / part_buf_size;
+    CHECK_GT(part_capacity, 0);
+    parallel_num = std::min(parallel_num, part_capacity);
+  }
+  return parallel_num;
+}
+
+void ParallelForEachRange(int64_t total_num, int64_t parallel_num,
+                          const std::function<void(int64_t part_id, const Range& range)>& Handler) {
+  if (parallel_num == 1) {
+    Handler(0, Range(0, total_num));
+    return;
+  }
+  const BalancedSplitter bs(total_num, parallel_num);
+  MultiThreadLoop(parallel_num, [&](size_t part_id) { Handler(part_id, bs.At(part_id)); });
+}
+
+bool IsDepthwiseConv2D(const user_op::KernelRegContext& ctx, const std::string& in_name) {
+  if (std::getenv("ONEFLOW_DISABLE_CPU_DEPTHWISE_CONV") != nullptr) { return false; }
+  const int32_t groups = ctx.Attr<int32_t>("groups");
+  if (groups == 1 || ctx.Attr<std::vector<int32_t>>("kernel_size").size() != 2) { return false; }
+  const Shape& in_shape = ctx.TensorDesc4ArgNameAndIndex(in_name, 0)->shape();
+  const std::string& data_format = ctx.Attr<std::string>("data_format");
+  return groups == in_shape.At(ChannelIdx(data_format, in_shape.NumAxes()));
+}
+
+hob::HobContextGetter<user_op::KernelRegContext, bool> HobIsDepthwiseConv2D(
+    const std::string& in_name) {
+  return user_op::HobCtxGetter<bool>(
+      "is_depthwise_conv2d",
+      [in_name](const user_op::KernelRegContext& ctx) { return IsDepthwiseConv2D(ctx, in_name); });
+}
+
 template<typename T>
 std::shared_ptr<user_op::OpKernelState> CreateConvOpKernelState(user_op::KernelInitContext* ctx,
                                                                 const std::string& in_name,
@@ -376,6 +462,13 @@ std::shared_ptr<user_op::OpKernelState> CreateConvOpKernelState(user_op::KernelI
       state->padding_before_3d_.push_back(padding_before.at(index));
     }
   }
+  state->groups_ = ctx->Attr<int32_t>("groups");
+  state->is_1x1_ = IsConv1x1(ctx);
+  state->col_buf_elem_cnt_ =
+      CalcElemNumOfColBuf(ShapeView(state->out_5d_shape_), ShapeView(state->weight_5d_shape_),
+                          state->idx_offset_);
+  state->bias_mul_elem_cnt_ =
+      state->out_5d_shape_.Count(state->idx_offset_, state->idx_offset_ + 3);
 
   return std::move(state);
 }
@@ -402,55 +495,87 @@ class ConvCpuKernel final : public user_op::OpKernel {
   void Compute(user_op::KernelComputeContext* ctx, user_op::OpKernelState* state) const override {
     const user_op::Tensor* in = ctx->Tensor4ArgNameAndIndex("in", 0);
     const user_op::Tensor* weight = ctx->Tensor4ArgNameAndIndex("weight", 0);
+    const user_op::Tensor* bias = ctx->Tensor4ArgNameAndIndex("bias", 0);
     user_op::Tensor* tmp_buffer = ctx->Tensor4ArgNameAndIndex("tmp_buffer", 0);
     user_op::Tensor* out = ctx->Tensor4ArgNameAndIndex("out", 0);
 
-    T* col_buf_dptr = tmp_buffer->mut_dptr<T>();
-
     auto* conv_state = dynamic_cast<ConvOpKernelState<T>*>(state);
-    conv_state->Update(in->shape(), out->shape());
     CHECK_NOTNULL(conv_state);
-    bool is_bias_mul_inited = false;
-    for (int64_t i = 0; i < in->shape().At(0); ++i) {
-      conv_state->im2col_func_(GetImgDptr<T>(in, i), ShapeView(conv_state->in_5d_shape_),
-                               ShapeView(conv_state->weight_5d_shape_),
-                               ShapeView(conv_state->out_5d_shape_), conv_state->strides_3d_.data(),
-                               conv_state->dilation_rate_3d_.data(),
-                               conv_state->padding_before_3d_.data(), col_buf_dptr);
-
-      // channels first: out = weight * col_buf
-      // channels last:  out = (weight * col_buf)(T)
-      int32_t idx_offset = conv_state->idx_offset_;
-      conv_state->forward_func_(
-          CblasNoTrans, CblasNoTrans,
-          conv_state->weight_5d_shape_.At(0),                           // filter
-          conv_state->out_5d_shape_.Count(idx_offset, idx_offset + 3),  // od * oh * ow
-          conv_state->weight_5d_shape_.Count(1),                        // ci * kd * kh * kw
-          static_cast<T>(1), weight->dptr<T>(), col_buf_dptr, static_cast<T>(0),
-          GetImgMutDptr<T>(out, i));
-
-      const user_op::Tensor* bias = ctx->Tensor4ArgNameAndIndex("bias", 0);
-      if (bias != nullptr) {
-        int64_t num_of_col_buf = CalcElemNumOfColBuf(out->shape(), weight->shape(), idx_offset);
-        int64_t num_of_bias_mul = tmp_buffer->shape().elem_cnt() - num_of_col_buf;
-        CHECK_GT(num_of_bias_mul, 0);
-        T* bias_mul_dptr = col_buf_dptr + num_of_col_buf * sizeof(T);
-        if (!is_bias_mul_inited) {
-          InitBiasMulBuf(bias_mul_dptr, num_of_bias_mul);
-          is_bias_mul_inited = true;
+    conv_state->Update(in->shape(), out->shape());
+    const int32_t idx_offset = conv_state->idx_offset_;
+    const Shape& in_5d_shape = conv_state->in_5d_shape_;
+    const Shape& out_5d_shape = conv_state->out_5d_shape_;
+    const int64_t out_spatial_cnt = out_5d_shape.Count(idx_offset, idx_offset + 3);
+
+    // tmp_buffer: | bias_mul | col_buf of part 0 | col_buf of part 1 | ...
+    T* bias_mul_dptr = nullptr;
+    size_t col_bufs_offset = 0;
+    if (bias != nullptr) {
+      bias_mul_dptr = tmp_buffer->mut_dptr<T>();
+      InitBiasMulBuf(bias_mul_dptr, out_spatial_cnt);
+      col_bufs_offset = conv_state->bias_mul_elem_cnt_ * sizeof(T);
+    }
+    const int64_t col_buf_elem_cnt = conv_state->is_1x1_ ? 0 : conv_state->col_buf_elem_cnt_;
+    const int64_t batch_size = in->shape().At(0);
+    const int64_t parallel_num = GetConvParallelNum(batch_size, tmp_buffer, col_bufs_offset,
+                                                    col_buf_elem_cnt * sizeof(T), 0);
+
+    const int64_t filters_per_group = conv_state->weight_5d_shape_.At(0) / conv_state->groups_;
+    const int64_t weight_group_elem_cnt = filters_per_group * conv_state->weight_5d_shape_.Count(1);
+    ParallelForEachRange(batch_size, parallel_num, [&](int64_t part_id, const Range& range) {
+      T* col_buf_dptr = nullptr;
+      if (col_buf_elem_cnt > 0) {
+        col_buf_dptr = reinterpret_cast<T*>(tmp_buffer->mut_dptr<char>() + col_bufs_offset)
+                       + part_id * col_buf_elem_cnt;
+      }
+      FOR_RANGE(int64_t, i, range.begin(), range.end()) {
+        FOR_RANGE(int32_t, g, 0, conv_state->groups_) {
+          const T* in_dptr = GetImgDptr<T>(in, i) + conv_state->ImgGroupOffset(in_5d_shape, g);
+          const T* col_dptr = nullptr;
+          int64_t col_ld = out_spatial_cnt;
+          enum CBLAS_TRANSPOSE is_col_need_trans = CblasNoTrans;
+          if (conv_state->is_1x1_) {
+            // the layout of in[i] is the same as out[i], which is the transpose of col_buf in
+            // channels last
+            col_dptr = in_dptr;
+            col_ld = conv_state->ImgLd(in_5d_shape);
+            is_col_need_trans = conv_state->is_out_diff_need_trans_;
+          } else {
+            conv_state->im2col_func_(in_dptr, ShapeView(in_5d_shape),
+                                     ShapeView(conv_state->weight_5d_shape_),
+                                     ShapeView(conv_state->out_5d_shape_),
+                                     conv_state->strides_3d_.data(),
+                                     conv_state->dilation_rate_3d_.data(),
+                                     conv_state->padding_before_3d_.data(), col_buf_dptr);
+            col_dptr = col_buf_dptr;
+          }
+
+          // channels first: out = weight * col_buf
+          // channels last:  out = (weight * col_buf)(T)
+          conv_state->forward_func_(
+              CblasNoTrans, is_col_need_trans,
+              filters_per_group,                      // filter / groups
+              out_spatial_cnt,                        // od * oh * ow
+              conv_state->weight_5d_shape_.Count(1),  // ci / groups * kd * kh * kw
+              static_cast<T>(1), weight->dptr<T>() + g * weight_group_elem_cnt,
+              conv_state->weight_5d_shape_.Count(1), col_dptr, col_ld, static_cast<T>(0),
+              GetImgMutDptr<T>(out, i) + conv_state->ImgGroupOffset(out_5d_shape, g),
+              conv_state->ImgLd(out_5d_shape));
         }
 
-        // channels first:  out += bias * bias_mul
-        // channels last:   out += (bias * bias_mul)(T)
-        conv_state->forward_func_(
-            CblasNoTrans, CblasNoTrans,
-            conv_state->weight_5d_shape_.At(0),                           // filter
-            conv_state->out_5d_shape_.Count(idx_offset, idx_offset + 3),  // od * oh * ow
-            1,                                                            // 1
-            static_cast<T>(1), bias->dptr<T>(), bias_mul_dptr, static_cast<T>(1),
-            GetImgMutDptr<T>(out, i));
+        if (bias != nullptr) {
+          // channels first:  out += bias * bias_mul
+          // channels last:   out += (bias * bias_mul)(T)
+          conv_state->forward_func_(CblasNoTrans, CblasNoTrans,
+                                    conv_state->weight_5d_shape_.At(0),  // filter
+                                    out_spatial_cnt,                     // od * oh * ow
+                                    1,                                   // 1
+                                    static_cast<T>(1), bias->dptr<T>(), 1, bias_mul_dptr,
+                                    out_spatial_cnt, static_cast<T>(1), GetImgMutDptr<T>(out, i),
+                                    conv_state->ImgLd(out_5d_shape));
+        }
       }
-    }
+    });
   }
 };
 
@@ -458,7 +583,7 @@ class ConvCpuKernel final : public user_op::OpKernel {
   REGISTER_USER_KERNEL(#op_name)                                                            \
       .SetCreateFn<ConvCpuKernel<dtype, ndims>>()                                           \
       .SetIsMatchedHob((user_op::HobDeviceType() == DeviceType::kCPU)                       \
-                       & (user_op::HobAttr<int32_t>("groups") == 1)                         \
+                       & (HobIsDepthwiseConv2D("in") == false)                              \
                        & (user_op::HobDataType("in", 0) == GetDataType<dtype>::value))      \
       .SetInferTmpSizeFn([](user_op::InferContext* ctx) -> size_t {                         \
         size_t tmp_buffer_size = 0;                                                         \
@@ -466,15 +591,17 @@ class ConvCpuKernel final : public user_op::OpKernel {
         const auto& weight_shape = ctx->TensorDesc4ArgNameAndIndex("weight", 0)->shape();   \
                                                                                             \
         int64_t idx_offset = IdxOffset(ctx->Attr<std::string>("data_format"));              \
-        tmp_buffer_size +=                                                                  \
-            CalcElemNumOfColBuf(out_shape, weight_shape, idx_offset) * sizeof(dtype);       \
-                                                                                            \
         const auto* bias = ctx->TensorDesc4ArgNameAndIndex("bias", 0);                      \
         if (bias != nullptr) {                                                              \
           int64_t bias_mul_cnt = 1;                                                         \
           for (int i = 0; i < ndims; ++i) { bias_mul_cnt *= out_shape.At(idx_offset + i); } \
           tmp_buffer_size += bias_mul_cnt * sizeof(dtype);                                  \
         }                                                                                   \
+        if (!IsConv1x1(ctx)) {                                                              \
+          tmp_buffer_size += GetConvParallelNum(out_shape.At(0))                            \
+                             * CalcElemNumOfColBuf(out_shape, weight_shape, idx_offset)     \
+                             * sizeof(dtype);                                               \
+        }                                                                                   \
         return tmp_buffer_size;                                                             \
       })
 
@@ -508,28 +635,63 @@ class ConvDataGradCpuKernel final : public user_op::OpKernel {
     user_op::Tensor* dx = ctx->Tensor4ArgNameAndIndex("dx", 0);
     user_op::Tensor* col_buf = ctx->Tensor4ArgNameAndIndex("tmp_buffer", 0);
     conv_state->Update(dx->shape(), dy->shape());
-    Memset<DeviceType::kCPU>(ctx->device_ctx(), dx->mut_dptr<T>(), 0,
-                             dx->shape().elem_cnt() * sizeof(T));
 
-    int32_t idx_offset = conv_state->idx_offset_;
-    FOR_RANGE(int64_t, i, 0, dy->shape().At(0)) {
-      // channels first:  col_buf' = weight(T) * out[i]'
-      // channels last :  col_buf' = weight(T) * out[i]'(T)
-      NewKernelUtil<DeviceType::kCPU>::OFGemm(
-          nullptr, CblasTrans, conv_state->is_out_diff_need_trans_,
-          conv_state->weight_5d_shape_.Count(1),                        //  ci * kd * kh * kw
-          conv_state->out_5d_shape_.Count(idx_offset, idx_offset + 3),  //  od * oh * ow
-          conv_state->weight_5d_shape_.At(0),                           //  filter
-          static_cast<T>(1), filter->dptr<T>(), GetImgDptr<T>(dy, i), static_cast<T>(0),
-          col_buf->mut_dptr<T>());
-
-      // in' = col2im(col_buf')
-      conv_state->col2im_func_(col_buf->dptr<T>(), ShapeView(conv_state->in_5d_shape_),
-                               ShapeView(conv_state->weight_5d_shape_),
-                               ShapeView(conv_state->out_5d_shape_), conv_state->strides_3d_.data(),
-                               conv_state->dilation_rate_3d_.data(),
-                               conv_state->padding_before_3d_.data(), GetImgMutDptr<T>(dx, i));
-    }
+    const int32_t idx_offset = conv_state->idx_offset_;
+    const Shape& in_5d_shape = conv_state->in_5d_shape_;
+    const Shape& out_5d_shape = conv_state->out_5d_shape_;
+    const int64_t out_spatial_cnt = out_5d_shape.Count(idx_offset, idx_offset + 3);
+    const int64_t col_buf_elem_cnt = conv_state->is_1x1_ ? 0 : conv_state->col_buf_elem_cnt_;
+    const int64_t batch_size = dy->shape().At(0);
+    const int64_t parallel_num =
+        GetConvParallelNum(batch_size, col_buf, 0, col_buf_elem_cnt * sizeof(T), 0);
+    const int64_t filters_per_group = conv_state->weight_5d_shape_.At(0) / conv_state->groups_;
+    const int64_t weight_group_elem_cnt = filters_per_group * conv_state->weight_5d_shape_.Count(1);
+
+    ParallelForEachRange(batch_size, parallel_num, [&](int64_t part_id, const Range& range) {
+      T* col_buf_dptr = nullptr;
+      if (!conv_state->is_1x1_) {
+        col_buf_dptr = col_buf->mut_dptr<T>() + part_id * col_buf_elem_cnt;
+        Memset<DeviceType::kCPU>(ctx->device_ctx(), GetImgMutDptr<T>(dx, range.begin()), 0,
+                                 range.size() * dx->shape().Count(1) * sizeof(T));
+      }
+      FOR_RANGE(int64_t, i, range.begin(), range.end()) {
+        FOR_RANGE(int32_t, g, 0, conv_state->groups_) {
+          const T* filter_dptr = filter->dptr<T>() + g * weight_group_elem_cnt;
+          const T* dy_dptr = GetImgDptr<T>(dy, i) + conv_state->ImgGroupOffset(out_5d_shape, g);
+          T* dx_dptr = GetImgMutDptr<T>(dx, i) + conv_state->ImgGroupOffset(in_5d_shape, g);
+          if (conv_state->is_1x1_) {
+            // col2im of 1x1 conv is the identity, so write to dx[i] directly
+            // channels first:  in' = weight(T) * out[i]'
+            // channels last :  in' = (weight(T) * out[i]'(T))(T)
+            conv_state->forward_func_(
+                CblasTrans, conv_state->is_out_diff_need_trans_,
+                conv_state->weight_5d_shape_.Count(1),  //  ci / groups
+                out_spatial_cnt,                        //  od * oh * ow
+                filters_per_group,                      //  filter / groups
+                static_cast<T>(1), filter_dptr, conv_state->weight_5d_shape_.Count(1), dy_dptr,
+                conv_state->ImgLd(out_5d_shape), static_cast<T>(0), dx_dptr,
+                conv_state->ImgLd(in_5d_shape));
+            continue;
+          }
+          // channels first:  col_buf' = weight(T) * out[i]'
+          // channels last :  col_buf' = weight(T) * out[i]'(T)
+          Gemm4ChannelFirst<T>(
+              CblasTrans, conv_state->is_out_diff_need_trans_,
+              conv_state->weight_5d_shape_.Count(1),  //  ci / groups * kd * kh * kw
+              out_spatial_cnt,                        //  od * oh * ow
+              filters_per_group,                      //  filter / groups
+              static_cast<T>(1), filter_dptr, conv_state->weight_5d_shape_.Count(1), dy_dptr,
+              conv_state->ImgLd(out_5d_shape), static_cast<T>(0), col_buf_dptr, out_spatial_cnt);
+
+          // in' = col2im(col_buf')
+          conv_state->col2im_func_(col_buf_dptr, ShapeView(in_5d_shape),
+                                   ShapeView(conv_state->weight_5d_shape_),
+                                   ShapeView(out_5d_shape), conv_state->strides_3d_.data(),
+                                   conv_state->dilation_rate_3d_.data(),
+                                   conv_state->padding_before_3d_.data(), dx_dptr);
+        }
+      }
+    });
   }
 };
 
@@ -537,17 +699,17 @@ class ConvDataGradCpuKernel final : public user_op::OpKernel {
   REGISTER_USER_KERNEL(#op_name)                                                           \
       .SetCreateFn<ConvDataGradCpuKernel<dtype>>()                                         \
       .SetIsMatchedHob((user_op::HobDeviceType() == DeviceType::kCPU)                      \
-                       & (user_op::HobAttr<int32_t>("groups") == 1)                        \
+                       & (HobIsDepthwiseConv2D("x_like") == false)                         \
                        & (user_op::HobDataType("dy", 0) == GetDataType<dtype>::value))     \
       .SetInferTmpSizeFn([](user_op::InferContext* ctx) -> size_t {                        \
-        size_t tmp_buffer_size = 0;                                                        \
+        if (IsConv1x1(ctx)) { return 0; }                                                  \
         const auto& out_diff_shape = ctx->TensorDesc4ArgNameAndIndex("dy", 0)->shape();    \
         const auto& weight_shape = ctx->TensorDesc4ArgNameAndIndex("filter", 0)->shape();  \
                                                                                            \
         int64_t idx_offset = IdxOffset(ctx->Attr<std::string>("data_format"));             \
-        tmp_buffer_size +=                                                                 \
-            CalcElemNumOfColBuf(out_diff_shape, weight_shape, idx_offset) * sizeof(dtype); \
-        return tmp_buffer_size;                                                            \
+        return GetConvParallelNum(out_diff_shape.At(0))                                    \
+               * CalcElemNumOfColBuf(out_diff_shape, weight_shape, idx_offset)             \
+               * sizeof(dtype);                                                            \
       })
 
 REGISTER_CONV_DATA_GRAD_KERNEL(conv_data_grad, float);
@@ -575,53 +737,547 @@ class ConvFilterGradCpuKernel final : public user_op::OpKernel {
     const user_op::Tensor* dy = ctx->Tensor4ArgNameAndIndex("dy", 0);
     const user_op::Tensor* x = ctx->Tensor4ArgNameAndIndex("x", 0);
     user_op::Tensor* filter_diff = ctx->Tensor4ArgNameAndIndex("filter_diff", 0);
-    user_op::Tensor* col_buf = ctx->Tensor4ArgNameAndIndex("tmp_buffer", 0);
+    user_op::Tensor* tmp_buffer = ctx->Tensor4ArgNameAndIndex("tmp_buffer", 0);
     conv_state->Update(x->shape(), dy->shape());
 
-    Memset<DeviceType::kCPU>(ctx->device_ctx(), filter_diff->mut_dptr<T>(), 0,
-                             filter_diff->shape().elem_cnt() * sizeof(T));
-    int32_t idx_offset = conv_state->idx_offset_;
-    FOR_RANGE(int64_t, i, 0, dy->shape().At(0)) {
-      conv_state->im2col_func_(GetImgDptr<T>(x, i), ShapeView(conv_state->in_5d_shape_),
-                               ShapeView(conv_state->weight_5d_shape_),
-                               ShapeView(conv_state->out_5d_shape_), conv_state->strides_3d_.data(),
-                               conv_state->dilation_rate_3d_.data(),
-                               conv_state->padding_before_3d_.data(), col_buf->mut_dptr<T>());
-
-      // channels first:  weight' += out[i]' * col_buf(T)
-      // channels last :  weight' += out[i]'(T) * col_buf(T)
-      NewKernelUtil<DeviceType::kCPU>::OFGemm(
-          nullptr, conv_state->is_out_diff_need_trans_, CblasTrans,
-          conv_state->weight_5d_shape_.At(0),                           //  filter
-          conv_state->weight_5d_shape_.Count(1),                        //  ci * kd * kh * kw
-          conv_state->out_5d_shape_.Count(idx_offset, idx_offset + 3),  //  od * oh * ow
-          static_cast<T>(1), GetImgDptr<T>(dy, i), col_buf->dptr<T>(), static_cast<T>(1),
-          filter_diff->mut_dptr<T>());
+    // tmp_buffer: | col_buf of part 0 | ... | col_buf of part n-1 | filter_diff of part 1 | ...
+    // part 0 accumulates to filter_diff directly, the others are reduced into it at last
+    const int32_t idx_offset = conv_state->idx_offset_;
+    const Shape& in_5d_shape = conv_state->in_5d_shape_;
+    const Shape& out_5d_shape = conv_state->out_5d_shape_;
+    const int64_t out_spatial_cnt = out_5d_shape.Count(idx_offset, idx_offset + 3);
+    const int64_t col_buf_elem_cnt = conv_state->is_1x1_ ? 0 : conv_state->col_buf_elem_cnt_;
+    const int64_t filter_elem_cnt = filter_diff->shape().elem_cnt();
+    const int64_t filters_per_group = conv_state->weight_5d_shape_.At(0) / conv_state->groups_;
+    const int64_t weight_group_elem_cnt = filters_per_group * conv_state->weight_5d_shape_.Count(1);
+    const int64_t batch_size = dy->shape().At(0);
+    const int64_t parallel_num = GetConvParallelNum(
+        batch_size, tmp_buffer, 0, (col_buf_elem_cnt + filter_elem_cnt) * sizeof(T),
+        filter_elem_cnt * sizeof(T));
+    T* col_bufs_dptr = tmp_buffer == nullptr ? nullptr : tmp_buffer->mut_dptr<T>();
+    T* part_filter_diffs_dptr = col_bufs_dptr + parallel_num * col_buf_elem_cnt;
+    auto PartFilterDiffDptr = [&](int64_t part_id) -> T* {
+      if (part_id == 0) { return filter_diff->mut_dptr<T>(); }
+      return part_filter_diffs_dptr + (part_id - 1) * filter_elem_cnt;
+    };
+    // channels first:  x[i] is col_buf,     weight' += out[i]' * x[i](T)
+    // channels last :  x[i] is col_buf(T),  weight' += out[i]'(T) * x[i]
+    const enum CBLAS_TRANSPOSE is_x_need_trans =
+        conv_state->is_out_diff_need_trans_ == CblasNoTrans ? CblasTrans : CblasNoTrans;
+
+    ParallelForEachRange(batch_size, parallel_num, [&](int64_t part_id, const Range& range) {
+      T* col_buf_dptr = col_bufs_dptr + part_id * col_buf_elem_cnt;
+      T* part_filter_diff_dptr = PartFilterDiffDptr(part_id);
+      Memset<DeviceType::kCPU>(ctx->device_ctx(), part_filter_diff_dptr, 0,
+                               filter_elem_cnt * sizeof(T));
+      FOR_RANGE(int64_t, i, range.begin(), range.end()) {
+        FOR_RANGE(int32_t, g, 0, conv_state->groups_) {
+          const T* x_dptr = GetImgDptr<T>(x, i) + conv_state->ImgGroupOffset(in_5d_shape, g);
+          const T* col_dptr = nullptr;
+          int64_t col_ld = out_spatial_cnt;
+          enum CBLAS_TRANSPOSE is_col_need_trans = CblasTrans;
+          if (conv_state->is_1x1_) {
+            col_dptr = x_dptr;
+            col_ld = conv_state->ImgLd(in_5d_shape);
+            is_col_need_trans = is_x_need_trans;
+          } else {
+            conv_state->im2col_func_(x_dptr, ShapeView(in_5d_shape),
+                                     ShapeView(conv_state->weight_5d_shape_),
+                                     ShapeView(out_5d_shape), conv_state->strides_3d_.data(),
+                                     conv_state->dilation_rate_3d_.data(),
+                                     conv_state->padding_before_3d_.data(), col_buf_dptr);
+            col_dptr = col_buf_dptr;
+          }
+
+          // channels first:  weight' += out[i]' * col_buf(T)
+          // channels last :  weight' += out[i]'(T) * col_buf(T)
+          Gemm4ChannelFirst<T>(
+              conv_state->is_out_diff_need_trans_, is_col_need_trans,
+              filters_per_group,                      //  filter / groups
+              conv_state->weight_5d_shape_.Count(1),  //  ci / groups * kd * kh * kw
+              out_spatial_cnt,                        //  od * oh * ow
+              static_cast<T>(1),
+              GetImgDptr<T>(dy, i) + conv_state->ImgGroupOffset(out_5d_shape, g),
+              conv_state->ImgLd(out_5d_shape), col_dptr, col_ld, static_cast<T>(1),
+              part_filter_diff_dptr + g * weight_group_elem_cnt,
+              conv_state->weight_5d_shape_.Count(1));
+        }
+      }
+    });
+    if (parallel_num > 1) {
+      ParallelForEachRange(filter_elem_cnt, parallel_num, [&](int64_t, const Range& range) {
+        T* filter_diff_dptr = filter_diff->mut_dptr<T>();
+        FOR_RANGE(int64_t, part_id, 1, parallel_num) {
+          const T* part_filter_diff_dptr = PartFilterDiffDptr(part_id);
+          FOR_RANGE(int64_t, j, range.begin(), range.end()) {
+            filter_diff_dptr[j] += part_filter_diff_dptr[j];
+          }
+        }
+      });
     }
   }
 };
 
-#define REGISTER_CONV_FILTER_GRAD_KERNEL(op_name, dtype)                                        \
-  REGISTER_USER_KERNEL(#op_name)                                                                \
-      .SetCreateFn<ConvFilterGradCpuKernel<dtype>>()                                            \
-      .SetIsMatchedHob((user_op::HobDeviceType() == DeviceType::kCPU)                           \
-                       & (user_op::HobAttr<int32_t>("groups") == 1)                             \
-                       & (user_op::HobDataType("dy", 0) == GetDataType<dtype>::value))          \
-      .SetInferTmpSizeFn([](user_op::InferContext* ctx) -> size_t {                             \
-        size_t tmp_buffer_size = 0;                                                             \
-        const auto& out_diff_shape = ctx->TensorDesc4ArgNameAndIndex("dy", 0)->shape();         \
-        const auto& weight_diff_shape =                                                         \
-            ctx->TensorDesc4ArgNameAndIndex("filter_diff", 0)->shape();                         \
-                                                                                                \
-        int64_t idx_offset = IdxOffset(ctx->Attr<std::string>("data_format"));                  \
-        tmp_buffer_size +=                                                                      \
-            CalcElemNumOfColBuf(out_diff_shape, weight_diff_shape, idx_offset) * sizeof(dtype); \
-        return tmp_buffer_size;                                                                 \
+#define REGISTER_CONV_FILTER_GRAD_KERNEL(op_name, dtype)                                         \
+  REGISTER_USER_KERNEL(#op_name)                                                                 \
+      .SetCreateFn<ConvFilterGradCpuKernel<dtype>>()                                             \
+      .SetIsMatchedHob((user_op::HobDeviceType() == DeviceType::kCPU)                            \
+                       & (HobIsDepthwiseConv2D("x") == false)                                    \
+                       & (user_op::HobDataType("dy", 0) == GetDataType<dtype>::value))           \
+      .SetInferTmpSizeFn([](user_op::InferContext* ctx) -> size_t {                              \
+        const auto& out_diff_shape = ctx->TensorDesc4ArgNameAndIndex("dy", 0)->shape();          \
+        const auto& weight_diff_shape =                                                          \
+            ctx->TensorDesc4ArgNameAndIndex("filter_diff", 0)->shape();                          \
+                                                                                                 \
+        int64_t idx_offset = IdxOffset(ctx->Attr<std::string>("data_format"));                   \
+        const int64_t parallel_num = GetConvParallelNum(out_diff_shape.At(0));                   \
+        int64_t col_buf_elem_cnt = 0;                                                            \
+        if (!IsConv1x1(ctx)) {                                                                   \
+          col_buf_elem_cnt = CalcElemNumOfColBuf(out_diff_shape, weight_diff_shape, idx_offset); \
+        }                                                                                        \
+        return (parallel_num * col_buf_elem_cnt                                                  \
+                + (parallel_num - 1) * weight_diff_shape.elem_cnt())                             \
+               * sizeof(dtype);                                                                  \
       })
 
 REGISTER_CONV_FILTER_GRAD_KERNEL(conv_filter_grad, float);
 REGISTER_CONV_FILTER_GRAD_KERNEL(conv_filter_grad, double);
 
+struct DepthwiseConv2DParams {
+  int64_t batch_size;
+  int64_t channels;
+  int64_t multiplier;
+  int64_t filters;
+  int64_t in_h;
+  int64_t in_w;
+  int64_t out_h;
+  int64_t out_w;
+  int64_t kernel_h;
+  int64_t kernel_w;
+  int64_t stride_h;
+  int64_t stride_w;
+  int64_t dilation_h;
+  int64_t dilation_w;
+  int64_t padding_h;
+  int64_t padding_w;
+  bool is_channels_last;
+
+  int64_t kernel_size() const { return kernel_h * kernel_w; }
+};
+
+DepthwiseConv2DParams MakeDepthwiseConv2DParams(user_op::KernelComputeContext* ctx,
+                                                const ShapeView& x_shape,
+                                                const ShapeView& y_shape) {
+  DepthwiseConv2DParams params;
+  params.is_channels_last = ctx->Attr<std::string>("data_format") == "channels_last";
+  const int32_t c_idx = params.is_channels_last ? 3 : 1;
+  const int32_t h_idx = params.is_channels_last ? 1 : 2;
+  params.batch_size = x_shape.At(0);
+  params.channels = x_shape.At(c_idx);
+  params.filters = y_shape.At(c_idx);
+  params.multiplier = params.filters / params.channels;
+  params.in_h = x_shape.At(h_idx);
+  params.in_w = x_shape.At(h_idx + 1);
+  params.out_h = y_shape.At(h_idx);
+  params.out_w = y_shape.At(h_idx + 1);
+  const auto& kernel_size = ctx->Attr<std::vector<int32_t>>("kernel_size");
+  const auto& strides = ctx->Attr<std::vector<int32_t>>("strides");
+  const auto& dilation_rate = ctx->Attr<std::vector<int32_t>>("dilation_rate");
+  const auto& padding_before = ctx->Attr<std::vector<int32_t>>("padding_before");
+  params.kernel_h = kernel_size.at(0);
+  params.kernel_w = kernel_size.at(1);
+  params.stride_h = strides.at(0);
+  params.stride_w = strides.at(1);
+  params.dilation_h = dilation_rate.at(0);
+  params.dilation_w = dilation_rate.at(1);
+  params.padding_h = padding_before.at(0);
+  params.padding_w = padding_before.at(1);
+  CHECK_EQ(params.filters % params.channels, 0);
+  return params;
+}
+
+// [*begin, *end) are the output indices whose input index, out * stride - padding + offset, is in
+// [0, in_size)
+void CalcValidOutRange(int64_t in_size, int64_t out_size, int64_t stride, int64_t padding,
+                       int64_t offset, int64_t* begin, int64_t* end) {
+  const int64_t lower = padding - offset;
+  const int64_t upper = in_size + padding - offset;
+  *begin = lower <= 0 ? 0 : std::min(out_size, (lower + stride - 1) / stride);
+  *end = upper <= 0 ? 0 : std::min(out_size, (upper + stride - 1) / stride);
+  *end = std::max(*begin, *end);
+}
+
+// the weight of depthwise conv is [filters, kh, kw], channels last kernels use the transposed
+// [kh, kw, filters] one to vectorize over the contiguous channels
+template<typename T>
+void TransposeDepthwiseWeight(const DepthwiseConv2DParams& params, const T* weight, T* weight_t) {
+  const int64_t kernel_size = params.kernel_size();
+  FOR_RANGE(int64_t, o, 0, params.filters) {
+    FOR_RANGE(int64_t, k, 0, kernel_size) {
+      weight_t[k * params.filters + o] = weight[o * kernel_size + k];
+    }
+  }
+}
+
+template<typename T>
+struct DepthwiseConv2DKernelUtil final {
+  // parallel over the output rows, vectorized over the channels
+  static void NHWCForward(const DepthwiseConv2DParams& p, const T* x, const T* weight_t,
+                          const T* bias, T* y) {
+    ParallelForEachRange(
+        p.batch_size * p.out_h, GetConvParallelNum(p.batch_size * p.out_h),
+        [&](int64_t, const Range& range) {
+          FOR_RANGE(int64_t, row, range.begin(), range.end()) {
+            const int64_t n = row / p.out_h;
+            const int64_t oh = row % p.out_h;
+            FOR_RANGE(int64_t, ow, 0, p.out_w) {
+              T* y_px = y + (row * p.out_w + ow) * p.filters;
+              FOR_RANGE(int64_t, o, 0, p.filters) {
+                y_px[o] = bias == nullptr ? static_cast<T>(0) : bias[o];
+              }
+              FOR_RANGE(int64_t, kh, 0, p.kernel_h) {
+                const int64_t ih = oh * p.stride_h - p.padding_h + kh * p.dilation_h;
+                if (ih < 0 || ih >= p.in_h) { continue; }
+                FOR_RANGE(int64_t, kw, 0, p.kernel_w) {
+                  const int64_t iw = ow * p.stride_w - p.padding_w + kw * p.dilation_w;
+                  if (iw < 0 || iw >= p.in_w) { continue; }
+                  const T* x_px = x + ((n * p.in_h + ih) * p.in_w + iw) * p.channels;
+                  const T* w_px = weight_t + (kh * p.kernel_w + kw) * p.filters;
+                  if (p.multiplier == 1) {
+                    FOR_RANGE(int64_t, c, 0, p.channels) { y_px[c] += x_px[c] * w_px[c]; }
+                  } else {
+                    FOR_RANGE(int64_t, o, 0, p.filters) {
+                      y_px[o] += x_px[o / p.multiplier] * w_px[o];
+                    }
+                  }
+                }
+              }
+            }
+          }
+        });
+  }
+
+  // parallel over the input rows, every dx pixel gathers from the dy pixels it contributes to
+  static void NHWCDataGrad(const DepthwiseConv2DParams& p, const T* dy, const T* weight_t,
+                           T* dx) {
+    ParallelForEachRange(
+        p.batch_size * p.in_h, GetConvParallelNum(p.batch_size * p.in_h),
+        [&](int64_t, const Range& range) {
+          FOR_RANGE(int64_t, row, range.begin(), range.end()) {
+            const int64_t n = row / p.in_h;
+            const int64_t ih = row % p.in_h;
+            T* dx_row = dx + row * p.in_w * p.channels;
+            std::fill(dx_row, dx_row + p.in_w * p.channels, static_cast<T>(0));
+            FOR_RANGE(int64_t, kh, 0, p.kernel_h) {
+              const int64_t h_numerator = ih + p.padding_h - kh * p.dilation_h;
+              if (h_numerator < 0 || h_numerator % p.stride_h != 0) { continue; }
+              const int64_t oh = h_numerator / p.stride_h;
+              if (oh >= p.out_h) { continue; }
+              FOR_RANGE(int64_t, iw, 0, p.in_w) {
+                T* dx_px = dx_row + iw * p.channels;
+                FOR_RANGE(int64_t, kw, 0, p.kernel_w) {
+                  const int64_t w_numerator = iw + p.padding_w - kw * p.dilation_w;
+                  if (w_numerator < 0 || w_numerator % p.stride_w != 0) { continue; }
+                  const int64_t ow = w_numerator / p.stride_w;
+                  if (ow >= p.out_w) { continue; }
+                  const T* dy_px = dy + ((n * p.out_h + oh) * p.out_w + ow) * p.filters;
+                  const T* w_px = weight_t + (kh * p.kernel_w + kw) * p.filters;
+                  if (p.multiplier == 1) {
+                    FOR_RANGE(int64_t, c, 0, p.channels) { dx_px[c] += dy_px[c] * w_px[c]; }
+                  } else {
+                    FOR_RANGE(int64_t, o, 0, p.filters) {
+                      dx_px[o / p.multiplier] += dy_px[o] * w_px[o];
+                    }
+                  }
+                }
+              }
+            }
+          }
+        });
+  }
+
+  // every part accumulates the images of its batch range to its own [kh, kw, filters] buffer,
+  // which are reduced and transposed to filter_diff at last
+  static void NHWCFilterGrad(const DepthwiseConv2DParams& p, int64_t parallel_num, const T* dy,
+                             const T* x, T* part_filter_diffs, T* filter_diff) {
+    const int64_t filter_elem_cnt = p.kernel_size() * p.filters;
+    ParallelForEachRange(p.batch_size, parallel_num, [&](int64_t part_id, const Range& range) {
+      T* part_filter_diff = part_filter_diffs + part_id * filter_elem_cnt;
+      std::fill(part_filter_diff, part_filter_diff + filter_elem_cnt, static_cast<T>(0));
+      FOR_RANGE(int64_t, n, range.begin(), range.end()) {
+        FOR_RANGE(int64_t, oh, 0, p.out_h) {
+          FOR_RANGE(int64_t, kh, 0, p.kernel_h) {
+            const int64_t ih = oh * p.stride_h - p.padding_h + kh * p.dilation_h;
+            if (ih < 0 || ih >= p.in_h) { continue; }
+            FOR_RANGE(int64_t, ow, 0, p.out_w) {
+              const T* dy_px = dy + ((n * p.out_h + oh) * p.out_w + ow) * p.filters;
+              FOR_RANGE(int64_t, kw, 0, p.kernel_w) {
+                const int64_t iw = ow * p.stride_w - p.padding_w + kw * p.dilation_w;
+                if (iw < 0 || iw >= p.in_w) { continue; }
+                const T* x_px = x + ((n * p.in_h + ih) * p.in_w + iw) * p.channels;
+                T* dw_px = part_filter_diff + (kh * p.kernel_w + kw) * p.filters;
+                if (p.multiplier == 1) {
+                  FOR_RANGE(int64_t, c, 0, p.channels) { dw_px[c] += dy_px[c] * x_px[c]; }
+                } else {
+                  FOR_RANGE(int64_t, o, 0, p.filters) {
+                    dw_px[o] += dy_px[o] * x_px[o / p.multiplier];
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+    });
+    const int64_t kernel_size = p.kernel_size();
+    ParallelForEachRange(filter_elem_cnt, parallel_num, [&](int64_t, const Range& range) {
+      FOR_RANGE(int64_t, i, range.begin(), range.end()) {
+        T sum = part_filter_diffs[i];
+        FOR_RANGE(int64_t, part_id, 1, parallel_num) {
+          sum += part_filter_diffs[part_id * filter_elem_cnt + i];
+        }
+        filter_diff[(i % p.filters) * kernel_size + i / p.filters] = sum;
+      }
+    });
+  }
+
+  // parallel over the output planes, vectorized over the output columns
+  static void NCHWForward(const DepthwiseConv2DParams& p, const T* x, const T* weight,
+                          const T* bias, T* y) {
+    const int64_t plane_num = p.batch_size * p.filters;
+    const int64_t parallel_num = GetConvParallelNum(plane_num);
+    ParallelForEachRange(plane_num, parallel_num, [&](int64_t, const Range& range) {
+      FOR_RANGE(int64_t, plane, range.begin(), range.end()) {
+        const int64_t n = plane / p.filters;
+        const int64_t o = plane % p.filters;
+        const T* x_plane = x + (n * p.channels + o / p.multiplier) * p.in_h * p.in_w;
+        const T* w_o = weight + o * p.kernel_size();
+        T* y_plane = y + plane * p.out_h * p.out_w;
+        std::fill(y_plane, y_plane + p.out_h * p.out_w,
+                  bias == nullptr ? static_cast<T>(0) : bias[o]);
+        FOR_RANGE(int64_t, kw, 0, p.kernel_w) {
+          int64_t ow_begin = 0;
+          int64_t ow_end = 0;
+          CalcValidOutRange(p.in_w, p.out_w, p.stride_w, p.padding_w, kw * p.dilation_w,
+                            &ow_begin, &ow_end);
+          const int64_t iw_offset = kw * p.dilation_w - p.padding_w;
+          FOR_RANGE(int64_t, oh, 0, p.out_h) {
+            T* y_row = y_plane + oh * p.out_w;
+            FOR_RANGE(int64_t, kh, 0, p.kernel_h) {
+              const int64_t ih = oh * p.stride_h - p.padding_h + kh * p.dilation_h;
+              if (ih < 0 || ih >= p.in_h) { continue; }
+              const T* x_row = x_plane + ih * p.in_w;
+              const T w_val = w_o[kh * p.kernel_w + kw];
+              FOR_RANGE(int64_t, ow, ow_begin, ow_end) {
+                y_row[ow] += w_val * x_row[ow * p.stride_w + iw_offset];
+              }
+            }
+          }
+        }
+      }
+    });
+  }
+
+  // parallel over the input planes, scatter from the dy planes of the channel's filters
+  static void NCHWDataGrad(const DepthwiseConv2DParams& p, const T* dy, const T* weight, T* dx) {
+    const int64_t plane_num = p.batch_size * p.channels;
+    const int64_t parallel_num = GetConvParallelNum(plane_num);
+    ParallelForEachRange(plane_num, parallel_num, [&](int64_t, const Range& range) {
+      FOR_RANGE(int64_t, plane, range.begin(), range.end()) {
+        const int64_t n = plane / p.channels;
+        const int64_t c = plane % p.channels;
+        T* dx_plane = dx + plane * p.in_h * p.in_w;
+        std::fill(dx_plane, dx_plane + p.in_h * p.in_w, static_cast<T>(0));
+        FOR_RANGE(int64_t, o, c * p.multiplier, (c + 1) * p.multiplier) {
+          const T* dy_plane = dy + (n * p.filters + o) * p.out_h * p.out_w;
+          const T* w_o = weight + o * p.kernel_size();
+          FOR_RANGE(int64_t, kw, 0, p.kernel_w) {
+            int64_t ow_begin = 0;
+            int64_t ow_end = 0;
+            CalcValidOutRange(p.in_w, p.out_w, p.stride_w, p.padding_w, kw * p.dilation_w,
+                              &ow_begin, &ow_end);
+            const int64_t iw_offset = kw * p.dilation_w - p.padding_w;
+            FOR_RANGE(int64_t, oh, 0, p.out_h) {
+              const T* dy_row = dy_plane + oh * p.out_w;
+              FOR_RANGE(int64_t, kh, 0, p.kernel_h) {
+                const int64_t ih = oh * p.stride_h - p.padding_h + kh * p.dilation_h;
+                if (ih < 0 || ih >= p.in_h) { continue; }
+                T* dx_row = dx_plane + ih * p.in_w;
+                const T w_val = w_o[kh * p.kernel_w + kw];
+                FOR_RANGE(int64_t, ow, ow_begin, ow_end) {
+                  dx_row[ow * p.stride_w + iw_offset] += w_val * dy_row[ow];
+                }
+              }
+            }
+          }
+        }
+      }
+    });
+  }
+
+  // parallel over the filters, so that every filter_diff is owned by one thread
+  static void NCHWFilterGrad(const DepthwiseConv2DParams& p, const T* dy, const T* x,
+                             T* filter_diff) {
+    const int64_t parallel_num = GetConvParallelNum(p.filters);
+    ParallelForEachRange(p.filters, parallel_num, [&](int64_t, const Range& range) {
+      FOR_RANGE(int64_t, o, range.begin(), range.end()) {
+        T* dw_o = filter_diff + o * p.kernel_size();
+        std::fill(dw_o, dw_o + p.kernel_size(), static_cast<T>(0));
+        FOR_RANGE(int64_t, n, 0, p.batch_size) {
+          const T* x_plane = x + (n * p.channels + o / p.multiplier) * p.in_h * p.in_w;
+          const T* dy_plane = dy + (n * p.filters + o) * p.out_h * p.out_w;
+          FOR_RANGE(int64_t, kw, 0, p.kernel_w) {
+            int64_t ow_begin = 0;
+            int64_t ow_end = 0;
+            CalcValidOutRange(p.in_w, p.out_w, p.stride_w, p.padding_w, kw * p.dilation_w,
+                              &ow_begin, &ow_end);
+            const int64_t iw_offset = kw * p.dilation_w - p.padding_w;
+            FOR_RANGE(int64_t, kh, 0, p.kernel_h) {
+              T sum = 0;
+              FOR_RANGE(int64_t, oh, 0, p.out_h) {
+                const int64_t ih = oh * p.stride_h - p.padding_h + kh * p.dilation_h;
+                if (ih < 0 || ih >= p.in_h) { continue; }
+                const T* x_row = x_plane + ih * p.in_w;
+                const T* dy_row = dy_plane + oh * p.out_w;
+                FOR_RANGE(int64_t, ow, ow_begin, ow_end) {
+                  sum += dy_row[ow] * x_row[ow * p.stride_w + iw_offset];
+                }
+              }
+              dw_o[kh * p.kernel_w + kw] += sum;
+            }
+          }
+        }
+      }
+    });
+  }
+};
+
+template<typename T>
+class DepthwiseConv2DCpuKernel final : public user_op::OpKernel {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(DepthwiseConv2DCpuKernel);
+  DepthwiseConv2DCpuKernel() = default;
+  ~DepthwiseConv2DCpuKernel() = default;
+
+  bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
+
+ private:
+  void Compute(user_op::KernelComputeContext* ctx) const override {
+    const user_op::Tensor* in = ctx->Tensor4ArgNameAndIndex("in", 0);
+    const user_op::Tensor* weight = ctx->Tensor4ArgNameAndIndex("weight", 0);
+    const user_op::Tensor* bias = ctx->Tensor4ArgNameAndIndex("bias", 0);
+    user_op::Tensor* out = ctx->Tensor4ArgNameAndIndex("out", 0);
+    const DepthwiseConv2DParams params = MakeDepthwiseConv2DParams(ctx, in->shape(), out->shape());
+    const T* bias_dptr = bias == nullptr ? nullptr : bias->dptr<T>();
+    if (params.is_channels_last) {
+      user_op::Tensor* tmp_buffer = ctx->Tensor4ArgNameAndIndex("tmp_buffer", 0);
+      TransposeDepthwiseWeight(params, weight->dptr<T>(), tmp_buffer->mut_dptr<T>());
+      DepthwiseConv2DKernelUtil<T>::NHWCForward(params, in->dptr<T>(), tmp_buffer->dptr<T>(),
+                                                bias_dptr, out->mut_dptr<T>());
+    } else {
+      DepthwiseConv2DKernelUtil<T>::NCHWForward(params, in->dptr<T>(), weight->dptr<T>(),
+                                                bias_dptr, out->mut_dptr<T>());
+    }
+  }
+};
+
+template<typename T>
+class DepthwiseConv2DDataGradCpuKernel final : public user_op::OpKernel {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(DepthwiseConv2DDataGradCpuKernel);
+  DepthwiseConv2DDataGradCpuKernel() = default;
+  ~DepthwiseConv2DDataGradCpuKernel() = default;
+
+  bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
+
+ private:
+  void Compute(user_op::KernelComputeContext* ctx) const override {
+    const user_op::Tensor* dy = ctx->Tensor4ArgNameAndIndex("dy", 0);
+    const user_op::Tensor* filter = ctx->Tensor4ArgNameAndIndex("filter", 0);
+    user_op::Tensor* dx = ctx->Tensor4ArgNameAndIndex("dx", 0);
+    const DepthwiseConv2DParams params = MakeDepthwiseConv2DParams(ctx, dx->shape(), dy->shape());
+    if (params.is_channels_last) {
+      user_op::Tensor* tmp_buffer = ctx->Tensor4ArgNameAndIndex("tmp_buffer", 0);
+      TransposeDepthwiseWeight(params, filter->dptr<T>(), tmp_buffer->mut_dptr<T>());
+      DepthwiseConv2DKernelUtil<T>::NHWCDataGrad(params, dy->dptr<T>(), tmp_buffer->dptr<T>(),
+                                                 dx->mut_dptr<T>());
+    } else {
+      DepthwiseConv2DKernelUtil<T>::NCHWDataGrad(params, dy->dptr<T>(), filter->dptr<T>(),
+                                                 dx->mut_dptr<T>());
+    }
+  }
+};
+
+template<typename T>
+class DepthwiseConv2DFilterGradCpuKernel final : public user_op::OpKernel {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(DepthwiseConv2DFilterGradCpuKernel);
+  DepthwiseConv2DFilterGradCpuKernel() = default;
+  ~DepthwiseConv2DFilterGradCpuKernel() = default;
+
+  bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
+
+ private:
+  void Compute(user_op::KernelComputeContext* ctx) const override {
+    const user_op::Tensor* dy = ctx->Tensor4ArgNameAndIndex("dy", 0);
+    const user_op::Tensor* x = ctx->Tensor4ArgNameAndIndex("x", 0);
+    user_op::Tensor* filter_diff = ctx->Tensor4ArgNameAndIndex("filter_diff", 0);
+    const DepthwiseConv2DParams params = MakeDepthwiseConv2DParams(ctx, x->shape(), dy->shape());
+    if (params.is_channels_last) {
+      user_op::Tensor* tmp_buffer = ctx->Tensor4ArgNameAndIndex("tmp_buffer", 0);
+      const int64_t parallel_num = GetConvParallelNum(
+          params.batch_size, tmp_buffer, 0, filter_diff->shape().elem_cnt() * sizeof(T), 0);
+      DepthwiseConv2DKernelUtil<T>::NHWCFilterGrad(params, parallel_num, dy->dptr<T>(),
+                                                   x->dptr<T>(), tmp_buffer->mut_dptr<T>(),
+                                                   filter_diff->mut_dptr<T>());
+    } else {
+      DepthwiseConv2DKernelUtil<T>::NCHWFilterGrad(params, dy->dptr<T>(), x->dptr<T>(),
+                                                   filter_diff->mut_dptr<T>());
+    }
+  }
+};
+
+size_t InferDepthwiseConv2DTmpSize(user_op::InferContext* ctx, const std::string& weight_name,
+                                   const std::string& parallel_bn, size_t elem_size) {
+  if (ctx->Attr<std::string>("data_format") != "channels_last") { return 0; }
+  int64_t parallel_num = 1;
+  if (!parallel_bn.empty()) {
+    const Shape& parallel_shape = ctx->TensorDesc4ArgNameAndIndex(parallel_bn, 0)->shape();
+    parallel_num = GetConvParallelNum(parallel_shape.At(0));
+  }
+  return parallel_num * ctx->TensorDesc4ArgNameAndIndex(weight_name, 0)->shape().elem_cnt()
+         * elem_size;
+}
+
+#define REGISTER_DEPTHWISE_CONV2D_KERNELS(dtype)                                              \
+  REGISTER_USER_KERNEL("conv2d")                                                              \
+      .SetCreateFn<DepthwiseConv2DCpuKernel<dtype>>()                                         \
+      .SetIsMatchedHob((user_op::HobDeviceType() == DeviceType::kCPU)                         \
+                       & (HobIsDepthwiseConv2D("in") == true)                                 \
+                       & (user_op::HobDataType("in", 0) == GetDataType<dtype>::value))        \
+      .SetInferTmpSizeFn([](user_op::InferContext* ctx) -> size_t {                           \
+        return InferDepthwiseConv2DTmpSize(ctx, "weight", "", sizeof(dtype));                 \
+      });                                                                                     \
+  REGISTER_USER_KERNEL("conv_data_grad")                                                      \
+      .SetCreateFn<DepthwiseConv2DDataGradCpuKernel<dtype>>()                                 \
+      .SetIsMatchedHob((user_op::HobDeviceType() == DeviceType::kCPU)                         \
+                       & (HobIsDepthwiseConv2D("x_like") == true)                             \
+                       & (user_op::HobDataType("dy", 0) == GetDataType<dtype>::value))        \
+      .SetInferTmpSizeFn([](user_op::InferContext* ctx) -> size_t {                           \
+        return InferDepthwiseConv2DTmpSize(ctx, "filter", "", sizeof(dtype));                 \
+      });                                                                                     \
+  REGISTER_USER_KERNEL("conv_filter_grad")                                                    \
+      .SetCreateFn<DepthwiseConv2DFilterGradCpuKernel<dtype>>()                               \
+      .SetIsMatchedHob((user_op::HobDeviceType() == DeviceType::kCPU)                         \
+                       & (HobIsDepthwiseConv2D("x") == true)                                  \
+                       & (user_op::HobDataType("dy", 0) == GetDataType<dtype>::value))        \
+      .SetInferTmpSizeFn([](user_op::InferContext* ctx) -> size_t {                           \
+        return InferDepthwiseConv2DTmpSize(ctx, "filter_diff", "dy", sizeof(dtype));          \
+      });
+
+REGISTER_DEPTHWISE_CONV2D_KERNELS(float)
+REGISTER_DEPTHWISE_CONV2D_KERNELS(double)
+
 template<typename T>
 class ConvBiasGradCpuKernel final : public user_op::OpKernel {
  public:
@@ -0,0 +1,107 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/framework/framework.h"
+#include "oneflow/core/kernel/util/host_elementwise.h"
+
+namespace oneflow {
+
+namespace {
+
+template<typename T>
+struct ReluFunctor {
+  T operator()(T x) const { return std::max(x, GetZeroVal<T>()); }
+};
+
+// same formula as gelu kernel
+template<typename T>
+struct GeluFunctor {
+  T operator()(T x) const {
+    const T inv_sqrt2 = std::sqrt(0.5);
+    return 0.5 * x * (1.0 + std::erf(inv_sqrt2 * x));
+  }
+};
+
+// the bias and the activation are applied in one pass over the blob, the rows of
+// [outer_size, bias_size * inner_size] are split across the thread pool
+template<typename T, typename ActivationT>
+void BiasAddActivation(ActivationT activation, int64_t outer_size, int64_t bias_size,
+                       int64_t inner_size, const T* a, const T* b, T* out) {
+  const int64_t row_size = bias_size * inner_size;
+  host_elementwise::ParallelForRows(outer_size, row_size, [&](int64_t begin, int64_t end) {
+    FOR_RANGE(int64_t, i, begin, end) {
+      const T* a_row = a + i * row_size;
+      T* out_row = out + i * row_size;
+      if (inner_size == 1) {
+        FOR_RANGE(int64_t, j, 0, bias_size) { out_row[j] = activation(a_row[j] + b[j]); }
+      } else {
+        FOR_RANGE(int64_t, j, 0, bias_size) {
+          const T bias = b[j];
+          const T* a_ptr = a_row + j * inner_size;
+          T* out_ptr = out_row + j * inner_size;
+          FOR_RANGE(int64_t, k, 0, inner_size) { out_ptr[k] = activation(a_ptr[k] + bias); }
+        }
+      }
+    }
+  });
+}
+
+template<typename T>
+class CpuFusedBiasAddActivationKernel final : public user_op::OpKernel {
+ public:
+  CpuFusedBiasAddActivationKernel() = default;
+  ~CpuFusedBiasAddActivationKernel() = default;
+
+ private:
+  void Compute(user_op::KernelComputeContext* ctx) const override {
+    const user_op::Tensor* a = ctx->Tensor4ArgNameAndIndex("a", 0);
+    const user_op::Tensor* b = ctx->Tensor4ArgNameAndIndex("b", 0);
+    user_op::Tensor* out = ctx->Tensor4ArgNameAndIndex("out", 0);
+    const int32_t bias_add_axis = ctx->Attr<int32_t>("axis");
+    const std::string& activation = ctx->Attr<std::string>("activation");
+    const int64_t outer_size = a->shape().Count(0, bias_add_axis);
+    const int64_t bias_size = a->shape().At(bias_add_axis);
+    const int64_t inner_size = a->shape().Count(bias_add_axis + 1);
+    if (activation == "relu") {
+      BiasAddActivation<T>(ReluFunctor<T>(), outer_size, bias_size, inner_size, a->dptr<T>(),
+                           b->dptr<T>(), out->mut_dptr<T>());
+    } else if (activation == "gelu") {
+      BiasAddActivation<T>(GeluFunctor<T>(), outer_size, bias_size, inner_size, a->dptr<T>(),
+                           b->dptr<T>(), out->mut_dptr<T>());
+    } else {
+      UNIMPLEMENTED();
+    }
+  }
+
+  bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
+};
+
+#define REGISTER_CPU_FUSED_BIAS_ADD_ACTIVATION_KERNEL(dtype)                                    \
+  REGISTER_USER_KERNEL("fused_bias_add_activation")                                             \
+      .SetCreateFn<CpuFusedBiasAddActivationKernel<dtype>>()                                    \
+      .SetIsMatchedHob((user_op::HobDeviceType() == DeviceType::kCPU)                           \
+                       & (user_op::HobDataType("out", 0) == GetDataType<dtype>::value))         \
+      .SetInplaceProposalFn([](const user_op::InferContext&,                                    \
+                               user_op::AddInplaceArgPair AddInplaceArgPairFn) -> Maybe<void> { \
+        OF_RETURN_IF_ERROR(AddInplaceArgPairFn("out", 0, "a", 0, true));                        \
+        return Maybe<void>::Ok();                                                               \
+      });
+
+REGISTER_CPU_FUSED_BIAS_ADD_ACTIVATION_KERNEL(float)
+REGISTER_CPU_FUSED_BIAS_ADD_ACTIVATION_KERNEL(double)
+
+}  // namespace
+
+}  // namespace oneflow
@@ -0,0 +1,74 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/framework/framework.h"
+#include "oneflow/core/kernel/util/host_elementwise.h"
+
+namespace oneflow {
+
+namespace {
+
+template<typename T>
+class CpuFusedScaleAddNKernel final : public user_op::OpKernel {
+ public:
+  CpuFusedScaleAddNKernel() = default;
+  ~CpuFusedScaleAddNKernel() = default;
+
+ private:
+  void Compute(user_op::KernelComputeContext* ctx) const override {
+    const std::vector<float>& scales = ctx->Attr<std::vector<float>>("scales");
+    const size_t in_num = ctx->inputs().size();
+    CHECK_EQ(scales.size(), in_num);
+    user_op::Tensor* out = ctx->Tensor4ArgNameAndIndex("out", 0);
+    const int64_t n = out->shape().elem_cnt();
+    T* out_dptr = out->mut_dptr<T>();
+    std::vector<const T*> in_dptrs(in_num);
+    FOR_RANGE(size_t, i, 0, in_num) {
+      in_dptrs.at(i) = ctx->Tensor4ArgNameAndIndex("in", i)->dptr<T>();
+    }
+    std::vector<T> in_scales(in_num);
+    FOR_RANGE(size_t, i, 0, in_num) { in_scales.at(i) = static_cast<T>(scales.at(i)); }
+    const T* scale_ptr = in_scales.data();
+    const T* const* in_ptrs = in_dptrs.data();
+    // every element reads all the inputs before out is written, so out may alias any input
+    host_elementwise::ParallelFor(n, [&](int64_t begin, int64_t end) {
+      FOR_RANGE(int64_t, j, begin, end) {
+        T sum = scale_ptr[0] * in_ptrs[0][j];
+        FOR_RANGE(size_t, i, 1, in_num) { sum += scale_ptr[i] * in_ptrs[i][j]; }
+        out_dptr[j] = sum;
+      }
+    });
+  }
+
+  bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
+};
+
+#define REGISTER_CPU_FUSED_SCALE_ADD_N_KERNEL(dtype)                                            \
+  REGISTER_USER_KERNEL("fused_scale_add_n")                                                     \
+      .SetCreateFn<CpuFusedScaleAddNKernel<dtype>>()                                            \
+      .SetIsMatchedHob((user_op::HobDeviceType() == DeviceType::kCPU)                           \
+                       & (user_op::HobDataType("out", 0) == GetDataType<dtype>::value))         \
+      .SetInplaceProposalFn([](const user_op::InferContext&,                                    \
+                               user_op::AddInplaceArgPair AddInplaceArgPairFn) -> Maybe<void> { \
+        OF_RETURN_IF_ERROR(AddInplaceArgPairFn("out", 0, "in", 0, true));                       \
+        return Maybe<void>::Ok();                                                               \
+      });
+
+REGISTER_CPU_FUSED_SCALE_ADD_N_KERNEL(float)
+REGISTER_CPU_FUSED_SCALE_ADD_N_KERNEL(double)
+
+}  // namespace
+
+}  // namespace oneflow
@@ -15,6 +15,7 @@ limitations under the License.
 */
 #include "oneflow/core/framework/framework.h"
 #include "oneflow/customized/kernels/math_binary_elementwise_func.h"
+#include "oneflow/core/kernel/util/host_elementwise.h"
 
 namespace oneflow {
 
@@ -32,9 +33,9 @@ class MathBinaryElementwiseCpuKernel final : public user_op::OpKernel {
     const T* x = tensor_x->dptr<T>();
     const T* y = tensor_y->dptr<T>();
     T* z = tensor_z->mut_dptr<T>();
-    int64_t n = tensor_x->shape().elem_cnt();
-    CHECK_LE(n, GetMaxVal<int32_t>() / 2);
-    for (int32_t i = 0; i < n; ++i) { z[i] = BinaryFunctor<T>::Forward(x[i], y[i]); }
+    const int64_t n = tensor_x->shape().elem_cnt();
+    host_elementwise::Binary([](const T x, const T y) { return BinaryFunctor<T>::Forward(x, y); },
+                             n, z, x, y);
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
 };
@@ -56,9 +57,10 @@ class MathBinaryElementwiseXGradCpuKernel final : public user_op::OpKernel {
     const T* y = tensor_y->dptr<T>();
     const T* dz = tensor_dz->dptr<T>();
     T* dx = tensor_dx->mut_dptr<T>();
-    int64_t n = tensor_x->shape().elem_cnt();
-    CHECK_LE(n, GetMaxVal<int32_t>() / 2);
-    for (int32_t i = 0; i < n; ++i) { dx[i] = BinaryFunctor<T>::BackwardXGrad(x[i], y[i], dz[i]); }
+    const int64_t n = tensor_x->shape().elem_cnt();
+    host_elementwise::Ternary(
+        [](const T x, const T y, const T dz) { return BinaryFunctor<T>::BackwardXGrad(x, y, dz); },
+        n, dx, x, y, dz);
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
 };
@@ -80,9 +82,10 @@ class MathBinaryElementwiseYGradCpuKernel final : public user_op::OpKernel {
     const T* y = tensor_y->dptr<T>();
     const T* dz = tensor_dz->dptr<T>();
     T* dy = tensor_dy->mut_dptr<T>();
-    int64_t n = tensor_x->shape().elem_cnt();
-    CHECK_LE(n, GetMaxVal<int32_t>() / 2);
-    for (int32_t i = 0; i < n; ++i) { dy[i] = BinaryFunctor<T>::BackwardYGrad(x[i], y[i], dz[i]); }
+    const int64_t n = tensor_x->shape().elem_cnt();
+    host_elementwise::Ternary(
+        [](const T x, const T y, const T dz) { return BinaryFunctor<T>::BackwardYGrad(x, y, dz); },
+        n, dy, x, y, dz);
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
 };
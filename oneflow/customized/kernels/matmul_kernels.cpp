@@ -138,6 +138,7 @@ class BatchMatmulFloatingKernel final : public user_op::OpKernel {
   }
 };
 
+// tmp_buffer holds the a, b and c pointer arrays of the batched gemm of cublas or MKL
 #define REGISTER_BATCH_MATMUL_KERNEL(device, dtype)                                   \
   REGISTER_USER_KERNEL("batch_matmul")                                                \
       .SetCreateFn<BatchMatmulFloatingKernel<device, dtype>>()                        \
@@ -16,7 +16,8 @@ limitations under the License.
 #include "oneflow/core/framework/framework.h"
 #include "oneflow/customized/kernels/op_kernel_state_wrapper.h"
 #include "oneflow/customized/utils/pool_util.h"
-#include "oneflow/core/common/eigen_util.h"
+#include "oneflow/core/thread/thread_manager.h"
+#include "oneflow/core/common/balanced_splitter.h"
 
 namespace oneflow {
 
@@ -33,209 +34,259 @@ struct PoolOpKernelState final : public user_op::OpKernelState {
   }
 };
 
-template<typename T>
-struct PoolCpuKernelUtil {
- public:
-  typedef std::function<T()> ForwardInitialize;
-  typedef std::function<void(const T& lhs, T& rhs)> CFirstProcess;
-  typedef std::function<void(const int64_t in_col, const int64_t out_col,
-                             ConstEigenMatrixMap<T>& in_mat, EigenMatrixMap<T>& out_mat)>
-      CLastProcess;
-  typedef std::function<void(const int64_t size, T& out)> CFirstFinalize;
-  typedef std::function<void(const int64_t size, const int64_t col, EigenMatrixMap<T>& out_mat)>
-      CLastFinalize;
-  typedef std::function<void(const T& in, const T& out, const T& out_diff, const int64_t size,
-                             T& in_diff)>
-      CFirstProcessGrad;
-  typedef std::function<void(const int64_t out_col, const int64_t in_col, const int64_t size,
-                             ConstEigenArrayMap<T>& out_arr, ConstEigenArrayMap<T>& in_arr,
-                             ConstEigenArrayMap<T>& out_diff_arr, EigenArrayMap<T>& in_diff_arr)>
-      CLastProcessGrad;
-
-  static void CFirstForward(const Params3D& params_3d, const user_op::Tensor* in_blob,
-                            user_op::Tensor* out_blob, const ForwardInitialize& initialize,
-                            const CFirstProcess& process, const CFirstFinalize& finalize) {
-    const Shape& in = params_3d.GetXShape5D();
-    const Shape& out = params_3d.GetYShape5D();
-    const std::vector<int32_t>& pool_size = params_3d.pool_size_3d();
-    const std::vector<int32_t>& strides = params_3d.strides_3d();
-    const std::vector<int32_t>& padding_before = params_3d.padding_before_3d();
+// pooling window of one output clipped to the input, or the outputs whose windows cover one input
+struct PoolRange {
+  int64_t start;
+  int64_t end;
+  int64_t size() const { return end - start; }
+};
 
-    const T* input = in_blob->dptr<T>();
-    T* output = out_blob->mut_dptr<T>();
-    FOR_RANGE(int64_t, n, 0, in.At(0)) {
-      FOR_RANGE(int64_t, c, 0, in.At(1)) {
-        FOR_RANGE(int64_t, pd, 0, out.At(2)) {
-          int64_t dstart = pd * strides.at(0) - padding_before.at(0);
-          int64_t dend = std::min(dstart + pool_size.at(0), in.At(2));
-          dstart = std::max(dstart, static_cast<int64_t>(0));
-          FOR_RANGE(int64_t, ph, 0, out.At(3)) {
-            int64_t hstart = ph * strides.at(1) - padding_before.at(1);
-            int64_t hend = std::min(hstart + pool_size.at(1), in.At(3));
-            hstart = std::max(hstart, static_cast<int64_t>(0));
-            FOR_RANGE(int64_t, pw, 0, out.At(4)) {
-              int64_t wstart = pw * strides.at(2) - padding_before.at(2);
-              int64_t wend = std::min(wstart + pool_size.at(2), in.At(4));
-              wstart = std::max(wstart, static_cast<int64_t>(0));
-
-              const int64_t pool_index = pd * out.Count(3) + ph * out.At(4) + pw;
-              T res = initialize();
-              FOR_RANGE(int64_t, d, dstart, dend) {
-                FOR_RANGE(int64_t, h, hstart, hend) {
-                  FOR_RANGE(int64_t, w, wstart, wend) {
-                    const int64_t input_index = d * in.Count(3) + h * in.At(4) + w;
-                    process(input[input_index], res);
-                  }
-                }
-              }
-              finalize((dend - dstart) * (hend - hstart) * (wend - wstart), res);
-              output[pool_index] = res;
-            }
-          }
-        }
-        input += in.Count(2);
-        output += out.Count(2);
-      }
+std::vector<PoolRange> GetWindowRanges(int64_t in_size, int64_t out_size, int32_t pool_size,
+                                       int32_t stride, int32_t padding_before) {
+  std::vector<PoolRange> windows(out_size);
+  FOR_RANGE(int64_t, o, 0, out_size) {
+    const int64_t start = o * stride - padding_before;
+    windows.at(o).start = std::max<int64_t>(start, 0);
+    windows.at(o).end = std::min<int64_t>(start + pool_size, in_size);
+  }
+  return windows;
+}
+
+std::vector<PoolRange> GetCoveringRanges(int64_t in_size, const std::vector<PoolRange>& windows) {
+  std::vector<PoolRange> covering_ranges(in_size, PoolRange{0, 0});
+  FOR_RANGE(int64_t, o, 0, windows.size()) {
+    FOR_RANGE(int64_t, i, windows.at(o).start, windows.at(o).end) {
+      PoolRange& range = covering_ranges.at(i);
+      if (range.size() == 0) { range.start = o; }
+      range.end = o + 1;
     }
   }
+  return covering_ranges;
+}
 
-  static void CFirstBackward(const Params3D& params_3d, const user_op::Tensor* out_diff_blob,
-                             const user_op::Tensor* out_blob, const user_op::Tensor* in_blob,
-                             user_op::Tensor* in_diff_blob, const CFirstProcessGrad& process) {
+// Both layouts are viewed as outer x (d, h) rows x w x inner, so that every row is contiguous and
+// the innermost loops run over the `inner` contiguous channels:
+//   channels_first: outer = n * c, inner = 1
+//   channels_last:  outer = n, inner = c
+struct PoolCpuShape {
+  PoolCpuShape(const Params3D& params_3d, const std::string& data_format) {
     const Shape& in = params_3d.GetXShape5D();
     const Shape& out = params_3d.GetYShape5D();
+    if (data_format == "channels_first") {
+      outer = in.At(0) * in.At(1);
+      inner = 1;
+    } else {
+      CHECK_EQ(data_format, "channels_last");
+      outer = in.At(0);
+      inner = in.At(1);
+    }
+    in_d = in.At(2);
+    in_h = in.At(3);
+    in_w = in.At(4);
+    out_d = out.At(2);
+    out_h = out.At(3);
+    out_w = out.At(4);
     const std::vector<int32_t>& pool_size = params_3d.pool_size_3d();
     const std::vector<int32_t>& strides = params_3d.strides_3d();
     const std::vector<int32_t>& padding_before = params_3d.padding_before_3d();
+    d_windows = GetWindowRanges(in_d, out_d, pool_size.at(0), strides.at(0), padding_before.at(0));
+    h_windows = GetWindowRanges(in_h, out_h, pool_size.at(1), strides.at(1), padding_before.at(1));
+    w_windows = GetWindowRanges(in_w, out_w, pool_size.at(2), strides.at(2), padding_before.at(2));
+  }
+  int64_t InRowOffset(int64_t o, int64_t d, int64_t h) const {
+    return ((o * in_d + d) * in_h + h) * in_w * inner;
+  }
+  int64_t OutRowOffset(int64_t o, int64_t d, int64_t h) const {
+    return ((o * out_d + d) * out_h + h) * out_w * inner;
+  }
 
-    const T* output_diff = out_diff_blob->dptr<T>();
-    const T* output = out_blob->dptr<T>();
-    const T* input = in_blob->dptr<T>();
-    std::memset(in_diff_blob->mut_dptr<T>(), T(0), in.elem_cnt() * sizeof(T));
-    T* input_diff = in_diff_blob->mut_dptr<T>();
-    FOR_RANGE(int64_t, n, 0, in.At(0)) {
-      FOR_RANGE(int64_t, c, 0, in.At(1)) {
-        FOR_RANGE(int64_t, pd, 0, out.At(2)) {
-          int64_t dstart = pd * strides.at(0) - padding_before.at(0);
-          int64_t dend = std::min(dstart + pool_size.at(0), in.At(2));
-          dstart = std::max(dstart, static_cast<int64_t>(0));
-          FOR_RANGE(int64_t, ph, 0, out.At(3)) {
-            int64_t hstart = ph * strides.at(1) - padding_before.at(1);
-            int64_t hend = std::min(hstart + pool_size.at(1), in.At(3));
-            hstart = std::max(hstart, static_cast<int64_t>(0));
-            FOR_RANGE(int64_t, pw, 0, out.At(4)) {
-              int64_t wstart = pw * strides.at(2) - padding_before.at(2);
-              int64_t wend = std::min(wstart + pool_size.at(2), in.At(4));
-              wstart = std::max(wstart, static_cast<int64_t>(0));
-
-              const int64_t size = (dend - dstart) * (hend - hstart) * (wend - wstart);
-              const int64_t pool_index = pd * out.Count(3) + ph * out.At(4) + pw;
-              FOR_RANGE(int64_t, d, dstart, dend) {
-                FOR_RANGE(int64_t, h, hstart, hend) {
-                  FOR_RANGE(int64_t, w, wstart, wend) {
-                    const int64_t index = d * in.Count(3) + h * in.At(4) + w;
-                    process(input[index], output[pool_index], output_diff[pool_index], size,
-                            input_diff[index]);
-                  }
-                }
+  int64_t outer;
+  int64_t inner;
+  int64_t in_d;
+  int64_t in_h;
+  int64_t in_w;
+  int64_t out_d;
+  int64_t out_h;
+  int64_t out_w;
+  std::vector<PoolRange> d_windows;
+  std::vector<PoolRange> h_windows;
+  std::vector<PoolRange> w_windows;
+};
+
+// a part should have enough elements to amortize the cost of dispatching it to the thread pool
+constexpr int64_t kPoolMinElemCntPerPart = 4096;
+
+int64_t GetPoolParallelNum(int64_t row_num, int64_t row_elem_cnt) {
+  const ThreadPool* thread_pool = Global<ThreadPool>::Get();
+  const int64_t thread_num = thread_pool == nullptr ? 1 : thread_pool->thread_num();
+  const int64_t part_num = row_num * row_elem_cnt / kPoolMinElemCntPerPart;
+  return std::max<int64_t>(std::min(std::min(row_num, thread_num), part_num), 1);
+}
+
+void ParallelForEachRow(int64_t row_num, int64_t parallel_num,
+                        const std::function<void(int64_t part_id, const Range& rows)>& Handler) {
+  if (parallel_num == 1) {
+    Handler(0, Range(0, row_num));
+    return;
+  }
+  const BalancedSplitter bs(row_num, parallel_num);
+  MultiThreadLoop(parallel_num, [&](size_t part_id) { Handler(part_id, bs.At(part_id)); });
+}
+
+// Overlapping average windows along w are computed on the sum of the d x h window rows with a
+// running sum, which costs O(w) instead of O(out_w * pool_size_w) per output row
+constexpr int32_t kSeparableAvgPoolMinWindow = 3;
+
+bool IsSeparableAvgPool(int32_t pool_size_w, int32_t stride_w) {
+  return pool_size_w >= kSeparableAvgPoolMinWindow && stride_w < pool_size_w;
+}
+
+// a row sum of in_w * inner elements and a running window sum of inner elements per part
+int64_t GetSeparableAvgPoolPartBufElemCnt(int64_t in_w, int64_t inner) {
+  return (in_w + 1) * inner;
+}
+
+template<typename T>
+struct AvgPoolFunctor {
+  static T Initial() { return GetZeroVal<T>(); }
+  static void Process(const T x, T& y) { y += x; }
+  static void Finalize(const int64_t size, T& y) { y /= static_cast<T>(size); }
+  static void ProcessGrad(const T x, const T y, const T dy, const int64_t size, T& dx) {
+    dx += dy / static_cast<T>(size);
+  }
+};
+
+template<typename T>
+struct MaxPoolFunctor {
+  static T Initial() { return GetMinVal<T>(); }
+  static void Process(const T x, T& y) { y = x > y ? x : y; }
+  static void Finalize(const int64_t size, T& y) {}
+  static void ProcessGrad(const T x, const T y, const T dy, const int64_t size, T& dx) {
+    dx += x == y ? dy : GetZeroVal<T>();
+  }
+};
+
+template<typename T>
+struct PoolCpuKernelUtil {
+ public:
+  template<typename Functor>
+  static void Forward(const PoolCpuShape& s, const T* x, T* y) {
+    const int64_t row_num = s.outer * s.out_d * s.out_h;
+    const int64_t parallel_num = GetPoolParallelNum(row_num, s.out_w * s.inner);
+    ParallelForEachRow(row_num, parallel_num, [&](int64_t part_id, const Range& rows) {
+      FOR_RANGE(int64_t, row, rows.begin(), rows.end()) {
+        const int64_t o = row / (s.out_d * s.out_h);
+        const PoolRange& d_window = s.d_windows.at(row / s.out_h % s.out_d);
+        const PoolRange& h_window = s.h_windows.at(row % s.out_h);
+        T* y_row = y + row * s.out_w * s.inner;
+        FOR_RANGE(int64_t, ow, 0, s.out_w) {
+          const PoolRange& w_window = s.w_windows.at(ow);
+          T* y_px = y_row + ow * s.inner;
+          FOR_RANGE(int64_t, c, 0, s.inner) { y_px[c] = Functor::Initial(); }
+          FOR_RANGE(int64_t, d, d_window.start, d_window.end) {
+            FOR_RANGE(int64_t, h, h_window.start, h_window.end) {
+              const T* x_row = x + s.InRowOffset(o, d, h);
+              FOR_RANGE(int64_t, w, w_window.start, w_window.end) {
+                const T* x_px = x_row + w * s.inner;
+                FOR_RANGE(int64_t, c, 0, s.inner) { Functor::Process(x_px[c], y_px[c]); }
               }
             }
           }
+          const int64_t size = d_window.size() * h_window.size() * w_window.size();
+          FOR_RANGE(int64_t, c, 0, s.inner) { Functor::Finalize(size, y_px[c]); }
         }
-        // offset
-        input += in.Count(2);
-        input_diff += in.Count(2);
-        output += out.Count(2);
-        output_diff += out.Count(2);
       }
-    }
+    });
   }
 
-  static void CLastForward(const Params3D& params_3d, const user_op::Tensor* in_blob,
-                           user_op::Tensor* out_blob, const ForwardInitialize& forward_initialize,
-                           const CLastProcess& process, const CLastFinalize& finalize) {
-    const Shape& in = params_3d.GetXShape5D();
-    const Shape& out = params_3d.GetYShape5D();
-    const std::vector<int32_t>& pool_size = params_3d.pool_size_3d();
-    const std::vector<int32_t>& strides = params_3d.strides_3d();
-    const std::vector<int32_t>& padding_before = params_3d.padding_before_3d();
-
-    ConstEigenMatrixMap<T> in_mat(in_blob->dptr<T>(), in.At(1), in.elem_cnt() / in.At(1));
-    EigenMatrixMap<T> out_mat(out_blob->mut_dptr<T>(), out.At(1), out.elem_cnt() / out.At(1));
-    FOR_RANGE(int64_t, n, 0, in.At(0)) {
-      FOR_RANGE(int64_t, pd, 0, out.At(2)) {
-        int64_t dstart = pd * strides.at(0) - padding_before.at(0);
-        int64_t dend = std::min(dstart + pool_size.at(0), in.At(2));
-        dstart = std::max(dstart, static_cast<int64_t>(0));
-        FOR_RANGE(int64_t, ph, 0, out.At(3)) {
-          int64_t hstart = ph * strides.at(1) - padding_before.at(1);
-          int64_t hend = std::min(hstart + pool_size.at(1), in.At(3));
-          hstart = std::max(hstart, static_cast<int64_t>(0));
-          FOR_RANGE(int64_t, pw, 0, out.At(4)) {
-            int64_t wstart = pw * strides.at(2) - padding_before.at(2);
-            int64_t wend = std::min(wstart + pool_size.at(2), in.At(4));
-            wstart = std::max(wstart, static_cast<int64_t>(0));
-            const int out_col = ((n * out.At(2) + pd) * out.At(3) + ph) * out.At(4) + pw;
-            out_mat.col(out_col).setConstant(forward_initialize());
-            FOR_RANGE(int64_t, d, dstart, dend) {
-              FOR_RANGE(int64_t, h, hstart, hend) {
-                FOR_RANGE(int64_t, w, wstart, wend) {
-                  const int in_col = ((n * in.At(2) + d) * in.At(3) + h) * in.At(4) + w;
-                  process(in_col, out_col, in_mat, out_mat);
-                }
-              }
-            }
-            finalize((hend - hstart) * (wend - wstart) * (dend - dstart), out_col, out_mat);
+  static void SeparableAvgForward(const PoolCpuShape& s, const T* x, T* y, T* buf,
+                                  int64_t buf_elem_cnt) {
+    const int64_t row_num = s.outer * s.out_d * s.out_h;
+    const int64_t row_elem_cnt = s.in_w * s.inner;
+    const int64_t part_buf_elem_cnt = GetSeparableAvgPoolPartBufElemCnt(s.in_w, s.inner);
+    CHECK_GE(buf_elem_cnt, part_buf_elem_cnt);
+    const int64_t parallel_num = std::min(GetPoolParallelNum(row_num, s.out_w * s.inner),
+                                          buf_elem_cnt / part_buf_elem_cnt);
+    ParallelForEachRow(row_num, parallel_num, [&](int64_t part_id, const Range& rows) {
+      T* row_sum = buf + part_id * part_buf_elem_cnt;
+      T* window_sum = row_sum + row_elem_cnt;
+      FOR_RANGE(int64_t, row, rows.begin(), rows.end()) {
+        const int64_t o = row / (s.out_d * s.out_h);
+        const PoolRange& d_window = s.d_windows.at(row / s.out_h % s.out_d);
+        const PoolRange& h_window = s.h_windows.at(row % s.out_h);
+        std::fill(row_sum, row_sum + row_elem_cnt, GetZeroVal<T>());
+        FOR_RANGE(int64_t, d, d_window.start, d_window.end) {
+          FOR_RANGE(int64_t, h, h_window.start, h_window.end) {
+            const T* x_row = x + s.InRowOffset(o, d, h);
+            FOR_RANGE(int64_t, i, 0, row_elem_cnt) { row_sum[i] += x_row[i]; }
+          }
+        }
+        // window_sum holds the sum of row_sum[lo, hi) along w
+        int64_t lo = 0;
+        int64_t hi = 0;
+        std::fill(window_sum, window_sum + s.inner, GetZeroVal<T>());
+        T* y_row = y + row * s.out_w * s.inner;
+        FOR_RANGE(int64_t, ow, 0, s.out_w) {
+          const PoolRange& w_window = s.w_windows.at(ow);
+          if (w_window.start >= hi) {
+            std::fill(window_sum, window_sum + s.inner, GetZeroVal<T>());
+            lo = hi = w_window.start;
+          }
+          for (; hi < w_window.end; ++hi) {
+            const T* px = row_sum + hi * s.inner;
+            FOR_RANGE(int64_t, c, 0, s.inner) { window_sum[c] += px[c]; }
+          }
+          for (; lo < w_window.start; ++lo) {
+            const T* px = row_sum + lo * s.inner;
+            FOR_RANGE(int64_t, c, 0, s.inner) { window_sum[c] -= px[c]; }
           }
+          const T size = static_cast<T>(d_window.size() * h_window.size() * w_window.size());
+          T* y_px = y_row + ow * s.inner;
+          FOR_RANGE(int64_t, c, 0, s.inner) { y_px[c] = window_sum[c] / size; }
         }
       }
-    }
+    });
   }
 
-  static void CLastBackward(const Params3D& params_3d, const user_op::Tensor* out_diff_blob,
-                            const user_op::Tensor* out_blob, const user_op::Tensor* in_blob,
-                            user_op::Tensor* in_diff_blob, const CLastProcessGrad& process) {
-    const Shape& in = params_3d.GetXShape5D();
-    const Shape& out = params_3d.GetYShape5D();
-    const std::vector<int32_t>& pool_size = params_3d.pool_size_3d();
-    const std::vector<int32_t>& strides = params_3d.strides_3d();
-    const std::vector<int32_t>& padding_before = params_3d.padding_before_3d();
-
-    // caffe2 implementation: need check
-    ConstEigenArrayMap<T> out_mat(out_blob->dptr<T>(), out.At(1), out.elem_cnt() / out.At(1));
-    ConstEigenArrayMap<T> in_mat(in_blob->dptr<T>(), in.At(1), in.elem_cnt() / in.At(1));
-    ConstEigenArrayMap<T> out_diff_mat(out_diff_blob->dptr<T>(), out.At(1),
-                                       out.elem_cnt() / out.At(1));
-    std::memset(in_diff_blob->mut_dptr<T>(), T(0), in.elem_cnt() * sizeof(T));
-    EigenArrayMap<T> in_diff_mat(in_diff_blob->mut_dptr<T>(), in.At(1), in.elem_cnt() / in.At(1));
-    FOR_RANGE(int64_t, n, 0, in.At(0)) {
-      FOR_RANGE(int64_t, pd, 0, out.At(2)) {
-        int64_t dstart = pd * strides.at(0) - padding_before.at(0);
-        int64_t dend = std::min(dstart + pool_size.at(0), in.At(2));
-        dstart = std::max(dstart, static_cast<int64_t>(0));
-        FOR_RANGE(int64_t, ph, 0, out.At(3)) {
-          int64_t hstart = ph * strides.at(1) - padding_before.at(1);
-          int64_t hend = std::min(hstart + pool_size.at(1), in.At(3));
-          hstart = std::max(hstart, static_cast<int64_t>(0));
-          FOR_RANGE(int64_t, pw, 0, out.At(4)) {
-            int64_t wstart = pw * strides.at(2) - padding_before.at(2);
-            int64_t wend = std::min(wstart + pool_size.at(2), in.At(4));
-            wstart = std::max(wstart, static_cast<int64_t>(0));
-            const int64_t pool_index = ((n * out.At(2) + pd) * out.At(3) + ph) * out.At(4) + pw;
-            const int64_t size = (dend - dstart) * (hend - hstart) * (wend - wstart);
-            FOR_RANGE(int64_t, d, dstart, dend) {
-              FOR_RANGE(int64_t, h, hstart, hend) {
-                FOR_RANGE(int64_t, w, wstart, wend) {
-                  const int64_t input_index = ((n * in.At(2) + d) * in.At(3) + h) * in.At(4) + w;
-                  process(pool_index, input_index, size, out_mat, in_mat, out_diff_mat,
-                          in_diff_mat);
+  // every input gathers the grads of the outputs whose windows cover it, so the rows of dx can be
+  // computed independently without memset or atomic accumulation
+  template<typename Functor>
+  static void Backward(const PoolCpuShape& s, const T* x, const T* y, const T* dy, T* dx) {
+    const std::vector<PoolRange> d_covering = GetCoveringRanges(s.in_d, s.d_windows);
+    const std::vector<PoolRange> h_covering = GetCoveringRanges(s.in_h, s.h_windows);
+    const std::vector<PoolRange> w_covering = GetCoveringRanges(s.in_w, s.w_windows);
+    const int64_t row_num = s.outer * s.in_d * s.in_h;
+    const int64_t parallel_num = GetPoolParallelNum(row_num, s.in_w * s.inner);
+    ParallelForEachRow(row_num, parallel_num, [&](int64_t part_id, const Range& rows) {
+      FOR_RANGE(int64_t, row, rows.begin(), rows.end()) {
+        const int64_t o = row / (s.in_d * s.in_h);
+        const PoolRange& od_range = d_covering.at(row / s.in_h % s.in_d);
+        const PoolRange& oh_range = h_covering.at(row % s.in_h);
+        const T* x_row = x + row * s.in_w * s.inner;
+        T* dx_row = dx + row * s.in_w * s.inner;
+        std::fill(dx_row, dx_row + s.in_w * s.inner, GetZeroVal<T>());
+        FOR_RANGE(int64_t, od, od_range.start, od_range.end) {
+          FOR_RANGE(int64_t, oh, oh_range.start, oh_range.end) {
+            const int64_t out_row_offset = s.OutRowOffset(o, od, oh);
+            const T* y_row = y + out_row_offset;
+            const T* dy_row = dy + out_row_offset;
+            const int64_t dh_size = s.d_windows.at(od).size() * s.h_windows.at(oh).size();
+            FOR_RANGE(int64_t, w, 0, s.in_w) {
+              const T* x_px = x_row + w * s.inner;
+              T* dx_px = dx_row + w * s.inner;
+              FOR_RANGE(int64_t, ow, w_covering.at(w).start, w_covering.at(w).end) {
+                const int64_t size = dh_size * s.w_windows.at(ow).size();
+                const T* y_px = y_row + ow * s.inner;
+                const T* dy_px = dy_row + ow * s.inner;
+                FOR_RANGE(int64_t, c, 0, s.inner) {
+                  Functor::ProcessGrad(x_px[c], y_px[c], dy_px[c], size, dx_px[c]);
                 }
               }
             }
           }
         }
       }
-    }
+    });
   }
 
   static void AvgFWCompute(user_op::KernelComputeContext* ctx, user_op::OpKernelState* state) {
@@ -244,20 +295,14 @@ struct PoolCpuKernelUtil {
     auto* pool_state = dynamic_cast<PoolOpKernelState*>(state);
     CHECK(pool_state != nullptr);
     pool_state->Update(x->shape());
-    const std::string& data_format = ctx->Attr<std::string>("data_format");
-    if (data_format == "channels_first") {
-      CFirstForward(pool_state->GetParams3D(), x, y, GetZeroVal<T>,
-                    [](const T& lhs, T& rhs) { rhs += lhs; },
-                    [](const int64_t size, T& out) { out /= size; });
-    } else if (data_format == "channels_last") {
-      CLastForward(pool_state->GetParams3D(), x, y, GetZeroVal<T>,
-                   [](const int64_t in_col, const int64_t out_col, ConstEigenMatrixMap<T>& in_mat,
-                      EigenMatrixMap<T>& out_mat) { out_mat.col(out_col) += in_mat.col(in_col); },
-                   [](const int64_t size, const int64_t col, EigenMatrixMap<T>& out_mat) {
-                     out_mat.col(col) /= size;
-                   });
+    const Params3D& params_3d = pool_state->GetParams3D();
+    const PoolCpuShape shape(params_3d, ctx->Attr<std::string>("data_format"));
+    if (IsSeparableAvgPool(params_3d.pool_size_3d().at(2), params_3d.strides_3d().at(2))) {
+      user_op::Tensor* tmp_buffer = ctx->Tensor4ArgNameAndIndex("tmp_buffer", 0);
+      SeparableAvgForward(shape, x->dptr<T>(), y->mut_dptr<T>(), tmp_buffer->mut_dptr<T>(),
+                          tmp_buffer->shape().elem_cnt() / sizeof(T));
     } else {
-      UNIMPLEMENTED();
+      Forward<AvgPoolFunctor<T>>(shape, x->dptr<T>(), y->mut_dptr<T>());
     }
   }
 
@@ -269,21 +314,9 @@ struct PoolCpuKernelUtil {
     auto* pool_state = dynamic_cast<PoolOpKernelState*>(state);
     CHECK(pool_state != nullptr);
     pool_state->Update(x->shape());
-    const std::string& data_format = ctx->Attr<std::string>("data_format");
-    if (data_format == "channels_first") {
-      CFirstBackward(pool_state->GetParams3D(), dy, y, x, dx,
-                     [](const T& in, const T& out, const T& out_diff, const int64_t size,
-                        T& in_diff) { in_diff += (out_diff / static_cast<T>(size)); });
-    } else if (data_format == "channels_last") {
-      CLastBackward(pool_state->GetParams3D(), dy, y, x, dx,
-                    [](const int64_t out_col, const int64_t in_col, const int64_t size,
-                       ConstEigenArrayMap<T>& out_arr, ConstEigenArrayMap<T>& in_arr,
-                       ConstEigenArrayMap<T>& out_diff_arr, EigenArrayMap<T>& in_diff_arr) {
-                      in_diff_arr.col(in_col) += out_diff_arr.col(out_col) / static_cast<T>(size);
-                    });
-    } else {
-      UNIMPLEMENTED();
-    }
+    const PoolCpuShape shape(pool_state->GetParams3D(), ctx->Attr<std::string>("data_format"));
+    Backward<AvgPoolFunctor<T>>(shape, x->dptr<T>(), y->dptr<T>(), dy->dptr<T>(),
+                                dx->mut_dptr<T>());
   }
 
   static void MaxFWCompute(user_op::KernelComputeContext* ctx, user_op::OpKernelState* state) {
@@ -292,23 +325,8 @@ struct PoolCpuKernelUtil {
     auto* pool_state = dynamic_cast<PoolOpKernelState*>(state);
     CHECK(pool_state != nullptr);
     pool_state->Update(x->shape());
-    const std::string& data_format = ctx->Attr<std::string>("data_format");
-    if (data_format == "channels_first") {
-      CFirstForward(pool_state->GetParams3D(), x, y, GetMinVal<T>,
-                    [](const T& lhs, T& rhs) {
-                      if (lhs > rhs) { rhs = lhs; }
-                    },
-                    [](const int64_t size, T& out) {});
-    } else if (data_format == "channels_last") {
-      CLastForward(pool_state->GetParams3D(), x, y, GetMinVal<T>,
-                   [](const int64_t in_col, const int64_t out_col, ConstEigenMatrixMap<T>& in_mat,
-                      EigenMatrixMap<T>& out_mat) {
-                     out_mat.col(out_col) = out_mat.col(out_col).cwiseMax(in_mat.col(in_col));
-                   },
-                   [](const int64_t size, const int64_t col, EigenMatrixMap<T>& out_mat) {});
-    } else {
-      UNIMPLEMENTED();
-    }
+    const PoolCpuShape shape(pool_state->GetParams3D(), ctx->Attr<std::string>("data_format"));
+    Forward<MaxPoolFunctor<T>>(shape, x->dptr<T>(), y->mut_dptr<T>());
   }
 
   static void MaxBWCompute(user_op::KernelComputeContext* ctx, user_op::OpKernelState* state) {
@@ -319,29 +337,33 @@ struct PoolCpuKernelUtil {
     auto* pool_state = dynamic_cast<PoolOpKernelState*>(state);
     CHECK(pool_state != nullptr);
     pool_state->Update(x->shape());
-    const std::string& data_format = ctx->Attr<std::string>("data_format");
-    if (data_format == "channels_first") {
-      CFirstBackward(
-          pool_state->GetParams3D(), dy, y, x, dx,
-          [](const T& in, const T& out, const T& out_diff, const int64_t size, T& in_diff) {
-            if (in == out) { in_diff += out_diff; }
-          });
-    } else if (data_format == "channels_last") {
-      CLastBackward(
-          pool_state->GetParams3D(), dy, y, x, dx,
-          [](const int64_t out_col, const int64_t in_col, const int64_t size,
-             ConstEigenArrayMap<T>& out_arr, ConstEigenArrayMap<T>& in_arr,
-             ConstEigenArrayMap<T>& out_diff_arr, EigenArrayMap<T>& in_diff_arr) {
-            in_diff_arr.col(in_col) +=
-                out_diff_arr.col(out_col)
-                * (in_arr.col(in_col).cwiseEqual(out_arr.col(out_col)).template cast<T>());
-          });
-    } else {
-      UNIMPLEMENTED();
-    }
+    const PoolCpuShape shape(pool_state->GetParams3D(), ctx->Attr<std::string>("data_format"));
+    Backward<MaxPoolFunctor<T>>(shape, x->dptr<T>(), y->dptr<T>(), dy->dptr<T>(),
+                                dx->mut_dptr<T>());
   }
 };
 
+template<typename T>
+size_t InferAvgPoolTmpSize(user_op::InferContext* ctx) {
+  const std::vector<int32_t>& pool_size = ctx->Attr<std::vector<int32_t>>("pool_size");
+  const std::vector<int32_t>& strides = ctx->Attr<std::vector<int32_t>>("strides");
+  if (!IsSeparableAvgPool(pool_size.back(), strides.back())) { return 0; }
+  const Shape* x_shape = ctx->Shape4ArgNameAndIndex("x", 0);
+  const int64_t num_axes = x_shape->NumAxes();
+  int64_t in_w = 0;
+  int64_t inner = 0;
+  if (ctx->Attr<std::string>("data_format") == "channels_first") {
+    in_w = x_shape->At(num_axes - 1);
+    inner = 1;
+  } else {
+    in_w = x_shape->At(num_axes - 2);
+    inner = x_shape->At(num_axes - 1);
+  }
+  const ThreadPool* thread_pool = Global<ThreadPool>::Get();
+  const int64_t thread_num = thread_pool == nullptr ? 1 : thread_pool->thread_num();
+  return thread_num * GetSeparableAvgPoolPartBufElemCnt(in_w, inner) * sizeof(T);
+}
+
 std::shared_ptr<user_op::OpKernelState> DoCreateOpKernelState(user_op::KernelInitContext* ctx,
                                                               const int32_t& dim) {
   const Shape& x_shape = ctx->TensorDesc4ArgNameAndIndex("x", 0)->shape();
@@ -581,7 +603,8 @@ class MaxPool3DGradCpuKernel final : public user_op::OpKernel {
   REGISTER_USER_KERNEL("avg_pool_1d")                                                  \
       .SetCreateFn<AvgPool1DCpuKernel<dtype>>()                                        \
       .SetIsMatchedHob((user_op::HobDeviceType() == DeviceType::kCPU)                  \
-                       & (user_op::HobDataType("x", 0) == GetDataType<dtype>::value)); \
+                       & (user_op::HobDataType("x", 0) == GetDataType<dtype>::value))  \
+      .SetInferTmpSizeFn(InferAvgPoolTmpSize<dtype>);                                  \
   REGISTER_USER_KERNEL("avg_pool_1d_grad")                                             \
       .SetCreateFn<AvgPool1DGradCpuKernel<dtype>>()                                    \
       .SetIsMatchedHob((user_op::HobDeviceType() == DeviceType::kCPU)                  \
@@ -589,7 +612,8 @@ class MaxPool3DGradCpuKernel final : public user_op::OpKernel {
   REGISTER_USER_KERNEL("avg_pool_2d")                                                  \
       .SetCreateFn<AvgPool2DCpuKernel<dtype>>()                                        \
       .SetIsMatchedHob((user_op::HobDeviceType() == DeviceType::kCPU)                  \
-                       & (user_op::HobDataType("x", 0) == GetDataType<dtype>::value)); \
+                       & (user_op::HobDataType("x", 0) == GetDataType<dtype>::value))  \
+      .SetInferTmpSizeFn(InferAvgPoolTmpSize<dtype>);                                  \
   REGISTER_USER_KERNEL("avg_pool_2d_grad")                                             \
       .SetCreateFn<AvgPool2DGradCpuKernel<dtype>>()                                    \
       .SetIsMatchedHob((user_op::HobDeviceType() == DeviceType::kCPU)                  \
@@ -597,7 +621,8 @@ class MaxPool3DGradCpuKernel final : public user_op::OpKernel {
   REGISTER_USER_KERNEL("avg_pool_3d")                                                  \
       .SetCreateFn<AvgPool3DCpuKernel<dtype>>()                                        \
       .SetIsMatchedHob((user_op::HobDeviceType() == DeviceType::kCPU)                  \
-                       & (user_op::HobDataType("x", 0) == GetDataType<dtype>::value)); \
+                       & (user_op::HobDataType("x", 0) == GetDataType<dtype>::value))  \
+      .SetInferTmpSizeFn(InferAvgPoolTmpSize<dtype>);                                  \
   REGISTER_USER_KERNEL("avg_pool_3d_grad")                                             \
       .SetCreateFn<AvgPool3DGradCpuKernel<dtype>>()                                    \
       .SetIsMatchedHob((user_op::HobDeviceType() == DeviceType::kCPU)                  \
@@ -47,9 +47,11 @@ class SoftmaxKernel final : public user_op::OpKernel {
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
 };
 
-template<typename T>
+template<DeviceType device_type, typename T>
 user_op::InferTmpSizeFn GenInferTmpSizeFn(const std::string& bn) {
-  return [bn](user_op::InferContext* ctx) {
+  return [bn](user_op::InferContext* ctx) -> size_t {
+    // the fused cpu softmax needs no temp storage
+    if (device_type == DeviceType::kCPU) { return 0; }
     const Shape* x = ctx->Shape4ArgNameAndIndex(bn, 0);
     const size_t num_classes = x->dim_vec().back();
     size_t temp_storage_bytes = GetCudaAlignedSize(x->elem_cnt() * sizeof(T));           // [i][j]
@@ -63,7 +65,7 @@ user_op::InferTmpSizeFn GenInferTmpSizeFn(const std::string& bn) {
       .SetCreateFn<SoftmaxKernel<device, dtype>>()                                      \
       .SetIsMatchedHob((user_op::HobDeviceType() == device)                             \
                        & (user_op::HobDataType("out", 0) == GetDataType<dtype>::value)) \
-      .SetInferTmpSizeFn(GenInferTmpSizeFn<dtype>("in"));
+      .SetInferTmpSizeFn(GenInferTmpSizeFn<device, dtype>("in"));
 
 REGISTER_SOFTMAX_KERNEL(DeviceType::kCPU, float)
 REGISTER_SOFTMAX_KERNEL(DeviceType::kCPU, double)
@@ -104,7 +106,7 @@ class SoftmaxGradKernel final : public user_op::OpKernel {
       .SetCreateFn<SoftmaxGradKernel<device, dtype>>()                                 \
       .SetIsMatchedHob((user_op::HobDeviceType() == device)                            \
                        & (user_op::HobDataType("dx", 0) == GetDataType<dtype>::value)) \
-      .SetInferTmpSizeFn(GenInferTmpSizeFn<dtype>("dx"));
+      .SetInferTmpSizeFn(GenInferTmpSizeFn<device, dtype>("dx"));
 
 REGISTER_SOFTMAX_GRAD_KERNEL(DeviceType::kCPU, float)
 REGISTER_SOFTMAX_GRAD_KERNEL(DeviceType::kCPU, double)
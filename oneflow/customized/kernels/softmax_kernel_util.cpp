@@ -16,6 +16,7 @@ limitations under the License.
 #include "oneflow/customized/kernels/softmax_kernel_util.h"
 #include "oneflow/core/kernel/kernel_util.cuh"
 #include "oneflow/core/ndarray/ndarray_util.h"
+#include "oneflow/core/kernel/util/host_elementwise.h"
 
 namespace oneflow {
 
@@ -64,12 +65,48 @@ void SoftmaxKernelUtil<device_type, T>::ComputeDiff(DeviceCtx* ctx, const int64_
   NdarrayUtil<device_type, T>::InplaceMul(ctx, Var({n * w}, dx), Val({n * w}, out));
 }
 
+template<typename T>
+void CpuSoftmaxKernelUtil<T>::ComputeProb(DeviceCtx* ctx, const int64_t n, const int64_t w,
+                                          const T* in, T* prob, T* log_sum_exp) {
+  host_elementwise::ParallelForRows(n, w, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const T* in_row = in + i * w;
+      T* prob_row = prob + i * w;
+      T max = in_row[0];
+      for (int64_t j = 1; j < w; ++j) { max = std::max(max, in_row[j]); }
+      T sum = 0;
+      for (int64_t j = 0; j < w; ++j) {
+        prob_row[j] = std::exp(in_row[j] - max);
+        sum += prob_row[j];
+      }
+      const T inv_sum = 1 / sum;
+      for (int64_t j = 0; j < w; ++j) { prob_row[j] *= inv_sum; }
+      if (log_sum_exp != nullptr) { log_sum_exp[i] = max + std::log(sum); }
+    }
+  });
+}
+
+template<typename T>
+void CpuSoftmaxKernelUtil<T>::ComputeDiff(DeviceCtx* ctx, const int64_t n, const int64_t w,
+                                          const T* dy, const T* out, T* dx) {
+  host_elementwise::ParallelForRows(n, w, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const T* dy_row = dy + i * w;
+      const T* out_row = out + i * w;
+      T* dx_row = dx + i * w;
+      T dot = 0;
+      for (int64_t j = 0; j < w; ++j) { dot += dy_row[j] * out_row[j]; }
+      for (int64_t j = 0; j < w; ++j) { dx_row[j] = (dy_row[j] - dot) * out_row[j]; }
+    }
+  });
+}
+
 #define INSTANTIATE_SOFTMAX_KERNEL_UTIL(device_type, data_type) \
   template struct SoftmaxKernelUtil<device_type, data_type>;
 INSTANTIATE_SOFTMAX_KERNEL_UTIL(DeviceType::kGPU, float16)
 INSTANTIATE_SOFTMAX_KERNEL_UTIL(DeviceType::kGPU, float)
 INSTANTIATE_SOFTMAX_KERNEL_UTIL(DeviceType::kGPU, double)
-INSTANTIATE_SOFTMAX_KERNEL_UTIL(DeviceType::kCPU, float)
-INSTANTIATE_SOFTMAX_KERNEL_UTIL(DeviceType::kCPU, double)
 #undef INSTANTIATE_SOFTMAX_KERNEL_UTIL
+template struct CpuSoftmaxKernelUtil<float>;
+template struct CpuSoftmaxKernelUtil<double>;
 }  // namespace oneflow
@@ -29,6 +29,32 @@ struct SoftmaxKernelUtil {
                           const size_t temp_storage_bytes);
 };
 
+// Softmax on CPU, the rows are split across the thread pool and every row stays in cache through
+// its max, exp-sum and scale loops, so that neither temp storage nor extra passes are needed.
+template<typename T>
+struct CpuSoftmaxKernelUtil {
+  // log_sum_exp[i] = log(Sum_j(exp(in[i][j]))), skipped if log_sum_exp is nullptr
+  static void ComputeProb(DeviceCtx* ctx, const int64_t n, const int64_t w, const T* in, T* prob,
+                          T* log_sum_exp);
+  // dx[i][j] = (dy[i][j] - Sum_k(dy[i][k] * out[i][k])) * out[i][j], dx may be dy
+  static void ComputeDiff(DeviceCtx* ctx, const int64_t n, const int64_t w, const T* dy,
+                          const T* out, T* dx);
+};
+
+// the CPU kernels need neither tmp nor temp_storage
+template<typename T>
+struct SoftmaxKernelUtil<DeviceType::kCPU, T> {
+  static void ComputeProb(DeviceCtx* ctx, const int64_t n, const int64_t w, const T* in, T* tmp,
+                          T* prob, void* temp_storage, const size_t temp_storage_bytes) {
+    CpuSoftmaxKernelUtil<T>::ComputeProb(ctx, n, w, in, prob, nullptr);
+  }
+  static void ComputeDiff(DeviceCtx* ctx, const int64_t n, const int64_t w, const T* dy,
+                          const T* out, T* sum_vec, T* dx, void* temp_storage,
+                          const size_t temp_storage_bytes) {
+    CpuSoftmaxKernelUtil<T>::ComputeDiff(ctx, n, w, dy, out, dx);
+  }
+};
+
 }  // namespace oneflow
 
 #endif  // ONEFLOW_CUSTOMIZED_KERNELS_SOFTMAX_KERNEL_UTIL_H_
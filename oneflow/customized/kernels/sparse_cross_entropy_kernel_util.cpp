@@ -15,6 +15,7 @@ limitations under the License.
 */
 #include "oneflow/customized/kernels/sparse_cross_entropy_kernel_util.h"
 #include "oneflow/core/kernel/kernel_util.cuh"
+#include "oneflow/core/kernel/util/host_elementwise.h"
 
 namespace oneflow {
 namespace user_op {
@@ -49,19 +50,21 @@ struct SparseCrossEntropyKernelUtil<DeviceType::kCPU, T, K> {
                                      const int64_t num_classes, const int64_t depth,
                                      const int64_t lower_bound, const T* prob, const K* labels,
                                      const T* dy, T* dx) {
-    FOR_RANGE(int64_t, i, 0, elem_cnt) {
-      const int32_t row_id = i / num_classes;
-      const int32_t col_id = i - row_id * num_classes;
-      CHECK_GE(labels[row_id], 0);
-      CHECK_LT(labels[row_id], depth);
-      K label = labels[row_id] - lower_bound;
-
-      if (label == col_id) {
-        dx[i] = dy[row_id] * (prob[i] - 1);
-      } else {
-        dx[i] = dy[row_id] * prob[i];
+    // dx = dy * prob first, then the label column of every row is corrected, so the inner loop
+    // has neither divisions nor branches
+    const int64_t num_instances = elem_cnt / num_classes;
+    host_elementwise::ParallelForRows(num_instances, num_classes, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        CHECK_GE(labels[i], 0);
+        CHECK_LT(labels[i], depth);
+        const T* prob_row = prob + i * num_classes;
+        T* dx_row = dx + i * num_classes;
+        const T dy_i = dy[i];
+        for (int64_t j = 0; j < num_classes; ++j) { dx_row[j] = dy_i * prob_row[j]; }
+        const K label = labels[i] - lower_bound;
+        if (label >= 0 && label < num_classes) { dx_row[label] -= dy_i; }
       }
-    }
+    });
   }
 };
 
@@ -49,6 +49,44 @@ class SparseSoftmaxCrossEntropyKernel final : public user_op::OpKernel {
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
 };
 
+// On CPU the loss is taken from the log-sum-exp of every row while its softmax is computed, so
+// the probabilities are written once and never read back, and no temp storage is needed.
+template<DeviceType device_type, typename T, typename K>
+class SparseSoftmaxCrossEntropyCpuKernel final : public user_op::OpKernel {
+ public:
+  SparseSoftmaxCrossEntropyCpuKernel() = default;
+  ~SparseSoftmaxCrossEntropyCpuKernel() = default;
+
+ private:
+  void Compute(user_op::KernelComputeContext* ctx) const override {
+    const user_op::Tensor* prediction = ctx->Tensor4ArgNameAndIndex("prediction", 0);
+    const user_op::Tensor* label = ctx->Tensor4ArgNameAndIndex("label", 0);
+    user_op::Tensor* prob = ctx->Tensor4ArgNameAndIndex("prob", 0);
+    user_op::Tensor* out = ctx->Tensor4ArgNameAndIndex("out", 0);
+    const int64_t num_instances = label->shape().elem_cnt();
+    CHECK_EQ(prediction->shape().elem_cnt() % num_instances, 0);
+    const int64_t num_classes = prediction->shape().elem_cnt() / num_instances;
+    const int64_t depth = ctx->Attr<int64_t>("depth");
+    const T* prediction_ptr = prediction->dptr<T>();
+    const K* label_ptr = label->dptr<K>();
+    T* out_ptr = out->mut_dptr<T>();
+    // out holds the log-sum-exp of every row until the loss is computed
+    CpuSoftmaxKernelUtil<T>::ComputeProb(ctx->device_ctx(), num_instances, num_classes,
+                                         prediction_ptr, prob->mut_dptr<T>(), out_ptr);
+    // -log(prob) is bounded the same as -SafeLog(prob)
+    const T max_loss = -std::log(static_cast<T>(1e-20));
+    FOR_RANGE(int64_t, i, 0, num_instances) {
+      CHECK_GE(label_ptr[i], 0);
+      CHECK_LT(label_ptr[i], depth);
+      if (label_ptr[i] < num_classes) {
+        out_ptr[i] =
+            std::min(out_ptr[i] - prediction_ptr[i * num_classes + label_ptr[i]], max_loss);
+      }
+    }
+  }
+  bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
+};
+
 template<DeviceType device_type, typename T, typename K>
 class SparseSoftmaxCrossEntropyMsKernel final : public user_op::OpKernel {
  public:
@@ -70,13 +108,14 @@ class SparseSoftmaxCrossEntropyMsKernel final : public user_op::OpKernel {
       .SetIsMatchedHob((user_op::HobDeviceType() == device_type_v)                             \
                        & (user_op::HobDataType("label", 0) == OF_PP_PAIR_SECOND(ltype_pair))   \
                        & (user_op::HobDataType("out", 0) == OF_PP_PAIR_SECOND(dtype_pair)))    \
-      .SetInferTmpSizeFn([](user_op::InferContext* ctx) {                                      \
+      .SetInferTmpSizeFn([](user_op::InferContext* ctx) -> size_t {                            \
+        if (device_type_v == DeviceType::kCPU) { return 0; }                                   \
         const Shape* prediction_shape = ctx->Shape4ArgNameAndIndex("prediction", 0);           \
         return prediction_shape->elem_cnt() * sizeof(OF_PP_PAIR_FIRST(dtype_pair));            \
       });
 
 OF_PP_SEQ_PRODUCT_FOR_EACH_TUPLE(REGISTER_SPARSE_SOFTMAX_CROSS_ENTROPY_KERNEL,
-                                 (SparseSoftmaxCrossEntropyKernel),
+                                 (SparseSoftmaxCrossEntropyCpuKernel),
                                  ("sparse_softmax_cross_entropy"),
                                  OF_PP_MAKE_TUPLE_SEQ(DeviceType::kCPU), FLOATING_DATA_TYPE_SEQ,
                                  INDEX_DATA_TYPE_SEQ)
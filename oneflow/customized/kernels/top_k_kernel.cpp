@@ -21,6 +21,27 @@ namespace oneflow {
 
 namespace {
 
+// top_k no larger than this streams every instance once through a bounded heap, larger ones run
+// nth_element over an index array kept in tmp_buffer
+constexpr int32_t kMaxHeapSelectionK = 256;
+// when there are fewer instances than threads, every instance is split into chunks of this many
+// elements at least, the chunks are selected in parallel and their candidates merged
+constexpr int32_t kMinTopKChunkSize = 16384;
+
+bool UseHeapSelection(int32_t k) { return k <= kMaxHeapSelectionK; }
+
+template<typename T>
+struct TopKEntry {
+  T value;
+  int32_t index;
+};
+
+// the larger value wins, and the smaller index between equal values, the same as ComputeTopK
+template<typename T>
+bool IsBetterEntry(const TopKEntry<T>& lhs, const TopKEntry<T>& rhs) {
+  return lhs.value > rhs.value || (lhs.value == rhs.value && lhs.index < rhs.index);
+}
+
 template<typename T>
 void ComputeTopOne(const T* in_ptr, const Range& range, int32_t instance_size, int32_t* out_ptr) {
   FOR_RANGE(int32_t, i, range.begin(), range.end()) {
@@ -29,6 +50,46 @@ void ComputeTopOne(const T* in_ptr, const Range& range, int32_t instance_size, i
   }
 }
 
+// Selects the best k of in_ptr[begin, end) into heap, the worst of them on the top. Every element
+// is only compared with the top unless it is better, so the values are streamed once.
+template<typename T>
+void HeapSelect(const T* in_ptr, int32_t begin, int32_t end, int32_t k,
+                std::vector<TopKEntry<T>>* heap) {
+  heap->clear();
+  const int32_t fill_end = std::min(end, begin + k);
+  FOR_RANGE(int32_t, j, begin, fill_end) { heap->push_back(TopKEntry<T>{in_ptr[j], j}); }
+  std::make_heap(heap->begin(), heap->end(), IsBetterEntry<T>);
+  if (fill_end == end) { return; }
+  T threshold = heap->front().value;
+  FOR_RANGE(int32_t, j, fill_end, end) {
+    // the index of in_ptr[j] is larger than all in the heap, so it has to be strictly larger
+    if (in_ptr[j] > threshold) {
+      std::pop_heap(heap->begin(), heap->end(), IsBetterEntry<T>);
+      heap->back() = TopKEntry<T>{in_ptr[j], j};
+      std::push_heap(heap->begin(), heap->end(), IsBetterEntry<T>);
+      threshold = heap->front().value;
+    }
+  }
+}
+
+template<typename T>
+void WriteTopKEntries(std::vector<TopKEntry<T>>* entries, int32_t k, bool sorted,
+                      int32_t* out_ptr) {
+  if (sorted) { std::sort(entries->begin(), entries->end(), IsBetterEntry<T>); }
+  FOR_RANGE(int32_t, j, 0, k) { out_ptr[j] = entries->at(j).index; }
+}
+
+template<typename T>
+void ComputeTopKByHeap(const T* in_ptr, const Range& range, int32_t instance_size, int32_t k,
+                       bool sorted, int32_t* out_ptr) {
+  std::vector<TopKEntry<T>> heap;
+  heap.reserve(k);
+  FOR_RANGE(int32_t, i, range.begin(), range.end()) {
+    HeapSelect(in_ptr + i * instance_size, 0, instance_size, k, &heap);
+    WriteTopKEntries(&heap, k, sorted, out_ptr + i * k);
+  }
+}
+
 template<typename T>
 void ComputeTopK(const T* in_ptr, int32_t* indices_ptr, const Range& range, int32_t instance_size,
                  int32_t k, bool sorted, int32_t* out_ptr) {
@@ -52,10 +113,46 @@ void ComputeTopK(const T* in_ptr, int32_t* indices_ptr, const Range& range, int3
   }
 }
 
+// for a few large instances, e.g. the logits of a decoding step over a large vocabulary
+template<typename T>
+void ChunkedCpuTopK(const T* in_ptr, int32_t instance_num, int32_t instance_size, int32_t k,
+                    int32_t chunk_num, bool sorted, int32_t* out_ptr) {
+  const BalancedSplitter chunk_bs(instance_size, chunk_num);
+  std::vector<std::vector<TopKEntry<T>>> chunk_heaps(instance_num * chunk_num);
+  MultiThreadLoop(instance_num * chunk_num, [&](size_t i) {
+    const int64_t instance_id = i / chunk_num;
+    const Range chunk = chunk_bs.At(i % chunk_num);
+    chunk_heaps.at(i).reserve(k);
+    HeapSelect(in_ptr + instance_id * instance_size, chunk.begin(), chunk.end(), k,
+               &chunk_heaps.at(i));
+  });
+  std::vector<TopKEntry<T>> candidates;
+  FOR_RANGE(int32_t, i, 0, instance_num) {
+    candidates.clear();
+    FOR_RANGE(int32_t, c, 0, chunk_num) {
+      const auto& heap = chunk_heaps.at(i * chunk_num + c);
+      candidates.insert(candidates.end(), heap.begin(), heap.end());
+    }
+    std::partial_sort(candidates.begin(), candidates.begin() + k, candidates.end(),
+                      IsBetterEntry<T>);
+    candidates.resize(k);
+    WriteTopKEntries(&candidates, k, false, out_ptr + i * k);
+  }
+}
+
 template<typename T>
 void CpuTopK(DeviceCtx* ctx, const T* in_ptr, int32_t* indices_ptr, int32_t instance_num,
              int32_t instance_size, int32_t k, bool sorted, int32_t* out_ptr) {
-  const int32_t num_thread = std::min(instance_num, Global<ThreadPool>::Get()->thread_num());
+  const int32_t thread_num = Global<ThreadPool>::Get()->thread_num();
+  if (k > 1 && UseHeapSelection(k) && instance_num < thread_num) {
+    const int32_t chunk_num =
+        std::min(thread_num / instance_num, std::max(instance_size / kMinTopKChunkSize, 1));
+    if (chunk_num > 1) {
+      ChunkedCpuTopK(in_ptr, instance_num, instance_size, k, chunk_num, sorted, out_ptr);
+      return;
+    }
+  }
+  const int32_t num_thread = std::min(instance_num, thread_num);
   const BalancedSplitter bs(instance_num, num_thread);
   BlockingCounter bc(num_thread);
   FOR_RANGE(int32_t, thread_id, 0, num_thread) {
@@ -63,6 +160,8 @@ void CpuTopK(DeviceCtx* ctx, const T* in_ptr, int32_t* indices_ptr, int32_t inst
     Global<ThreadPool>::Get()->AddWork([=, &bc]() {
       if (k == 1) {
         ComputeTopOne(in_ptr, range, instance_size, out_ptr);
+      } else if (UseHeapSelection(k)) {
+        ComputeTopKByHeap(in_ptr, range, instance_size, k, sorted, out_ptr);
       } else {
         ComputeTopK(in_ptr, indices_ptr, range, instance_size, k, sorted, out_ptr);
       }
@@ -96,14 +195,15 @@ class TopKCpuKernel final : public user_op::OpKernel {
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
 };
 
-#define REGISTER_CPU_TOP_K_KERNEL(dtype)                                                 \
-  REGISTER_USER_KERNEL("top_k")                                                          \
-      .SetCreateFn<TopKCpuKernel<dtype>>()                                               \
-      .SetIsMatchedHob((user_op::HobDeviceType() == DeviceType::kCPU)                    \
-                       & (user_op::HobDataType("in", 0) == GetDataType<dtype>::value))   \
-      .SetInferTmpSizeFn([](user_op::InferContext* ctx) {                                \
-        const Shape* in_shape = ctx->Shape4ArgNameAndIndex("in", 0);                     \
-        return ctx->Attr<int32_t>("k") > 1 ? in_shape->elem_cnt() * sizeof(int32_t) : 0; \
+#define REGISTER_CPU_TOP_K_KERNEL(dtype)                                                   \
+  REGISTER_USER_KERNEL("top_k")                                                            \
+      .SetCreateFn<TopKCpuKernel<dtype>>()                                                 \
+      .SetIsMatchedHob((user_op::HobDeviceType() == DeviceType::kCPU)                      \
+                       & (user_op::HobDataType("in", 0) == GetDataType<dtype>::value))     \
+      .SetInferTmpSizeFn([](user_op::InferContext* ctx) -> size_t {                        \
+        const Shape* in_shape = ctx->Shape4ArgNameAndIndex("in", 0);                       \
+        const int32_t k = ctx->Attr<int32_t>("k");                                         \
+        return k > 1 && !UseHeapSelection(k) ? in_shape->elem_cnt() * sizeof(int32_t) : 0; \
       });
 
 REGISTER_CPU_TOP_K_KERNEL(float)
@@ -384,7 +384,10 @@ REGISTER_USER_OP("conv_filter_grad")
                                    kernel_size.cend());
       } else {
         CHECK_EQ_OR_RETURN("channels_last", data_format);
-        CHECK_EQ_OR_RETURN(groups, 1);
+        CHECK_LE_OR_RETURN(groups, x->shape().dim_vec().back());
+        CHECK_LE_OR_RETURN(groups, dy->shape().dim_vec().back());
+        CHECK_EQ_OR_RETURN(x->shape().dim_vec().back() % groups, 0);
+        CHECK_EQ_OR_RETURN(dy->shape().dim_vec().back() % groups, 0);
         filter_diff_dim_vec.push_back(dy->shape().dim_vec().back());
         filter_diff_dim_vec.insert(filter_diff_dim_vec.end(), kernel_size.cbegin(),
                                    kernel_size.cend());
@@ -0,0 +1,60 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/framework/framework.h"
+
+namespace oneflow {
+
+// Generated by OpFusionPass from bias_add -> relu/gelu, the backward ops are generated from the
+// original ops beforehand, so there is no grad registered.
+REGISTER_USER_OP("fused_bias_add_activation")
+    .Input("a")
+    .Input("b")
+    .Output("out")
+    .Attr("axis", UserOpAttrType::kAtInt32)
+    .Attr("activation", UserOpAttrType::kAtString)
+    .SetTensorDescInferFn([](user_op::InferContext* ctx) -> Maybe<void> {
+      const auto* a_tensor_desc = ctx->TensorDesc4ArgNameAndIndex("a", 0);
+      const auto* b_tensor_desc = ctx->TensorDesc4ArgNameAndIndex("b", 0);
+      const auto bias_add_axis = ctx->Attr<int32_t>("axis");
+      const std::string& activation = ctx->Attr<std::string>("activation");
+      CHECK_OR_RETURN(activation == "relu" || activation == "gelu");
+      CHECK_EQ_OR_RETURN(b_tensor_desc->shape().NumAxes(), 1);
+      CHECK_GE_OR_RETURN(bias_add_axis, 0);
+      CHECK_LT_OR_RETURN(bias_add_axis, a_tensor_desc->shape().NumAxes());
+      CHECK_EQ_OR_RETURN(a_tensor_desc->shape().At(bias_add_axis), b_tensor_desc->shape().At(0));
+      *ctx->TensorDesc4ArgNameAndIndex("out", 0) = *a_tensor_desc;
+      return Maybe<void>::Ok();
+    })
+    .SetGetSbpFn([](user_op::SbpContext* ctx) -> Maybe<void> {
+      const auto axis = ctx->Attr<int32_t>("axis");
+      for (int64_t i = 0; i < ctx->LogicalTensorDesc4InputArgNameAndIndex("a", 0).shape().NumAxes();
+           ++i) {
+        if (i == axis) { continue; }
+        ctx->NewBuilder()
+            .Split(user_op::OpArg("a", 0), i)
+            .Broadcast(user_op::OpArg("b", 0))
+            .Split(ctx->outputs(), i)
+            .Build();
+      }
+      ctx->NewBuilder()
+          .Split(user_op::OpArg("b", 0), 0)
+          .Split(user_op::OpArg("a", 0), axis)
+          .Split(ctx->outputs(), axis)
+          .Build();
+      return Maybe<void>::Ok();
+    });
+
+}  // namespace oneflow
@@ -0,0 +1,67 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import benchmark_util
+import oneflow as flow
+import oneflow.typing as oft
+
+# (name, seq_length, head_size, transpose_b), per-head matmuls of bert self attention
+ATTENTION_MATMULS = [
+    ("bert_query_key_seq128", 128, 64, True),
+    ("bert_prob_value_seq128", 128, 64, False),
+    ("bert_query_key_seq384", 384, 64, True),
+    ("bert_prob_value_seq384", 384, 64, False),
+    ("bert_query_key_seq32", 32, 64, True),
+]
+
+
+def benchmark_batch_matmul(args, layer):
+    name, seq_length, head_size, transpose_b = layer
+    benchmark_util.init_env(args)
+    batch = (args.batch_size, args.num_heads)
+    if transpose_b:
+        # scores = query * key^T
+        a_shape = batch + (seq_length, head_size)
+        b_shape = batch + (seq_length, head_size)
+        m, n, k = seq_length, seq_length, head_size
+    else:
+        # context = probs * value
+        a_shape = batch + (seq_length, seq_length)
+        b_shape = batch + (seq_length, head_size)
+        m, n, k = seq_length, head_size, seq_length
+
+    @flow.global_function(function_config=benchmark_util.get_func_config())
+    def BatchMatmulJob(
+        a: oft.Numpy.Placeholder(a_shape), b: oft.Numpy.Placeholder(b_shape)
+    ):
+        with flow.scope.placement("cpu", "0:0"):
+            return flow.matmul(a, b, transpose_b=transpose_b)
+
+    inputs = [
+        benchmark_util.random_input(a_shape),
+        benchmark_util.random_input(b_shape),
+    ]
+    latency = benchmark_util.measure(BatchMatmulJob, inputs, args)
+    flops = 2.0 * args.batch_size * args.num_heads * m * n * k
+    benchmark_util.print_result(name, latency, flops=flops)
+
+
+if __name__ == "__main__":
+    parser = benchmark_util.get_parser("benchmark of cpu batch_matmul in attention")
+    parser.add_argument("--batch_size", type=int, default=8)
+    parser.add_argument("--num_heads", type=int, default=12)
+    args = parser.parse_args()
+    for layer in ATTENTION_MATMULS:
+        benchmark_batch_matmul(args, layer)
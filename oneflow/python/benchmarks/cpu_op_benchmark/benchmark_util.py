@@ -0,0 +1,71 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import argparse
+import time
+
+import numpy as np
+import oneflow as flow
+
+
+def get_parser(description):
+    parser = argparse.ArgumentParser(description=description)
+    parser.add_argument(
+        "--thread_num",
+        type=int,
+        default=0,
+        help="size of the compute thread pool, 0 means the default of oneflow",
+    )
+    parser.add_argument("--warmup_iter_num", type=int, default=5)
+    parser.add_argument("--iter_num", type=int, default=20)
+    return parser
+
+
+def init_env(args):
+    flow.clear_default_session()
+    flow.config.cpu_device_num(1)
+    flow.config.gpu_device_num(0)
+    if args.thread_num > 0:
+        flow.config.compute_thread_pool_size(args.thread_num)
+
+
+def get_func_config():
+    func_config = flow.FunctionConfig()
+    func_config.default_data_type(flow.float)
+    func_config.default_logical_view(flow.scope.consistent_view())
+    return func_config
+
+
+def measure(job, inputs, args):
+    r"""Run job(*inputs) synchronously, returns the mean latency in milliseconds."""
+    for _ in range(args.warmup_iter_num):
+        job(*inputs).get()
+    start = time.perf_counter()
+    for _ in range(args.iter_num):
+        job(*inputs).get()
+    return (time.perf_counter() - start) * 1000 / args.iter_num
+
+
+def print_result(name, latency_ms, flops=None, bytes_accessed=None):
+    msg = "{:<48} {:>10.3f} ms".format(name, latency_ms)
+    if flops is not None:
+        msg += " {:>10.2f} GFLOP/s".format(flops / latency_ms / 1e6)
+    if bytes_accessed is not None:
+        msg += " {:>10.2f} GB/s".format(bytes_accessed / latency_ms / 1e6)
+    print(msg)
+
+
+def random_input(shape, dtype=np.float32):
+    return np.random.uniform(-1, 1, size=shape).astype(dtype)
@@ -0,0 +1,103 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import benchmark_util
+import oneflow as flow
+import oneflow.typing as oft
+
+# (name, in_channels, height/width, out_channels, kernel_size, stride)
+RESNET50_CONV_LAYERS = [
+    ("conv1", 3, 224, 64, 7, 2),
+    ("res2_1x1_reduce", 256, 56, 64, 1, 1),
+    ("res2_3x3", 64, 56, 64, 3, 1),
+    ("res2_1x1_expand", 64, 56, 256, 1, 1),
+    ("res3_1x1_reduce", 512, 28, 128, 1, 1),
+    ("res3_3x3", 128, 28, 128, 3, 1),
+    ("res4_1x1_reduce", 1024, 14, 256, 1, 1),
+    ("res4_3x3", 256, 14, 256, 3, 1),
+    ("res5_1x1_reduce", 2048, 7, 512, 1, 1),
+    ("res5_3x3", 512, 7, 512, 3, 1),
+    ("res5_1x1_expand", 512, 7, 2048, 1, 1),
+]
+
+
+def benchmark_conv(args, layer):
+    name, in_channels, size, out_channels, kernel_size, stride = layer
+    benchmark_util.init_env(args)
+    if args.data_format == "NCHW":
+        x_shape = (args.batch_size, in_channels, size, size)
+        weight_shape = (out_channels, in_channels, kernel_size, kernel_size)
+    else:
+        x_shape = (args.batch_size, size, size, in_channels)
+        weight_shape = (out_channels, kernel_size, kernel_size, in_channels)
+    job_type = "train" if args.backward else "predict"
+
+    @flow.global_function(
+        type=job_type, function_config=benchmark_util.get_func_config()
+    )
+    def ConvJob(x: oft.Numpy.Placeholder(x_shape)):
+        with flow.scope.placement("cpu", "0:0"):
+            weight = flow.get_variable(
+                "weight",
+                shape=weight_shape,
+                dtype=flow.float,
+                initializer=flow.random_uniform_initializer(minval=-1, maxval=1),
+            )
+            if args.backward:
+                x += flow.get_variable(
+                    "x_bias",
+                    shape=(1,),
+                    dtype=flow.float,
+                    initializer=flow.zeros_initializer(),
+                )
+            out = flow.nn.conv2d(
+                x, weight, strides=stride, padding="SAME", data_format=args.data_format
+            )
+            if args.backward:
+                flow.optimizer.SGD(
+                    flow.optimizer.PiecewiseConstantScheduler([], [0]), momentum=0
+                ).minimize(out)
+            return out
+
+    flow.train.CheckPoint().init()
+    latency = benchmark_util.measure(
+        ConvJob, [benchmark_util.random_input(x_shape)], args
+    )
+    out_size = (size + stride - 1) // stride
+    flops = (
+        2.0
+        * args.batch_size
+        * out_channels
+        * out_size
+        * out_size
+        * in_channels
+        * kernel_size
+        * kernel_size
+    )
+    if args.backward:
+        flops *= 3
+    benchmark_util.print_result(
+        "{} {} {}".format(name, args.data_format, job_type), latency, flops=flops
+    )
+
+
+if __name__ == "__main__":
+    parser = benchmark_util.get_parser("benchmark of cpu conv on ResNet-50 layers")
+    parser.add_argument("--batch_size", type=int, default=16)
+    parser.add_argument("--data_format", type=str, default="NCHW")
+    parser.add_argument("--backward", action="store_true")
+    args = parser.parse_args()
+    for layer in RESNET50_CONV_LAYERS:
+        benchmark_conv(args, layer)
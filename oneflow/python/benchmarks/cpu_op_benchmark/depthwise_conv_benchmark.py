@@ -0,0 +1,112 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import os
+
+import benchmark_util
+import oneflow as flow
+import oneflow.typing as oft
+
+# (name, channels, height/width, stride), the 3x3 depthwise layers of MobileNetV2
+MOBILENET_V2_DEPTHWISE_LAYERS = [
+    ("block1_dw", 32, 112, 1),
+    ("block2_dw", 96, 112, 2),
+    ("block3_dw", 144, 56, 1),
+    ("block4_dw", 144, 56, 2),
+    ("block5_dw", 192, 28, 1),
+    ("block7_dw", 192, 28, 2),
+    ("block8_dw", 384, 14, 1),
+    ("block12_dw", 576, 14, 1),
+    ("block14_dw", 576, 14, 2),
+    ("block15_dw", 960, 7, 1),
+]
+
+
+def benchmark_depthwise_conv(args, layer):
+    name, channels, size, stride = layer
+    benchmark_util.init_env(args)
+    if args.data_format == "NCHW":
+        x_shape = (args.batch_size, channels, size, size)
+        weight_shape = (channels, 1, 3, 3)
+    else:
+        x_shape = (args.batch_size, size, size, channels)
+        weight_shape = (channels, 3, 3, 1)
+    job_type = "train" if args.backward else "predict"
+
+    @flow.global_function(
+        type=job_type, function_config=benchmark_util.get_func_config()
+    )
+    def DepthwiseConvJob(x: oft.Numpy.Placeholder(x_shape)):
+        with flow.scope.placement("cpu", "0:0"):
+            weight = flow.get_variable(
+                "weight",
+                shape=weight_shape,
+                dtype=flow.float,
+                initializer=flow.random_uniform_initializer(minval=-1, maxval=1),
+            )
+            if args.backward:
+                x += flow.get_variable(
+                    "x_bias",
+                    shape=(1,),
+                    dtype=flow.float,
+                    initializer=flow.zeros_initializer(),
+                )
+            out = flow.nn.conv2d(
+                x,
+                weight,
+                strides=stride,
+                padding="SAME",
+                data_format=args.data_format,
+                groups=channels,
+            )
+            if args.backward:
+                flow.optimizer.SGD(
+                    flow.optimizer.PiecewiseConstantScheduler([], [0]), momentum=0
+                ).minimize(out)
+            return out
+
+    flow.train.CheckPoint().init()
+    latency = benchmark_util.measure(
+        DepthwiseConvJob, [benchmark_util.random_input(x_shape)], args
+    )
+    out_size = (size + stride - 1) // stride
+    flops = 2.0 * args.batch_size * channels * out_size * out_size * 3 * 3
+    if args.backward:
+        flops *= 3
+    kernel = "im2col" if args.disable_depthwise_kernel else "depthwise"
+    benchmark_util.print_result(
+        "{} {} {} {}".format(name, args.data_format, job_type, kernel),
+        latency,
+        flops=flops,
+    )
+
+
+if __name__ == "__main__":
+    parser = benchmark_util.get_parser(
+        "benchmark of cpu depthwise conv on MobileNetV2 layers"
+    )
+    parser.add_argument("--batch_size", type=int, default=16)
+    parser.add_argument("--data_format", type=str, default="NHWC")
+    parser.add_argument("--backward", action="store_true")
+    parser.add_argument(
+        "--disable_depthwise_kernel",
+        action="store_true",
+        help="fall back to the per-group im2col + gemm kernel for comparison",
+    )
+    args = parser.parse_args()
+    if args.disable_depthwise_kernel:
+        os.environ["ONEFLOW_DISABLE_CPU_DEPTHWISE_CONV"] = "1"
+    for layer in MOBILENET_V2_DEPTHWISE_LAYERS:
+        benchmark_depthwise_conv(args, layer)
@@ -0,0 +1,86 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+from google.protobuf import text_format
+
+import benchmark_util
+import oneflow as flow
+import oneflow.core.common.error_pb2 as error_util
+import oneflow.oneflow_internal as oneflow_internal
+import oneflow.python.framework.c_api_util as c_api_util
+from oneflow.python.framework.job_build_and_infer_error import JobBuildAndInferError
+
+# (name, op), the ops run on a tiny blob so that the dispatching dominates the latency
+EAGER_OPS = [
+    ("identity", flow.identity),
+    ("relu", flow.math.relu),
+    ("scalar_add", lambda x: x + 1),
+]
+
+
+def _TextProtoRunInstruction(run_api):
+    def RunInstruction(vm_instruction_list, eager_symbol_list):
+        error_str = run_api(
+            text_format.MessageToString(vm_instruction_list),
+            text_format.MessageToString(eager_symbol_list),
+        )
+        error = text_format.Parse(error_str, error_util.ErrorProto())
+        if error.HasField("error_type"):
+            raise JobBuildAndInferError(error)
+
+    return RunInstruction
+
+
+def use_text_proto():
+    r"""Sends the instructions in text format, which is the wire format used before."""
+    c_api_util.RunLogicalInstruction = _TextProtoRunInstruction(
+        oneflow_internal.RunLogicalInstruction
+    )
+    c_api_util.RunPhysicalInstruction = _TextProtoRunInstruction(
+        oneflow_internal.RunPhysicalInstruction
+    )
+
+
+def benchmark_eager_dispatch(args, name, op):
+    benchmark_util.init_env(args)
+    flow.enable_eager_execution(True)
+    func_config = flow.FunctionConfig()
+    func_config.default_data_type(flow.float)
+    func_config.default_logical_view(flow.scope.mirrored_view())
+
+    @flow.global_function(function_config=func_config)
+    def DispatchJob():
+        with flow.scope.placement("cpu", "0:0"):
+            x = flow.constant(1, shape=(1,), dtype=flow.float)
+            for _ in range(args.op_num):
+                x = op(x)
+            return x
+
+    latency = benchmark_util.measure(DispatchJob, [], args)
+    wire_format = "text" if args.text_proto else "binary"
+    benchmark_util.print_result(
+        "{} {} per op".format(name, wire_format), latency / (args.op_num + 1)
+    )
+
+
+if __name__ == "__main__":
+    parser = benchmark_util.get_parser("benchmark of the dispatch latency of eager ops")
+    parser.add_argument("--op_num", type=int, default=100)
+    parser.add_argument("--text_proto", action="store_true")
+    args = parser.parse_args()
+    if args.text_proto:
+        use_text_proto()
+    for name, op in EAGER_OPS:
+        benchmark_eager_dispatch(args, name, op)
@@ -0,0 +1,69 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import benchmark_util
+import oneflow as flow
+import oneflow.typing as oft
+
+# (name, input num, job body)
+ELEMENTWISE_OPS = [
+    ("relu", 1, lambda x: flow.math.relu(x)),
+    ("sigmoid", 1, lambda x: flow.math.sigmoid(x)),
+    ("tanh", 1, lambda x: flow.math.tanh(x)),
+    ("scalar_add", 1, lambda x: flow.math.add(x, 1.5)),
+    ("scalar_mul", 1, lambda x: flow.math.multiply(x, 1.5)),
+    ("abs", 1, lambda x: flow.math.abs(x)),
+    ("exp", 1, lambda x: flow.math.exp(x)),
+    ("square", 1, lambda x: flow.math.square(x)),
+    ("pow", 2, lambda x, y: flow.math.pow(x, y)),
+    ("xdivy", 2, lambda x, y: flow.math.xdivy(x, y)),
+]
+
+
+def benchmark_elementwise(args, op):
+    name, input_num, body = op
+    benchmark_util.init_env(args)
+    shape = (args.elem_cnt,)
+    placeholders = [oft.Numpy.Placeholder(shape) for _ in range(input_num)]
+
+    if input_num == 1:
+
+        @flow.global_function(function_config=benchmark_util.get_func_config())
+        def ElementwiseJob(x: placeholders[0]):
+            with flow.scope.placement("cpu", "0:0"):
+                return body(x)
+
+    else:
+
+        @flow.global_function(function_config=benchmark_util.get_func_config())
+        def ElementwiseJob(x: placeholders[0], y: placeholders[1]):
+            with flow.scope.placement("cpu", "0:0"):
+                return body(x, y)
+
+    # positive inputs keep pow and friends away from nan
+    inputs = [benchmark_util.random_input(shape) + 2 for _ in range(input_num)]
+    latency = benchmark_util.measure(ElementwiseJob, inputs, args)
+    bytes_accessed = 4.0 * args.elem_cnt * (input_num + 1)
+    benchmark_util.print_result(
+        "{} {}".format(name, args.elem_cnt), latency, bytes_accessed=bytes_accessed
+    )
+
+
+if __name__ == "__main__":
+    parser = benchmark_util.get_parser("throughput benchmark of cpu elementwise ops")
+    parser.add_argument("--elem_cnt", type=int, default=16 * 1024 * 1024)
+    args = parser.parse_args()
+    for op in ELEMENTWISE_OPS:
+        benchmark_elementwise(args, op)
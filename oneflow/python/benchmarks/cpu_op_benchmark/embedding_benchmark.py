@@ -0,0 +1,89 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import numpy as np
+
+import benchmark_util
+import oneflow as flow
+import oneflow.typing as oft
+
+# (num_ids, embedding_size), ids looked up per step
+LOOKUPS = [
+    (4096, 16),
+    (65536, 64),
+    (16384, 128),
+]
+
+
+def benchmark_gather(args, lookup):
+    num_ids, embedding_size = lookup
+    benchmark_util.init_env(args)
+
+    @flow.global_function(function_config=benchmark_util.get_func_config())
+    def GatherJob(ids: oft.Numpy.Placeholder((num_ids,), dtype=flow.int32)):
+        with flow.scope.placement("cpu", "0:0"):
+            table = flow.get_variable(
+                "table",
+                shape=(args.num_rows, embedding_size),
+                dtype=flow.float,
+                initializer=flow.zeros_initializer(),
+            )
+            return flow.gather(table, ids)
+
+    flow.train.CheckPoint().init()
+    ids = np.random.randint(0, args.num_rows, size=(num_ids,)).astype(np.int32)
+    latency = benchmark_util.measure(GatherJob, [ids], args)
+    benchmark_util.print_result(
+        "gather {}x{} of {} rows".format(num_ids, embedding_size, args.num_rows),
+        latency,
+        bytes_accessed=2 * 4.0 * num_ids * embedding_size,
+    )
+
+
+def benchmark_unsorted_segment_sum(args, lookup):
+    num_ids, embedding_size = lookup
+    benchmark_util.init_env(args)
+    data_shape = (num_ids, embedding_size)
+
+    @flow.global_function(function_config=benchmark_util.get_func_config())
+    def UnsortedSegmentSumJob(
+        data: oft.Numpy.Placeholder(data_shape),
+        ids: oft.Numpy.Placeholder((num_ids,), dtype=flow.int32),
+    ):
+        with flow.scope.placement("cpu", "0:0"):
+            return flow.math.unsorted_segment_sum(data, ids, num_segments=args.num_rows)
+
+    ids = np.random.randint(0, args.num_rows, size=(num_ids,)).astype(np.int32)
+    inputs = [benchmark_util.random_input(data_shape), ids]
+    latency = benchmark_util.measure(UnsortedSegmentSumJob, inputs, args)
+    # the output table is zeroed and written besides the accumulated rows
+    bytes_accessed = 4.0 * (3 * num_ids + args.num_rows) * embedding_size
+    benchmark_util.print_result(
+        "unsorted_segment_sum {}x{} to {} rows".format(
+            num_ids, embedding_size, args.num_rows
+        ),
+        latency,
+        bytes_accessed=bytes_accessed,
+    )
+
+
+if __name__ == "__main__":
+    parser = benchmark_util.get_parser("benchmark of cpu embedding lookup and its grad")
+    parser.add_argument("--num_rows", type=int, default=1024 * 1024)
+    args = parser.parse_args()
+    for lookup in LOOKUPS:
+        benchmark_gather(args, lookup)
+    for lookup in LOOKUPS:
+        benchmark_unsorted_segment_sum(args, lookup)
@@ -0,0 +1,53 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import benchmark_util
+import numpy as np
+import oneflow as flow
+import oneflow.typing as oft
+
+# sizes of the pushed and pulled tensor in MB
+TENSOR_SIZES = [1, 4, 16, 64, 100]
+
+
+def benchmark_foreign_io(args, size_mb, lend):
+    benchmark_util.init_env(args)
+    elem_cnt = size_mb * 1024 * 1024 // 4
+    shape = (elem_cnt // 1024, 1024)
+
+    @flow.global_function(function_config=benchmark_util.get_func_config())
+    def ForeignIOJob(x: oft.Numpy.Placeholder(shape)):
+        with flow.scope.placement("cpu", "0:0"):
+            return flow.identity(x)
+
+    x = benchmark_util.random_input(shape)
+    # a read-only ndarray owning its data is lent to the input blob, otherwise copied
+    x.flags.writeable = not lend
+    latency = benchmark_util.measure(ForeignIOJob, [x], args)
+    benchmark_util.print_result(
+        "foreign io {}MB {}".format(size_mb, "lent" if lend else "copied"),
+        latency,
+        bytes_accessed=x.nbytes * 2,
+    )
+
+
+if __name__ == "__main__":
+    parser = benchmark_util.get_parser(
+        "benchmark of the latency of feeding and fetching a tensor in lazy mode"
+    )
+    args = parser.parse_args()
+    for size_mb in TENSOR_SIZES:
+        for lend in [False, True]:
+            benchmark_foreign_io(args, size_mb, lend)
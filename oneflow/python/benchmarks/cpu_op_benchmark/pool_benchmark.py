@@ -0,0 +1,89 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import benchmark_util
+import oneflow as flow
+import oneflow.typing as oft
+
+# (name, pooling_type, channels, height/width, ksize, stride, padding)
+POOL_LAYERS = [
+    ("resnet_stem_max", "MAX", 64, 112, 3, 2, "SAME"),
+    ("inception_3x3_avg", "AVG", 192, 35, 3, 1, "SAME"),
+    ("inception_3x3_max", "MAX", 288, 35, 3, 2, "VALID"),
+    ("vgg_2x2_max", "MAX", 128, 112, 2, 2, "VALID"),
+    ("resnet_global_avg", "AVG", 2048, 7, 7, 1, "VALID"),
+]
+
+
+def benchmark_pool(args, layer):
+    name, pooling_type, channels, size, ksize, stride, padding = layer
+    benchmark_util.init_env(args)
+    if args.data_format == "NCHW":
+        x_shape = (args.batch_size, channels, size, size)
+    else:
+        x_shape = (args.batch_size, size, size, channels)
+    job_type = "train" if args.backward else "predict"
+
+    @flow.global_function(
+        type=job_type, function_config=benchmark_util.get_func_config()
+    )
+    def PoolJob(x: oft.Numpy.Placeholder(x_shape)):
+        with flow.scope.placement("cpu", "0:0"):
+            if args.backward:
+                x += flow.get_variable(
+                    "x_bias",
+                    shape=(1,),
+                    dtype=flow.float,
+                    initializer=flow.zeros_initializer(),
+                )
+            if pooling_type == "AVG":
+                pooling_f = flow.nn.avg_pool2d
+            else:
+                pooling_f = flow.nn.max_pool2d
+            out = pooling_f(
+                x,
+                ksize=ksize,
+                strides=stride,
+                padding=padding,
+                data_format=args.data_format,
+            )
+            if args.backward:
+                flow.optimizer.SGD(
+                    flow.optimizer.PiecewiseConstantScheduler([], [0]), momentum=0
+                ).minimize(out)
+            return out
+
+    flow.train.CheckPoint().init()
+    latency = benchmark_util.measure(
+        PoolJob, [benchmark_util.random_input(x_shape)], args
+    )
+    bytes_accessed = 4.0 * args.batch_size * channels * size * size
+    if args.backward:
+        bytes_accessed *= 3
+    benchmark_util.print_result(
+        "{} {} {}".format(name, args.data_format, job_type),
+        latency,
+        bytes_accessed=bytes_accessed,
+    )
+
+
+if __name__ == "__main__":
+    parser = benchmark_util.get_parser("benchmark of cpu pooling")
+    parser.add_argument("--batch_size", type=int, default=16)
+    parser.add_argument("--data_format", type=str, default="NCHW")
+    parser.add_argument("--backward", action="store_true")
+    args = parser.parse_args()
+    for layer in POOL_LAYERS:
+        benchmark_pool(args, layer)
@@ -0,0 +1,120 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import numpy as np
+
+import benchmark_util
+import oneflow as flow
+import oneflow.typing as oft
+
+# (name, num_instances, num_classes)
+SOFTMAX_SHAPES = [
+    ("bert_attention_probs", 8 * 12 * 128, 128),
+    ("imagenet_logits", 256, 1000),
+    ("bert_vocab_logits", 640, 30522),
+]
+
+
+def benchmark_softmax(args, shape):
+    name, num_instances, num_classes = shape
+    benchmark_util.init_env(args)
+    x_shape = (num_instances, num_classes)
+    job_type = "train" if args.backward else "predict"
+
+    @flow.global_function(
+        type=job_type, function_config=benchmark_util.get_func_config()
+    )
+    def SoftmaxJob(x: oft.Numpy.Placeholder(x_shape)):
+        with flow.scope.placement("cpu", "0:0"):
+            if args.backward:
+                x += flow.get_variable(
+                    "x_bias",
+                    shape=(1,),
+                    dtype=flow.float,
+                    initializer=flow.zeros_initializer(),
+                )
+            out = flow.nn.softmax(x)
+            if args.backward:
+                flow.optimizer.SGD(
+                    flow.optimizer.PiecewiseConstantScheduler([], [0]), momentum=0
+                ).minimize(out)
+            return out
+
+    flow.train.CheckPoint().init()
+    latency = benchmark_util.measure(
+        SoftmaxJob, [benchmark_util.random_input(x_shape)], args
+    )
+    passes = 4 if args.backward else 2
+    benchmark_util.print_result(
+        "softmax {}".format(name),
+        latency,
+        bytes_accessed=4.0 * num_instances * num_classes * passes,
+    )
+
+
+def benchmark_sparse_softmax_cross_entropy(args, shape):
+    name, num_instances, num_classes = shape
+    benchmark_util.init_env(args)
+    x_shape = (num_instances, num_classes)
+    job_type = "train" if args.backward else "predict"
+
+    @flow.global_function(
+        type=job_type, function_config=benchmark_util.get_func_config()
+    )
+    def SparseSoftmaxCrossEntropyJob(
+        x: oft.Numpy.Placeholder(x_shape),
+        label: oft.Numpy.Placeholder((num_instances,), dtype=flow.int32),
+    ):
+        with flow.scope.placement("cpu", "0:0"):
+            if args.backward:
+                x += flow.get_variable(
+                    "x_bias",
+                    shape=(1,),
+                    dtype=flow.float,
+                    initializer=flow.zeros_initializer(),
+                )
+            loss = flow.nn.sparse_softmax_cross_entropy_with_logits(
+                labels=label, logits=x
+            )
+            if args.backward:
+                flow.optimizer.SGD(
+                    flow.optimizer.PiecewiseConstantScheduler([], [0]), momentum=0
+                ).minimize(loss)
+            return loss
+
+    flow.train.CheckPoint().init()
+    inputs = [
+        benchmark_util.random_input(x_shape),
+        np.random.randint(0, num_classes, size=(num_instances,)).astype(np.int32),
+    ]
+    latency = benchmark_util.measure(SparseSoftmaxCrossEntropyJob, inputs, args)
+    passes = 4 if args.backward else 2
+    benchmark_util.print_result(
+        "sparse_softmax_cross_entropy {}".format(name),
+        latency,
+        bytes_accessed=4.0 * num_instances * num_classes * passes,
+    )
+
+
+if __name__ == "__main__":
+    parser = benchmark_util.get_parser(
+        "benchmark of cpu softmax and softmax cross entropy"
+    )
+    parser.add_argument("--backward", action="store_true")
+    args = parser.parse_args()
+    for shape in SOFTMAX_SHAPES:
+        benchmark_softmax(args, shape)
+    for shape in SOFTMAX_SHAPES:
+        benchmark_sparse_softmax_cross_entropy(args, shape)
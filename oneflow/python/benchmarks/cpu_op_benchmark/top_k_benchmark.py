@@ -0,0 +1,75 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import benchmark_util
+import oneflow as flow
+import oneflow.typing as oft
+
+# (instance_num, instance_size), from recommendation scores to lm decoding logits
+TOP_K_SHAPES = [
+    (1024, 1000),
+    (64, 32000),
+    (8, 131072),
+    (1, 1048576),
+]
+TOP_K_KS = [1, 10, 100, 1000]
+
+
+def benchmark_top_k(args, shape, k):
+    instance_num, instance_size = shape
+    benchmark_util.init_env(args)
+
+    @flow.global_function(function_config=benchmark_util.get_func_config())
+    def TopKJob(x: oft.Numpy.Placeholder(shape)):
+        with flow.scope.placement("cpu", "0:0"):
+            return flow.math.top_k(x, k=k)
+
+    latency = benchmark_util.measure(
+        TopKJob, [benchmark_util.random_input(shape)], args
+    )
+    benchmark_util.print_result(
+        "top_k {}x{} k={}".format(instance_num, instance_size, k),
+        latency,
+        bytes_accessed=4.0 * instance_num * instance_size,
+    )
+
+
+def benchmark_arg_sort(args, shape):
+    instance_num, instance_size = shape
+    benchmark_util.init_env(args)
+
+    @flow.global_function(function_config=benchmark_util.get_func_config())
+    def ArgSortJob(x: oft.Numpy.Placeholder(shape)):
+        with flow.scope.placement("cpu", "0:0"):
+            return flow.argsort(x)
+
+    latency = benchmark_util.measure(
+        ArgSortJob, [benchmark_util.random_input(shape)], args
+    )
+    benchmark_util.print_result(
+        "arg_sort {}x{}".format(instance_num, instance_size),
+        latency,
+        bytes_accessed=8.0 * instance_num * instance_size,
+    )
+
+
+if __name__ == "__main__":
+    parser = benchmark_util.get_parser("benchmark of cpu top_k and arg_sort")
+    args = parser.parse_args()
+    for shape in TOP_K_SHAPES:
+        for k in TOP_K_KS:
+            benchmark_top_k(args, shape, k)
+    for shape in TOP_K_SHAPES:
+        benchmark_arg_sort(args, shape)
@@ -58,6 +58,34 @@ def LogicalRun(build):
     )
 
 
+# same as *Run, but return without waiting for the instructions to be done.
+# the returned sequence number is passed to WaitUntilDone or IsDone
+def PhysicalSubmit(build):
+    return _Run(
+        build,
+        vm_id_util.PhysicalIdGenerator(),
+        c_api_util.SubmitPhysicalInstruction,
+        _ReleasePhysicalObject,
+    )
+
+
+def LogicalSubmit(build):
+    return _Run(
+        build,
+        vm_id_util.LogicalIdGenerator(),
+        c_api_util.SubmitLogicalInstruction,
+        _ReleaseLogicalObject,
+    )
+
+
+def WaitUntilDone(submitted_seq):
+    c_api_util.WaitUntilInstructionsDone(submitted_seq)
+
+
+def IsDone(submitted_seq):
+    return c_api_util.InstructionsDone(submitted_seq)
+
+
 def _Run(build, id_generator, run_api, release_object):
     instruction_list = session_ctx.GetDefaultSession().instruction_list
     eager_symbol_list = session_ctx.GetDefaultSession().eager_symbol_list
@@ -66,9 +94,10 @@ def _Run(build, id_generator, run_api, release_object):
             id_generator, release_object, instruction_list, eager_symbol_list
         )
     )
-    run_api(instruction_list, eager_symbol_list)
+    ret = run_api(instruction_list, eager_symbol_list)
     instruction_list.ClearField("instruction")
     eager_symbol_list.ClearField("eager_symbol")
+    return ret
 
 
 def _DefaultBlobObject4Ibn(ibn):
@@ -572,21 +572,62 @@ def GetFunctionConfigDef():
 
 
 def RunLogicalInstruction(vm_instruction_list, eager_symbol_list):
-    instructions = str(text_format.MessageToString(vm_instruction_list))
-    symbols = str(text_format.MessageToString(eager_symbol_list))
-    error_str = oneflow_internal.RunLogicalInstruction(instructions, symbols)
+    instructions = vm_instruction_list.SerializeToString()
+    symbols = eager_symbol_list.SerializeToString()
+    error_str = oneflow_internal.RunLogicalInstructionFromBinaryProto(
+        instructions, symbols
+    )
     error = text_format.Parse(error_str, error_util.ErrorProto())
     if error.HasField("error_type"):
         raise JobBuildAndInferError(error)
 
 
 def RunPhysicalInstruction(vm_instruction_list, eager_symbol_list):
-    instructions = str(text_format.MessageToString(vm_instruction_list))
-    symbols = str(text_format.MessageToString(eager_symbol_list))
-    error_str = oneflow_internal.RunPhysicalInstruction(instructions, symbols)
+    instructions = vm_instruction_list.SerializeToString()
+    symbols = eager_symbol_list.SerializeToString()
+    error_str = oneflow_internal.RunPhysicalInstructionFromBinaryProto(
+        instructions, symbols
+    )
+    error = text_format.Parse(error_str, error_util.ErrorProto())
+    if error.HasField("error_type"):
+        raise JobBuildAndInferError(error)
+
+
+def SubmitLogicalInstruction(vm_instruction_list, eager_symbol_list):
+    instructions = vm_instruction_list.SerializeToString()
+    symbols = eager_symbol_list.SerializeToString()
+    submit_api = oneflow_internal.SubmitLogicalInstructionFromBinaryProto
+    submitted_seq, error_str = submit_api(instructions, symbols)
+    error = text_format.Parse(error_str, error_util.ErrorProto())
+    if error.HasField("error_type"):
+        raise JobBuildAndInferError(error)
+    return submitted_seq
+
+
+def SubmitPhysicalInstruction(vm_instruction_list, eager_symbol_list):
+    instructions = vm_instruction_list.SerializeToString()
+    symbols = eager_symbol_list.SerializeToString()
+    submit_api = oneflow_internal.SubmitPhysicalInstructionFromBinaryProto
+    submitted_seq, error_str = submit_api(instructions, symbols)
+    error = text_format.Parse(error_str, error_util.ErrorProto())
+    if error.HasField("error_type"):
+        raise JobBuildAndInferError(error)
+    return submitted_seq
+
+
+def WaitUntilInstructionsDone(submitted_seq):
+    error_str = oneflow_internal.WaitUntilInstructionsDone(submitted_seq)
+    error = text_format.Parse(error_str, error_util.ErrorProto())
+    if error.HasField("error_type"):
+        raise JobBuildAndInferError(error)
+
+
+def InstructionsDone(submitted_seq):
+    done, error_str = oneflow_internal.InstructionsDone(submitted_seq)
     error = text_format.Parse(error_str, error_util.ErrorProto())
     if error.HasField("error_type"):
         raise JobBuildAndInferError(error)
+    return done
 
 
 def CurrentMachineId():
@@ -142,6 +142,42 @@ def enable_numa_aware_cuda_malloc_host(val):
     sess.config_proto.resource.enable_numa_aware_cuda_malloc_host = val
 
 
+@oneflow_export("config.enable_thread_pinning")
+def api_enable_thread_pinning(val: bool = True) -> None:
+    r"""Whether or not pin the actor threads and the compute threads to cpu cores
+    by the numa topology of the machine.
+
+    Args:
+        val (bool, optional): True or False. Defaults to True.
+    """
+    return enable_if.unique([enable_thread_pinning, do_nothing])(val)
+
+
+@enable_if.condition(hob.in_normal_mode & ~hob.session_initialized)
+def enable_thread_pinning(val):
+    sess = session_ctx.GetDefaultSession()
+    assert type(val) is bool
+    sess.config_proto.resource.thread_placement_conf.enable_thread_pinning = val
+
+
+@oneflow_export("config.enable_numa_aware_host_malloc")
+def api_enable_numa_aware_host_malloc(val: bool = True) -> None:
+    r"""Whether or not allocate the host memory of registers on the numa node
+    of the threads producing them.
+
+    Args:
+        val (bool, optional): True or False. Defaults to True.
+    """
+    return enable_if.unique([enable_numa_aware_host_malloc, do_nothing])(val)
+
+
+@enable_if.condition(hob.in_normal_mode & ~hob.session_initialized)
+def enable_numa_aware_host_malloc(val):
+    sess = session_ctx.GetDefaultSession()
+    assert type(val) is bool
+    sess.config_proto.resource.thread_placement_conf.enable_numa_aware_host_malloc = val
+
+
 @oneflow_export("config.compute_thread_pool_size")
 def api_compute_thread_pool_size(val: int) -> None:
     r"""Set up the size of compute thread pool 
@@ -545,6 +545,52 @@ def set_enable_non_distributed_optimizer(func_desc, value=True):
     func_desc.job_config_proto.enable_non_distributed_optimizer = value
 
 
+@oneflow_function_config("enable_multi_tensor_model_update")
+def set_enable_multi_tensor_model_update(func_desc, value=True):
+    r"""Whether update the models placed on cpu with the same optimizer in one fused op or not
+
+    Args:
+        func_desc ([type]): [description]
+        value (bool, optional): [description]. Defaults to True.
+    """
+    func_desc.job_config_proto.enable_multi_tensor_model_update = value
+
+
+@oneflow_function_config("enable_op_fusion")
+def set_enable_op_fusion(func_desc, value=True):
+    r"""Whether fuse op chains such as bias_add -> relu, scalar_mul -> add_n and cast -> cast
+    or not
+
+    Args:
+        func_desc ([type]): [description]
+        value (bool, optional): [description]. Defaults to True.
+    """
+    func_desc.job_config_proto.enable_op_fusion = value
+
+
+@oneflow_function_config("enable_sbp_signature_cache")
+def set_enable_sbp_signature_cache(func_desc, value=True):
+    r"""Whether infer the sbp signature of identical user ops only once or not
+
+    Args:
+        func_desc ([type]): [description]
+        value (bool, optional): [description]. Defaults to True.
+    """
+    func_desc.job_config_proto.enable_sbp_signature_cache = value
+
+
+@oneflow_function_config("enable_sbp_signature_search")
+def set_enable_sbp_signature_search(func_desc, value=True):
+    r"""Whether search the sbp signatures of user ops for the least total copy cost of
+    the job, instead of choosing them op by op, or not
+
+    Args:
+        func_desc ([type]): [description]
+        value (bool, optional): [description]. Defaults to True.
+    """
+    func_desc.job_config_proto.enable_sbp_signature_search = value
+
+
 @oneflow_function_config("disable_all_reduce_sequence")
 def set_disable_all_reduce_sequence(func_desc, value=True):
     print(
@@ -683,6 +729,19 @@ def set_indexed_slices_optimizer_conf(func_desc, value):
     pb_util.PythonDict2PbMessage(value, pb_msg)
 
 
+@oneflow_function_config("activation_checkpointing_conf")
+def set_activation_checkpointing_conf(func_desc, value):
+    r"""Set which forward activations are recomputed in backward instead of being kept
+
+    Args:
+        func_desc ([type]): [description]
+        value ([type]): a dict like {"op_name_prefix": ["layer0-"]}
+    """
+    assert type(value) is dict
+    pb_msg = func_desc.job_config_proto.activation_checkpointing_conf
+    pb_util.PythonDict2PbMessage(value, pb_msg)
+
+
 @oneflow_function_config("train.loss_scale_factor")
 def set_loss_scale_factor(func_desc, value):
     r"""Set scale factor for loss
@@ -765,6 +824,17 @@ def set_use_tensorrt(func_desc, value=True):
     func_desc.job_config_proto.xrt_config.use_tensorrt = value
 
 
+@oneflow_function_config("use_xrt_native")
+def set_use_xrt_native(func_desc, value=True):
+    r"""Whether use the native xrt engine for cpu or not
+
+    Args:
+        func_desc ([type]): [description]
+        value (bool, optional): [description]. Defaults to True.
+    """
+    func_desc.job_config_proto.xrt_config.use_xrt_native = value
+
+
 @oneflow_function_config("tensorrt.use_fp16")
 def set_tensorrt_use_fp16(func_desc, value=True):
     r"""Whether use tensorrt fp16  or not
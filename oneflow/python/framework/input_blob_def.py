@@ -324,13 +324,27 @@ def _AddAndInferMirroredOp(mirrored_lbn, op_conf, sub_consistent_blob_list):
 
 
 def _MakePushNdarrayCallback(ndarray):
-    copied = np.copy(ndarray)
+    # Pushing is asynchronous, so a snapshot of the ndarray is taken unless it's a
+    # read-only array owning its data. A read-only view or a broadcast array may still
+    # be modified through its base. Either way it's lent to the input blob if possible,
+    # and kept alive by the push job instance until the push job is finished.
+    if (
+        ndarray.flags.owndata
+        and not ndarray.flags.writeable
+        and ndarray.flags.c_contiguous
+    ):
+        copied = ndarray
+    else:
+        copied = np.copy(ndarray)
 
     def Copy(ofblob):
         capacity = reduce(lambda x, y: x * y, ofblob.static_shape, 1)
         elem_cnt = reduce(lambda x, y: x * y, copied.shape, 1)
         assert elem_cnt <= capacity, "%s v.s. %s" % (copied.shape, ofblob.static_shape)
-        ofblob.CopyFromNdarray(copied)
+        if ofblob.CanLendNdarray(copied):
+            ofblob.LendNdarray(copied)
+        else:
+            ofblob.CopyFromNdarray(copied)
 
     return Copy
 
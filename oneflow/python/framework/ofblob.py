@@ -22,7 +22,10 @@ import numpy as np
 import oneflow as flow
 import oneflow.oneflow_internal as oneflow_api
 from google.protobuf import text_format
-from oneflow.python.framework.dtype import convert_proto_dtype_to_oneflow_dtype
+from oneflow.python.framework.dtype import (
+    convert_oneflow_dtype_to_numpy_dtype,
+    convert_proto_dtype_to_oneflow_dtype,
+)
 from oneflow.python.lib.core.box import Box
 
 
@@ -85,6 +88,29 @@ class OfBlob(object):
     def is_tensor_list(self):
         return oneflow_api.OfBlob_IsTensorList(self.of_blob_ptr_)
 
+    @property
+    def is_body_host_accessible(self):
+        return oneflow_api.OfBlob_IsBodyHostAccessible(self.of_blob_ptr_)
+
+    def CanLendNdarray(self, ndarray):
+        return (
+            self.is_body_host_accessible
+            and ndarray.flags.c_contiguous
+            and ndarray.dtype == convert_oneflow_dtype_to_numpy_dtype(self.dtype)
+            and ndarray.shape == self.static_shape
+            and ndarray.ctypes.data % ndarray.itemsize == 0
+        )
+
+    def LendNdarray(self, ndarray):
+        r"""Uses the memory of `ndarray` as the blob body without copying.
+        The caller must keep `ndarray` alive and unmodified until all the consumers
+        of the blob are done, e.g. until the job pushing it is finished.
+        """
+        assert self.CanLendNdarray(ndarray)
+        oneflow_api.OfBlob_LendBody(
+            self.of_blob_ptr_, ndarray.ctypes.data, ndarray.nbytes
+        )
+
     def CopyToNdarray(self):
         ndarray_lists = self._CopyToNdarrayLists()
         assert len(ndarray_lists) == 1
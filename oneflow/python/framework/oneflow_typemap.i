@@ -3,3 +3,19 @@
 %apply_numpy_typemaps(int64_t)
 %apply_numpy_typemaps(uint8_t)
 %apply_numpy_typemaps(char)
+
+// binary protobuf is passed as python bytes, which is not accepted by the std::string typemaps
+%typemap(in) const std::string& serialized_binary_proto (std::string temp) {
+  char* buffer = nullptr;
+  Py_ssize_t length = 0;
+  if (PyBytes_AsStringAndSize($input, &buffer, &length) == -1) { SWIG_fail; }
+  temp.assign(buffer, length);
+  $1 = &temp;
+}
+%typemap(typecheck, precedence=SWIG_TYPECHECK_STRING) const std::string& serialized_binary_proto {
+  $1 = PyBytes_Check($input) ? 1 : 0;
+}
+%apply const std::string& serialized_binary_proto {
+  const std::string& serialized_instruction_list,
+  const std::string& serialized_eager_symbol_list
+};
@@ -155,6 +155,52 @@ void RunPhysicalInstruction(const std::string& vm_instruction_list,
       .GetDataAndSerializedErrorProto(error_str);
 }
 
+std::string EagerSymbolStorageMemoryUsage(std::string* error_str) {
+  return oneflow::EagerSymbolStorageMemoryUsage().GetDataAndSerializedErrorProto(error_str,
+                                                                                 std::string(""));
+}
+
+void RunLogicalInstructionFromBinaryProto(const std::string& serialized_instruction_list,
+                                          const std::string& serialized_eager_symbol_list,
+                                          std::string* error_str) {
+  return oneflow::RunLogicalInstructionFromBinaryProto(serialized_instruction_list,
+                                                       serialized_eager_symbol_list)
+      .GetDataAndSerializedErrorProto(error_str);
+}
+
+void RunPhysicalInstructionFromBinaryProto(const std::string& serialized_instruction_list,
+                                           const std::string& serialized_eager_symbol_list,
+                                           std::string* error_str) {
+  return oneflow::RunPhysicalInstructionFromBinaryProto(serialized_instruction_list,
+                                                        serialized_eager_symbol_list)
+      .GetDataAndSerializedErrorProto(error_str);
+}
+
+long SubmitLogicalInstructionFromBinaryProto(const std::string& serialized_instruction_list,
+                                            const std::string& serialized_eager_symbol_list,
+                                            std::string* error_str) {
+  return oneflow::SubmitLogicalInstructionFromBinaryProto(serialized_instruction_list,
+                                                          serialized_eager_symbol_list)
+      .GetDataAndSerializedErrorProto(error_str, 0LL);
+}
+
+long SubmitPhysicalInstructionFromBinaryProto(const std::string& serialized_instruction_list,
+                                             const std::string& serialized_eager_symbol_list,
+                                             std::string* error_str) {
+  return oneflow::SubmitPhysicalInstructionFromBinaryProto(serialized_instruction_list,
+                                                           serialized_eager_symbol_list)
+      .GetDataAndSerializedErrorProto(error_str, 0LL);
+}
+
+void WaitUntilInstructionsDone(long submitted_seq, std::string* error_str) {
+  return oneflow::WaitUntilInstructionsDone(submitted_seq)
+      .GetDataAndSerializedErrorProto(error_str);
+}
+
+bool InstructionsDone(long submitted_seq, std::string* error_str) {
+  return oneflow::InstructionsDone(submitted_seq).GetDataAndSerializedErrorProto(error_str, false);
+}
+
 long CurrentMachineId(std::string* error_str) {
   return oneflow::CurrentMachineId().GetDataAndSerializedErrorProto(error_str, 0LL);
 }
@@ -289,6 +335,18 @@ void OfBlob_CurMutTensorCopyShapeFrom(uint64_t of_blob_ptr, long* array, int siz
   return of_blob->CurMutTensorCopyShapeFrom(array, size);
 }
 
+bool OfBlob_IsBodyHostAccessible(uint64_t of_blob_ptr) {
+  using namespace oneflow;
+  auto* of_blob = reinterpret_cast<OfBlob*>(of_blob_ptr);
+  return of_blob->IsBodyHostAccessible();
+}
+
+void OfBlob_LendBody(uint64_t of_blob_ptr, uint64_t body_ptr, long byte_size) {
+  using namespace oneflow;
+  auto* of_blob = reinterpret_cast<OfBlob*>(of_blob_ptr);
+  return of_blob->LendBody(reinterpret_cast<char*>(body_ptr), byte_size);
+}
+
 void CacheInt8Calibration(std::string* error_str) {
   oneflow::CacheInt8Calibration().GetDataAndSerializedErrorProto(error_str);
 }
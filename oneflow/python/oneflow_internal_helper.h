@@ -283,6 +283,42 @@ Maybe<void> RunPhysicalInstruction(const std::string& instruction_list_str,
   return eager::RunPhysicalInstruction(instruction_list_str, eager_symbol_list_str);
 }
 
+Maybe<std::string> EagerSymbolStorageMemoryUsage() { return eager::SymbolStorageMemoryUsage(); }
+
+Maybe<void> RunLogicalInstructionFromBinaryProto(const std::string& serialized_instruction_list,
+                                                 const std::string& serialized_eager_symbol_list) {
+  return eager::RunLogicalInstructionFromBinaryProto(serialized_instruction_list,
+                                                     serialized_eager_symbol_list);
+}
+
+Maybe<void> RunPhysicalInstructionFromBinaryProto(const std::string& serialized_instruction_list,
+                                                  const std::string& serialized_eager_symbol_list) {
+  return eager::RunPhysicalInstructionFromBinaryProto(serialized_instruction_list,
+                                                      serialized_eager_symbol_list);
+}
+
+Maybe<long long> SubmitLogicalInstructionFromBinaryProto(
+    const std::string& serialized_instruction_list,
+    const std::string& serialized_eager_symbol_list) {
+  return JUST(eager::SubmitLogicalInstructionFromBinaryProto(serialized_instruction_list,
+                                                             serialized_eager_symbol_list));
+}
+
+Maybe<long long> SubmitPhysicalInstructionFromBinaryProto(
+    const std::string& serialized_instruction_list,
+    const std::string& serialized_eager_symbol_list) {
+  return JUST(eager::SubmitPhysicalInstructionFromBinaryProto(serialized_instruction_list,
+                                                              serialized_eager_symbol_list));
+}
+
+Maybe<void> WaitUntilInstructionsDone(long long submitted_seq) {
+  return eager::WaitUntilInstructionsDone(submitted_seq);
+}
+
+Maybe<bool> InstructionsDone(long long submitted_seq) {
+  return eager::InstructionsDone(submitted_seq);
+}
+
 Maybe<long long> CurrentMachineId() {
   CHECK_NOTNULL_OR_RETURN(Global<MachineCtx>::Get());
   return Global<MachineCtx>::Get()->this_machine_id();
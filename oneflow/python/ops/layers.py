@@ -179,7 +179,6 @@ def conv2d(
         ValueError: The number of groups must be positive and number of filters must be divisible by it. 
         ValueError: If data_format is not one of 'NCHW', 'NHWC'. 
         ValueError: If number of input channels is not divisible by number of groups or less than number of groups.
-        ValueError: Number of group must be one when data_format is 'NHWC'.
 
     Returns:
         remote_blob_util.BlobDef: A 4D `Blob` with the shape of (batch_size, filters, new_height, new_width).  
@@ -202,7 +201,6 @@ def conv2d(
         assert inputs.shape[1] % groups == 0
         weight_shape = (filters, inputs.shape[1] // groups) + kernel_size
     elif data_format.upper() == "NHWC":
-        assert groups == 1
         assert groups <= inputs.shape[3]
         assert inputs.shape[3] % groups == 0
         weight_shape = (
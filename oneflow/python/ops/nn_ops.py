@@ -221,7 +221,6 @@ def conv2d(
         ValueError: data_format must be "NHWC" or "NCHW".
         ValueError: dilations must be an int or a list.
         ValueError: invalid data_format.
-        ValueError: data_format NHWC not support groups > 1
         ValueError: invalid data_format.
 
     Returns:
@@ -273,7 +272,11 @@ def conv2d(
             assert input.shape[1] % groups == 0
             assert filters.shape[1] == input.shape[1] // groups
         elif data_format.upper() == "NHWC":
-            raise ValueError("data_format NHWC not support groups > 1")
+            assert groups <= filters.shape[0]
+            assert filters.shape[0] % groups == 0
+            assert groups <= input.shape[3]
+            assert input.shape[3] % groups == 0
+            assert filters.shape[3] == input.shape[3] // groups
         else:
             raise ValueError("invalid data_format")
     inputs, pads_list = calc_conv_padding(
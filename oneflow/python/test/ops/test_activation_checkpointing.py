@@ -0,0 +1,114 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import time
+
+import numpy as np
+import oneflow as flow
+import oneflow.python.framework.c_api_util as c_api_util
+import oneflow.typing as oft
+
+_clone_op_name_prefix = "System-ActivationCheckpointing-"
+
+
+def _run_mlp(checkpointing_conf, x, step_num, hidden_units, layer_num):
+    flow.clear_default_session()
+    func_config = flow.FunctionConfig()
+    func_config.default_data_type(flow.float)
+    if checkpointing_conf is not None:
+        func_config.activation_checkpointing_conf(checkpointing_conf)
+
+    @flow.global_function(type="train", function_config=func_config)
+    def MlpJob(x: oft.Numpy.Placeholder(x.shape)):
+        with flow.scope.placement("cpu", "0:0"):
+            out = x
+            with flow.scope.namespace("checkpointed"):
+                for i in range(layer_num):
+                    out = flow.layers.dense(
+                        out,
+                        hidden_units,
+                        activation=flow.math.gelu,
+                        kernel_initializer=flow.random_normal_initializer(
+                            stddev=0.1, seed=i
+                        ),
+                        bias_initializer=flow.constant_initializer(0.01),
+                        name="layer{}".format(i),
+                    )
+            loss = flow.math.reduce_mean(out * out)
+            flow.optimizer.SGD(
+                flow.optimizer.PiecewiseConstantScheduler([], [1e-3]), momentum=0
+            ).minimize(loss)
+            return loss
+
+    check_point = flow.train.CheckPoint()
+    check_point.init()
+    losses = [MlpJob(x).get().numpy()]
+    start = time.time()
+    for _ in range(step_num):
+        losses.append(MlpJob(x).get().numpy())
+    step_time = (time.time() - start) / step_num
+    job = [j for j in c_api_util.GetJobSet().job if j.job_conf.job_name == "MlpJob"]
+    return np.array(losses), step_time, job[0]
+
+
+def _check_clones(test_case, job):
+    op_names = set(op.name for op in job.net.op)
+    clone_names = set(n for n in op_names if n.startswith(_clone_op_name_prefix))
+    test_case.assertTrue(len(clone_names) > 0)
+    for clone_name in clone_names:
+        test_case.assertIn(clone_name[len(_clone_op_name_prefix) :], op_names)
+    # the backward ops read the activations of the clones instead of the originals
+    backward_consumer_names = set()
+    for op in job.net.op:
+        if not op.HasField("user_conf"):
+            continue
+        for arg in op.user_conf.input.values():
+            for lbn in arg.s:
+                producer_name = lbn.split("/")[0]
+                if producer_name in clone_names and op.name not in clone_names:
+                    backward_consumer_names.add(op.name)
+    test_case.assertTrue(len(backward_consumer_names) > 0)
+    original_names = set(n[len(_clone_op_name_prefix) :] for n in clone_names)
+    for op in job.net.op:
+        if op.name not in backward_consumer_names:
+            continue
+        for arg in op.user_conf.input.values():
+            for lbn in arg.s:
+                test_case.assertNotIn(lbn.split("/")[0], original_names)
+
+
+def _compare_with_no_checkpointing(test_case, checkpointing_conf):
+    x = np.random.uniform(-1, 1, (64, 256)).astype(np.float32)
+    args = dict(x=x, step_num=8, hidden_units=256, layer_num=4)
+    expected, baseline_time, baseline_job = _run_mlp(None, **args)
+    losses, checkpointing_time, job = _run_mlp(checkpointing_conf, **args)
+    print(
+        "step time without checkpointing: {:.2f}ms, with {}: {:.2f}ms".format(
+            baseline_time * 1e3, checkpointing_conf, checkpointing_time * 1e3
+        )
+    )
+    test_case.assertTrue(np.allclose(losses, expected, rtol=1e-4, atol=1e-6))
+    test_case.assertFalse(
+        any(op.name.startswith(_clone_op_name_prefix) for op in baseline_job.net.op)
+    )
+    _check_clones(test_case, job)
+
+
+def test_checkpointing_by_op_name_prefix(test_case):
+    _compare_with_no_checkpointing(test_case, {"op_name_prefix": ["checkpointed-"]})
+
+
+def test_checkpointing_cheap_ops(test_case):
+    _compare_with_no_checkpointing(test_case, {"recompute_cheap_ops": True})
@@ -26,7 +26,7 @@ for gpu in gpus:
     tf.config.experimental.set_memory_growth(gpu, True)
 
 
-def compare_with_tensorflow(device_type, in_shape, direction, data_type):
+def _run_argsort(device_type, input, direction, data_type):
     assert device_type in ["gpu", "cpu"]
     assert data_type in ["float32", "double", "int8", "int32", "int64"]
     flow.clear_default_session()
@@ -37,22 +37,44 @@ def compare_with_tensorflow(device_type, in_shape, direction, data_type):
     @flow.global_function(function_config=func_config)
     def ArgSortJob(
         input: oft.ListNumpy.Placeholder(
-            tuple([dim + 10 for dim in in_shape]),
+            tuple([dim + 10 for dim in input.shape]),
             dtype=type_name_to_flow_type[data_type],
         )
     ):
         with flow.scope.placement(device_type, "0:0"):
             return flow.argsort(input, direction)
 
+    return ArgSortJob([input]).get().numpy_list()[0]
+
+
+def compare_with_tensorflow(device_type, in_shape, direction, data_type):
     input = (np.random.random(in_shape) * 100).astype(type_name_to_np_type[data_type])
     # OneFlow
-    of_out = ArgSortJob([input]).get().numpy_list()[0]
+    of_out = _run_argsort(device_type, input, direction, data_type)
     # TensorFlow
     tf_out = tf.argsort(input, axis=-1, direction=direction)
 
     assert np.array_equal(of_out, tf_out.numpy())
 
 
+def compare_with_numpy(device_type, in_shape, direction, data_type):
+    # many duplicates, whose indices keep their order in both directions
+    input = np.random.randint(-50, 50, size=in_shape).astype(
+        type_name_to_np_type[data_type]
+    )
+    if data_type in ["float32", "double"]:
+        # -0.0 and 0.0 are equal
+        input[..., ::7] = -0.0
+        input[..., ::11] = 0.0
+    of_out = _run_argsort(device_type, input, direction, data_type)
+    if direction == "ASCENDING":
+        np_out = np.argsort(input, axis=-1, kind="stable")
+    else:
+        np_out = np.argsort(-input, axis=-1, kind="stable")
+
+    assert np.array_equal(of_out, np_out)
+
+
 def gen_arg_list():
     arg_dict = OrderedDict()
     arg_dict["device_type"] = ["cpu", "gpu"]
@@ -66,3 +88,14 @@ def gen_arg_list():
 def test_argsort(test_case):
     for arg in gen_arg_list():
         compare_with_tensorflow(*arg)
+
+
+def test_argsort_stable(test_case):
+    arg_dict = OrderedDict()
+    arg_dict["device_type"] = ["cpu"]
+    # instances of 1024 elements and more are radix sorted
+    arg_dict["in_shape"] = [(100,), (10, 1000), (4000,), (10, 10, 2048)]
+    arg_dict["direction"] = ["ASCENDING", "DESCENDING"]
+    arg_dict["data_type"] = ["float32", "double", "int32", "int64"]
+    for arg in GenArgList(arg_dict):
+        compare_with_numpy(*arg)
@@ -178,3 +178,17 @@ def test_gather_case_3(test_case):
     arg_dict["mirrored"] = [True]
     for arg in GenArgList(arg_dict):
         _compare_gather_with_tf(test_case, *arg)
+
+
+def test_gather_case_4(test_case):
+    # the output has more elements than host_elementwise::kGrainSize and outer_dim_size
+    # > 1, so the CPU kernels of gather and of its grad split the rows across the thread
+    # pool
+    arg_dict = OrderedDict()
+    arg_dict["device_type"] = ["cpu"]
+    arg_dict["params_shape"] = [(4, 64, 256)]
+    arg_dict["indices_shape"] = [(128,)]
+    arg_dict["axis"] = [1]
+    arg_dict["batch_dims"] = [0]
+    for arg in GenArgList(arg_dict):
+        _compare_gather_with_tf(test_case, *arg)
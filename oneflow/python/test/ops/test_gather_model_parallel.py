@@ -69,3 +69,17 @@ def test_gather_model_parallel_fw(test_case):
     arg_dict["split_axis"] = [0, 1, 2]
     for arg in GenArgList(arg_dict):
         _test_gather_model_parallel_fw(test_case, *arg)
+
+
+def test_gather_model_parallel_fw_above_grain_size(test_case):
+    # every device gathers from its slice of params with an offset, so most of the
+    # indices are out of its range, and the output of every device has more elements
+    # than host_elementwise::kGrainSize with outer_dim_size > 1
+    arg_dict = OrderedDict()
+    arg_dict["device_type"] = ["cpu"]
+    arg_dict["params_shape"] = [(4, 512, 64)]
+    arg_dict["indices_shape"] = [(256,)]
+    arg_dict["axis"] = [1]
+    arg_dict["split_axis"] = [1]
+    for arg in GenArgList(arg_dict):
+        _test_gather_model_parallel_fw(test_case, *arg)
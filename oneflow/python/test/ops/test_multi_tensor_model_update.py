@@ -0,0 +1,95 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+from collections import OrderedDict
+
+import numpy as np
+import oneflow as flow
+import oneflow.python.framework.c_api_util as c_api_util
+import oneflow.typing as oft
+import test_global_storage
+from test_util import GenArgList
+
+VARIABLE_SHAPES = OrderedDict([("w0", (8, 16)), ("b0", (16,)), ("w1", (16, 1))])
+_multi_tensor_op_name_prefix = "System-Optimizer-MultiTensor-"
+
+
+def _GetOptimizer(optimizer_type):
+    lr_scheduler = flow.optimizer.PiecewiseConstantScheduler([], [0.01])
+    if optimizer_type == "sgd":
+        return flow.optimizer.SGD(lr_scheduler, momentum=0)
+    elif optimizer_type == "momentum":
+        return flow.optimizer.SGD(lr_scheduler, momentum=0.9)
+    elif optimizer_type == "adam":
+        return flow.optimizer.Adam(lr_scheduler, do_bias_correction=True)
+    elif optimizer_type == "adamw":
+        return flow.optimizer.AdamW(lr_scheduler, weight_decay=0.01)
+    else:
+        raise NotImplementedError(optimizer_type)
+
+
+def _TrainAndWatchVariables(optimizer_type, enable_multi_tensor, x, iter_num):
+    flow.clear_default_session()
+    func_config = flow.FunctionConfig()
+    func_config.default_data_type(flow.float)
+    func_config.default_logical_view(flow.scope.consistent_view())
+    func_config.enable_multi_tensor_model_update(enable_multi_tensor)
+
+    @flow.global_function(type="train", function_config=func_config)
+    def TrainJob(x: oft.Numpy.Placeholder(x.shape)):
+        with flow.scope.placement("cpu", "0:0"):
+            variables = {}
+            for i, (name, shape) in enumerate(VARIABLE_SHAPES.items()):
+                variables[name] = flow.get_variable(
+                    name,
+                    shape=shape,
+                    dtype=flow.float,
+                    initializer=flow.constant_initializer(0.1 * (i + 1)),
+                )
+                flow.watch(variables[name], test_global_storage.Setter(name))
+            hidden = flow.math.tanh(flow.matmul(x, variables["w0"]) + variables["b0"])
+            loss = flow.math.reduce_mean(flow.matmul(hidden, variables["w1"]))
+            _GetOptimizer(optimizer_type).minimize(loss)
+            return loss
+
+    for _ in range(iter_num):
+        TrainJob(x).get()
+    job = [j for j in c_api_util.GetJobSet().job if j.job_conf.job_name == "TrainJob"]
+    op_names = [op.name for op in job[0].net.op]
+    variables = {name: test_global_storage.Get(name) for name in VARIABLE_SHAPES}
+    return variables, op_names
+
+
+def _CountMultiTensorOps(op_names):
+    return len([n for n in op_names if n.startswith(_multi_tensor_op_name_prefix)])
+
+
+def compare_with_per_variable_update(test_case, optimizer_type):
+    x = np.random.uniform(-1, 1, size=(4, 8)).astype(np.float32)
+    expected, expected_op_names = _TrainAndWatchVariables(optimizer_type, False, x, 4)
+    actual, actual_op_names = _TrainAndWatchVariables(optimizer_type, True, x, 4)
+    test_case.assertEqual(_CountMultiTensorOps(expected_op_names), 0)
+    test_case.assertTrue(_CountMultiTensorOps(actual_op_names) > 0, optimizer_type)
+    for name in VARIABLE_SHAPES:
+        test_case.assertTrue(
+            np.allclose(actual[name], expected[name], rtol=1e-5, atol=1e-5), name
+        )
+
+
+def test_multi_tensor_model_update(test_case):
+    arg_dict = OrderedDict()
+    arg_dict["optimizer_type"] = ["sgd", "momentum", "adam", "adamw"]
+    for arg in GenArgList(arg_dict):
+        compare_with_per_variable_update(test_case, *arg)
@@ -28,7 +28,7 @@ for gpu in gpus:
 
 
 def grouped_convolution2D(
-    inputs, filters, padding, num_groups, strides=None, dilation_rate=None
+    inputs, filters, padding, num_groups, strides=1, dilation_rate=None
 ):
     # Split input and outputs along their last dimension
     input_list = tf.split(inputs, num_groups, axis=-1)
@@ -43,8 +43,8 @@ def grouped_convolution2D(
             tf.nn.conv2d(
                 input_tensor,
                 filter_tensor,
-                padding="VALID",
-                strides=[1, 1, 1, 1],
+                padding=padding,
+                strides=[1, strides, strides, 1],
                 data_format="NHWC",
             )
         )
@@ -54,9 +54,29 @@ def grouped_convolution2D(
 
 
 def compare_with_tensorflow(
-    device_type, x_shape, filters, kernel_size, groups, padding="VALID", stride=1
+    device_type,
+    x_shape,
+    filters,
+    kernel_size,
+    groups,
+    padding="VALID",
+    stride=1,
+    data_format="NCHW",
 ):
     assert device_type in ["gpu", "cpu"]
+    assert data_format in ["NCHW", "NHWC"]
+    # x_shape is always given in NCHW, the permutations convert oneflow blobs to
+    # the NHWC and HWIO layouts of tensorflow
+    if data_format == "NCHW":
+        of_x_shape = x_shape
+        weight_shape = (filters, x_shape[1] // groups, kernel_size, kernel_size)
+        nhwc_perm = (0, 2, 3, 1)
+        hwio_perm = (2, 3, 1, 0)
+    else:
+        of_x_shape = (x_shape[0], x_shape[2], x_shape[3], x_shape[1])
+        weight_shape = (filters, kernel_size, kernel_size, x_shape[1] // groups)
+        nhwc_perm = (0, 1, 2, 3)
+        hwio_perm = (1, 2, 3, 0)
     flow.clear_default_session()
     func_config = flow.FunctionConfig()
     func_config.default_data_type(flow.float)
@@ -66,12 +86,11 @@ def compare_with_tensorflow(
         with flow.scope.placement(device_type, "0:0"):
             x = flow.get_variable(
                 "x",
-                shape=x_shape,
+                shape=of_x_shape,
                 dtype=flow.float,
                 initializer=flow.random_uniform_initializer(minval=0, maxval=100),
                 trainable=True,
             )
-            weight_shape = (filters, int(x.shape[1] / groups), kernel_size, kernel_size)
             weight = flow.get_variable(
                 "conv-weight",
                 shape=weight_shape,
@@ -83,7 +102,7 @@ def compare_with_tensorflow(
                 weight,
                 strides=[stride, stride],
                 padding=padding,
-                data_format="NCHW",
+                data_format=data_format,
                 dilations=[1, 1],
                 groups=groups,
             )
@@ -106,13 +125,13 @@ def compare_with_tensorflow(
     of_out = ConvJob().get()
     # TensorFlow
     with tf.GradientTape(persistent=True) as tape:
-        x = tf.Variable(test_global_storage.Get("x").transpose(0, 2, 3, 1))
+        x = tf.Variable(test_global_storage.Get("x").transpose(nhwc_perm))
         assert groups > 0
         assert x_shape[1] % groups == 0
         assert filters % groups == 0
         if groups == 1:
             weight = tf.Variable(
-                test_global_storage.Get("weight").transpose(2, 3, 1, 0)
+                test_global_storage.Get("weight").transpose(hwio_perm)
             )
             tf_out = tf.nn.conv2d(
                 x,
@@ -123,29 +142,27 @@ def compare_with_tensorflow(
             )
         else:
             weight = tf.Variable(
-                test_global_storage.Get("weight").transpose(2, 3, 1, 0)
+                test_global_storage.Get("weight").transpose(hwio_perm)
             )
             tf_out = grouped_convolution2D(
-                x, weight, padding=padding, num_groups=groups
+                x, weight, padding=padding, num_groups=groups, strides=stride
             )
 
-    loss_diff = test_global_storage.Get("loss_diff").transpose(0, 2, 3, 1)
+    loss_diff = test_global_storage.Get("loss_diff").transpose(nhwc_perm)
     tf_x_diff = tape.gradient(tf_out, x, loss_diff)
     tf_weight_diff = tape.gradient(tf_out, weight, loss_diff)
-    max_diff = np.max(
-        np.absolute(of_out.numpy().transpose(0, 2, 3, 1) - tf_out.numpy())
-    )
+    max_diff = np.max(np.absolute(of_out.numpy().transpose(nhwc_perm) - tf_out.numpy()))
     assert np.allclose(
-        of_out.numpy().transpose(0, 2, 3, 1), tf_out.numpy(), rtol=1e-5, atol=1e-5
+        of_out.numpy().transpose(nhwc_perm), tf_out.numpy(), rtol=1e-5, atol=1e-5
     ), max_diff
     assert np.allclose(
-        test_global_storage.Get("x_diff").transpose(0, 2, 3, 1),
+        test_global_storage.Get("x_diff").transpose(nhwc_perm),
         tf_x_diff.numpy(),
         rtol=1e-4,
         atol=1e-4,
     )
     assert np.allclose(
-        test_global_storage.Get("weight_diff").transpose(2, 3, 1, 0),
+        test_global_storage.Get("weight_diff").transpose(hwio_perm),
         tf_weight_diff.numpy(),
         rtol=1e-5,
         atol=1e-5,
@@ -188,6 +205,56 @@ def test_cpu3(test_case):
         compare_with_tensorflow(*arg)
 
 
+def test_cpu_1x1(test_case):
+    arg_dict = OrderedDict()
+    arg_dict["device_type"] = ["cpu"]
+    arg_dict["x_shape"] = [(4, 32, 10, 10)]
+    arg_dict["filters"] = [64]
+    arg_dict["kernel_size"] = [1]
+    arg_dict["groups"] = [1]
+    for arg in GenArgList(arg_dict):
+        compare_with_tensorflow(*arg)
+
+
+def test_cpu_3x3(test_case):
+    arg_dict = OrderedDict()
+    arg_dict["device_type"] = ["cpu"]
+    arg_dict["x_shape"] = [(4, 16, 10, 10)]
+    arg_dict["filters"] = [32]
+    arg_dict["kernel_size"] = [3]
+    arg_dict["groups"] = [1]
+    for arg in GenArgList(arg_dict):
+        compare_with_tensorflow(*arg)
+
+
+def test_cpu_groups(test_case):
+    arg_dict = OrderedDict()
+    arg_dict["device_type"] = ["cpu"]
+    arg_dict["x_shape"] = [(4, 32, 10, 10)]
+    arg_dict["filters"] = [64]
+    arg_dict["kernel_size"] = [1, 3]
+    arg_dict["groups"] = [4]
+    arg_dict["padding"] = ["VALID"]
+    arg_dict["stride"] = [1]
+    arg_dict["data_format"] = ["NCHW", "NHWC"]
+    for arg in GenArgList(arg_dict):
+        compare_with_tensorflow(*arg)
+
+
+def test_cpu_depthwise(test_case):
+    arg_dict = OrderedDict()
+    arg_dict["device_type"] = ["cpu"]
+    arg_dict["x_shape"] = [(4, 32, 10, 10)]
+    arg_dict["filters"] = [32, 64]
+    arg_dict["kernel_size"] = [3]
+    arg_dict["groups"] = [32]
+    arg_dict["padding"] = ["VALID"]
+    arg_dict["stride"] = [1, 2]
+    arg_dict["data_format"] = ["NCHW", "NHWC"]
+    for arg in GenArgList(arg_dict):
+        compare_with_tensorflow(*arg)
+
+
 def test_conv1(test_case):
     arg_dict = OrderedDict()
     arg_dict["device_type"] = ["gpu"]
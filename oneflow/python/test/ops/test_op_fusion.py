@@ -0,0 +1,174 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import os
+import time
+
+import numpy as np
+import oneflow as flow
+import oneflow.python.framework.c_api_util as c_api_util
+import oneflow.typing as oft
+
+
+def _CompiledOps(job_name):
+    job_set = c_api_util.GetJobSet()
+    job = [j for j in job_set.job if j.job_conf.job_name == job_name]
+    return job[0].net.op
+
+
+def _CountUserOps(ops, op_type_name):
+    return len(
+        [
+            op
+            for op in ops
+            if op.HasField("user_conf") and op.user_conf.op_type_name == op_type_name
+        ]
+    )
+
+
+def _run_predict(enable_op_fusion, x, y, bias):
+    flow.clear_default_session()
+    func_config = flow.FunctionConfig()
+    func_config.default_data_type(flow.float)
+    func_config.enable_op_fusion(enable_op_fusion)
+
+    @flow.global_function(function_config=func_config)
+    def FusionJob(
+        x: oft.Numpy.Placeholder(x.shape),
+        y: oft.Numpy.Placeholder(y.shape),
+        bias: oft.Numpy.Placeholder(bias.shape),
+    ):
+        with flow.scope.placement("cpu", "0:0"):
+            relu_out = flow.math.relu(flow.nn.bias_add(x, bias))
+            gelu_out = flow.math.gelu(flow.nn.bias_add(x, bias))
+            add_n_out = flow.math.add_n([x * 2.0, y * 3, relu_out])
+            # float -> double -> float is removed
+            cast_out = flow.cast(flow.cast(add_n_out, flow.double), flow.float)
+            # int32 -> int64 -> float becomes one cast
+            int_out = flow.cast(flow.cast(y, flow.int32), flow.int64)
+            int_out = flow.cast(int_out, flow.float)
+            return relu_out, gelu_out, cast_out, int_out
+
+    outs = [blob.numpy() for blob in FusionJob(x, y, bias).get()]
+    return outs, _CompiledOps("FusionJob")
+
+
+def _run_scale_add_n(enable_op_fusion, x):
+    flow.clear_default_session()
+    func_config = flow.FunctionConfig()
+    func_config.default_data_type(flow.float)
+    func_config.enable_op_fusion(enable_op_fusion)
+
+    @flow.global_function(function_config=func_config)
+    def ScaleAddNJob(x: oft.Numpy.Placeholder(x.shape)):
+        with flow.scope.placement("cpu", "0:0"):
+            # x feeds several inputs of the fused op, one of them inplace with out
+            return flow.math.add_n([x * 2.0, x, x * 0.5, flow.math.relu(x)])
+
+    return ScaleAddNJob(x).get().numpy()
+
+
+def _run_mlp(enable_op_fusion, x, step_num, hidden_units, layer_num):
+    flow.clear_default_session()
+    func_config = flow.FunctionConfig()
+    func_config.default_data_type(flow.float)
+    func_config.enable_op_fusion(enable_op_fusion)
+
+    @flow.global_function(type="train", function_config=func_config)
+    def MlpJob(x: oft.Numpy.Placeholder(x.shape)):
+        with flow.scope.placement("cpu", "0:0"):
+            out = x
+            for i in range(layer_num):
+                out = flow.layers.dense(
+                    out,
+                    hidden_units,
+                    activation=flow.math.relu,
+                    kernel_initializer=flow.random_normal_initializer(
+                        stddev=0.1, seed=i
+                    ),
+                    bias_initializer=flow.constant_initializer(0.01),
+                    name="layer{}".format(i),
+                )
+            loss = flow.math.reduce_mean(out * out)
+            flow.optimizer.SGD(
+                flow.optimizer.PiecewiseConstantScheduler([], [1e-3]), momentum=0
+            ).minimize(loss)
+            return loss
+
+    check_point = flow.train.CheckPoint()
+    check_point.init()
+    losses = [MlpJob(x).get().numpy()]
+    start = time.time()
+    for _ in range(step_num):
+        losses.append(MlpJob(x).get().numpy())
+    return np.array(losses), (time.time() - start) / step_num
+
+
+def test_op_fusion_predict(test_case):
+    x = np.random.uniform(-1, 1, (64, 1024)).astype(np.float32)
+    y = np.random.uniform(-8, 8, (64, 1024)).astype(np.float32)
+    bias = np.random.uniform(-1, 1, (1024,)).astype(np.float32)
+    expected, ops_without_fusion = _run_predict(False, x, y, bias)
+    outs, ops = _run_predict(True, x, y, bias)
+    for out, expected_out in zip(outs, expected):
+        test_case.assertTrue(np.allclose(out, expected_out, rtol=1e-5, atol=1e-6))
+    print(
+        "ops in the compiled job without op fusion: {}, with: {}".format(
+            len(ops_without_fusion), len(ops)
+        )
+    )
+    test_case.assertEqual(_CountUserOps(ops_without_fusion, "bias_add"), 2)
+    test_case.assertEqual(_CountUserOps(ops_without_fusion, "scalar_mul"), 2)
+    test_case.assertEqual(_CountUserOps(ops_without_fusion, "cast"), 5)
+    # bias_add -> relu and bias_add -> gelu
+    test_case.assertEqual(_CountUserOps(ops, "fused_bias_add_activation"), 2)
+    test_case.assertEqual(_CountUserOps(ops, "bias_add"), 0)
+    test_case.assertEqual(_CountUserOps(ops, "relu"), 0)
+    test_case.assertEqual(_CountUserOps(ops, "gelu"), 0)
+    # x * 2.0 and y * 3 -> add_n
+    test_case.assertEqual(_CountUserOps(ops, "fused_scale_add_n"), 1)
+    test_case.assertEqual(_CountUserOps(ops, "scalar_mul"), 0)
+    test_case.assertEqual(_CountUserOps(ops, "add_n"), 0)
+    # float -> double -> float is removed, float -> int32 is kept and
+    # int32 -> int64 -> float becomes int32 -> float
+    test_case.assertEqual(_CountUserOps(ops, "cast"), 2)
+    # 2 bias_add, 2 scalar_mul and 3 cast ops are gone
+    test_case.assertEqual(len(ops_without_fusion) - len(ops), 7)
+
+
+def test_op_fusion_large_scale_add_n(test_case):
+    # more than 65536 elements per thread, so every chunk of the kernel would be split
+    # again if it nested parallel loops
+    rows = (os.cpu_count() or 1) * 64 + 3
+    x = np.random.uniform(-1, 1, (rows, 1024)).astype(np.float32)
+    expected = _run_scale_add_n(False, x)
+    out = _run_scale_add_n(True, x)
+    test_case.assertTrue(np.allclose(out, expected, rtol=1e-5, atol=1e-6))
+    test_case.assertTrue(
+        np.allclose(out, x * 3.5 + np.maximum(x, 0), rtol=1e-5, atol=1e-5)
+    )
+
+
+def test_op_fusion_train(test_case):
+    x = np.random.uniform(-1, 1, (64, 256)).astype(np.float32)
+    args = dict(x=x, step_num=8, hidden_units=256, layer_num=4)
+    expected, baseline_time = _run_mlp(False, **args)
+    losses, fusion_time = _run_mlp(True, **args)
+    print(
+        "step time without op fusion: {:.2f}ms, with: {:.2f}ms".format(
+            baseline_time * 1e3, fusion_time * 1e3
+        )
+    )
+    test_case.assertTrue(np.allclose(losses, expected, rtol=1e-4, atol=1e-6))
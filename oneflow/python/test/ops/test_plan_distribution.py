@@ -0,0 +1,67 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import time
+
+import numpy as np
+import oneflow as flow
+import oneflow.typing as oft
+
+
+def _make_wide_job(branch_num, op_num_per_branch, shape):
+    # every tiny op becomes a few tasks on every device, so the plan pushed through
+    # the control plane grows with branch_num * op_num_per_branch
+    func_config = flow.FunctionConfig()
+    func_config.default_data_type(flow.float)
+    func_config.default_logical_view(flow.scope.consistent_view())
+
+    @flow.global_function(function_config=func_config)
+    def WideJob(x: oft.Numpy.Placeholder(shape)):
+        outputs = []
+        for i in range(branch_num):
+            y = x
+            for _ in range(op_num_per_branch):
+                y = flow.math.add(y, x)
+            outputs.append(y)
+        return flow.math.add_n(outputs)
+
+    return WideJob
+
+
+def _test_large_plan_startup(test_case, branch_num, op_num_per_branch):
+    flow.config.cpu_device_num(2)
+    shape = (16, 4)
+    start = time.time()
+    job = _make_wide_job(branch_num, op_num_per_branch, shape)
+    x = np.random.rand(*shape).astype(np.float32)
+    # the first call includes compiling, distributing and pulling the plan
+    y = job(x).get().numpy()
+    print(
+        "plan with {} ops started in {:.3f}s".format(
+            branch_num * op_num_per_branch, time.time() - start
+        )
+    )
+    test_case.assertTrue(
+        np.allclose(y, x * (op_num_per_branch + 1) * branch_num, rtol=1e-4)
+    )
+
+
+def test_1n_large_plan_startup(test_case):
+    _test_large_plan_startup(test_case, 16, 64)
+
+
+@flow.unittest.num_nodes_required(2)
+def test_2n_large_plan_startup(test_case):
+    _test_large_plan_startup(test_case, 16, 64)
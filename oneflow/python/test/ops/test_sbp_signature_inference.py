@@ -0,0 +1,93 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import time
+
+import numpy as np
+import oneflow as flow
+import oneflow.python.framework.c_api_util as c_api_util
+import oneflow.typing as oft
+
+
+def _run_repeated_layers(x, layer_num, enable_cache=True, enable_search=False):
+    flow.clear_default_session()
+    flow.config.cpu_device_num(2)
+    func_config = flow.FunctionConfig()
+    func_config.default_data_type(flow.float)
+    func_config.default_logical_view(flow.scope.consistent_view())
+    func_config.enable_sbp_signature_cache(enable_cache)
+    func_config.enable_sbp_signature_search(enable_search)
+
+    @flow.global_function(function_config=func_config)
+    def RepeatedLayersJob(x: oft.Numpy.Placeholder(x.shape)):
+        with flow.scope.placement("cpu", "0:0-1"):
+            hidden = x
+            for i in range(layer_num):
+                # the layers alternate between data and model parallel weights, so the
+                # identical ops are inferred with different producer signatures
+                w = flow.get_variable(
+                    "w%d" % i,
+                    shape=(x.shape[1], x.shape[1]),
+                    dtype=flow.float,
+                    initializer=flow.constant_initializer(0.01),
+                    distribute=flow.distribute.split(1)
+                    if i % 2
+                    else flow.distribute.broadcast(),
+                )
+                hidden = flow.math.relu(
+                    flow.matmul(hidden, w, name="matmul%d" % i), name="relu%d" % i
+                )
+            return hidden
+
+    start = time.time()
+    y = RepeatedLayersJob(x).get().numpy()
+    print(
+        "{} layers compiled and run in {:.3f}s, cache: {}, search: {}".format(
+            layer_num, time.time() - start, enable_cache, enable_search
+        )
+    )
+    job_set = c_api_util.GetJobSet()
+    job = [j for j in job_set.job if j.job_conf.job_name == "RepeatedLayersJob"]
+    op_name2sbp_signature = job[0].job_parallel_view_conf.op_name2sbp_signature_conf
+    sbp_signatures = {}
+    for i in range(layer_num):
+        for op_name in ["matmul%d" % i, "relu%d" % i]:
+            sbp_signatures[op_name] = op_name2sbp_signature[op_name]
+    return y, sbp_signatures
+
+
+def test_sbp_signature_cache(test_case):
+    x = np.random.uniform(-1, 1, size=(8, 16)).astype(np.float32)
+    layer_num = 24
+    y, sbp_signatures = _run_repeated_layers(x, layer_num)
+    y_ref, sbp_signatures_ref = _run_repeated_layers(x, layer_num, enable_cache=False)
+    test_case.assertTrue(np.allclose(y, y_ref, rtol=1e-4, atol=1e-6))
+    test_case.assertEqual(sbp_signatures.keys(), sbp_signatures_ref.keys())
+    for op_name, sbp_signature in sbp_signatures.items():
+        test_case.assertEqual(sbp_signature, sbp_signatures_ref[op_name], op_name)
+
+
+def test_sbp_signature_search(test_case):
+    x = np.random.uniform(-1, 1, size=(8, 16)).astype(np.float32)
+    layer_num = 8
+    y, sbp_signatures = _run_repeated_layers(x, layer_num, enable_search=True)
+    y_ref, sbp_signatures_ref = _run_repeated_layers(x, layer_num)
+    test_case.assertTrue(np.allclose(y, y_ref, rtol=1e-4, atol=1e-6))
+    changed_op_names = [
+        op_name
+        for op_name, sbp_signature in sbp_signatures.items()
+        if sbp_signature != sbp_signatures_ref[op_name]
+    ]
+    print("sbp signatures changed by the search: {}".format(changed_op_names))
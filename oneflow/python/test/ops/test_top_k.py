@@ -26,7 +26,7 @@ for gpu in gpus:
     tf.config.experimental.set_memory_growth(gpu, True)
 
 
-def compare_with_tensorflow(device_type, in_shape, k, data_type, sorted):
+def _run_top_k(device_type, input, k, data_type, sorted):
     assert device_type in ["gpu", "cpu"]
     assert data_type in ["float32", "double", "int8", "int32", "int64"]
     flow.clear_default_session()
@@ -37,16 +37,20 @@ def compare_with_tensorflow(device_type, in_shape, k, data_type, sorted):
     @flow.global_function(function_config=func_config)
     def TopKJob(
         input: oft.ListNumpy.Placeholder(
-            tuple([dim + 10 for dim in in_shape]),
+            tuple([dim + 10 for dim in input.shape]),
             dtype=type_name_to_flow_type[data_type],
         )
     ):
         with flow.scope.placement(device_type, "0:0"):
             return flow.math.top_k(input, k, sorted)
 
+    return TopKJob([input]).get().numpy_list()[0]
+
+
+def compare_with_tensorflow(device_type, in_shape, k, data_type, sorted):
     input = (np.random.random(in_shape) * 100).astype(type_name_to_np_type[data_type])
     # OneFlow
-    of_out = TopKJob([input]).get().numpy_list()[0]
+    of_out = _run_top_k(device_type, input, k, data_type, sorted)
     # TensorFlow
     if k <= in_shape[-1]:
         _, tf_out = tf.math.top_k(input, k, sorted)
@@ -56,6 +60,17 @@ def compare_with_tensorflow(device_type, in_shape, k, data_type, sorted):
     assert np.array_equal(of_out, tf_out.numpy())
 
 
+def compare_with_numpy(device_type, in_shape, k, data_type):
+    # many ties, the smaller index wins between equal values
+    input = np.random.randint(-50, 50, size=in_shape).astype(
+        type_name_to_np_type[data_type]
+    )
+    of_out = _run_top_k(device_type, input, k, data_type, True)
+    np_out = np.argsort(-input, axis=-1, kind="stable")[..., :k]
+
+    assert np.array_equal(of_out, np_out)
+
+
 def gen_arg_list():
     arg_dict = OrderedDict()
     arg_dict["device_type"] = ["cpu", "gpu"]
@@ -70,3 +85,15 @@ def gen_arg_list():
 def test_top_k(test_case):
     for arg in gen_arg_list():
         compare_with_tensorflow(*arg)
+
+
+def test_top_k_ties(test_case):
+    arg_dict = OrderedDict()
+    arg_dict["device_type"] = ["cpu"]
+    # a few instances of 16384 * 2 elements and more are split into chunks, the others
+    # select by heap for k <= 256 and by nth_element above
+    arg_dict["in_shape"] = [(100, 1000), (1, 65536), (2, 40000)]
+    arg_dict["k"] = [1, 50, 256, 300]
+    arg_dict["data_type"] = ["float32", "double", "int32", "int64"]
+    for arg in GenArgList(arg_dict):
+        compare_with_numpy(*arg)
@@ -106,3 +106,15 @@ def test_unsorted_segment_sum(test_case):
         if arg[2] >= len(arg[1]):
             continue
         _run_test(test_case, *arg)
+
+
+def test_unsorted_segment_sum_above_grain_size(test_case):
+    # the data has more elements than host_elementwise::kGrainSize and outer_dim_size >
+    # 1, so the CPU kernel splits the work across the thread pool
+    arg_dict = OrderedDict()
+    arg_dict["device_type"] = ["cpu"]
+    arg_dict["out_shape"] = [(4, 512, 64)]
+    arg_dict["axis"] = [1]
+    arg_dict["segment_ids_shape"] = [(256,)]
+    for arg in GenArgList(arg_dict):
+        _run_test(test_case, *arg)
@@ -109,3 +109,17 @@ def test_unsorted_segment_sum_model_parallel_fw(test_case):
     arg_dict["split_axis"] = [0, 1, 2]
     for arg in GenArgList(arg_dict):
         _test_unsorted_segment_sum_model_parallel_fw(test_case, *arg)
+
+
+def test_unsorted_segment_sum_model_parallel_fw_above_grain_size(test_case):
+    # every device sums into its slice of out with an offset, so most of the segment ids
+    # are out of its range, and the data has more elements than
+    # host_elementwise::kGrainSize with outer_dim_size > 1
+    arg_dict = OrderedDict()
+    arg_dict["device_type"] = ["cpu"]
+    arg_dict["out_shape"] = [(4, 512, 64)]
+    arg_dict["segment_ids_shape"] = [(256,)]
+    arg_dict["axis"] = [1]
+    arg_dict["split_axis"] = [1]
+    for arg in GenArgList(arg_dict):
+        _test_unsorted_segment_sum_model_parallel_fw(test_case, *arg)
@@ -0,0 +1,107 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import unittest
+
+import numpy as np
+import oneflow as flow
+
+config = flow.function_config()
+
+
+def fused_ops(x, bias, y):
+    z = flow.nn.bias_add(x, bias)
+    z = flow.math.relu(z)
+    z = flow.math.sigmoid(z * 2.0 + 1.0)
+    z = flow.math.add(z, y)
+    return flow.math.reduce_sum(z, axis=[1], keepdims=False)
+
+
+def make_job(x_shape, b_shape, y_shape, use_xrt_native, dtype=flow.float32):
+    config.use_xla_jit(False)
+    config.use_tensorrt(False)
+    config.use_xrt_native(use_xrt_native)
+
+    @flow.global_function(config)
+    def native_fusion_job(
+        x=flow.FixedTensorDef(x_shape, dtype=dtype),
+        bias=flow.FixedTensorDef(b_shape, dtype=dtype),
+        y=flow.FixedTensorDef(y_shape, dtype=dtype),
+    ):
+        with flow.scope.placement("cpu", "0:0"):
+            return fused_ops(x, bias, y)
+
+    return native_fusion_job
+
+
+def make_mixed_job(x_shape, use_xrt_native):
+    config.use_xla_jit(False)
+    config.use_tensorrt(False)
+    config.use_xrt_native(use_xrt_native)
+
+    @flow.global_function(config)
+    def mixed_dtype_job(
+        x=flow.FixedTensorDef(x_shape, dtype=flow.float32),
+        i=flow.FixedTensorDef(x_shape, dtype=flow.int32),
+    ):
+        with flow.scope.placement("cpu", "0:0"):
+            # int32 ops are left to the default engine
+            i = flow.math.add(i * 2, i)
+            # float and double ops go to different clusters
+            y = flow.math.relu(x * 2.0 + 1.0)
+            z = flow.cast(y, flow.double)
+            z = flow.math.sigmoid(z * 3.0 + 1.0)
+            return flow.cast(z, flow.float32) + flow.cast(i, flow.float32)
+
+    return mixed_dtype_job
+
+
+class TestNativeFusion(unittest.TestCase):
+    def _test_body(self, x, bias, y, dtype=np.float32):
+        f1 = make_job(x.shape, bias.shape, y.shape, False)
+        a = f1(x, bias, y).get()
+        flow.clear_default_session()
+
+        f2 = make_job(x.shape, bias.shape, y.shape, True)
+        b = f2(x, bias, y).get()
+        print("without native engine: ", a)
+        print("with native engine: ", b)
+        self.assertTrue(a.shape == b.shape)
+        self.assertTrue(np.allclose(a.numpy(), b.numpy(), rtol=1e-03, atol=1e-05))
+        flow.clear_default_session()
+
+    def _test_random_body(self, x_shape, b_shape, y_shape, dtype=np.float32):
+        x = np.random.random(x_shape).astype(dtype)
+        bias = np.random.random(b_shape).astype(dtype)
+        y = np.random.random(y_shape).astype(dtype)
+        self._test_body(x, bias, y, dtype=dtype)
+
+    def test_random_input(self):
+        self._test_random_body((4, 8), (8,), (4, 8))
+        self._test_random_body((4, 8, 16), (8,), (8, 16))
+        self._test_random_body((2, 64, 7, 7), (64,), (1, 64, 1, 1))
+
+    def test_mixed_data_types(self):
+        x = np.random.random((4, 8)).astype(np.float32)
+        i = np.random.randint(-10, 10, (4, 8)).astype(np.int32)
+        a = make_mixed_job(x.shape, False)(x, i).get()
+        flow.clear_default_session()
+        b = make_mixed_job(x.shape, True)(x, i).get()
+        flow.clear_default_session()
+        self.assertTrue(np.allclose(a.numpy(), b.numpy(), rtol=1e-03, atol=1e-05))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -54,6 +54,15 @@ GraphBuilder::GraphBuilder(const OpGraph *op_graph) : graph_(std::make_shared<Xr
       node_info_[node].inputs.insert(input);
     }
     node_info_[node].op_node = op_node;
+    // Data types of all the blobs, which decide whether the native engine compiles the node.
+    std::vector<DataType> data_types;
+    for (const std::string &bn : op->input_bns()) {
+      data_types.push_back(op_node->LogicalBlobDesc4Lbi(op->BnInOp2Lbi(bn)).data_type());
+    }
+    for (const std::string &bn : op->output_bns()) {
+      data_types.push_back(op_node->LogicalBlobDesc4Lbi(op->BnInOp2Lbi(bn)).data_type());
+    }
+    node->Attr("data_types", data_types);
   });
 }
 
@@ -14,19 +14,36 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include "oneflow/xrt/compilation_cache.h"
+#include "oneflow/core/common/str_util.h"
+#include "oneflow/core/persistence/file_system.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 
 namespace oneflow {
 namespace xrt {
 
 bool operator==(const Signature &lhs, const Signature &rhs) {
   return lhs.builder_name == rhs.builder_name && lhs.device_ordinal == rhs.device_ordinal
-         && lhs.entry_shapes == rhs.entry_shapes;
+         && lhs.entry_data_types == rhs.entry_data_types && lhs.entry_shapes == rhs.entry_shapes;
 }
 
 size_t SignatureHash::operator()(const Signature &signature) const {
-  size_t hash_val =
-      std::hash<std::string>()(signature.builder_name) ^ std::hash<int>()(signature.device_ordinal);
-  for (const auto &shape : signature.entry_shapes) { hash_val ^= std::hash<Shape>()(shape); }
+  // XOR would cancel out the same shapes of different entries
+  size_t hash_val = std::hash<std::string>()(signature.builder_name);
+  HashCombine(&hash_val, std::hash<int>()(signature.device_ordinal));
+  for (const auto &data_type : signature.entry_data_types) {
+    HashCombine(&hash_val, std::hash<int>()(static_cast<int>(data_type)));
+  }
+  for (const auto &shape : signature.entry_shapes) {
+    HashCombine(&hash_val, std::hash<Shape>()(shape));
+  }
   return hash_val;
 }
 
@@ -35,32 +52,205 @@ Signature ComputeSignature(const std::string &name, const int device_ordinal,
   Signature signature;
   signature.builder_name = name;
   signature.device_ordinal = device_ordinal;
+  signature.entry_data_types.resize(entry_params.size());
   signature.entry_shapes.resize(entry_params.size());
   for (int i = 0; i < entry_params.size(); ++i) {
+    signature.entry_data_types[i] = entry_params[i].data_type();
     signature.entry_shapes[i] = entry_params[i].shape();
   }
   return std::move(signature);
 }
 
-Executable *CompilationCache::GetRecord(const Signature &signature) const {
-  Executable *record = nullptr;
+Shape BucketShape(const Shape &shape, const Shape &static_shape, int64_t bucket_size) {
+  CHECK_GT(bucket_size, 0);
+  if (shape.NumAxes() == 0 || shape.NumAxes() != static_shape.NumAxes()) { return static_shape; }
+  for (int64_t i = 1; i < shape.NumAxes(); ++i) {
+    if (shape.At(i) != static_shape.At(i)) { return static_shape; }
+  }
+  const int64_t bucket_num = std::max<int64_t>((shape.At(0) + bucket_size - 1) / bucket_size, 1);
+  Shape bucketed_shape(static_shape);
+  bucketed_shape.Set(0, std::min(bucket_num * bucket_size, static_shape.At(0)));
+  return bucketed_shape;
+}
+
+std::shared_ptr<Executable> CompilationCache::GetRecord(const Signature &signature) {
   // std::shared_lock<std::shared_mutex> lock(mutex_);
   std::lock_guard<std::mutex> lock(mutex_);
-  const auto &it = records_.find(signature);
-  if (it != records_.end()) { record = it->second.get(); }
-  return record;
+  const auto &it = signature_to_record_.find(signature);
+  if (it == signature_to_record_.end()) {
+    ++stats_.miss_count;
+    return nullptr;
+  }
+  ++stats_.hit_count;
+  records_.splice(records_.begin(), records_, it->second);
+  return it->second->second;
 }
 
 void CompilationCache::Record(const Signature &signature,
                               const std::shared_ptr<Executable> &result) {
   // std::unique_lock<std::shared_mutex> lock(mutex_);
   std::lock_guard<std::mutex> lock(mutex_);
-  records_.emplace(signature, result);
+  compiling_signatures_.erase(signature);
+  const auto &it = signature_to_record_.find(signature);
+  if (it != signature_to_record_.end()) {
+    it->second->second = result;
+    records_.splice(records_.begin(), records_, it->second);
+    return;
+  }
+  records_.emplace_front(signature, result);
+  signature_to_record_.emplace(signature, records_.begin());
+  while (records_.size() > capacity_) {
+    signature_to_record_.erase(records_.back().first);
+    records_.pop_back();
+    ++stats_.eviction_count;
+  }
+}
+
+bool CompilationCache::StartCompiling(const Signature &signature) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return compiling_signatures_.insert(signature).second;
 }
 
 void CompilationCache::Release() {
-  util::Map<Signature, std::shared_ptr<Executable>, SignatureHash> empty_records;
-  records_.swap(empty_records);
+  std::lock_guard<std::mutex> lock(mutex_);
+  util::Map<Signature, RecordList::iterator, SignatureHash> empty_signature_to_record;
+  signature_to_record_.swap(empty_signature_to_record);
+  records_.clear();
+}
+
+CompilationCacheStats CompilationCache::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+namespace {
+
+// Bump it if the serialized programs are not compatible any more, such as an
+// upgrade of the XLA version.
+constexpr int32_t kSerializedProgramVersion = 1;
+
+void AppendDeterministicSerialization(const google::protobuf::Message &message, std::string *key) {
+  std::string serialized;
+  {
+    google::protobuf::io::StringOutputStream output_stream(&serialized);
+    google::protobuf::io::CodedOutputStream coded_stream(&output_stream);
+    coded_stream.SetSerializationDeterministic(true);
+    CHECK(message.SerializeToCodedStream(&coded_stream));
+  }
+  key->append(std::to_string(serialized.size()) + ":" + serialized + "\n");
+}
+
+// FNV-1a, unlike std::hash it is stable across builds.
+uint64_t StableHash(const std::string &str) {
+  uint64_t hash_val = 14695981039346656037ULL;
+  for (const char c : str) {
+    hash_val ^= static_cast<uint8_t>(c);
+    hash_val *= 1099511628211ULL;
+  }
+  return hash_val;
+}
+
+// The cache files are accessed with the C library rather than LocalFS(), which
+// aborts on errors. A read-only or full cache directory must not kill the job.
+bool RecursivelyCreateDirIfNotExists(const std::string &dir) {
+  for (size_t pos = dir.find('/', 1); true; pos = dir.find('/', pos + 1)) {
+    const std::string sub_dir = dir.substr(0, pos);
+    if (mkdir(sub_dir.c_str(), 0755) != 0 && errno != EEXIST) { return false; }
+    if (pos == std::string::npos) { break; }
+  }
+  struct stat sbuf;
+  return stat(dir.c_str(), &sbuf) == 0 && S_ISDIR(sbuf.st_mode);
+}
+
+bool WriteFile(const std::string &file_path, const std::string &content) {
+  FILE *file = fopen(file_path.c_str(), "wb");
+  if (file == nullptr) { return false; }
+  const bool written = fwrite(content.data(), 1, content.size(), file) == content.size();
+  return fclose(file) == 0 && written;
+}
+
+bool ReadFile(const std::string &file_path, std::string *content) {
+  std::ifstream is(file_path, std::ios::binary);
+  if (!is) { return false; }
+  content->assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+  return !is.bad();
+}
+
+}  // namespace
+
+std::string ComputePersistentKey(const XrtLaunchOpConf &launch_conf, const XrtDevice &device,
+                                 const Signature &signature,
+                                 const std::vector<xrt::Parameter> &return_params) {
+  std::string key;
+  key += launch_conf.engine() + "\n";
+  key += std::to_string(device) + "\n";
+  key += std::to_string(signature.device_ordinal) + "\n";
+  for (int i = 0; i < signature.entry_shapes.size(); ++i) {
+    key += std::to_string(signature.entry_data_types[i]) + signature.entry_shapes[i].ToString()
+           + "\n";
+  }
+  for (const Parameter &param : return_params) {
+    key += param.name() + std::to_string(param.data_type()) + param.shape().ToString() + "\n";
+  }
+  AppendDeterministicSerialization(launch_conf.function(), &key);
+  XrtLaunchOpConf io_conf;
+  *io_conf.mutable_input_mutability() = launch_conf.input_mutability();
+  *io_conf.mutable_input_output_mapping() = launch_conf.input_output_mapping();
+  AppendDeterministicSerialization(io_conf, &key);
+  return key;
+}
+
+std::string PersistentProgramCache::FilePath(const std::string &key) const {
+  char file_name[32];
+  snprintf(file_name, sizeof(file_name), "%016llx.xrt",
+           static_cast<unsigned long long>(StableHash(key)));
+  return JoinPath(dir_, file_name);
+}
+
+bool PersistentProgramCache::Load(const std::string &key, const XrtEngine &engine,
+                                      std::string *serialized) const {
+  const std::string file_path = FilePath(key);
+  std::string content;
+  if (!ReadFile(file_path, &content)) { return false; }
+  SerializedProgramProto proto;
+  if (!proto.ParseFromString(content)) {
+    LOG(WARNING) << "Ignore the broken program cache " << file_path;
+    return false;
+  }
+  if (proto.version() != kSerializedProgramVersion || proto.engine() != engine
+      || proto.key() != key) {
+    VLOG(1) << "Ignore the stale program cache " << file_path;
+    return false;
+  }
+  *serialized = proto.program();
+  return true;
+}
+
+bool PersistentProgramCache::Store(const std::string &key, const XrtEngine &engine,
+                                   const std::string &serialized) const {
+  SerializedProgramProto proto;
+  proto.set_version(kSerializedProgramVersion);
+  proto.set_engine(engine);
+  proto.set_key(key);
+  proto.set_program(serialized);
+  std::string content;
+  CHECK(proto.SerializeToString(&content));
+  if (!RecursivelyCreateDirIfNotExists(dir_)) {
+    LOG(WARNING) << "Skip storing the program cache, failed to create " << dir_ << ": "
+                 << strerror(errno);
+    return false;
+  }
+  const std::string file_path = FilePath(key);
+  // Write to a temporary file first, so that the other processes never read
+  // a partially written cache.
+  const std::string tmp_file_path =
+      file_path + "." + std::to_string(getpid()) + "." + NewUniqueId() + ".tmp";
+  if (!WriteFile(tmp_file_path, content) || rename(tmp_file_path.c_str(), file_path.c_str()) != 0) {
+    LOG(WARNING) << "Skip storing the program cache " << file_path << ": " << strerror(errno);
+    unlink(tmp_file_path.c_str());
+    return false;
+  }
+  return true;
 }
 
 }  // namespace xrt
@@ -16,13 +16,15 @@ limitations under the License.
 #ifndef ONEFLOW_XRT_COMPILATION_CACHE_H_
 #define ONEFLOW_XRT_COMPILATION_CACHE_H_
 
+#include <list>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
 
-//#include "oneflow/core/common/data_type.pb.h"
+#include "oneflow/core/common/data_type.pb.h"
 #include "oneflow/core/common/shape.h"
+#include "oneflow/core/operator/op_conf.pb.h"
 #include "oneflow/xrt/executable.h"
 #include "oneflow/xrt/parameter.h"
 #include "oneflow/xrt/utility/stl.h"
@@ -35,7 +37,7 @@ struct Signature {
   std::string builder_name;
   // Device ordinal
   int device_ordinal;
-  // std::vector<Shape> entry_data_types;
+  std::vector<DataType> entry_data_types;
   // It will lose efficacy if the entry shapes has been changed.
   std::vector<Shape> entry_shapes;
 };
@@ -49,20 +51,102 @@ struct SignatureHash {
 Signature ComputeSignature(const std::string &name, const int device_ordinal,
                            const std::vector<xrt::Parameter> &entry_params);
 
+// Round the leading dimension of the runtime shape up to a multiple of
+// `bucket_size`, but no more than the static shape. Only the leading dimension
+// is bucketed, so that the padded rows follow the real ones in the memory of
+// the blob. Return the static shape if any other dimension differs from it.
+Shape BucketShape(const Shape &shape, const Shape &static_shape, int64_t bucket_size);
+
+// The executable compiled for the bucketed shapes of the entries. The return
+// parameters are padded as well, their shapes are known after compilation.
+class BucketedExecutable : public Executable {
+ public:
+  BucketedExecutable(const std::shared_ptr<Executable> &executable,
+                     const std::vector<Shape> &return_shapes)
+      : Executable(executable->name(), executable->engine()),
+        executable_(executable),
+        return_shapes_(return_shapes) {}
+  virtual ~BucketedExecutable() = default;
+
+  bool Run(const std::vector<Parameter> &inputs, const ExecutableRunOptions &run_options,
+           bool block_until_done = true) override {
+    bool status = executable_->Run(inputs, run_options, block_until_done);
+    results_ = executable_->Results();
+    return status;
+  }
+
+  const std::vector<Shape> &return_shapes() const { return return_shapes_; }
+
+ private:
+  std::shared_ptr<Executable> executable_;
+  std::vector<Shape> return_shapes_;
+};
+
+struct CompilationCacheStats {
+  int64_t hit_count = 0;
+  int64_t miss_count = 0;
+  int64_t eviction_count = 0;
+};
+
+// A LRU cache of the compilation results. The least recently used record is
+// evicted once the number of records exceeds the capacity.
 class CompilationCache {
  public:
-  Executable *GetRecord(const Signature &signature) const;
+  explicit CompilationCache(size_t capacity) : capacity_(capacity) { CHECK_GT(capacity_, 0); }
+
+  // The returned executable is still valid after it has been evicted.
+  std::shared_ptr<Executable> GetRecord(const Signature &signature);
 
   void Record(const Signature &signature, const std::shared_ptr<Executable> &result);
 
+  // Return false if the signature is being compiled already. The compilation
+  // is finished once its result is recorded.
+  bool StartCompiling(const Signature &signature);
+
   void Release();
 
+  size_t capacity() const { return capacity_; }
+  CompilationCacheStats stats() const;
+
  private:
+  using RecordList = std::list<std::pair<Signature, std::shared_ptr<Executable>>>;
+
   // static std::shared_mutex mutex_;
   mutable std::mutex mutex_;
-  util::Map<Signature, std::shared_ptr<Executable>, SignatureHash> records_;
+  size_t capacity_;
+  // The most recently used record is at the front.
+  RecordList records_;
+  util::Map<Signature, RecordList::iterator, SignatureHash> signature_to_record_;
+  util::Set<Signature, SignatureHash> compiling_signatures_;
+  CompilationCacheStats stats_;
+};
+
+// The serialized programs of the executables in a local directory, so that a
+// restarted process skips building the programs from the clusters. The
+// programs are still compiled by the engine after being loaded, see
+// `Executable::SerializeProgram`.
+class PersistentProgramCache {
+ public:
+  explicit PersistentProgramCache(const std::string &dir) : dir_(dir) {}
+
+  bool Load(const std::string &key, const XrtEngine &engine, std::string *serialized) const;
+
+  // Return false, after logging a warning, if the program is not stored.
+  bool Store(const std::string &key, const XrtEngine &engine, const std::string &serialized) const;
+
+ private:
+  std::string FilePath(const std::string &key) const;
+
+  std::string dir_;
 };
 
+// The key does not depend on the launch op name, so that the same cluster is
+// shared by different jobs. All the protobuf messages are serialized
+// deterministically.
+std::string ComputePersistentKey(const XrtLaunchOpConf &launch_conf, const XrtDevice &device,
+                                 const Signature &signature,
+                                 const std::vector<xrt::Parameter> &return_params);
+
 }  // namespace xrt
 }  // namespace oneflow
 
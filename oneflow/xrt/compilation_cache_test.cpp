@@ -0,0 +1,229 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+// include sstream first to avoid some compiling error
+// caused by the following trick
+// reference: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=65899
+#include <sstream>
+#define private public
+#include "oneflow/xrt/compilation_cache.h"
+#include "oneflow/xrt/xrt.pb.h"
+#include "oneflow/core/common/str_util.h"
+#include "oneflow/core/persistence/file_system.h"
+
+#include <unistd.h>
+#include <fstream>
+
+DECLARE_int32(compilation_cache_capacity);
+
+namespace oneflow {
+namespace xrt {
+
+namespace {
+
+class FakeExecutable final : public Executable {
+ public:
+  explicit FakeExecutable(const std::string &name) : Executable(name, XrtEngine::XLA) {}
+
+  bool Run(const std::vector<Parameter> &inputs, const ExecutableRunOptions &run_options,
+           bool block_until_done) override {
+    return true;
+  }
+};
+
+Signature MakeSignature(int64_t dim, DataType data_type) {
+  Signature signature;
+  signature.builder_name = "cluster";
+  signature.device_ordinal = 0;
+  signature.entry_data_types = {data_type};
+  signature.entry_shapes = {Shape({dim})};
+  return signature;
+}
+
+class ProgramCacheDir final {
+ public:
+  ProgramCacheDir()
+      : dir_(JoinPath("/tmp", "xrt_program_cache_test_" + std::to_string(getpid()) + "_"
+                                  + NewUniqueId())) {}
+  ~ProgramCacheDir() {
+    if (LocalFS()->IsDirectory(dir_)) { LocalFS()->RecursivelyDeleteDir(dir_); }
+  }
+  const std::string &dir() const { return dir_; }
+
+ private:
+  std::string dir_;
+};
+
+SerializedProgramProto ReadCacheFile(const std::string &file_path) {
+  std::ifstream is(file_path, std::ios::binary);
+  SerializedProgramProto proto;
+  CHECK(proto.ParseFromIstream(&is));
+  return proto;
+}
+
+void WriteCacheFile(const std::string &file_path, const SerializedProgramProto &proto) {
+  std::ofstream os(file_path, std::ios::binary | std::ios::trunc);
+  CHECK(proto.SerializeToOstream(&os));
+}
+
+}  // namespace
+
+TEST(CompilationCache, lru_eviction_at_capacity) {
+  const size_t capacity = FLAGS_compilation_cache_capacity;
+  CompilationCache cache(capacity);
+  FOR_RANGE(int64_t, i, 0, capacity) {
+    cache.Record(MakeSignature(i, DataType::kFloat),
+                 std::make_shared<FakeExecutable>(std::to_string(i)));
+  }
+  ASSERT_EQ(cache.records_.size(), capacity);
+  ASSERT_EQ(cache.stats().eviction_count, 0);
+  // touch the oldest record, so that the second one is the least recently used
+  std::shared_ptr<Executable> first = cache.GetRecord(MakeSignature(0, DataType::kFloat));
+  ASSERT_TRUE(first != nullptr);
+  cache.Record(MakeSignature(capacity, DataType::kFloat),
+               std::make_shared<FakeExecutable>(std::to_string(capacity)));
+  ASSERT_EQ(cache.records_.size(), capacity);
+  ASSERT_EQ(cache.stats().eviction_count, 1);
+  ASSERT_TRUE(cache.GetRecord(MakeSignature(0, DataType::kFloat)) != nullptr);
+  ASSERT_TRUE(cache.GetRecord(MakeSignature(1, DataType::kFloat)) == nullptr);
+  ASSERT_TRUE(cache.GetRecord(MakeSignature(capacity, DataType::kFloat)) != nullptr);
+  // the evicted executables are still valid for their holders
+  cache.Release();
+  ASSERT_EQ(first->name(), "0");
+}
+
+TEST(CompilationCache, data_type_distinct_keys) {
+  CompilationCache cache(2);
+  const Signature float_signature = MakeSignature(8, DataType::kFloat);
+  const Signature double_signature = MakeSignature(8, DataType::kDouble);
+  ASSERT_FALSE(float_signature == double_signature);
+  cache.Record(float_signature, std::make_shared<FakeExecutable>("float"));
+  ASSERT_TRUE(cache.GetRecord(double_signature) == nullptr);
+  cache.Record(double_signature, std::make_shared<FakeExecutable>("double"));
+  ASSERT_EQ(cache.GetRecord(float_signature)->name(), "float");
+  ASSERT_EQ(cache.GetRecord(double_signature)->name(), "double");
+}
+
+TEST(CompilationCache, stats) {
+  CompilationCache cache(1);
+  const Signature signature = MakeSignature(8, DataType::kFloat);
+  ASSERT_TRUE(cache.GetRecord(signature) == nullptr);
+  cache.Record(signature, std::make_shared<FakeExecutable>("first"));
+  ASSERT_TRUE(cache.GetRecord(signature) != nullptr);
+  ASSERT_TRUE(cache.GetRecord(signature) != nullptr);
+  // recording the same signature replaces the executable without eviction
+  cache.Record(signature, std::make_shared<FakeExecutable>("second"));
+  ASSERT_EQ(cache.GetRecord(signature)->name(), "second");
+  cache.Record(MakeSignature(16, DataType::kFloat), std::make_shared<FakeExecutable>("third"));
+  ASSERT_TRUE(cache.GetRecord(signature) == nullptr);
+  const CompilationCacheStats stats = cache.stats();
+  ASSERT_EQ(stats.hit_count, 3);
+  ASSERT_EQ(stats.miss_count, 2);
+  ASSERT_EQ(stats.eviction_count, 1);
+}
+
+TEST(CompilationCache, start_compiling) {
+  CompilationCache cache(2);
+  const Signature signature = MakeSignature(8, DataType::kFloat);
+  ASSERT_TRUE(cache.StartCompiling(signature));
+  // a pending compilation is not started twice
+  ASSERT_FALSE(cache.StartCompiling(signature));
+  ASSERT_TRUE(cache.StartCompiling(MakeSignature(16, DataType::kFloat)));
+  cache.Record(signature, std::make_shared<FakeExecutable>("compiled"));
+  ASSERT_TRUE(cache.StartCompiling(signature));
+}
+
+TEST(BucketShape, leading_dim) {
+  const Shape static_shape({100, 16});
+  ASSERT_EQ(BucketShape(Shape({1, 16}), static_shape, 32), Shape({32, 16}));
+  ASSERT_EQ(BucketShape(Shape({32, 16}), static_shape, 32), Shape({32, 16}));
+  ASSERT_EQ(BucketShape(Shape({33, 16}), static_shape, 32), Shape({64, 16}));
+  // capped by the static shape
+  ASSERT_EQ(BucketShape(Shape({97, 16}), static_shape, 32), Shape({100, 16}));
+  // an empty blob takes the first bucket
+  ASSERT_EQ(BucketShape(Shape({0, 16}), static_shape, 32), Shape({32, 16}));
+  // only the leading dim is bucketed
+  ASSERT_EQ(BucketShape(Shape({10, 8}), static_shape, 32), static_shape);
+  ASSERT_EQ(BucketShape(Shape({10}), static_shape, 32), static_shape);
+}
+
+TEST(BucketedExecutable, run) {
+  auto executable = std::make_shared<FakeExecutable>("bucket");
+  BucketedExecutable bucketed(executable, {Shape({32, 16})});
+  ASSERT_EQ(bucketed.name(), "bucket");
+  ASSERT_EQ(bucketed.engine(), XrtEngine::XLA);
+  ASSERT_TRUE(bucketed.Run({}, ExecutableRunOptions()));
+  ASSERT_EQ(bucketed.return_shapes().size(), 1);
+  ASSERT_EQ(bucketed.return_shapes().at(0), Shape({32, 16}));
+}
+
+TEST(PersistentProgramCache, round_trip) {
+  ProgramCacheDir cache_dir;
+  PersistentProgramCache cache(cache_dir.dir());
+  std::string serialized;
+  ASSERT_FALSE(cache.Load("key", XrtEngine::XLA, &serialized));
+  cache.Store("key", XrtEngine::XLA, std::string("program\0with nul", 19));
+  ASSERT_TRUE(cache.Load("key", XrtEngine::XLA, &serialized));
+  ASSERT_EQ(serialized, std::string("program\0with nul", 19));
+  // a new store replaces the old one
+  cache.Store("key", XrtEngine::XLA, "another program");
+  ASSERT_TRUE(cache.Load("key", XrtEngine::XLA, &serialized));
+  ASSERT_EQ(serialized, "another program");
+  // the cache survives the cache object
+  PersistentProgramCache reopened_cache(cache_dir.dir());
+  ASSERT_TRUE(reopened_cache.Load("key", XrtEngine::XLA, &serialized));
+  ASSERT_EQ(serialized, "another program");
+}
+
+TEST(PersistentProgramCache, store_fails_soft) {
+  ProgramCacheDir cache_dir;
+  PersistentProgramCache cache(cache_dir.dir());
+  ASSERT_TRUE(cache.Store("key", XrtEngine::XLA, "program"));
+  // a directory under a regular file can not be created, even by root
+  PersistentProgramCache broken_cache(cache.FilePath("key") + "/sub_dir");
+  ASSERT_FALSE(broken_cache.Store("key", XrtEngine::XLA, "program"));
+  std::string serialized;
+  ASSERT_FALSE(broken_cache.Load("key", XrtEngine::XLA, &serialized));
+}
+
+TEST(PersistentProgramCache, mismatch) {
+  ProgramCacheDir cache_dir;
+  PersistentProgramCache cache(cache_dir.dir());
+  cache.Store("key", XrtEngine::XLA, "program");
+  std::string serialized;
+  ASSERT_FALSE(cache.Load("another key", XrtEngine::XLA, &serialized));
+  ASSERT_FALSE(cache.Load("key", XrtEngine::TENSORRT, &serialized));
+  const std::string file_path = cache.FilePath("key");
+  const SerializedProgramProto stored = ReadCacheFile(file_path);
+  // stored by another version
+  SerializedProgramProto proto = stored;
+  proto.set_version(stored.version() + 1);
+  WriteCacheFile(file_path, proto);
+  ASSERT_FALSE(cache.Load("key", XrtEngine::XLA, &serialized));
+  // another key whose file name collides
+  proto = stored;
+  proto.set_key("colliding key");
+  WriteCacheFile(file_path, proto);
+  ASSERT_FALSE(cache.Load("key", XrtEngine::XLA, &serialized));
+  // broken file
+  std::ofstream(file_path, std::ios::binary | std::ios::trunc) << "broken";
+  ASSERT_FALSE(cache.Load("key", XrtEngine::XLA, &serialized));
+  WriteCacheFile(file_path, stored);
+  ASSERT_TRUE(cache.Load("key", XrtEngine::XLA, &serialized));
+  ASSERT_EQ(serialized, "program");
+}
+
+}  // namespace xrt
+}  // namespace oneflow
@@ -78,6 +78,12 @@ class Executable {
 
   const std::vector<Parameter> &Results() const { return results_; }
 
+  // Serialize the engine program the executable is compiled from, such as the
+  // HLO module of XLA, so that the graph compiler of the same engine compiles
+  // it again without building it from the graph. The compiled code itself is
+  // not serialized. Return false if the engine does not support it.
+  virtual bool SerializeProgram(std::string *serialized) const { return false; }
+
  protected:
   // Executable name.
   std::string name_;
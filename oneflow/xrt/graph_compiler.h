@@ -67,6 +67,12 @@ class GraphCompiler {
                                                 const std::vector<Parameter> &return_params,
                                                 const std::vector<InputOutputAlias> &aliases) = 0;
 
+    // Compile the program serialized by `Executable::SerializeProgram`. Return
+    // nullptr if the engine does not support it or the program is broken.
+    virtual std::shared_ptr<Executable> CompileSerializedProgram(const std::string &serialized) {
+      return nullptr;
+    }
+
    protected:
     // Compiler name
     std::string name_ = "";
@@ -97,6 +103,10 @@ class GraphCompiler {
     return impl_->Compile(graph, entry_params, return_params, aliases);
   }
 
+  std::shared_ptr<Executable> CompileSerializedProgram(const std::string &serialized) {
+    return impl_->CompileSerializedProgram(serialized);
+  }
+
   const XrtEngine &engine() const { return engine_; }
 
  private:
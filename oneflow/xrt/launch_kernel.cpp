@@ -20,6 +20,7 @@ limitations under the License.
 #include "oneflow/xrt/graph_compiler.h"
 #include "oneflow/xrt/platform.h"
 #include "oneflow/xrt/utility/env.h"
+#include "oneflow/core/thread/thread_pool.h"
 
 // General executable setup.
 DEFINE_int64(max_workspace_bytes, EnvToInt64(FLAGS_max_workspace_bytes, -1),
@@ -27,6 +28,19 @@ DEFINE_int64(max_workspace_bytes, EnvToInt64(FLAGS_max_workspace_bytes, -1),
 // TENSORRT executable setup.
 DEFINE_int32(max_batch_size, EnvToInt(FLAGS_max_batch_size, 1),
              "Maximum batch size for builder of TENSORRT engine.");
+// Compilation cache setup.
+DEFINE_int32(compilation_cache_capacity, EnvToInt(FLAGS_compilation_cache_capacity, 64),
+             "Maximum number of executables cached by each launch kernel.");
+DEFINE_string(program_cache_dir, EnvToString(FLAGS_program_cache_dir, ""),
+              "Local directory to persist the engine programs (HLO modules of XLA) across "
+              "processes, so that a restarted process skips building them. They are still "
+              "compiled by the engine. It is disabled if empty.");
+DEFINE_int64(shape_bucket_size, EnvToInt64(FLAGS_shape_bucket_size, 0),
+             "Compile the leading dimension of the dynamic entry blobs padded to a multiple of "
+             "it, instead of the static shapes. It is disabled if not positive.");
+DEFINE_bool(background_compilation, EnvToBool(FLAGS_background_compilation, true),
+            "Compile the shape buckets of XLA in background, and run the executable of the "
+            "static shapes until they are ready.");
 
 DECLARE_bool(tensorrt_fp16);
 DECLARE_bool(tensorrt_int8);
@@ -62,47 +76,196 @@ void BlobDescGetter<device_type>::DumpEntryBlobDescTo(
 }
 
 template<DeviceType device_type>
-xrt::Executable *XrtLaunchKernel<device_type>::BuildExecutable(
+XrtLaunchKernel<device_type>::~XrtLaunchKernel() {
+  if (compilation_cache_) {
+    const xrt::CompilationCacheStats stats = compilation_cache_->stats();
+    VLOG(1) << "Compilation cache of launch op " << this->op_conf().name()
+            << ": hit=" << stats.hit_count << ", miss=" << stats.miss_count
+            << ", eviction=" << stats.eviction_count;
+  }
+}
+
+namespace {
+
+// Compile the program persisted by a previous process, nullptr if there is
+// none or the program cache is disabled.
+std::shared_ptr<xrt::Executable> CompilePersistedProgram(xrt::GraphCompiler *compiler,
+                                                         const std::string &persistent_key) {
+  if (FLAGS_program_cache_dir.empty()) { return nullptr; }
+  xrt::PersistentProgramCache persistent_cache(FLAGS_program_cache_dir);
+  std::string serialized;
+  if (!persistent_cache.Load(persistent_key, compiler->engine(), &serialized)) { return nullptr; }
+  return compiler->CompileSerializedProgram(serialized);
+}
+
+void PersistProgram(const std::string &persistent_key, const xrt::Executable &executable) {
+  if (FLAGS_program_cache_dir.empty()) { return; }
+  std::string serialized;
+  if (executable.SerializeProgram(&serialized)) {
+    xrt::PersistentProgramCache(FLAGS_program_cache_dir)
+        .Store(persistent_key, executable.engine(), serialized);
+  }
+}
+
+// The real rows of the output blob are the leading ones of the padded output,
+// which fits into the memory of the blob.
+bool IsPaddedByRows(const Shape &padded_shape, const Shape &static_shape) {
+  if (padded_shape.NumAxes() != static_shape.NumAxes()) { return false; }
+  if (padded_shape.NumAxes() == 0) { return true; }
+  for (int64_t i = 1; i < padded_shape.NumAxes(); ++i) {
+    if (padded_shape.At(i) != static_shape.At(i)) { return false; }
+  }
+  return padded_shape.At(0) <= static_shape.At(0);
+}
+
+// XLA does not read the data of the parameters while compiling, which is only
+// valid during the launch.
+bool CanCompileInBackground(const xrt::XrtEngine &engine) {
+  return FLAGS_background_compilation && engine == xrt::XrtEngine::XLA;
+}
+
+ThreadPool *BackgroundCompilationThreadPool() {
+  static ThreadPool thread_pool(1);
+  return &thread_pool;
+}
+
+}  // namespace
+
+template<DeviceType device_type>
+xrt::CompilationCache *XrtLaunchKernel<device_type>::MutCompilationCache() const {
+  if (!compilation_cache_) {
+    compilation_cache_.reset(new xrt::CompilationCache(FLAGS_compilation_cache_capacity));
+  }
+  return compilation_cache_.get();
+}
+
+template<DeviceType device_type>
+std::shared_ptr<xrt::XrtGraph> XrtLaunchKernel<device_type>::BuildGraph(
+    const std::vector<xrt::Parameter> &entry_params,
+    std::unordered_map<std::string, BlobDesc> *blob_descs) const {
+  const auto &launch_conf = this->op_conf().xrt_launch_conf();
+  auto graph = xrt::BuildXrtGraph(launch_conf.function(), device_type, this->job_desc());
+  // Run InferShape pass
+  const auto &parallel_ctx = this->kernel_conf().xrt_launch_conf().parallel_ctx();
+  const auto &sbp_signatures = launch_conf.sbp_signatures();
+  desc_getter_.DumpEntryBlobDescTo(blob_descs);
+  for (const xrt::Parameter &param : entry_params) {
+    blob_descs->at(param.name()).mut_shape() = param.shape();
+  }
+  auto options = xrt::CreateDefaultXrtPassOptions();
+  xrt::RunXrtPass("InferShape", graph.get(), options, &this->job_desc(), &parallel_ctx,
+                  &sbp_signatures, blob_descs);
+  // Update argument meta data
+  // xrt::RunXrtPass("UpdateArgMetaData", graph.get(), options,
+  //                 &this->job_desc());
+  return graph;
+}
+
+template<DeviceType device_type>
+std::shared_ptr<xrt::Executable> XrtLaunchKernel<device_type>::BuildExecutable(
     const std::vector<xrt::Parameter> &entry_params,
     const std::vector<xrt::Parameter> &return_params,
     const std::vector<xrt::InputOutputAlias> &aliases, const int device_ordinal) const {
-  if (!compilation_cache_) { compilation_cache_.reset(new xrt::CompilationCache); }
-
-  xrt::Executable *executable = nullptr;
+  xrt::CompilationCache *compilation_cache = MutCompilationCache();
+  std::shared_ptr<xrt::Executable> executable;
   xrt::Signature signature =
       xrt::ComputeSignature(this->op_conf().name(), device_ordinal, entry_params);
   bool force_compile = false;
-  if (!force_compile) { executable = compilation_cache_->GetRecord(signature); }
+  if (!force_compile) { executable = compilation_cache->GetRecord(signature); }
 
   if (!executable) {
-    VLOG(2) << "Build executable for launch op " << this->op_conf().name();
     const auto &launch_conf = this->op_conf().xrt_launch_conf();
-    auto graph = xrt::BuildXrtGraph(launch_conf.function(), device_type, this->job_desc());
-    {
-      // Run InferShape pass
-      const auto &parallel_ctx = this->kernel_conf().xrt_launch_conf().parallel_ctx();
-      const auto &sbp_signatures = launch_conf.sbp_signatures();
-
-      std::unordered_map<std::string, BlobDesc> entry_blob_descs;
-      desc_getter_.DumpEntryBlobDescTo(&entry_blob_descs);
-      auto options = xrt::CreateDefaultXrtPassOptions();
-      xrt::RunXrtPass("InferShape", graph.get(), options, &this->job_desc(), &parallel_ctx,
-                      &sbp_signatures, &entry_blob_descs);
-      // Update argument meta data
-      // xrt::RunXrtPass("UpdateArgMetaData", graph.get(), options,
-      //                 &this->job_desc());
-    }
     xrt::XrtEngine engine = xrt::StringToXrtEngine(launch_conf.engine());
     xrt::XrtDevice device = xrt::DeviceTypeToXrtDevice(device_type);
     xrt::GraphCompiler compiler(this->op_conf().name(), engine, device, device_ordinal);
-    auto result = compiler.Compile(graph.get(), entry_params, return_params, aliases);
+    const std::string persistent_key =
+        FLAGS_program_cache_dir.empty()
+            ? ""
+            : xrt::ComputePersistentKey(launch_conf, device, signature, return_params);
+    executable = CompilePersistedProgram(&compiler, persistent_key);
+    if (executable) {
+      VLOG(2) << "Compile the persisted program for launch op " << this->op_conf().name();
+    } else {
+      VLOG(2) << "Build executable for launch op " << this->op_conf().name();
+      std::unordered_map<std::string, BlobDesc> blob_descs;
+      auto graph = BuildGraph(entry_params, &blob_descs);
+      executable = compiler.Compile(graph.get(), entry_params, return_params, aliases);
+      PersistProgram(persistent_key, *executable);
+    }
     // Record new compilation result
-    compilation_cache_->Record(signature, result);
-    // Get compilation result from cache
-    executable = compilation_cache_->GetRecord(signature);
+    compilation_cache->Record(signature, executable);
   }
 
-  return std::move(executable);
+  return executable;
+}
+
+template<DeviceType device_type>
+std::shared_ptr<xrt::Executable> XrtLaunchKernel<device_type>::GetBucketedExecutable(
+    const std::vector<xrt::Parameter> &entry_params,
+    const std::vector<xrt::Parameter> &return_params,
+    const std::vector<xrt::InputOutputAlias> &aliases, const int device_ordinal,
+    std::vector<xrt::Parameter> *bucketed_return_params) const {
+  xrt::CompilationCache *compilation_cache = MutCompilationCache();
+  xrt::Signature signature =
+      xrt::ComputeSignature(this->op_conf().name(), device_ordinal, entry_params);
+  auto executable = std::dynamic_pointer_cast<xrt::BucketedExecutable>(
+      compilation_cache->GetRecord(signature));
+  if (!executable) {
+    if (!compilation_cache->StartCompiling(signature)) { return nullptr; }
+    std::unordered_map<std::string, BlobDesc> blob_descs;
+    std::shared_ptr<xrt::XrtGraph> graph = BuildGraph(entry_params, &blob_descs);
+    std::vector<xrt::Parameter> padded_return_params;
+    for (const xrt::Parameter &param : return_params) {
+      const Shape &shape = blob_descs.at(param.name()).shape();
+      if (!IsPaddedByRows(shape, param.shape())) {
+        LOG(WARNING) << "Disable shape bucketing for launch op " << this->op_conf().name()
+                     << " since its output " << param.name() << " is not padded by rows";
+        shape_bucketing_disabled_ = true;
+        return nullptr;
+      }
+      padded_return_params.emplace_back(param.name(), param.data(), shape, param.data_type());
+    }
+    const auto &launch_conf = this->op_conf().xrt_launch_conf();
+    xrt::XrtEngine engine = xrt::StringToXrtEngine(launch_conf.engine());
+    xrt::XrtDevice device = xrt::DeviceTypeToXrtDevice(device_type);
+    const std::string name = this->op_conf().name();
+    const std::string persistent_key =
+        FLAGS_program_cache_dir.empty()
+            ? ""
+            : xrt::ComputePersistentKey(launch_conf, device, signature, padded_return_params);
+    std::shared_ptr<xrt::CompilationCache> cache = compilation_cache_;
+    // Nothing of the kernel is used, which may be destroyed before the
+    // background compilation is done.
+    auto Compile = [=]() -> std::shared_ptr<xrt::BucketedExecutable> {
+      xrt::platform::SetDeviceId(device, device_ordinal);
+      xrt::GraphCompiler compiler(name, engine, device, device_ordinal);
+      auto compiled = CompilePersistedProgram(&compiler, persistent_key);
+      if (!compiled) {
+        compiled = compiler.Compile(graph.get(), entry_params, padded_return_params, aliases);
+        PersistProgram(persistent_key, *compiled);
+      }
+      std::vector<Shape> return_shapes;
+      for (const xrt::Parameter &param : padded_return_params) {
+        return_shapes.push_back(param.shape());
+      }
+      auto bucketed = std::make_shared<xrt::BucketedExecutable>(compiled, return_shapes);
+      cache->Record(signature, bucketed);
+      return bucketed;
+    };
+    if (CanCompileInBackground(engine)) {
+      VLOG(2) << "Compile shape bucket in background for launch op " << name;
+      BackgroundCompilationThreadPool()->AddWork([Compile]() { Compile(); });
+      return nullptr;
+    }
+    executable = Compile();
+  }
+  CHECK_EQ(executable->return_shapes().size(), return_params.size());
+  for (int i = 0; i < return_params.size(); ++i) {
+    bucketed_return_params->emplace_back(return_params[i].name(), return_params[i].data(),
+                                         executable->return_shapes()[i],
+                                         return_params[i].data_type());
+  }
+  return executable;
 }
 
 template<DeviceType device_type>
@@ -145,11 +308,24 @@ void XrtLaunchKernel<device_type>::ForwardDataContent(
   desc_getter_ = BlobDescGetter<device_type>(this, BnInOp2Blob);
   // Prepare input and output parameters
   std::vector<xrt::Parameter> entry_params, return_params;
+  // The entry shapes with the bucketed leading dimensions of the dynamic blobs.
+  std::vector<Shape> bucketed_entry_shapes;
+  bool use_shape_bucket = FLAGS_shape_bucket_size > 0 && !shape_bucketing_disabled_;
   for (const std::string &bn : this->op_attribute().input_bns()) {
     const LogicalBlobId &lbi = this->BnInOp2Lbi(bn);
     std::string blob_name = xrt::BlobIdToName(lbi);
-    xrt::Parameter input = xrt::BuildParameter(*BnInOp2Blob(bn), blob_name);
+    const Blob *blob = BnInOp2Blob(bn);
+    xrt::Parameter input = xrt::BuildParameter(*blob, blob_name);
     entry_params.push_back(input);
+    if (use_shape_bucket && blob->blob_desc().is_dynamic()) {
+      // The dynamic blobs are compiled with the static shapes if not bucketed.
+      Shape shape;
+      blob->shape().ToShape(&shape);
+      bucketed_entry_shapes.push_back(
+          xrt::BucketShape(shape, input.shape(), FLAGS_shape_bucket_size));
+    } else if (use_shape_bucket) {
+      bucketed_entry_shapes.push_back(input.shape());
+    }
   }
   for (const std::string &bn : this->op_attribute().output_bns()) {
     const LogicalBlobId &lbi = this->BnInOp2Lbi(bn);
@@ -165,7 +341,31 @@ void XrtLaunchKernel<device_type>::ForwardDataContent(
   // Mapping parameter names to function input and output names.
   MappingParamsToFunctionNames(&entry_params, &return_params);
   // Build executable.
-  auto executable = BuildExecutable(entry_params, return_params, aliases, device_ordinal);
+  std::shared_ptr<xrt::Executable> executable;
+  if (use_shape_bucket) {
+    use_shape_bucket = false;
+    for (int i = 0; i < entry_params.size(); ++i) {
+      if (bucketed_entry_shapes[i] != entry_params[i].shape()) { use_shape_bucket = true; }
+    }
+  }
+  if (use_shape_bucket) {
+    std::vector<xrt::Parameter> bucketed_entry_params, bucketed_return_params;
+    for (int i = 0; i < entry_params.size(); ++i) {
+      bucketed_entry_params.emplace_back(entry_params[i].name(), entry_params[i].data(),
+                                         bucketed_entry_shapes[i], entry_params[i].data_type());
+    }
+    executable = GetBucketedExecutable(bucketed_entry_params, return_params, aliases,
+                                       device_ordinal, &bucketed_return_params);
+    // Fall back to the executable of the static shapes until the bucket is
+    // compiled.
+    if (executable) {
+      entry_params.swap(bucketed_entry_params);
+      return_params.swap(bucketed_return_params);
+    }
+  }
+  if (!executable) {
+    executable = BuildExecutable(entry_params, return_params, aliases, device_ordinal);
+  }
   if (!executable) { LOG(FATAL) << "Executable is built failed."; }
   // Run executable.
   xrt::ExecutableRunOptions run_options;
@@ -21,6 +21,7 @@ limitations under the License.
 #include "oneflow/core/kernel/kernel.h"
 #include "oneflow/xrt/compilation_cache.h"
 #include "oneflow/xrt/executable.h"
+#include "oneflow/xrt/graph/graph.h"
 #include "oneflow/xrt/graph_compiler.h"
 #include "oneflow/xrt/parameter.h"
 #include "oneflow/xrt/types.h"
@@ -46,16 +47,33 @@ template<DeviceType device_type>
 class XrtLaunchKernel : public KernelIf<device_type> {
  public:
   XrtLaunchKernel() = default;
-  virtual ~XrtLaunchKernel() {}
+  virtual ~XrtLaunchKernel();
 
  private:
   void ForwardDataContent(const KernelCtx &ctx,
                           std::function<Blob *(const std::string &)> BnInOp2Blob) const override;
 
-  xrt::Executable *BuildExecutable(const std::vector<xrt::Parameter> &entry_params,
-                                   const std::vector<xrt::Parameter> &return_params,
-                                   const std::vector<xrt::InputOutputAlias> &aliases,
-                                   const int device_ordinal) const;
+  std::shared_ptr<xrt::Executable> BuildExecutable(
+      const std::vector<xrt::Parameter> &entry_params,
+      const std::vector<xrt::Parameter> &return_params,
+      const std::vector<xrt::InputOutputAlias> &aliases, const int device_ordinal) const;
+
+  // Return the executable of the bucketed entry shapes, and the return
+  // parameters padded as it produces. Return nullptr if the bucket is not
+  // compiled yet.
+  std::shared_ptr<xrt::Executable> GetBucketedExecutable(
+      const std::vector<xrt::Parameter> &entry_params,
+      const std::vector<xrt::Parameter> &return_params,
+      const std::vector<xrt::InputOutputAlias> &aliases, const int device_ordinal,
+      std::vector<xrt::Parameter> *bucketed_return_params) const;
+
+  // Build the graph of the launch function and infer the blob descs with the
+  // shapes of the entry parameters.
+  std::shared_ptr<xrt::XrtGraph> BuildGraph(
+      const std::vector<xrt::Parameter> &entry_params,
+      std::unordered_map<std::string, BlobDesc> *blob_descs) const;
+
+  xrt::CompilationCache *MutCompilationCache() const;
 
   void MakeInputOutputAlias(                            // NOLINT
       const std::vector<xrt::Parameter> &entry_params,  // NOLINT
@@ -70,6 +88,8 @@ class XrtLaunchKernel : public KernelIf<device_type> {
  private:
   mutable BlobDescGetter<device_type> desc_getter_;
   mutable std::shared_ptr<xrt::CompilationCache> compilation_cache_;
+  // Set once an output is not padded by rows with the bucketed entry shapes.
+  mutable bool shape_bucketing_disabled_ = false;
 };
 
 }  // namespace oneflow
@@ -0,0 +1,171 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/xrt/native/native_builder.h"
+
+#include <algorithm>
+
+#include "glog/logging.h"
+
+namespace oneflow {
+namespace xrt {
+namespace native {
+
+Shape BroadcastShape(const Shape &a, const Shape &b) {
+  const int64_t num_axes = std::max(a.NumAxes(), b.NumAxes());
+  DimVector dim_vec(num_axes);
+  for (int64_t i = 0; i < num_axes; ++i) {
+    const int64_t a_axis = i - (num_axes - a.NumAxes());
+    const int64_t b_axis = i - (num_axes - b.NumAxes());
+    const int64_t a_dim = a_axis < 0 ? 1 : a.At(a_axis);
+    const int64_t b_dim = b_axis < 0 ? 1 : b.At(b_axis);
+    CHECK(a_dim == b_dim || a_dim == 1 || b_dim == 1)
+        << "Shape " << a.ToString() << " can not be broadcasted with " << b.ToString();
+    dim_vec[i] = (a_dim == 1) ? b_dim : a_dim;
+  }
+  return Shape(dim_vec);
+}
+
+void NativeBuilder::CheckDataType(const DataType &data_type) {
+  CHECK(data_type == DataType::kFloat || data_type == DataType::kDouble)
+      << "Native engine only supports float and double, but got " << data_type;
+  if (program_.data_type == DataType::kInvalidDataType) { program_.data_type = data_type; }
+  CHECK_EQ(program_.data_type, data_type)
+      << "Native engine requires all the values of a cluster have the same data type.";
+}
+
+int64_t NativeBuilder::AddBuffer(NativeBuffer::Kind kind, int64_t index, int64_t elem_cnt) {
+  program_.buffers.push_back(NativeBuffer{kind, index, elem_cnt});
+  return program_.buffers.size() - 1;
+}
+
+NativeValue NativeBuilder::Load(int64_t buffer_id, const Shape &shape) {
+  CHECK_EQ(program_.buffers[buffer_id].elem_cnt, shape.elem_cnt());
+  auto expr = std::make_shared<NativeExpr>();
+  expr->opcode = NativeOpCode::kLoad;
+  expr->shape = shape;
+  expr->data_type = program_.data_type;
+  expr->buffer_id = buffer_id;
+  return expr;
+}
+
+NativeValue NativeBuilder::Parameter(int64_t index, const xrt::Parameter &param) {
+  CheckDataType(param.data_type());
+  program_.num_entries = std::max(program_.num_entries, index + 1);
+  int64_t buffer_id = AddBuffer(NativeBuffer::kEntry, index, param.shape().elem_cnt());
+  return Load(buffer_id, param.shape());
+}
+
+NativeValue NativeBuilder::Scalar(const NativeValue &like, double value) {
+  auto expr = std::make_shared<NativeExpr>();
+  expr->opcode = NativeOpCode::kScalar;
+  expr->shape = Shape({1});
+  expr->data_type = like->data_type;
+  expr->scalar = value;
+  return expr;
+}
+
+NativeValue NativeBuilder::Unary(NativeOpCode opcode, const NativeValue &x, double alpha) {
+  CHECK(IsUnaryOpCode(opcode));
+  auto expr = std::make_shared<NativeExpr>();
+  expr->opcode = opcode;
+  expr->shape = x->shape;
+  expr->data_type = x->data_type;
+  expr->operands = {x};
+  expr->scalar = alpha;
+  return expr;
+}
+
+NativeValue NativeBuilder::Binary(NativeOpCode opcode, const NativeValue &a,
+                                  const NativeValue &b) {
+  CHECK(IsBinaryOpCode(opcode));
+  CHECK_EQ(a->data_type, b->data_type);
+  auto expr = std::make_shared<NativeExpr>();
+  expr->opcode = opcode;
+  expr->shape = BroadcastShape(a->shape, b->shape);
+  expr->data_type = a->data_type;
+  expr->operands = {a, b};
+  return expr;
+}
+
+NativeValue NativeBuilder::Materialize(const NativeValue &x) {
+  if (x->opcode == NativeOpCode::kLoad) { return x; }
+  int64_t buffer_id = AddBuffer(NativeBuffer::kTemp, num_temps_++, x->shape.elem_cnt());
+  program_.stages.push_back(NativeStage{x, buffer_id, {}});
+  return Load(buffer_id, x->shape);
+}
+
+NativeValue NativeBuilder::Reshape(const NativeValue &x, const Shape &shape) {
+  CHECK_EQ(x->shape.elem_cnt(), shape.elem_cnt());
+  // Reshaping keeps the order of the elements, so the materialized buffer is
+  // simply loaded with the new shape.
+  return Load(Materialize(x)->buffer_id, shape);
+}
+
+NativeValue NativeBuilder::ReduceSum(const NativeValue &x, const std::vector<int32_t> &axes,
+                                     bool keep_dims) {
+  const int64_t num_axes = x->shape.NumAxes();
+  std::vector<int32_t> reduce_axes;
+  for (int32_t axis : axes) { reduce_axes.push_back(axis < 0 ? axis + num_axes : axis); }
+  // Reduce all the axes if `axes` is empty.
+  if (reduce_axes.empty()) {
+    for (int32_t i = 0; i < num_axes; ++i) { reduce_axes.push_back(i); }
+  }
+  std::sort(reduce_axes.begin(), reduce_axes.end());
+  reduce_axes.erase(std::unique(reduce_axes.begin(), reduce_axes.end()), reduce_axes.end());
+
+  DimVector dim_vec;
+  for (int32_t i = 0; i < num_axes; ++i) {
+    bool reduced = std::binary_search(reduce_axes.begin(), reduce_axes.end(), i);
+    if (!reduced) {
+      dim_vec.push_back(x->shape.At(i));
+    } else if (keep_dims) {
+      dim_vec.push_back(1);
+    }
+  }
+  // Keep consistent with oneflow that the scalar is an 1-d array.
+  if (dim_vec.empty()) { dim_vec.push_back(1); }
+  Shape shape(dim_vec);
+
+  int64_t buffer_id = AddBuffer(NativeBuffer::kTemp, num_temps_++, shape.elem_cnt());
+  program_.stages.push_back(NativeStage{x, buffer_id, reduce_axes});
+  return Load(buffer_id, shape);
+}
+
+void NativeBuilder::MarkOutput(int64_t index, const NativeValue &value) {
+  program_.num_returns = std::max(program_.num_returns, index + 1);
+  if (value->opcode == NativeOpCode::kLoad) {
+    NativeBuffer *buffer = &program_.buffers[value->buffer_id];
+    // The temporary buffer is written into the return parameter directly.
+    if (buffer->kind == NativeBuffer::kTemp) {
+      buffer->kind = NativeBuffer::kReturn;
+      buffer->index = index;
+      return;
+    }
+  }
+  int64_t buffer_id = AddBuffer(NativeBuffer::kReturn, index, value->shape.elem_cnt());
+  program_.stages.push_back(NativeStage{value, buffer_id, {}});
+}
+
+NativeProgram NativeBuilder::Release() {
+  NativeProgram program = std::move(program_);
+  program_ = NativeProgram();
+  num_temps_ = 0;
+  return program;
+}
+
+}  // namespace native
+}  // namespace xrt
+}  // namespace oneflow
@@ -0,0 +1,141 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_XRT_NATIVE_NATIVE_BUILDER_H_
+#define ONEFLOW_XRT_NATIVE_NATIVE_BUILDER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "oneflow/core/common/data_type.pb.h"
+#include "oneflow/core/common/shape.h"
+#include "oneflow/xrt/parameter.h"
+
+namespace oneflow {
+namespace xrt {
+namespace native {
+
+enum class NativeOpCode : int {
+  // Leaves
+  kLoad = 0,
+  kScalar = 1,
+  // Unary operations
+  kIdentity = 10,
+  kRelu = 11,
+  kSigmoid = 12,
+  kTanh = 13,
+  kGelu = 14,
+  kLeakyRelu = 15,
+  // Binary operations
+  kAdd = 20,
+  kSub = 21,
+  kMul = 22,
+  kDiv = 23,
+};
+
+inline bool IsUnaryOpCode(const NativeOpCode &opcode) {
+  return opcode >= NativeOpCode::kIdentity && opcode <= NativeOpCode::kLeakyRelu;
+}
+
+inline bool IsBinaryOpCode(const NativeOpCode &opcode) {
+  return opcode >= NativeOpCode::kAdd && opcode <= NativeOpCode::kDiv;
+}
+
+// A node of the elementwise expression built by the op kernels. Operands are
+// broadcasted to the shape of the node in the numpy way, so all the nodes of
+// an expression can be evaluated element by element over a single loop nest.
+struct NativeExpr {
+  NativeOpCode opcode;
+  Shape shape;
+  DataType data_type;
+  std::vector<std::shared_ptr<const NativeExpr>> operands;
+  // Buffer read by kLoad.
+  int64_t buffer_id = -1;
+  // Value of kScalar, or the alpha of kLeakyRelu.
+  double scalar = 0.0;
+};
+
+using NativeValue = std::shared_ptr<const NativeExpr>;
+
+struct NativeBuffer {
+  enum Kind : int {
+    kEntry = 0,
+    kReturn = 1,
+    kTemp = 2,
+  };
+  Kind kind;
+  // Index of the entry or return parameter, or index of the temporary buffer.
+  int64_t index;
+  int64_t elem_cnt;
+};
+
+// A stage evaluates `value` and writes it into buffer `dst_buffer_id`. The
+// value is reduced by summing over `reduce_axes` if it is not empty.
+struct NativeStage {
+  NativeValue value;
+  int64_t dst_buffer_id;
+  std::vector<int32_t> reduce_axes;
+};
+
+struct NativeProgram {
+  DataType data_type = DataType::kInvalidDataType;
+  std::vector<NativeBuffer> buffers;
+  std::vector<NativeStage> stages;
+  int64_t num_entries = 0;
+  int64_t num_returns = 0;
+};
+
+// Builds a program of fused stages. Elementwise and broadcast operations are
+// only recorded in the expression, and a stage is created if the value has to
+// be materialized, that is it's reduced, reshaped or returned.
+class NativeBuilder {
+ public:
+  explicit NativeBuilder(const std::string &name) : name_(name) {}
+
+  const std::string &name() const { return name_; }
+
+  NativeValue Parameter(int64_t index, const xrt::Parameter &param);
+
+  NativeValue Scalar(const NativeValue &like, double value);
+  NativeValue Unary(NativeOpCode opcode, const NativeValue &x, double alpha = 0.0);
+  NativeValue Binary(NativeOpCode opcode, const NativeValue &a, const NativeValue &b);
+
+  NativeValue Reshape(const NativeValue &x, const Shape &shape);
+  NativeValue ReduceSum(const NativeValue &x, const std::vector<int32_t> &axes, bool keep_dims);
+
+  void MarkOutput(int64_t index, const NativeValue &value);
+
+  NativeProgram Release();
+
+ private:
+  void CheckDataType(const DataType &data_type);
+  NativeValue Load(int64_t buffer_id, const Shape &shape);
+  NativeValue Materialize(const NativeValue &x);
+  int64_t AddBuffer(NativeBuffer::Kind kind, int64_t index, int64_t elem_cnt);
+
+  std::string name_;
+  NativeProgram program_;
+  int64_t num_temps_ = 0;
+};
+
+// Return the shape of the result broadcasting `a` and `b`.
+Shape BroadcastShape(const Shape &a, const Shape &b);
+
+}  // namespace native
+}  // namespace xrt
+}  // namespace oneflow
+
+#endif  // ONEFLOW_XRT_NATIVE_NATIVE_BUILDER_H_
@@ -0,0 +1,391 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/xrt/native/native_executable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+#include "oneflow/core/kernel/util/host_elementwise.h"
+
+namespace oneflow {
+namespace xrt {
+namespace native {
+
+namespace {
+
+// Number of elements evaluated by each instruction at a time. The block of
+// every instruction stays in the cache while it's consumed by the others.
+constexpr int64_t kBlockSize = 512;
+constexpr int64_t kTempAlignSize = 64;
+
+class LoopNestLowering {
+ public:
+  LoopNestLowering(const NativeStage &stage, NativeLoopNest *loop_nest)
+      : shape_(stage.value->shape), loop_nest_(loop_nest) {
+    const int64_t num_axes = shape_.NumAxes();
+    // Move the reduced axes to the innermost loops.
+    for (int32_t i = 0; i < num_axes; ++i) {
+      if (!std::binary_search(stage.reduce_axes.begin(), stage.reduce_axes.end(), i)) {
+        perm_.push_back(i);
+      }
+    }
+    for (int32_t axis : stage.reduce_axes) {
+      CHECK_LT(axis, num_axes);
+      perm_.push_back(axis);
+    }
+    loop_nest_->reduce_cnt = 1;
+    for (int32_t axis : stage.reduce_axes) { loop_nest_->reduce_cnt *= shape_.At(axis); }
+    for (int32_t i = 0; i < num_axes; ++i) {
+      loop_nest_->dims.push_back(shape_.At(perm_[i]));
+      if (perm_[i] != i) { identity_perm_ = false; }
+    }
+    // Scalar is evaluated as an 1-d array.
+    if (loop_nest_->dims.empty()) {
+      loop_nest_->dims.push_back(1);
+      perm_.push_back(0);
+      shape_ = Shape({1});
+    }
+    loop_nest_->elem_cnt = shape_.elem_cnt();
+    loop_nest_->dst_buffer_id = stage.dst_buffer_id;
+  }
+
+  int32_t Lower(const NativeExpr *expr) {
+    auto it = lowered_.find(expr);
+    if (it != lowered_.end()) { return it->second; }
+    NativeInstruction instruction;
+    instruction.opcode = expr->opcode;
+    instruction.scalar = expr->scalar;
+    if (expr->opcode == NativeOpCode::kLoad) {
+      instruction.buffer_id = expr->buffer_id;
+      instruction.strides = LoadStrides(expr->shape);
+      instruction.contiguous = identity_perm_ && expr->shape.elem_cnt() == shape_.elem_cnt();
+    }
+    for (int i = 0; i < expr->operands.size(); ++i) {
+      instruction.operands[i] = Lower(expr->operands[i].get());
+    }
+    loop_nest_->instructions.push_back(instruction);
+    int32_t index = loop_nest_->instructions.size() - 1;
+    lowered_.emplace(expr, index);
+    return index;
+  }
+
+ private:
+  std::vector<int64_t> LoadStrides(const Shape &load_shape) const {
+    const int64_t num_axes = shape_.NumAxes();
+    const int64_t offset = num_axes - load_shape.NumAxes();
+    CHECK_GE(offset, 0);
+    std::vector<int64_t> strides(num_axes, 0);
+    int64_t stride = 1;
+    for (int64_t i = num_axes - 1; i >= offset; --i) {
+      const int64_t dim = load_shape.At(i - offset);
+      CHECK(dim == shape_.At(i) || dim == 1);
+      // Broadcast along the axis if it's 1.
+      if (dim != 1) { strides[i] = stride; }
+      stride *= dim;
+    }
+    std::vector<int64_t> permuted_strides(num_axes);
+    for (int64_t i = 0; i < num_axes; ++i) { permuted_strides[i] = strides[perm_[i]]; }
+    return permuted_strides;
+  }
+
+  Shape shape_;
+  std::vector<int32_t> perm_;
+  bool identity_perm_ = true;
+  NativeLoopNest *loop_nest_;
+  std::unordered_map<const NativeExpr *, int32_t> lowered_;
+};
+
+template<typename T>
+void GatherBlock(const DimVector &dims, const std::vector<int64_t> &strides, const T *src,
+                 int64_t begin, int64_t n, T *out) {
+  const int64_t num_dims = dims.size();
+  const int64_t inner_dim = dims[num_dims - 1];
+  const int64_t inner_stride = strides[num_dims - 1];
+  int64_t index[SHAPE_MAX_AXIS_SIZE];
+  int64_t offset = 0;
+  int64_t remaining = begin;
+  for (int64_t d = num_dims - 1; d >= 0; --d) {
+    index[d] = remaining % dims[d];
+    remaining /= dims[d];
+    offset += index[d] * strides[d];
+  }
+  int64_t i = 0;
+  while (true) {
+    // Run along the innermost loop.
+    const int64_t m = std::min(n - i, inner_dim - index[num_dims - 1]);
+    const T *ptr = src + offset;
+    if (inner_stride == 0) {
+      std::fill(out + i, out + i + m, *ptr);
+    } else if (inner_stride == 1) {
+      std::copy(ptr, ptr + m, out + i);
+    } else {
+      for (int64_t j = 0; j < m; ++j) { out[i + j] = ptr[j * inner_stride]; }
+    }
+    i += m;
+    if (i >= n) { break; }
+    offset += m * inner_stride;
+    index[num_dims - 1] += m;
+    for (int64_t d = num_dims - 1; d > 0 && index[d] == dims[d]; --d) {
+      offset += strides[d - 1] - dims[d] * strides[d];
+      index[d] = 0;
+      index[d - 1] += 1;
+    }
+  }
+}
+
+template<typename T, typename UnaryFunctor>
+void UnaryLoop(UnaryFunctor functor, int64_t n, T *out, const T *x) {
+  for (int64_t i = 0; i < n; ++i) { out[i] = functor(x[i]); }
+}
+
+template<typename T, typename BinaryFunctor>
+void BinaryLoop(BinaryFunctor functor, int64_t n, T *out, const T *a, const T *b) {
+  for (int64_t i = 0; i < n; ++i) { out[i] = functor(a[i], b[i]); }
+}
+
+template<typename T>
+void UnaryBlock(NativeOpCode opcode, T alpha, int64_t n, T *out, const T *x) {
+  switch (opcode) {
+    case NativeOpCode::kIdentity: {
+      std::copy(x, x + n, out);
+      break;
+    }
+    case NativeOpCode::kRelu: {
+      UnaryLoop([](T v) { return v > static_cast<T>(0) ? v : static_cast<T>(0); }, n, out, x);
+      break;
+    }
+    case NativeOpCode::kSigmoid: {
+      UnaryLoop([](T v) { return static_cast<T>(1) / (static_cast<T>(1) + std::exp(-v)); }, n,
+                 out, x);
+      break;
+    }
+    case NativeOpCode::kTanh: {
+      UnaryLoop([](T v) { return std::tanh(v); }, n, out, x);
+      break;
+    }
+    case NativeOpCode::kGelu: {
+      const T inv_sqrt2 = static_cast<T>(std::sqrt(0.5));
+      UnaryLoop(
+          [inv_sqrt2](T v) {
+            return static_cast<T>(0.5) * v * (static_cast<T>(1) + std::erf(inv_sqrt2 * v));
+          },
+          n, out, x);
+      break;
+    }
+    case NativeOpCode::kLeakyRelu: {
+      UnaryLoop([alpha](T v) { return v > static_cast<T>(0) ? v : alpha * v; }, n, out, x);
+      break;
+    }
+    default: LOG(FATAL) << "Unsupported unary opcode " << static_cast<int>(opcode);
+  }
+}
+
+template<typename T>
+void BinaryBlock(NativeOpCode opcode, int64_t n, T *out, const T *a, const T *b) {
+  switch (opcode) {
+    case NativeOpCode::kAdd: BinaryLoop([](T x, T y) { return x + y; }, n, out, a, b); break;
+    case NativeOpCode::kSub: BinaryLoop([](T x, T y) { return x - y; }, n, out, a, b); break;
+    case NativeOpCode::kMul: BinaryLoop([](T x, T y) { return x * y; }, n, out, a, b); break;
+    case NativeOpCode::kDiv: BinaryLoop([](T x, T y) { return x / y; }, n, out, a, b); break;
+    default: LOG(FATAL) << "Unsupported binary opcode " << static_cast<int>(opcode);
+  }
+}
+
+template<typename T>
+class LoopNestEvaluator {
+ public:
+  LoopNestEvaluator(const NativeLoopNest &loop_nest, const std::vector<char *> &buffer_ptrs)
+      : loop_nest_(loop_nest),
+        scratch_(loop_nest.instructions.size() * kBlockSize),
+        results_(loop_nest.instructions.size()) {
+    for (const NativeInstruction &instruction : loop_nest.instructions) {
+      const char *src = nullptr;
+      if (instruction.opcode == NativeOpCode::kLoad) { src = buffer_ptrs[instruction.buffer_id]; }
+      srcs_.push_back(reinterpret_cast<const T *>(src));
+    }
+  }
+
+  // Evaluate the elements [begin, begin + n) of the loop nest, n is not greater
+  // than kBlockSize. The result is written into `dst` if it's not nullptr, but
+  // the returned pointer should always be used since a contiguous load is
+  // returned without copying.
+  const T *Eval(int64_t begin, int64_t n, T *dst) {
+    const auto &instructions = loop_nest_.instructions;
+    const int32_t last = instructions.size() - 1;
+    for (int32_t i = 0; i <= last; ++i) {
+      const NativeInstruction &instruction = instructions[i];
+      T *out = (i == last && dst) ? dst : scratch_.data() + i * kBlockSize;
+      if (instruction.opcode == NativeOpCode::kLoad) {
+        if (instruction.contiguous) {
+          results_[i] = srcs_[i] + begin;
+          continue;
+        }
+        GatherBlock(loop_nest_.dims, instruction.strides, srcs_[i], begin, n, out);
+      } else if (instruction.opcode == NativeOpCode::kScalar) {
+        std::fill(out, out + n, static_cast<T>(instruction.scalar));
+      } else if (IsUnaryOpCode(instruction.opcode)) {
+        UnaryBlock(instruction.opcode, static_cast<T>(instruction.scalar), n, out,
+                   results_[instruction.operands[0]]);
+      } else {
+        BinaryBlock(instruction.opcode, n, out, results_[instruction.operands[0]],
+                    results_[instruction.operands[1]]);
+      }
+      results_[i] = out;
+    }
+    return results_[last];
+  }
+
+  // Sum the elements [begin, end) of the loop nest, and accumulate the results
+  // into `out` which is indexed by the reduced elements.
+  void ReduceSum(int64_t begin, int64_t end, T *out) {
+    const int64_t reduce_cnt = loop_nest_.reduce_cnt;
+    for (int64_t block_begin = begin; block_begin < end; block_begin += kBlockSize) {
+      const int64_t n = std::min(kBlockSize, end - block_begin);
+      const T *values = Eval(block_begin, n, nullptr);
+      int64_t i = 0;
+      while (i < n) {
+        const int64_t out_index = (block_begin + i) / reduce_cnt;
+        const int64_t segment_end = std::min(n, (out_index + 1) * reduce_cnt - block_begin);
+        T sum = static_cast<T>(0);
+        for (int64_t j = i; j < segment_end; ++j) { sum += values[j]; }
+        out[out_index] += sum;
+        i = segment_end;
+      }
+    }
+  }
+
+ private:
+  const NativeLoopNest &loop_nest_;
+  std::vector<const T *> srcs_;
+  std::vector<T> scratch_;
+  std::vector<const T *> results_;
+};
+
+void ForEachParallel(int64_t parallel_num, const std::function<void(int64_t i)> &Handler) {
+  if (parallel_num == 1) {
+    Handler(0);
+  } else {
+    MultiThreadLoop(parallel_num, [&](size_t i) { Handler(i); });
+  }
+}
+
+}  // namespace
+
+NativeExecutable::NativeExecutable(const std::string &name, NativeProgram program)
+    : Executable(name, XrtEngine::NATIVE), program_(std::move(program)) {
+  for (const NativeStage &stage : program_.stages) {
+    NativeLoopNest loop_nest;
+    LoopNestLowering lowering(stage, &loop_nest);
+    lowering.Lower(stage.value.get());
+    loop_nests_.push_back(std::move(loop_nest));
+  }
+  const int64_t size_of_data_type = SizeOf(program_.data_type);
+  int64_t temp_size = 0;
+  temp_offsets_.resize(program_.buffers.size(), -1);
+  for (int i = 0; i < program_.buffers.size(); ++i) {
+    const NativeBuffer &buffer = program_.buffers[i];
+    if (buffer.kind != NativeBuffer::kTemp) { continue; }
+    temp_offsets_[i] = temp_size;
+    temp_size += RoundUp(buffer.elem_cnt * size_of_data_type, kTempAlignSize);
+  }
+  temp_storage_.resize(temp_size);
+}
+
+template<typename T>
+void NativeExecutable::RunLoopNest(const NativeLoopNest &loop_nest,
+                                   const std::vector<char *> &buffer_ptrs) const {
+  T *dst = reinterpret_cast<T *>(buffer_ptrs[loop_nest.dst_buffer_id]);
+  if (loop_nest.reduce_cnt == 1) {
+    host_elementwise::ParallelFor(loop_nest.elem_cnt, [&](int64_t begin, int64_t end) {
+      LoopNestEvaluator<T> evaluator(loop_nest, buffer_ptrs);
+      for (int64_t block_begin = begin; block_begin < end; block_begin += kBlockSize) {
+        const int64_t n = std::min(kBlockSize, end - block_begin);
+        const T *values = evaluator.Eval(block_begin, n, dst + block_begin);
+        if (values != dst + block_begin) { std::copy(values, values + n, dst + block_begin); }
+      }
+    });
+    return;
+  }
+  const int64_t reduce_cnt = loop_nest.reduce_cnt;
+  const int64_t out_cnt = loop_nest.elem_cnt / reduce_cnt;
+  const int64_t parallel_num = host_elementwise::GetParallelNum(loop_nest.elem_cnt);
+  if (out_cnt >= parallel_num) {
+    // Every thread reduces a part of the outputs.
+    const BalancedSplitter bs(out_cnt, parallel_num);
+    ForEachParallel(parallel_num, [&](int64_t i) {
+      const Range range = bs.At(i);
+      std::fill(dst + range.begin(), dst + range.end(), static_cast<T>(0));
+      LoopNestEvaluator<T> evaluator(loop_nest, buffer_ptrs);
+      evaluator.ReduceSum(range.begin() * reduce_cnt, range.end() * reduce_cnt, dst);
+    });
+  } else {
+    // Too few outputs, so every thread reduces a part of the reduced elements
+    // and the partial sums are added up at last.
+    const BalancedSplitter bs(reduce_cnt, parallel_num);
+    std::vector<T> partial_sums(parallel_num * out_cnt, static_cast<T>(0));
+    ForEachParallel(parallel_num, [&](int64_t i) {
+      const Range range = bs.At(i);
+      LoopNestEvaluator<T> evaluator(loop_nest, buffer_ptrs);
+      T *partial_sum = partial_sums.data() + i * out_cnt;
+      for (int64_t j = 0; j < out_cnt; ++j) {
+        // The elements [j * reduce_cnt, (j + 1) * reduce_cnt) are reduced into
+        // the j-th output.
+        evaluator.ReduceSum(j * reduce_cnt + range.begin(), j * reduce_cnt + range.end(),
+                            partial_sum);
+      }
+    });
+    for (int64_t j = 0; j < out_cnt; ++j) {
+      T sum = static_cast<T>(0);
+      for (int64_t i = 0; i < parallel_num; ++i) { sum += partial_sums[i * out_cnt + j]; }
+      dst[j] = sum;
+    }
+  }
+}
+
+bool NativeExecutable::Run(const std::vector<Parameter> &inputs,
+                           const ExecutableRunOptions &run_options, bool block_until_done) {
+  CHECK_EQ(inputs.size(), program_.num_entries);
+  // All return params are the results of the executable.
+  this->results_ = run_options.return_params;
+  CHECK_EQ(this->results_.size(), program_.num_returns);
+
+  std::vector<char *> buffer_ptrs(program_.buffers.size());
+  for (int i = 0; i < program_.buffers.size(); ++i) {
+    const NativeBuffer &buffer = program_.buffers[i];
+    switch (buffer.kind) {
+      case NativeBuffer::kEntry: buffer_ptrs[i] = inputs[buffer.index].data<char>(); break;
+      case NativeBuffer::kReturn: buffer_ptrs[i] = this->results_[buffer.index].data<char>(); break;
+      case NativeBuffer::kTemp: buffer_ptrs[i] = temp_storage_.data() + temp_offsets_[i]; break;
+    }
+  }
+  // The stages run one by one, and each of them is parallelized over the
+  // thread pool.
+  for (const NativeLoopNest &loop_nest : loop_nests_) {
+    if (program_.data_type == DataType::kFloat) {
+      RunLoopNest<float>(loop_nest, buffer_ptrs);
+    } else if (program_.data_type == DataType::kDouble) {
+      RunLoopNest<double>(loop_nest, buffer_ptrs);
+    } else {
+      LOG(FATAL) << "Unsupported data type " << program_.data_type;
+    }
+  }
+  return true;
+}
+
+}  // namespace native
+}  // namespace xrt
+}  // namespace oneflow
@@ -0,0 +1,74 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_XRT_NATIVE_NATIVE_EXECUTABLE_H_
+#define ONEFLOW_XRT_NATIVE_NATIVE_EXECUTABLE_H_
+
+#include "oneflow/xrt/executable.h"
+#include "oneflow/xrt/native/native_builder.h"
+
+namespace oneflow {
+namespace xrt {
+namespace native {
+
+// An instruction of the fused loop nest. Each instruction produces a block of
+// elements which may be read by the following instructions.
+struct NativeInstruction {
+  NativeOpCode opcode;
+  int32_t operands[2] = {-1, -1};
+  double scalar = 0.0;
+  // Buffer read by kLoad, and its element strides for every loop of the nest.
+  // The stride is 0 along the broadcasted loops.
+  int64_t buffer_id = -1;
+  std::vector<int64_t> strides;
+  bool contiguous = false;
+};
+
+// All the stages are lowered to the loop nests over the elements of the
+// evaluated value. The reduced loops are moved to the innermost for a
+// reduction stage, so that `reduce_cnt` adjacent iterations produce one
+// element of the destination buffer.
+struct NativeLoopNest {
+  DimVector dims;
+  int64_t elem_cnt;
+  int64_t reduce_cnt;
+  std::vector<NativeInstruction> instructions;
+  int64_t dst_buffer_id;
+};
+
+class NativeExecutable : public Executable {
+ public:
+  NativeExecutable(const std::string &name, NativeProgram program);
+  virtual ~NativeExecutable() = default;
+
+  bool Run(const std::vector<Parameter> &inputs, const ExecutableRunOptions &run_options,
+           bool block_until_done = true) override;
+
+ private:
+  template<typename T>
+  void RunLoopNest(const NativeLoopNest &loop_nest, const std::vector<char *> &buffer_ptrs) const;
+
+  NativeProgram program_;
+  std::vector<NativeLoopNest> loop_nests_;
+  // Offset of every temporary buffer in `temp_storage_`.
+  std::vector<int64_t> temp_offsets_;
+  std::vector<char> temp_storage_;
+};
+
+}  // namespace native
+}  // namespace xrt
+}  // namespace oneflow
+
+#endif  // ONEFLOW_XRT_NATIVE_NATIVE_EXECUTABLE_H_
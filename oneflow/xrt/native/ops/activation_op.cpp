@@ -0,0 +1,60 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/xrt/native/ops/op_context.h"
+#include "oneflow/xrt/native/ops/op_kernel.h"
+
+namespace oneflow {
+namespace xrt {
+namespace native {
+
+template<NativeOpCode opcode>
+class ActivationOp : public NativeOpKernel {
+ public:
+  void Compile(NativeOpContext *ctx) override {
+    ctx->SetSoleOutput(ctx->builder()->Unary(opcode, ctx->SoleInput()));
+  }
+};
+
+REGISTER_NATIVE_OP_KERNEL(Relu, ActivationOp<NativeOpCode::kRelu>).EnableTrainPhase().Finalize();
+REGISTER_NATIVE_OP_KERNEL(Sigmoid, ActivationOp<NativeOpCode::kSigmoid>)
+    .EnableTrainPhase()
+    .Finalize();
+REGISTER_NATIVE_OP_KERNEL(Tanh, ActivationOp<NativeOpCode::kTanh>).EnableTrainPhase().Finalize();
+REGISTER_NATIVE_OP_KERNEL(Gelu, ActivationOp<NativeOpCode::kGelu>).EnableTrainPhase().Finalize();
+
+template<>
+class ActivationOp<NativeOpCode::kLeakyRelu> : public NativeOpKernel {
+ public:
+  void Compile(NativeOpContext *ctx) override {
+    float alpha = ctx->Attr<float>("alpha");
+    ctx->SetSoleOutput(ctx->builder()->Unary(NativeOpCode::kLeakyRelu, ctx->SoleInput(), alpha));
+  }
+};
+
+REGISTER_NATIVE_OP_KERNEL(LeakyRelu, ActivationOp<NativeOpCode::kLeakyRelu>)
+    .EnableTrainPhase()
+    .Finalize();
+
+class IdentityOp : public NativeOpKernel {
+ public:
+  void Compile(NativeOpContext *ctx) override { ctx->SetSoleOutput(ctx->SoleInput()); }
+};
+
+REGISTER_NATIVE_OP_KERNEL(Identity, IdentityOp).EnableTrainPhase().Finalize();
+
+}  // namespace native
+}  // namespace xrt
+}  // namespace oneflow
@@ -0,0 +1,122 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "absl/strings/str_cat.h"
+#include "oneflow/xrt/native/ops/op_context.h"
+#include "oneflow/xrt/native/ops/op_kernel.h"
+
+namespace oneflow {
+namespace xrt {
+namespace native {
+
+class AddOp : public NativeOpKernel {
+ public:
+  void Compile(NativeOpContext *ctx) override {
+    int num_inputs = ctx->num_inputs();
+    CHECK_GT(num_inputs, 0);
+    Shape shape = ctx->InputShape("in_0");
+    NativeValue sum = ctx->Input("in_0");
+    for (int i = 1; i < num_inputs; ++i) {
+      std::string name = absl::StrCat("in_", i);
+      CHECK_EQ(shape, ctx->InputShape(name));
+      sum = ctx->builder()->Binary(NativeOpCode::kAdd, sum, ctx->Input(name));
+    }
+    ctx->SetSoleOutput(sum);
+  }
+};
+
+REGISTER_NATIVE_OP_KERNEL(Add, AddOp).EnableTrainPhase().Finalize();
+
+class MultiplyOp : public NativeOpKernel {
+ public:
+  void Compile(NativeOpContext *ctx) override {
+    CHECK_EQ(ctx->InputShape("x_0"), ctx->InputShape("y_0"));
+    ctx->SetSoleOutput(
+        ctx->builder()->Binary(NativeOpCode::kMul, ctx->Input("x_0"), ctx->Input("y_0")));
+  }
+};
+
+REGISTER_NATIVE_OP_KERNEL(Multiply, MultiplyOp).EnableTrainPhase().Finalize();
+
+template<NativeOpCode opcode>
+class BcastBinaryOp : public NativeOpKernel {
+ public:
+  void Compile(NativeOpContext *ctx) override {
+    // The operands are broadcasted by the loop nest without copying.
+    ctx->SetOutput("z_0", ctx->builder()->Binary(opcode, ctx->Input("x_0"), ctx->Input("y_0")));
+  }
+};
+
+REGISTER_NATIVE_OP_KERNEL(BcastAdd, BcastBinaryOp<NativeOpCode::kAdd>)
+    .EnableTrainPhase()
+    .Finalize();
+REGISTER_NATIVE_OP_KERNEL(BcastSub, BcastBinaryOp<NativeOpCode::kSub>)
+    .EnableTrainPhase()
+    .Finalize();
+REGISTER_NATIVE_OP_KERNEL(BcastMul, BcastBinaryOp<NativeOpCode::kMul>)
+    .EnableTrainPhase()
+    .Finalize();
+REGISTER_NATIVE_OP_KERNEL(BcastDiv, BcastBinaryOp<NativeOpCode::kDiv>)
+    .EnableTrainPhase()
+    .Finalize();
+
+template<NativeOpCode opcode>
+class ScalarBinaryOp : public NativeOpKernel {
+ public:
+  void Compile(NativeOpContext *ctx) override {
+    NativeValue in = ctx->SoleInput();
+    double value = 0.0;
+    if (ctx->Attr<bool>("has_int_operand")) {
+      value = static_cast<double>(ctx->Attr<int64_t>("int_operand"));
+    } else if (ctx->Attr<bool>("has_float_operand")) {
+      value = ctx->Attr<double>("float_operand");
+    }
+    ctx->SetSoleOutput(ctx->builder()->Binary(opcode, in, ctx->builder()->Scalar(in, value)));
+  }
+};
+
+REGISTER_NATIVE_OP_KERNEL(ScalarAdd, ScalarBinaryOp<NativeOpCode::kAdd>)
+    .EnableTrainPhase()
+    .Finalize();
+REGISTER_NATIVE_OP_KERNEL(ScalarMul, ScalarBinaryOp<NativeOpCode::kMul>)
+    .EnableTrainPhase()
+    .Finalize();
+
+class BiasAddOp : public NativeOpKernel {
+ public:
+  void Compile(NativeOpContext *ctx) override {
+    Shape in_shape = ctx->InputShape("a_0");
+    Shape bias_shape = ctx->InputShape("b_0");
+    CHECK_GE(in_shape.NumAxes(), 2);
+    CHECK_EQ(bias_shape.NumAxes(), 1);
+    CHECK_EQ(ctx->InputType("a_0"), ctx->InputType("b_0"));
+
+    int32_t axis = ctx->Attr<int32_t>("axis");
+    if (axis < 0) { axis += in_shape.NumAxes(); }
+    CHECK_EQ(in_shape.At(axis), bias_shape.At(0));
+    DimVector dim_vec(in_shape.NumAxes() - axis, 1);
+    dim_vec[0] = bias_shape.At(0);
+    // Reshape bias to be broadcasted along all the axes except `axis`.
+    NativeValue bias = ctx->builder()->Reshape(ctx->Input("b_0"), Shape(dim_vec));
+    ctx->SetOutput("out_0",
+                   ctx->builder()->Binary(NativeOpCode::kAdd, ctx->Input("a_0"), bias));
+  }
+};
+
+REGISTER_NATIVE_OP_KERNEL(BiasAdd, BiasAddOp).EnableTrainPhase().Finalize();
+
+}  // namespace native
+}  // namespace xrt
+}  // namespace oneflow
@@ -45,6 +45,8 @@ class MarkClusterIdPass : public XrtPass {
   bool TryToFuseWithParent(ClusterNode *children, ClusterNode *parent,
                            const ClusteringOptions &options);
 
+  bool IsCompiled(const ClusterNode *node, const XrtEngine &engine, bool train_phase) const;
+
  private:
   // Root cluster nodes.
   util::Set<ClusterNode *> root_nodes_;
@@ -62,6 +64,33 @@ struct GraphTypeTrait<MarkClusterIdPass> {
 };
 }  // namespace algorithm
 
+namespace {
+
+// The native engine evaluates a cluster in a single floating point type, so it only takes the
+// nodes whose blobs are all float or all double. Returns kInvalidDataType for the others.
+DataType NativeDataType(const ClusterNode *node) {
+  const XrtNode *xrt_node = node->xrt_node();
+  if (!xrt_node->HasAttr("data_types")) { return DataType::kInvalidDataType; }
+  const auto &data_types = xrt_node->Attr<std::vector<DataType>>("data_types");
+  if (data_types.empty()) { return DataType::kInvalidDataType; }
+  const DataType data_type = data_types.front();
+  if (data_type != DataType::kFloat && data_type != DataType::kDouble) {
+    return DataType::kInvalidDataType;
+  }
+  for (const DataType &other : data_types) {
+    if (other != data_type) { return DataType::kInvalidDataType; }
+  }
+  return data_type;
+}
+
+}  // namespace
+
+bool MarkClusterIdPass::IsCompiled(const ClusterNode *node, const XrtEngine &engine,
+                                   bool train_phase) const {
+  if (!node->IsCompiled(engine, train_phase)) { return false; }
+  return engine != XrtEngine::NATIVE || NativeDataType(node) != DataType::kInvalidDataType;
+}
+
 void MarkClusterIdPass::BuildClusterNodesAndEdges(XrtGraph *graph) {
   CHECK(graph) << "Graph is required by MarkClusterIdPass.";
   util::Map<int64_t, ClusterNode *> cluster_nodes;
@@ -95,7 +124,7 @@ void MarkClusterIdPass::ClusteringSubgraphs(const ClusteringOptions &options,
     bool has_changed = false;
     std::vector<ClusterNode *> ordered_nodes;
     algorithm::TopologyVisit(*this, [&](ClusterNode *node) {
-      if (!node->IsCompiled(engine, options.train_phase)
+      if (!IsCompiled(node, engine, options.train_phase)
           || node->IsOptimizer(engine) /* skip model update op */) {
         return;
       }
@@ -108,7 +137,8 @@ void MarkClusterIdPass::ClusteringSubgraphs(const ClusteringOptions &options,
       util::Set<ClusterNode *> candidate_parents;
       for (ClusterEdge *edge : node->in_edges()) { candidate_parents.insert(edge->start()); }
       for (ClusterNode *parent : candidate_parents) {
-        if (parent->IsCompiled(engine, options.train_phase)
+        if (IsCompiled(parent, engine, options.train_phase)
+            && (engine != XrtEngine::NATIVE || NativeDataType(parent) == NativeDataType(node))
             && (parent->size() + node->size()) <= options.maximum_nodes
             && TryToFuseWithParent(node, parent, options)) {
           has_changed = true;
@@ -172,7 +202,7 @@ void MarkClusterIdPass::FinalizeClusterEngine(const ClusteringOptions &options,
   const int min_nodes = options.minimum_nodes;
   const int max_nodes = options.maximum_nodes;
   for (ClusterNode *node : root_nodes_) {
-    if (node->IsCompiled(engine, options.train_phase) && node->size() >= min_nodes
+    if (IsCompiled(node, engine, options.train_phase) && node->size() >= min_nodes
         && node->size() <= max_nodes) {
       node->set_engine(engine);
     }
@@ -203,6 +233,9 @@ void MarkClusterIdPass::Run(XrtGraph *graph, const XrtPassOptions &options) {
     ClusteringSubgraphs(clustering_options, XrtEngine::TENSORRT);
     ClusteringSubgraphs(clustering_options, XrtEngine::XLA);
   }
+  // The native engine clusters the remaining nodes which are not compiled by
+  // the other engines.
+  ClusteringSubgraphs(clustering_options, XrtEngine::NATIVE);
 
   RemoveInvalidClusterNodes(clustering_options);
   RerankClusterIds();
@@ -27,11 +27,13 @@ class XlaExecutable : public Executable {
  public:
   XlaExecutable(const std::string &name, const XrtDevice &device,
                 const std::vector<xla::Shape> &input_shapes,
-                const xla::Shape &output_shape, std::unique_ptr<xla::LocalExecutable> &&executable)
+                const xla::Shape &output_shape, const xla::HloModuleProto &hlo_module,
+                std::unique_ptr<xla::LocalExecutable> &&executable)
       : Executable(name, XrtEngine::XLA),
         device_(device),
         input_shapes_(input_shapes),
         output_shape_(output_shape),
+        hlo_module_(hlo_module),
         executable_(std::move(executable)) {}
 
   virtual ~XlaExecutable() = default;
@@ -39,6 +41,10 @@ class XlaExecutable : public Executable {
   bool Run(const std::vector<Parameter> &inputs, const ExecutableRunOptions &run_options,
            bool block_until_done = true) override;
 
+  bool SerializeProgram(std::string *serialized) const override {
+    return hlo_module_.SerializeToString(serialized);
+  }
+
  private:
   XrtDevice device_;
 
@@ -46,6 +52,8 @@ class XlaExecutable : public Executable {
   // The output shape is always a tuple.
   xla::Shape output_shape_;
 
+  xla::HloModuleProto hlo_module_;
+
   std::unique_ptr<xla::LocalExecutable> executable_;
 };
 
@@ -125,7 +125,7 @@ void XlaGraphCompiler::BuildComputation(const XrtGraph *graph,
   }
 }
 
-std::shared_ptr<Executable> XlaGraphCompiler::BuildExecutable(
+xla::StatusOr<std::shared_ptr<Executable>> XlaGraphCompiler::TryBuildExecutable(
     const std::vector<xla::Shape> &xla_input_shapes,  // NOLINT
     const xla::Shape &xla_output_shape,               // NOLINT
     const xla::XlaComputation &computation) {
@@ -137,10 +137,20 @@ std::shared_ptr<Executable> XlaGraphCompiler::BuildExecutable(
   xla::ExecutableBuildOptions build_options;
   build_options.set_device_ordinal(this->device_ordinal_);
   build_options.set_result_layout(xla_output_shape);
+  auto executable = client->Compile(computation, argument_layouts, build_options);
+  if (!executable.ok()) { return executable.status(); }
+  return std::shared_ptr<Executable>(std::make_shared<XlaExecutable>(
+      builder_->name(), this->device_, xla_input_shapes, xla_output_shape, computation.proto(),
+      std::move(executable.ValueOrDie())));
+}
+
+std::shared_ptr<Executable> XlaGraphCompiler::BuildExecutable(
+    const std::vector<xla::Shape> &xla_input_shapes,  // NOLINT
+    const xla::Shape &xla_output_shape,               // NOLINT
+    const xla::XlaComputation &computation) {
   MOLA_CHECK_AND_ASSIGN(auto executable,
-                        client->Compile(computation, argument_layouts, build_options));
-  return std::make_shared<XlaExecutable>(builder_->name(), this->device_, xla_input_shapes, xla_output_shape,
-                                         std::move(executable));
+                        TryBuildExecutable(xla_input_shapes, xla_output_shape, computation));
+  return executable;
 }
 
 void XlaGraphCompiler::BuildEntryParameters(const std::vector<Parameter> &entry_params,
@@ -185,6 +195,40 @@ std::shared_ptr<Executable> XlaGraphCompiler::Compile(
   return BuildExecutable(input_shapes, output_shape, computation);
 }
 
+std::shared_ptr<Executable> XlaGraphCompiler::CompileSerializedProgram(
+    const std::string &serialized) {
+  xla::HloModuleProto hlo_module;
+  if (!hlo_module.ParseFromString(serialized)) { return nullptr; }
+  xla::XlaComputation computation(hlo_module);
+  // A broken or incompatible program must not abort, the caller builds it from
+  // the graph again instead.
+  const auto program_shape = computation.GetProgramShape();
+  if (!program_shape.ok()) {
+    LOG(WARNING) << "Discard the serialized program of " << builder_->name() << ": "
+                 << program_shape.status();
+    return nullptr;
+  }
+  if (!xla::ShapeUtil::IsTuple(program_shape.ValueOrDie().result())) {
+    LOG(WARNING) << "Discard the serialized program of " << builder_->name()
+                 << ": the result is not a tuple";
+    return nullptr;
+  }
+  std::vector<xla::Shape> input_shapes(program_shape.ValueOrDie().parameters().begin(),
+                                       program_shape.ValueOrDie().parameters().end());
+  xla::Shape output_shape = program_shape.ValueOrDie().result();
+  for (int i = 0; i < xla::ShapeUtil::TupleElementCount(output_shape); ++i) {
+    xla::Shape *output_sub_shape = xla::ShapeUtil::GetMutableSubshape(&output_shape, {i});
+    xla::LayoutUtil::SetToDefaultLayout(output_sub_shape);
+  }
+  auto executable = TryBuildExecutable(input_shapes, output_shape, computation);
+  if (!executable.ok()) {
+    LOG(WARNING) << "Discard the serialized program of " << builder_->name() << ": "
+                 << executable.status();
+    return nullptr;
+  }
+  return executable.ValueOrDie();
+}
+
 REGISTER_GRAPH_COMPILER(XrtEngine::XLA, XlaGraphCompiler);
 
 }  // namespace mola
@@ -41,7 +41,15 @@ class XlaGraphCompiler : public GraphCompiler::Impl {
                                       const std::vector<Parameter> &return_params,
                                       const std::vector<InputOutputAlias> &aliases) override;
 
+  // Return nullptr if the serialized executable is broken or can not be
+  // compiled by this version of XLA.
+  std::shared_ptr<Executable> CompileSerializedProgram(const std::string &serialized) override;
+
  private:
+  xla::StatusOr<std::shared_ptr<Executable>> TryBuildExecutable(
+      const std::vector<xla::Shape> &xla_input_shapes, const xla::Shape &xla_output_shape,
+      const xla::XlaComputation &computation);
+
   std::shared_ptr<Executable> BuildExecutable(const std::vector<xla::Shape> &xla_input_shapes,
                                               const xla::Shape &xla_output_shape,
                                               const xla::XlaComputation &computation);
@@ -0,0 +1,34 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/xrt/xla/xla_graph_compiler.h"
+
+namespace oneflow {
+namespace xrt {
+namespace mola {
+
+TEST(XlaGraphCompiler, compile_broken_serialized_program) {
+  XlaGraphCompiler compiler("test_deserialize");
+  // not a HloModuleProto
+  EXPECT_TRUE(compiler.CompileSerializedProgram("\xff\xff\xff") == nullptr);
+  // a HloModuleProto without program shape
+  xla::HloModuleProto hlo_module;
+  hlo_module.set_name("test_deserialize");
+  EXPECT_TRUE(compiler.CompileSerializedProgram(hlo_module.SerializeAsString()) == nullptr);
+}
+
+}  // namespace mola
+}  // namespace xrt
+}  // namespace oneflow